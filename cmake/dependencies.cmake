@@ -2,7 +2,12 @@ include(FetchContent)
 
 list(APPEND CMAKE_MODULE_PATH "${CMAKE_SOURCE_DIR}/cmake/modules")
 
-find_package(MSFS_SDK MODULE REQUIRED)
+if(SIMCONNECT_STANDIN)
+    add_subdirectory(${CMAKE_SOURCE_DIR}/simconnect_standin)
+    add_library(msfs_sdk ALIAS simconnect_standin)
+else()
+    find_package(MSFS_SDK MODULE REQUIRED)
+endif()
 
 message(STATUS "Fetching alx-home::ts-utils")
 FetchContent_Declare(
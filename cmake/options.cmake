@@ -16,4 +16,7 @@ if(CMAKE_SYSTEM_NAME STREQUAL "Windows")
     option(WEBVIEW_USE_BUILTIN_MSWEBVIEW2 "Use built-in MS WebView2" ON)
 endif()
 
+# SimConnect
+option(SIMCONNECT_STANDIN "Link the SimConnect stand-in instead of the MSFS SDK library" OFF)
+
 set(MSFS_SDK_LOCATION "C:/MSFS 2024 SDK" CACHE STRING "MSFS 2024 SDK Path")
\ No newline at end of file
@@ -48,6 +48,7 @@
 #include <stop_token>
 #include <string_view>
 #include <thread>
+#include <utility>
 #include <atltypes.h>
 
 using namespace std::chrono_literals;
@@ -56,7 +57,14 @@ AppStopping::AppStopping()
    : std::runtime_error("App is stopping !") {}
 
 static uint32_t const MF_MOUSE_EVENT = ::RegisterWindowMessage("MainFrameMouseEvent");
-Main::Main(bool minimized, bool configure, bool open_efb, bool open_web)
+Main::Main(
+  bool                     minimized,
+  bool                     configure,
+  bool                     open_efb,
+  bool                     open_web,
+  Server::Options          server_options,
+  smc::SimConnect::Options sim_connect_options
+)
    : win32::SystemTray("MSFS2024 VFRNav' Server", "MSFS2024 VFRNav' Server")
    , promise::Pool<50>{"Main Pool"}
    , mouse_watcher_([this](std::stop_token stop_token) {
@@ -80,7 +88,9 @@ Main::Main(bool minimized, bool configure, bool open_efb, bool open_web)
 
          std::this_thread::sleep_for(50ms);
       }
-   }) {
+   })
+   , sim_connect_{*this, std::move(sim_connect_options)}
+   , server_{*this, std::move(server_options)} {
    SetStandardIcon(IDI_ICON1);
    ShowIcon();
 
@@ -0,0 +1,187 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PlaneBlobCache.h"
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+PlaneBlobCache::PlaneBlobCache(std::filesystem::path path)
+   : path_{std::move(path)} {}
+
+void
+PlaneBlobCache::Load() {
+   if (loaded_) {
+      return;
+   }
+   loaded_ = true;
+
+   try {
+      std::filesystem::create_directories(path_);
+
+      std::vector<std::pair<std::filesystem::file_time_type, std::size_t>> uses{};
+      for (auto const& file : std::filesystem::directory_iterator{path_}) {
+         auto const name = file.path().filename().string();
+
+         // <id>_<version>.blob, version 0 stands for an unversioned blob
+         std::size_t id{};
+         std::size_t version{};
+
+         auto const  sep = name.find('_');
+         auto const  ext = name.rfind(".blob");
+         char const* str = name.data();
+         if (
+           (sep == std::string::npos) || (ext == std::string::npos) || (ext < sep)
+           || (ext + 5 != name.size())
+           || (std::from_chars(str, str + sep, id).ec != std::errc{})
+           || (std::from_chars(str + sep + 1, str + ext, version).ec != std::errc{})
+         ) {
+            std::filesystem::remove(file.path());
+            continue;
+         }
+
+         Entry const entry{
+           .version_ = version ? std::optional{version} : std::nullopt, .size_ = file.file_size()
+         };
+         if (!entries_.emplace(id, entry).second) {
+            // Another version of the same blob (e.g. left by an interrupted Put), one is enough
+            std::filesystem::remove(file.path());
+            continue;
+         }
+         size_ += entry.size_;
+         uses.emplace_back(file.last_write_time(), id);
+      }
+
+      // Oldest files are the first evicted
+      std::ranges::sort(uses);
+      for (auto const& [_, id] : uses) {
+         entries_.at(id).last_use_ = ++use_counter_;
+      }
+
+      Evict();
+   } catch (std::exception const& e) {
+      std::cerr << "PlaneBlob cache: " << e.what() << std::endl;
+   }
+}
+
+std::filesystem::path
+PlaneBlobCache::Path(std::size_t id, Entry const& entry) const {
+   return path_ / std::format("{}_{}.blob", id, entry.version_.value_or(0));
+}
+
+std::optional<ws::msg::PlaneBlob>
+PlaneBlobCache::Get(std::size_t id) {
+   Load();
+
+   auto const it = entries_.find(id);
+   if (it == entries_.end()) {
+      return std::nullopt;
+   }
+
+   ws::msg::PlaneBlob blob{.id_ = id, .version_ = it->second.version_};
+   {
+      std::ifstream file{Path(id, it->second), std::ios::binary};
+      blob.value_.resize(it->second.size_);
+      file.read(blob.value_.data(), blob.value_.size());
+
+      if (!file) {
+         file.close();
+         Remove(id);
+         return std::nullopt;
+      }
+   }
+
+   it->second.last_use_ = ++use_counter_;
+   return blob;
+}
+
+void
+PlaneBlobCache::Put(ws::msg::PlaneBlob const& blob) {
+   Load();
+
+   if (blob.value_.empty() || (blob.value_.size() > MAX_SIZE)) {
+      // Error answers of the EFB are empty
+      return;
+   }
+
+   Remove(blob.id_);
+
+   Entry const entry{
+     .version_ = blob.version_, .size_ = blob.value_.size(), .last_use_ = ++use_counter_
+   };
+   auto const path = Path(blob.id_, entry);
+
+   try {
+      {
+         std::ofstream file{path.string() + ".tmp", std::ios::binary};
+         file.write(blob.value_.data(), blob.value_.size());
+      }
+
+      std::filesystem::rename(path.string() + ".tmp", path);
+   } catch (std::exception const& e) {
+      std::cerr << "PlaneBlob cache: " << e.what() << std::endl;
+      return;
+   }
+
+   entries_.emplace(blob.id_, entry);
+   size_ += entry.size_;
+
+   Evict();
+}
+
+void
+PlaneBlobCache::Remove(std::size_t id) {
+   Load();
+
+   if (auto const it = entries_.find(id); it != entries_.end()) {
+      std::error_code ec{};
+      std::filesystem::remove(Path(id, it->second), ec);
+
+      size_ -= it->second.size_;
+      entries_.erase(it);
+   }
+}
+
+void
+PlaneBlobCache::Retain(std::unordered_set<std::size_t> const& ids) {
+   Load();
+
+   std::vector<std::size_t> removed{};
+   for (auto const& [id, _] : entries_) {
+      if (!ids.contains(id)) {
+         removed.emplace_back(id);
+      }
+   }
+
+   for (auto const id : removed) {
+      Remove(id);
+   }
+}
+
+void
+PlaneBlobCache::Evict() {
+   while (size_ > MAX_SIZE) {
+      auto const oldest = std::ranges::min_element(entries_, {}, [](auto const& entry) {
+         return entry.second.last_use_;
+      });
+
+      Remove(oldest->first);
+   }
+}
@@ -0,0 +1,59 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Server/WebSockets/Messages/PlanePos.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+// Disk cache of the PlaneBlob sent by the EFB (<path>/<id>_<version>.blob)
+// Blobs are immutable once written by the EFB, entries are only dropped with their record or when
+// the cache exceeds MAX_SIZE (least recently used first). Lookups are by id only : GetPlaneBlob
+// carries no version, the version is kept to answer it back and a new one replaces the entry.
+class PlaneBlobCache {
+public:
+   static constexpr std::size_t MAX_SIZE = 256 * 1024 * 1024;
+
+   PlaneBlobCache(std::filesystem::path path);
+
+   std::optional<ws::msg::PlaneBlob> Get(std::size_t id);
+   void                              Put(ws::msg::PlaneBlob const& blob);
+   void                              Remove(std::size_t id);
+
+   // Drops the blobs that aren't part of a record anymore
+   void Retain(std::unordered_set<std::size_t> const& ids);
+
+private:
+   struct Entry {
+      std::optional<std::size_t> version_{};
+      std::size_t                size_{};
+      std::size_t                last_use_{};
+   };
+
+   void                  Load();
+   void                  Evict();
+   std::filesystem::path Path(std::size_t id, Entry const& entry) const;
+
+   bool                                   loaded_{false};
+   std::filesystem::path const            path_;
+   std::unordered_map<std::size_t, Entry> entries_{};
+   std::size_t                            size_{};
+   std::size_t                            use_counter_{};
+};
@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Server.h"
+
+#include "Registry/Registry.h"
+#include "Server/WebSockets/Messages/Facilities.h"
+#include "Server/WebSockets/Messages/Messages.h"
+#include "Server/WebSockets/Messages/NavData.h"
+#include "Server/WebSockets/Messages/PlanePos.h"
+#include "Server/WebSockets/Messages/Records.h"
+
+#include <json/json.h>
+
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+
+Server::Relay::Relay(Server& server, Tenant& tenant, io_context& ioc, std::string const& upstream) {
+   std::string host{};
+   std::string port{};
+
+   if (auto const sep = upstream.rfind(':'); sep == std::string::npos) {
+      // Upstream server on its default (registry) port
+      host = upstream;
+      port = std::to_string(*registry::Get().alx_home_->settings_->server_port_);
+   } else {
+      host = upstream.substr(0, sep);
+      port = upstream.substr(sep + 1);
+   }
+
+   link_ = std::make_shared<RelayLink>(
+     ioc,
+     std::move(host),
+     std::move(port),
+     js::Stringify(ws::msg::HelloWorld{.type_ = "Relay"}),
+     [&server, &tenant](RelayLink::Frame&& frame) {
+        try {
+           auto proxy = js::Parse<ws::Proxy>(*frame);
+
+           (void)server.Dispatch([&tenant, proxy = std::move(proxy), frame = std::move(frame)](
+                                 ) mutable { tenant.OnUpstream(std::move(proxy), frame); });
+        } catch (std::exception const& e) {
+           std::cerr << "Relay parsing error: " << e.what() << std::endl;
+        }
+     },
+     [&server, &tenant]() {
+        (void)server.Dispatch([&tenant]() { tenant.OnUpstreamState(false); });
+     }
+   );
+}
+
+void
+Server::Relay::Start() {
+   link_->Start();
+}
+
+void
+Server::Relay::Stop() {
+   link_->Stop();
+}
+
+void
+Server::Relay::Send(ws::Message&& message) {
+   if (!link_->Connected()) {
+      return;
+   }
+
+   try {
+      // Addressed to the upstream EFB, written from the link strand
+      link_->Send(js::Stringify(ws::Proxy{.id_ = 0, .content_ = std::move(message)}));
+   } catch (std::exception const& e) {
+      std::cerr << "Relay write error: " << e.what() << std::endl;
+   }
+}
+
+// Tenant side, on the server message queue
+
+void
+Server::Tenant::OnUpstream(ws::Proxy&& proxy, std::shared_ptr<std::string const> const& frame) {
+   if (!relay_) {
+      // Stopped in the meantime
+      return;
+   }
+
+   auto const& content = proxy.content_;
+
+   if (auto const state = std::get_if<ws::msg::EFBState>(&content)) {
+      if (state->state_ != efb_connected_) {
+         OnUpstreamState(state->state_);
+      }
+   } else if (
+     std::holds_alternative<ws::msg::PlanePos>(content)
+     || std::holds_alternative<ws::msg::ExportNav>(content)
+   ) {
+      Broadcast(proxy, frame);
+   } else if (std::holds_alternative<ws::msg::Records>(content)) {
+      // Upstream broadcasts and answers can't be told apart, every viewer gets the records
+      OnEFBSnapshot(1, content);
+      Broadcast(proxy, frame);
+   } else if (
+     std::holds_alternative<ws::msg::Facilities>(content)
+     || std::holds_alternative<ws::msg::PlaneBlob>(content)
+   ) {
+      // Answers to the requests sent upstream, served to their waiters
+      OnEFBSnapshot(0, content);
+   }
+
+   // Other messages (connection, edition, presets) aren't relayed
+}
+
+void
+Server::Tenant::OnUpstreamState(bool efb_connected) {
+   efb_connected_ = efb_connected;
+
+   // Snapshots of a previous upstream session are outdated
+   InvalidateSnapshots();
+
+   for (auto const& [id, handler] : message_handlers_) {
+      handler(1, ws::msg::EFBState{.state_ = efb_connected});
+   }
+
+   if (efb_connected) {
+      records_in_flight_ = true;
+      relay_->Send(ws::msg::GetRecords{});
+
+      for (auto const& [id, handler] : message_handlers_) {
+         if (handler.lat_ > -500) {
+            RequestFacilities(id, handler.lat_, handler.lon_);
+         }
+      }
+   }
+}
+
+void
+Server::Tenant::Broadcast(ws::Proxy const& proxy, std::shared_ptr<std::string const> const& frame) {
+   for (auto const& [id, handler] : message_handlers_) {
+      if (handler.frame_) {
+         handler.frame_(frame);
+      } else {
+         handler(proxy.id_, proxy.content_);
+      }
+   }
+}
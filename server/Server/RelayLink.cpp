@@ -0,0 +1,216 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "RelayLink.h"
+
+#include <iostream>
+#include <utility>
+
+using namespace boost::beast;
+
+RelayLink::RelayLink(
+  net::io_context& ioc,
+  std::string      host,
+  std::string      port,
+  std::string      hello,
+  OnFrame          on_frame,
+  OnDisconnected   on_disconnected
+)
+   : strand_{net::make_strand(ioc)}
+   , resolver_{strand_}
+   , timer_{strand_}
+   , host_{std::move(host)}
+   , port_{std::move(port)}
+   , hello_{std::make_shared<std::string const>(std::move(hello))}
+   , on_frame_{std::move(on_frame)}
+   , on_disconnected_{std::move(on_disconnected)} {}
+
+void
+RelayLink::Start() {
+   net::dispatch(strand_, bind_front_handler(&RelayLink::Connect, shared_from_this()));
+}
+
+void
+RelayLink::Stop() {
+   stopped_   = true;
+   connected_ = false;
+
+   net::post(strand_, [self = shared_from_this()]() {
+      self->timer_.cancel();
+      self->resolver_.cancel();
+
+      if (self->ws_) {
+         error_code ec{};
+         self->ws_->next_layer().close(ec);
+      }
+   });
+}
+
+void
+RelayLink::Send(std::string&& frame) {
+   if (!connected_) {
+      return;
+   }
+
+   net::post(
+     strand_,
+     [self = shared_from_this(), frame = std::make_shared<std::string const>(std::move(frame))](
+     ) mutable {
+        if (self->connected_) {
+           self->Enqueue(std::move(frame));
+        }
+     }
+   );
+}
+
+bool
+RelayLink::Connected() const {
+   return connected_;
+}
+
+void
+RelayLink::Connect() {
+   if (stopped_) {
+      return;
+   }
+
+   // Frames of the previous connection are lost with it
+   queue_.clear();
+   ws_.emplace(strand_);
+   buffer_.clear();
+
+   resolver_.async_resolve(
+     host_, port_, bind_front_handler(&RelayLink::OnResolve, shared_from_this())
+   );
+}
+
+void
+RelayLink::OnResolve(error_code ec, tcp::resolver::results_type results) {
+   if (ec) {
+      return Retry("resolve", ec);
+   }
+
+   net::async_connect(
+     ws_->next_layer(), results, bind_front_handler(&RelayLink::OnConnect, shared_from_this())
+   );
+}
+
+void
+RelayLink::OnConnect(error_code ec, tcp::endpoint const&) {
+   if (ec) {
+      return Retry("connect", ec);
+   }
+
+   // Position updates are small and latency bound
+   ws_->next_layer().set_option(tcp::no_delay{true});
+   ws_->set_option(websocket::stream_base::timeout::suggested(role_type::client));
+   ws_->text(true);
+
+   ws_->async_handshake(
+     host_ + ":" + port_, "/", bind_front_handler(&RelayLink::OnHandshake, shared_from_this())
+   );
+}
+
+void
+RelayLink::OnHandshake(error_code ec) {
+   if (ec) {
+      return Retry("handshake", ec);
+   }
+
+   if (stopped_) {
+      return;
+   }
+
+   std::cout << "Relaying " << host_ << ":" << port_ << std::endl;
+
+   // First in the queue, a write failure shows up as a read error
+   Enqueue(Frame{hello_});
+   connected_ = true;
+   Read();
+}
+
+void
+RelayLink::Read() {
+   ws_->async_read(buffer_, bind_front_handler(&RelayLink::OnRead, shared_from_this()));
+}
+
+void
+RelayLink::OnRead(error_code ec, std::size_t n) {
+   if (ec) {
+      return Retry("read", ec);
+   }
+
+   auto it    = buffers_begin(buffer_.data());
+   auto frame = std::make_shared<std::string const>(it, it + n);
+   buffer_.consume(n);
+
+   on_frame_(std::move(frame));
+   Read();
+}
+
+void
+RelayLink::Enqueue(Frame&& frame) {
+   queue_.emplace_back(std::move(frame));
+
+   if (queue_.size() == 1) {
+      Write();
+   }
+}
+
+void
+RelayLink::Write() {
+   ws_->async_write(
+     net::buffer(*queue_.front()), bind_front_handler(&RelayLink::OnWrite, shared_from_this())
+   );
+}
+
+void
+RelayLink::OnWrite(error_code ec, std::size_t) {
+   if (ec) {
+      // The pending read fails as well and retries
+      std::cerr << "Relay write error: " << ec.message() << std::endl;
+      queue_.clear();
+      return;
+   }
+
+   queue_.pop_front();
+   if (!queue_.empty()) {
+      Write();
+   }
+}
+
+void
+RelayLink::Retry(std::string_view step, error_code ec) {
+   if (stopped_) {
+      return;
+   }
+
+   std::cerr << "Relay " << step << " error: " << ec.message() << std::endl;
+
+   if (connected_.exchange(false)) {
+      on_disconnected_();
+   }
+
+   error_code close_ec{};
+   ws_->next_layer().close(close_ec);
+
+   timer_.expires_after(RETRY_DELAY);
+   timer_.async_wait([self = shared_from_this()](error_code ec) {
+      if (!ec) {
+         self->Connect();
+      }
+   });
+}
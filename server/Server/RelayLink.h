@@ -0,0 +1,106 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef __clang__
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Weverything"
+#elif defined(_MSC_VER)
+#   pragma warning(push, 0)
+#endif
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#ifdef __clang__
+#   pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#   pragma warning(pop)
+#endif
+
+// Websocket client link of a relay to its upstream server : says hello on every connection and
+// reconnects after RETRY_DELAY on error.
+// The stream is only touched from the link strand, Send posts the frame there and the writes are
+// queued behind a single async_write, nothing blocks the caller.
+class RelayLink : public std::enable_shared_from_this<RelayLink> {
+public:
+   using error_code = boost::beast::error_code;
+   using tcp        = boost::asio::ip::tcp;
+   using Frame      = std::shared_ptr<std::string const>;
+
+   // On the link strand
+   using OnFrame        = std::function<void(Frame&& frame)>;
+   using OnDisconnected = std::function<void()>;
+
+   static constexpr auto RETRY_DELAY = std::chrono::seconds{2};
+
+   RelayLink(
+     boost::asio::io_context& ioc,
+     std::string              host,
+     std::string              port,
+     std::string              hello,
+     OnFrame                  on_frame,
+     OnDisconnected           on_disconnected
+   );
+
+   void Start();
+   void Stop();
+
+   // From any thread, dropped while disconnected
+   void Send(std::string&& frame);
+
+   bool Connected() const;
+
+private:
+   void Connect();
+   void OnResolve(error_code ec, tcp::resolver::results_type results);
+   void OnConnect(error_code ec, tcp::endpoint const& endpoint);
+   void OnHandshake(error_code ec);
+   void Read();
+   void OnRead(error_code ec, std::size_t n);
+   void Enqueue(Frame&& frame);
+   void Write();
+   void OnWrite(error_code ec, std::size_t n);
+   void Retry(std::string_view step, error_code ec);
+
+   boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+   tcp::resolver                                               resolver_;
+   boost::asio::steady_timer                                   timer_;
+
+   std::string const    host_;
+   std::string const    port_;
+   Frame const          hello_;
+   OnFrame const        on_frame_;
+   OnDisconnected const on_disconnected_;
+
+   std::atomic<bool> stopped_{false};
+   std::atomic<bool> connected_{false};
+
+   std::optional<boost::beast::websocket::stream<tcp::socket>> ws_{};
+   boost::beast::flat_buffer                                   buffer_{};
+
+   // Front is being written
+   std::deque<Frame> queue_{};
+};
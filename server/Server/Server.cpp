@@ -21,6 +21,7 @@
 #include "main.h"
 #include "Registry/Registry.h"
 #include "Server/WebSockets/Messages/Messages.h"
+#include "SessionExpiry.h"
 #include "WebSockets/Messages/Fuel.h"
 #include "Window/template/Window.h"
 
@@ -44,18 +45,23 @@
 #include <winreg.h>
 #include <winuser.h>
 
+#include <algorithm>
+#include <cctype>
 #include <condition_variable>
 #include <exception>
 #include <filesystem>
+#include <format>
 #include <fstream>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
 #include <string_view>
 #include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <boost/url.hpp>
 
@@ -72,6 +78,10 @@ Server::GetState(Server::Lock) const {
 
 uint16_t
 Server::GetPort() const {
+   if (options_.port_) {
+      return *options_.port_;
+   }
+
    auto& registry = registry::Get();
    return *registry.alx_home_->settings_->server_port_;
 }
@@ -131,9 +141,20 @@ Server::CloseSockets() {
    std::condition_variable cv{};
    bool                    done  = false;
    auto const              clear = [this, &mutex, &cv, &done]() {
-      if (efb_socket_) {
-         efb_socket_->Stop();
-         efb_socket_ = nullptr;
+      auto const close_efb = [](Tenant& tenant) {
+         if (tenant.efb_socket_) {
+            tenant.efb_socket_->Stop();
+            tenant.efb_socket_ = nullptr;
+         }
+      };
+
+      close_efb(*default_tenant_);
+      if (auto const relay = std::exchange(default_tenant_->relay_, nullptr)) {
+         relay->Stop();
+      }
+
+      for (auto const& [_, tenant] : tenants_) {
+         close_efb(*tenant);
       }
 
       for (auto const& socket : web_sockets_) {
@@ -141,6 +162,14 @@ Server::CloseSockets() {
       }
       web_sockets_.clear();
 
+      // Sessions don't survive a server restart
+      for (auto const& [_, session] : sessions_) {
+         if (session->socket_.expired()) {
+            session->tenant_->UnsetMessageHandler(session->id_);
+         }
+      }
+      sessions_.clear();
+
       tcp_->ioc_.stop();
 
       std::lock_guard lock{mutex};
@@ -170,9 +199,17 @@ Server::Start() {
 Server::Tcp::Tcp(tcp::endpoint endpoint)
    : acceptor_(ioc_, std::move(endpoint)) {}
 
-Server::Server(Main& main)
+std::size_t
+Server::IoThreads() {
+   // Sockets are bound to strands, seats only share the threads
+   return std::clamp<std::size_t>(std::thread::hardware_concurrency(), 2, 8);
+}
+
+Server::Server(Main& main, Options options)
    : MessageQueue("Server Message queue")
    , main_{main}
+   , options_{std::move(options)}
+   , default_tenant_{std::make_unique<Tenant>(*this, "")}
    , thread_{[this](std::stop_token stoken) {
       SetThreadDescription(GetCurrentThread(), L"Server");
       ScopeExit flush_on_exit{[this]() { FlushState(); }};
@@ -204,7 +241,10 @@ Server::Server(Main& main)
 
                ScopeExit verify_shutdown{[this] {
                   (void)this;
-                  assert(!efb_socket_);
+                  assert(!default_tenant_->efb_socket_);
+                  assert(std::ranges::none_of(tenants_, [](auto const& tenant) {
+                     return tenant.second->efb_socket_ != nullptr;
+                  }));
                   assert(web_sockets_.empty());
                }};
 
@@ -213,17 +253,47 @@ Server::Server(Main& main)
                   throw std::runtime_error("Failed to open TCP acceptor");
                } else {
                   tcp_->acceptor_.async_accept(
+                    boost::asio::make_strand(tcp_->ioc_),
                     boost::beast::bind_front_handler(&Server::Accept, this)
                   );
 
+                  if (options_.relay_) {
+                     (void)Dispatch([this, &ioc = tcp_->ioc_]() {
+                        auto& tenant  = *default_tenant_;
+                        tenant.relay_ = std::make_shared<Relay>(*this, tenant, ioc, *options_.relay_);
+                        tenant.relay_->Start();
+                     });
+                  }
+
+                  // Abandoned sessions are dropped without waiting for another session event
+                  PeriodicTimer session_expiry{tcp_->ioc_, SESSION_EXPIRY_PERIOD, [this]() {
+                     (void)Dispatch([this]() { ExpireSessions(); });
+                  }};
+                  session_expiry.Start();
+
                   running_ = true;
                   Notify("running", lock);
 
                   lock.unlock();
                   {
-                     main_.SendServerPortToEFB(port);
-                     tcp_->ioc_.run();
-                     main_.SendServerPortToEFB(0);
+                     if (!options_.relay_) {
+                        // Relays aren't meant to be reached by the sim EFB
+                        main_.SendServerPortToEFB(port);
+                     }
+                     {
+                        std::vector<std::jthread> io_threads{};
+                        for (std::size_t i = 1; i < IoThreads(); ++i) {
+                           io_threads.emplace_back([this]() {
+                              SetThreadDescription(GetCurrentThread(), L"Server IO");
+                              tcp_->ioc_.run();
+                           });
+                        }
+
+                        tcp_->ioc_.run();
+                     }
+                     if (!options_.relay_) {
+                        main_.SendServerPortToEFB(0);
+                     }
                   }
                   lock.lock();
                }
@@ -244,33 +314,7 @@ Server::Server(Main& main)
          Notify(GetState(lock), lock);
       }
    }} {
-   (void)Dispatch([this]() {
-      LoadFuelPresets();
-
-      auto&       registry            = registry::Get();
-      auto const& default_fuel_preset = registry.alx_home_->settings_->default_fuel_preset_;
-
-      if (default_fuel_preset) {
-         this->default_fuel_preset_.name_ = *default_fuel_preset;
-         this->default_fuel_preset_.date_ = 0;
-      } else {
-         this->default_fuel_preset_.name_ = "";
-         this->default_fuel_preset_.date_ = 0;
-      }
-
-      LoadDeviationPresets();
-
-      auto const& default_deviation_preset =
-        registry.alx_home_->settings_->default_deviation_preset_;
-
-      if (default_deviation_preset) {
-         this->default_deviation_preset_.name_ = *default_deviation_preset;
-         this->default_deviation_preset_.date_ = 0;
-      } else {
-         this->default_deviation_preset_.name_ = "";
-         this->default_deviation_preset_.date_ = 0;
-      }
-   });
+   (void)Dispatch([this]() { default_tenant_->Load(); });
 }
 
 Server::~Server() {
@@ -375,14 +419,109 @@ Server::Accept(const boost_error& error, tcp::socket socket) {
    }
 
    if (want_run_) {
-      tcp_->acceptor_.async_accept(bind_front_handler(&Server::Accept, this));
+      tcp_->acceptor_.async_accept(
+        net::make_strand(tcp_->ioc_), bind_front_handler(&Server::Accept, this)
+      );
+   }
+}
+
+std::string
+Server::TenantName(std::optional<std::string> const& name) {
+   static constexpr std::size_t MAX_SIZE = 32;
+
+   // Tenant names are part of the data paths
+   std::string result{};
+   if (name) {
+      for (auto const c : *name) {
+         if (result.size() == MAX_SIZE) {
+            break;
+         }
+
+         if (std::isalnum(static_cast<unsigned char>(c)) || (c == '-') || (c == '_')) {
+            result += c;
+         }
+      }
+   }
+
+   return result;
+}
+
+Server::Tenant&
+Server::GetTenant(std::optional<std::string> const& name) {
+   auto const tenant_name = TenantName(name);
+   if (tenant_name.empty()) {
+      return *default_tenant_;
+   }
+
+   auto [tenant, inserted] = tenants_.try_emplace(tenant_name);
+   if (inserted) {
+      std::cout << "New tenant " << tenant_name << std::endl;
+
+      tenant->second = std::make_unique<Tenant>(*this, tenant_name);
+      tenant->second->Load();
+   }
+
+   return *tenant->second;
+}
+
+Server::Tenant::Tenant(Server& server, std::string name)
+   : server_{server}
+   , name_{std::move(name)}
+   , plane_blobs_{std::filesystem::path{DataPath()} / "PlaneBlobs"} {}
+
+std::string
+Server::Tenant::DataPath() const {
+   auto& registry = registry::Get();
+   auto  path     = *registry.alx_home_->settings_->destination_ + "/Data";
+
+   if (server_.options_.relay_) {
+      // Relays may run next to their upstream server
+      path += std::format("/Relays/{}", server_.GetPort());
+   }
+
+   return name_.empty() ? path : path + "/Tenants/" + name_;
+}
+
+bool
+Server::Tenant::UsesRegistry() const {
+   return name_.empty() && !server_.options_.relay_;
+}
+
+void
+Server::Tenant::Load() {
+   LoadFuelPresets();
+   LoadDeviationPresets();
+
+   if (!UsesRegistry()) {
+      return;
+   }
+
+   // Registry defaults are the ones of the in-app windows
+   auto&       registry            = registry::Get();
+   auto const& default_fuel_preset = registry.alx_home_->settings_->default_fuel_preset_;
+
+   if (default_fuel_preset) {
+      this->default_fuel_preset_.name_ = *default_fuel_preset;
+      this->default_fuel_preset_.date_ = 0;
+   } else {
+      this->default_fuel_preset_.name_ = "";
+      this->default_fuel_preset_.date_ = 0;
+   }
+
+   auto const& default_deviation_preset = registry.alx_home_->settings_->default_deviation_preset_;
+
+   if (default_deviation_preset) {
+      this->default_deviation_preset_.name_ = *default_deviation_preset;
+      this->default_deviation_preset_.date_ = 0;
+   } else {
+      this->default_deviation_preset_.name_ = "";
+      this->default_deviation_preset_.date_ = 0;
    }
 }
 
 void
-Server::SaveFuelPresets() const {
-   auto&      registry = registry::Get();
-   auto const path     = *registry.alx_home_->settings_->destination_ + "/Data";
+Server::Tenant::SaveFuelPresets() const {
+   auto const path = DataPath();
    std::filesystem::create_directories(path);
    {
       std::ofstream file{path + "/FuelPresets.json.tmp"};
@@ -402,9 +541,8 @@ Server::SaveFuelPresets() const {
 }
 
 void
-Server::LoadFuelPresets() {
-   auto&      registry = registry::Get();
-   auto const path     = *registry.alx_home_->settings_->destination_ + "/Data/FuelPresets.json";
+Server::Tenant::LoadFuelPresets() {
+   auto const path = DataPath() + "/FuelPresets.json";
    if (std::filesystem::exists(path)) {
       std::string content{};
       {
@@ -438,8 +576,8 @@ Server::LoadFuelPresets() {
 }
 
 void
-Server::HandleFuelPresets(std::size_t id, ws::Message&& message) {
-   (void)Dispatch([this, id, message = std::move(message)]() {
+Server::Tenant::HandleFuelPresets(std::size_t id, ws::Message&& message) {
+   (void)server_.Dispatch([this, id, message = std::move(message)]() {
       auto const& [_, fuel_presets] = std::get<ws::msg::fuel::Presets>(message);
 
       bool                            save = false;
@@ -536,8 +674,8 @@ Server::HandleFuelPresets(std::size_t id, ws::Message&& message) {
 }
 
 void
-Server::HandleFuelCurve(std::size_t, ws::Message&& message) {
-   (void)Dispatch([this, message = std::move(message)]() {
+Server::Tenant::HandleFuelCurve(std::size_t, ws::Message&& message) {
+   (void)server_.Dispatch([this, message = std::move(message)]() {
       auto const& fuel_preset = std::get<ws::msg::fuel::Curves>(message);
 
       bool update = false;
@@ -570,15 +708,16 @@ Server::HandleFuelCurve(std::size_t, ws::Message&& message) {
 }
 
 void
-Server::HandleDefaultFuelPreset(std::size_t, ws::Message&& message) {
-   (void)Dispatch([this, message = std::move(message)]() {
+Server::Tenant::HandleDefaultFuelPreset(std::size_t, ws::Message&& message) {
+   (void)server_.Dispatch([this, message = std::move(message)]() {
       auto const& default_fuel_preset = std::get<ws::msg::fuel::DefaultPreset>(message);
       if (
         this->default_fuel_preset_.name_.empty()
         || (this->default_fuel_preset_.date_ < default_fuel_preset.date_)
       ) {
          this->default_fuel_preset_ = default_fuel_preset;
-         {
+
+         if (UsesRegistry()) {
             auto& registry                                      = registry::Get();
             registry.alx_home_->settings_->default_fuel_preset_ = this->default_fuel_preset_.name_;
          }
@@ -587,14 +726,13 @@ Server::HandleDefaultFuelPreset(std::size_t, ws::Message&& message) {
 }
 
 void
-Server::HandleGetFuelPresets(std::size_t) {
+Server::Tenant::HandleGetFuelPresets(std::size_t) {
    std::cerr << "shall not happen..." << std::endl;
 }
 
 void
-Server::SaveDeviationPresets() const {
-   auto&      registry = registry::Get();
-   auto const path     = *registry.alx_home_->settings_->destination_ + "/Data";
+Server::Tenant::SaveDeviationPresets() const {
+   auto const path = DataPath();
    std::filesystem::create_directories(path);
    {
       std::ofstream file{path + "/DeviationPresets.json.tmp"};
@@ -614,9 +752,8 @@ Server::SaveDeviationPresets() const {
 }
 
 void
-Server::LoadDeviationPresets() {
-   auto&      registry = registry::Get();
-   auto const path = *registry.alx_home_->settings_->destination_ + "/Data/DeviationPresets.json";
+Server::Tenant::LoadDeviationPresets() {
+   auto const path = DataPath() + "/DeviationPresets.json";
    if (std::filesystem::exists(path)) {
       std::string content{};
       {
@@ -645,8 +782,8 @@ Server::LoadDeviationPresets() {
 }
 
 void
-Server::HandleDeviationPresets(std::size_t id, ws::Message&& message) {
-   (void)Dispatch([this, id, message = std::move(message)]() {
+Server::Tenant::HandleDeviationPresets(std::size_t id, ws::Message&& message) {
+   (void)server_.Dispatch([this, id, message = std::move(message)]() {
       auto const& [_, dev_presets] = std::get<ws::msg::dev::Presets>(message);
 
       bool                            save = false;
@@ -743,8 +880,8 @@ Server::HandleDeviationPresets(std::size_t id, ws::Message&& message) {
 }
 
 void
-Server::HandleDeviationCurve(std::size_t, ws::Message&& message) {
-   (void)Dispatch([this, message = std::move(message)]() {
+Server::Tenant::HandleDeviationCurve(std::size_t, ws::Message&& message) {
+   (void)server_.Dispatch([this, message = std::move(message)]() {
       auto const& dev_preset = std::get<ws::msg::dev::Curve>(message);
 
       bool update = false;
@@ -776,15 +913,16 @@ Server::HandleDeviationCurve(std::size_t, ws::Message&& message) {
 }
 
 void
-Server::HandleDefaultDeviationPreset(std::size_t, ws::Message&& message) {
-   (void)Dispatch([this, message = std::move(message)]() {
+Server::Tenant::HandleDefaultDeviationPreset(std::size_t, ws::Message&& message) {
+   (void)server_.Dispatch([this, message = std::move(message)]() {
       auto const& default_dev_preset = std::get<ws::msg::dev::DefaultPreset>(message);
       if (
         this->default_deviation_preset_.name_.empty()
         || (this->default_deviation_preset_.date_ < default_dev_preset.date_)
       ) {
          this->default_deviation_preset_ = default_dev_preset;
-         {
+
+         if (UsesRegistry()) {
             auto& registry = registry::Get();
             registry.alx_home_->settings_->default_deviation_preset_ =
               this->default_deviation_preset_.name_;
@@ -794,12 +932,12 @@ Server::HandleDefaultDeviationPreset(std::size_t, ws::Message&& message) {
 }
 
 void
-Server::HandleGetDeviationPresets(std::size_t) {
+Server::Tenant::HandleGetDeviationPresets(std::size_t) {
    std::cerr << "shall not happen..." << std::endl;
 }
 
 bool
-Server::VDispatchMessage(std::size_t id, ws::Message&& message) {
+Server::Tenant::VDispatchMessage(std::size_t id, ws::Message&& message) {
    auto const efb_socket = efb_socket_;
 
    if (std::holds_alternative<ws::msg::fuel::Presets>(message)) {
@@ -818,17 +956,28 @@ Server::VDispatchMessage(std::size_t id, ws::Message&& message) {
       HandleDefaultDeviationPreset(id, std::move(message));
    } else if (std::holds_alternative<ws::msg::dev::GetPresets>(message)) {
       HandleGetDeviationPresets(id);
+   } else if (auto const get_traffic = std::get_if<ws::msg::GetTraffic>(&message)) {
+      // Answered by the server, with or without EFB
+      (void)server_.Dispatch([this, id, get_traffic = *get_traffic]() {
+         HandleGetTraffic(id, get_traffic);
+      });
+   } else if (auto const get_profile = std::get_if<ws::msg::GetTerrainProfile>(&message)) {
+      (void)server_.Dispatch([this, id, get_profile = std::move(*get_profile)]() {
+         HandleGetTerrainProfile(id, get_profile);
+      });
    } else if (efb_socket) {
       try {
-         Dispatch([efb_socket, id, message = std::move(message)]() mutable {
-            efb_socket->VDispatchMessage(id, std::move(message));
+         server_.Dispatch([this, efb_socket, id, message = std::move(message)]() mutable {
+            if (!HandleSnapshotRequest(id, message)) {
+               efb_socket->VDispatchMessage(id, std::move(message));
+            }
          });
       } catch (QueueStopped const&) {
          std::cerr << "Failed to dispatch message to EFB WebSocket" << std::endl;
          return false;
       }
    } else if (std::holds_alternative<ws::msg::GetFacilities>(message)) {
-      (void)Dispatch([this, id, message = std::move(message)]() {
+      (void)server_.Dispatch([this, id, message = std::move(message)]() {
          if (auto const it = message_handlers_.find(id); it != message_handlers_.end()) {
             // Cache latitude and longitude to send GetFacilities later when the server becomes
             // available
@@ -843,33 +992,48 @@ Server::VDispatchMessage(std::size_t id, ws::Message&& message) {
 }
 
 void
-Server::SetMessageHandler(std::size_t id, MessageHandler&& message_handler) {
-   (void)Dispatch([this, id, message_handler = std::move(message_handler)]() {
+Server::Tenant::SetMessageHandler(std::size_t id, MessageHandler&& message_handler) {
+   (void)server_.Dispatch([this, id, message_handler = std::move(message_handler)]() {
       auto const [handler, _] = message_handlers_.emplace(id, std::move(message_handler));
       assert(_);
 
-      auto const efb_socket = efb_socket_;
-      if (efb_socket) {
-         efb_socket->VSendMessage(id, ws::msg::GetRecords{});
-         efb_socket->VSendMessage(
-           id, ws::msg::GetFacilities{.lat_ = handler->second.lat_, .lon_ = handler->second.lon_}
-         );
+      if (efb_socket_) {
+         // Served from the snapshots when another viewer already asked for them
+         RequestRecords(id);
+         RequestFacilities(id, handler->second.lat_, handler->second.lon_);
       }
    });
 }
 
 void
-Server::UnsetMessageHandler(std::size_t id) {
+Server::Tenant::UnsetMessageHandler(std::size_t id) {
    try {
-      Dispatch([this, id]() {
+      server_.Dispatch([this, id]() {
          auto const _ = message_handlers_.erase(id);
          assert(_ == 1);
+
+         DropTrafficViewer(id);
       });
    } catch (QueueStopped const&) {
       assert(message_handlers_.empty());
    }
 }
 
+bool
+Server::VDispatchMessage(std::size_t id, ws::Message&& message) {
+   return default_tenant_->VDispatchMessage(id, std::move(message));
+}
+
+void
+Server::SetMessageHandler(std::size_t id, MessageHandler&& message_handler) {
+   default_tenant_->SetMessageHandler(id, std::move(message_handler));
+}
+
+void
+Server::UnsetMessageHandler(std::size_t id) {
+   default_tenant_->UnsetMessageHandler(id);
+}
+
 void
 Server::WatchServerState(Resolve<ServerState> const& resolve, Reject const& reject) {
    std::unique_lock lock{mutex_};
@@ -15,20 +15,34 @@
 
 #pragma once
 
+#include "PlaneBlobCache.h"
+#include "RelayLink.h"
 #include "Registry/Registry.h"
 #include "Server/WebSockets/Messages/Messages.h"
+#include "SimConnect/Stream.h"
+#include "SimConnect/Traffic.h"
 #include "WebSockets/Messages/Fuel.h"
 #include "Window/template/Window.h"
+#include "WriteQueue.h"
 
 #include <utils/MessageQueue.h>
 #include <utils/Pool.h>
 #include <promise/promise.h>
 #include <minwindef.h>
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -70,7 +84,15 @@ public:
 
 class Main;
 struct Server : public MessageQueue<true> {
-   Server(Main& main);
+   // Command line overrides
+   struct Options {
+      // <host>[:<port>] of the server to relay (--relay)
+      std::optional<std::string> relay_{};
+      // Listening port, instead of the registry one (--port)
+      std::optional<uint16_t> port_{};
+   };
+
+   Server(Main& main, Options options);
    ~Server() override;
 
    using Lock = std::variant<
@@ -83,6 +105,9 @@ struct Server : public MessageQueue<true> {
 
       double lat_{-1000};
       double lon_{-1000};
+
+      // Set by the viewer sockets, relayed frames are written as is
+      std::function<void(std::shared_ptr<std::string const> const& frame)> frame_{};
    };
 
    uint16_t    GetPort() const;
@@ -99,43 +124,43 @@ struct Server : public MessageQueue<true> {
    void Stop();
    void Start();
 
-   void SaveFuelPresets() const;
-   void LoadFuelPresets();
-
-   void SaveDeviationPresets() const;
-   void LoadDeviationPresets();
-
-   void HandleFuelPresets(std::size_t id, ws::Message&& message);
-   void HandleFuelCurve(std::size_t id, ws::Message&& message);
-   void HandleDefaultFuelPreset(std::size_t id, ws::Message&& message);
-   void HandleGetFuelPresets(std::size_t id);
-
-   void HandleDeviationPresets(std::size_t id, ws::Message&& message);
-   void HandleDeviationCurve(std::size_t id, ws::Message&& message);
-   void HandleDefaultDeviationPreset(std::size_t id, ws::Message&& message);
-   void HandleGetDeviationPresets(std::size_t id);
-
    using tcp         = boost::asio::ip::tcp;
    using io_context  = boost::asio::io_context;
    using boost_error = boost::system::error_code;
 
    void Accept(const boost_error& error, tcp::socket socket);
 
+   // Default tenant (in-app windows)
    bool VDispatchMessage(std::size_t id, ws::Message&& message);
    void SetMessageHandler(std::size_t id, MessageHandler&&);
    void UnsetMessageHandler(std::size_t id);
 
    void WatchServerState(Resolve<ServerState> const& resolve, Reject const& reject);
 
+   // One tenant per EFB (sim seat), chosen by the EFB and its viewers at handshake
+   struct Tenant;
+
+   Tenant&            GetTenant(std::optional<std::string> const& name);
+   static std::string TenantName(std::optional<std::string> const& name);
+
+   // Resumable viewer sessions, see Sessions.cpp
+   struct Session;
+
+   std::shared_ptr<Session> OpenSession(Tenant& tenant);
+   std::shared_ptr<Session>
+        ResumeSession(Tenant& tenant, std::string const& token, std::size_t last_seq);
+   void DetachSession(std::shared_ptr<Session> const& session);
+   void ExpireSessions();
+
    Main&                       main_;
+   Options const               options_;
    bool                        running_ = false;
    mutable std::shared_mutex   mutex_{};
    std::condition_variable_any cv_{};
    Resolvers<ServerState>      resolvers_{};
-   bool                        efb_connected_{false};
-   bool                        want_run_{[]() {
+   bool                        want_run_{[this]() {
       auto& registry = registry::Get();
-      return *registry.alx_home_->settings_->auto_start_server_;
+      return options_.relay_ || *registry.alx_home_->settings_->auto_start_server_;
    }()};
 
    struct Tcp {
@@ -146,23 +171,160 @@ struct Server : public MessageQueue<true> {
    };
    std::unique_ptr<Tcp> tcp_{};
 
+   // io_context threads shared by all the tenants
+   static std::size_t IoThreads();
+
    class WebSocket;
    class EFBWebSocket;
    class WebWebSocket;
+   class Relay;
+
+   std::vector<std::shared_ptr<EFBWebSocket>> web_sockets_{};
+
+   std::unique_ptr<Tenant>                                  default_tenant_;
+   std::unordered_map<std::string, std::unique_ptr<Tenant>> tenants_{};
+
+   static constexpr auto        SESSION_TTL           = std::chrono::seconds{60};
+   // Expiry runs on every session event and at least this often
+   static constexpr auto        SESSION_EXPIRY_PERIOD = std::chrono::seconds{5};
+   static constexpr std::size_t SESSION_RING_MESSAGES = 512;
+   static constexpr std::size_t SESSION_RING_BYTES    = 8 * 1024 * 1024;
+
+   std::unordered_map<std::string, std::shared_ptr<Session>> sessions_{};
+   std::size_t                                               next_session_id_{3};
+
+   static std::vector<ws::msg::fuel::Curve> h125_curve_s;
+
+   // Must stays at the end
+   std::jthread thread_{};
+};
+
+// Handlers, EFB connection, snapshots and presets of a sim seat
+// Only accessed from the server message queue
+struct Server::Tenant {
+   Tenant(Server& server, std::string name);
+
+   // <destination>/Data for the default tenant, <destination>/Data/Tenants/<name> otherwise
+   // (under <destination>/Data/Relays/<port> for a relay)
+   std::string DataPath() const;
+   void        Load();
+
+   // In-app windows seat, its default presets are saved in the registry
+   bool UsesRegistry() const;
+
+   void SaveFuelPresets() const;
+   void LoadFuelPresets();
+
+   void SaveDeviationPresets() const;
+   void LoadDeviationPresets();
+
+   void HandleFuelPresets(std::size_t id, ws::Message&& message);
+   void HandleFuelCurve(std::size_t id, ws::Message&& message);
+   void HandleDefaultFuelPreset(std::size_t id, ws::Message&& message);
+   void HandleGetFuelPresets(std::size_t id);
+
+   void HandleDeviationPresets(std::size_t id, ws::Message&& message);
+   void HandleDeviationCurve(std::size_t id, ws::Message&& message);
+   void HandleDefaultDeviationPreset(std::size_t id, ws::Message&& message);
+   void HandleGetDeviationPresets(std::size_t id);
+
+   bool VDispatchMessage(std::size_t id, ws::Message&& message);
+   void SetMessageHandler(std::size_t id, MessageHandler&&);
+   void UnsetMessageHandler(std::size_t id);
+
+   // EFB snapshots (Records/Facilities/PlaneBlob) shared between viewers, see Snapshots.cpp
+   bool HandleSnapshotRequest(std::size_t id, ws::Message const& message);
+   void OnEFBSnapshot(std::size_t id, ws::Message const& message);
+   void RequestRecords(std::size_t id);
+   void RequestFacilities(std::size_t id, double lat, double lon);
+   void InvalidateSnapshots();
 
+   // Relay mode, see Relay.cpp
+   void OnUpstream(ws::Proxy&& proxy, std::shared_ptr<std::string const> const& frame);
+   void OnUpstreamState(bool efb_connected);
+   void Broadcast(ws::Proxy const& proxy, std::shared_ptr<std::string const> const& frame);
+
+   // Traffic of the simulator, streamed to the viewers asking for it, see Traffic.cpp
+   void HandleGetTraffic(std::size_t id, ws::msg::GetTraffic const& message);
+   void OnTraffic(smc::TrafficDiff const& diff);
+   void DropTrafficViewer(std::size_t id);
+
+   // Ground elevations along a route, see TerrainProfile.cpp
+   void HandleGetTerrainProfile(std::size_t id, ws::msg::GetTerrainProfile const& message);
+   void SendTerrainProfile(std::size_t id, ws::msg::TerrainProfile const& message);
+
+   Server&           server_;
+   std::string const name_;
+
+   bool                                            efb_connected_{false};
    std::unordered_map<std::size_t, MessageHandler> message_handlers_{};
    std::shared_ptr<EFBWebSocket>                   efb_socket_{nullptr};
-   std::vector<std::shared_ptr<EFBWebSocket>>      web_sockets_{};
+   // Upstream server standing for the EFB (relay mode)
+   std::shared_ptr<Relay> relay_{nullptr};
+
+   struct FacilitiesSnapshot {
+      double lat_{};
+      double lon_{};
+
+      std::optional<ws::msg::Facilities> value_{};
+      std::vector<std::size_t>           waiters_{};
+   };
+
+   static constexpr std::size_t MAX_FACILITIES_SNAPSHOTS = 16;
+
+   // The EFB searches the facilities 100 NM around the position, requests are snapped to this grid
+   // so that viewers around the same place share a snapshot
+   static constexpr double FACILITIES_GRID = 0.1;  // Degrees
+
+   std::optional<ws::msg::Records> records_snapshot_{};
+   bool                            records_in_flight_{false};
+   std::vector<std::size_t>        records_waiters_{};
+
+   std::deque<FacilitiesSnapshot> facilities_snapshots_{};
+   // Positions of the GetFacilities sent to the EFB, per requester (answered in order), the
+   // ones sent upstream are under 0
+   std::unordered_map<std::size_t, std::deque<std::pair<double, double>>> facilities_requests_{};
+
+   PlaneBlobCache plane_blobs_;
+   // Viewers waiting for a PlaneBlob already requested to the EFB
+   std::unordered_map<std::size_t, std::vector<std::size_t>> plane_blob_waiters_{};
+
+   std::optional<smc::Stream<smc::TrafficDiff>> traffic_stream_{};
+   std::unordered_set<std::size_t>              traffic_viewers_{};
+   // Aircraft sent so far, by object id, the viewers joining later start from them
+   std::unordered_map<std::size_t, ws::msg::TrafficAircraft> traffic_{};
+
+   static constexpr std::size_t MAX_TERRAIN_PROFILES = 8;
+
+   // Resolved profiles by route and spacing hash, most recent first
+   std::deque<std::pair<std::size_t, ws::msg::TerrainProfile>> terrain_profiles_{};
 
    std::unordered_map<std::string, ws::msg::fuel::Curves> fuel_presets_{};
    ws::msg::fuel::DefaultPreset                           default_fuel_preset_{};
    std::unordered_map<std::string, ws::msg::dev::Curve>   deviation_presets_{};
    ws::msg::dev::DefaultPreset                            default_deviation_preset_{};
+};
 
-   static std::vector<ws::msg::fuel::Curve> h125_curve_s;
+struct Server::Session {
+   std::size_t id_{};
+   std::string token_{};
+   Tenant*     tenant_{};
 
-   // Must stays at the end
-   std::jthread thread_{};
+   // Serializes the message with the next sequence number and keeps it for replay
+   std::string Record(std::size_t id, ws::Message&& message);
+   // Same for an already serialized (unsequenced) proxy frame
+   std::string Record(std::string_view frame);
+   std::string Keep(std::size_t seq, std::string&& message);
+
+   // Relays aren't resumable, their messages aren't sequenced
+   bool sequenced_{true};
+
+   std::size_t                                     next_seq_{1};
+   std::deque<std::pair<std::size_t, std::string>> ring_{};
+   std::size_t                                     ring_bytes_{};
+
+   std::weak_ptr<EFBWebSocket>           socket_{};
+   std::chrono::steady_clock::time_point expiry_{};
 };
 
 class Server::WebSocket : public std::enable_shared_from_this<WebSocket> {
@@ -196,27 +358,40 @@ private:
 
 class Server::EFBWebSocket : public std::enable_shared_from_this<EFBWebSocket> {
 public:
-   EFBWebSocket(Server::WebSocket&& socket, bool web_browser);
+   EFBWebSocket(
+     Server::WebSocket&&      socket,
+     Tenant&                  tenant,
+     bool                     web_browser,
+     std::shared_ptr<Session> session = nullptr
+   );
    ~EFBWebSocket();
 
-   void Start() noexcept(false);
+   // last_seq: last message received by a resumed session
+   void Start(std::optional<std::size_t> last_seq = std::nullopt) noexcept(false);
    void Stop() noexcept(false);
 
    void VDispatchMessage(std::size_t id, ws::Message&& message);
    void VSendMessage(std::size_t id, ws::Message&& message);
+   void VDispatchFrame(std::shared_ptr<std::string const> frame);
 
 private:
    void Read();
    void OnRead(boost::beast::error_code ec, size_t n);
-   void OnWrite(boost::beast::error_code ec, size_t n);
 
-   Server&     server_;
-   bool        web_browser_{};
-   std::size_t my_id_{1};
+   void SendControl(ws::Message&& message);
+   // Queued on the socket strand, a slow peer doesn't hold the server queue (nor other tenants)
+   void Write(std::string message);
+
+   Server&                  server_;
+   Tenant&                  tenant_;
+   bool                     web_browser_{};
+   std::shared_ptr<Session> session_{};
+   std::size_t              my_id_{1};
 
    boost::beast::flat_buffer                    buffer_;
    tcp::endpoint                                peer_;
    boost::beast::websocket::stream<tcp::socket> ws_;
+   WriteQueue                                   writes_{server_.tcp_->ioc_, ws_};
 
    Pool<true, 10> poll_{"ServPoll"};
 
@@ -226,3 +401,19 @@ private:
 
    std::jthread thread_;
 };
+
+// Viewer connection to an upstream server, standing for the EFB of a relay tenant
+// Upstream frames are parsed once and re-served as is to the relay viewers
+class Server::Relay {
+public:
+   Relay(Server& server, Tenant& tenant, io_context& ioc, std::string const& upstream);
+
+   void Start();
+   void Stop();
+
+   // Request to the upstream EFB, from the server message queue
+   void Send(ws::Message&& message);
+
+private:
+   std::shared_ptr<RelayLink> link_{};
+};
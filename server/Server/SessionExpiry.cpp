@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SessionExpiry.h"
+
+#include <utility>
+
+PeriodicTimer::PeriodicTimer(
+  boost::asio::io_context&            ioc,
+  std::chrono::steady_clock::duration period,
+  OnTick                              on_tick
+)
+   : timer_{ioc}
+   , period_{period}
+   , on_tick_{std::move(on_tick)} {}
+
+void
+PeriodicTimer::Start() {
+   Schedule();
+}
+
+void
+PeriodicTimer::Schedule() {
+   timer_.expires_after(period_);
+   timer_.async_wait([this](boost::system::error_code const& ec) {
+      if (ec) {
+         return;
+      }
+
+      on_tick_();
+      Schedule();
+   });
+}
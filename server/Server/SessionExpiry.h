@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+#ifdef __clang__
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Weverything"
+#elif defined(_MSC_VER)
+#   pragma warning(push, 0)
+#endif
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#ifdef __clang__
+#   pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#   pragma warning(pop)
+#endif
+
+// Drops the detached sessions (socket_ expired) past their expiry_, on_expired is called before
+// each one is erased
+template <class SESSIONS, class ON_EXPIRED>
+void
+DropExpiredSessions(
+  SESSIONS&                             sessions,
+  std::chrono::steady_clock::time_point now,
+  ON_EXPIRED&&                          on_expired
+) {
+   for (auto it = sessions.begin(); it != sessions.end();) {
+      auto const& session = it->second;
+
+      if (session->socket_.expired() && (session->expiry_ < now)) {
+         on_expired(*session);
+         it = sessions.erase(it);
+      } else {
+         ++it;
+      }
+   }
+}
+
+// Calls on_tick every period from the io_context threads, until the io_context is stopped. Must
+// be destroyed after it
+class PeriodicTimer {
+public:
+   using OnTick = std::function<void()>;
+
+   PeriodicTimer(
+     boost::asio::io_context&            ioc,
+     std::chrono::steady_clock::duration period,
+     OnTick                              on_tick
+   );
+
+   void Start();
+
+private:
+   void Schedule();
+
+   boost::asio::steady_timer                 timer_;
+   std::chrono::steady_clock::duration const period_;
+   OnTick const                              on_tick_;
+};
@@ -0,0 +1,153 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Server.h"
+#include "SessionExpiry.h"
+
+#include "Server/WebSockets/Messages/Messages.h"
+
+#include <json/json.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <utility>
+
+// All the session functions run on the server message queue
+
+std::string
+Server::Session::Record(std::size_t id, ws::Message&& message) {
+   if (!sequenced_) {
+      return js::Stringify(ws::Proxy{.id_ = id, .content_ = std::move(message)});
+   }
+
+   auto const seq = next_seq_++;
+   return Keep(
+     seq, js::Stringify(ws::Proxy{.id_ = id, .content_ = std::move(message), .seq_ = seq})
+   );
+}
+
+std::string
+Server::Session::Record(std::string_view frame) {
+   assert(sequenced_ && frame.ends_with('}'));
+
+   // The sequence number is appended to the proxy object, its content isn't encoded again
+   auto const seq = next_seq_++;
+   return Keep(seq, std::format("{},\"seq\":{}}}", frame.substr(0, frame.size() - 1), seq));
+}
+
+std::string
+Server::Session::Keep(std::size_t seq, std::string&& message_str) {
+   ring_bytes_ += message_str.size();
+   ring_.emplace_back(seq, message_str);
+
+   while ((ring_.size() > SESSION_RING_MESSAGES) || (ring_bytes_ > SESSION_RING_BYTES)) {
+      ring_bytes_ -= ring_.front().second.size();
+      ring_.pop_front();
+   }
+
+   return message_str;
+}
+
+std::shared_ptr<Server::Session>
+Server::OpenSession(Tenant& tenant) {
+   ExpireSessions();
+
+   // Whoever holds a token takes the session over : 128 bits straight from the OS generator
+   // (random_device is backed by it, unlike a seeded engine whose stream can be predicted)
+   std::random_device random{};
+   std::string        token{};
+   for (int i = 0; i < 4; ++i) {
+      token += std::format("{:08x}", static_cast<uint32_t>(random()));
+   }
+
+   // Expiry covers the time until the socket is attached
+   auto session     = std::make_shared<Session>();
+   session->id_     = next_session_id_++;
+   session->token_  = std::move(token);
+   session->tenant_ = &tenant;
+   session->expiry_ = std::chrono::steady_clock::now() + SESSION_TTL;
+
+   sessions_.emplace(session->token_, session);
+   return session;
+}
+
+std::shared_ptr<Server::Session>
+Server::ResumeSession(Tenant& tenant, std::string const& token, std::size_t last_seq) {
+   ExpireSessions();
+
+   auto const it = sessions_.find(token);
+   if (it == sessions_.end()) {
+      return nullptr;
+   }
+
+   auto const session = it->second;
+   if (session->tenant_ != &tenant) {
+      // A token is only valid for the seat it was issued for
+      return nullptr;
+   }
+
+   if (!session->socket_.expired()) {
+      // Still attached to another socket
+      return nullptr;
+   }
+
+   // Every message after last_seq must still be in the ring
+   auto const first_seq =
+     session->ring_.empty() ? session->next_seq_ : session->ring_.front().first;
+   if ((last_seq >= session->next_seq_) || (last_seq + 1 < first_seq)) {
+      std::cout << "Session " << session->id_ << " can't be resumed, missed messages were dropped"
+                << std::endl;
+
+      sessions_.erase(it);
+      tenant.UnsetMessageHandler(session->id_);
+      return nullptr;
+   }
+
+   return session;
+}
+
+void
+Server::DetachSession(std::shared_ptr<Session> const& session) {
+   if (
+     auto const it = sessions_.find(session->token_);
+     (it != sessions_.end()) && (it->second == session)
+   ) {
+      if (session->sequenced_) {
+         // Keep recording the messages for a reconnection
+         session->expiry_ = std::chrono::steady_clock::now() + SESSION_TTL;
+      } else {
+         // Relays request fresh snapshots when reconnecting
+         sessions_.erase(it);
+         session->tenant_->UnsetMessageHandler(session->id_);
+      }
+   } else {
+      session->tenant_->UnsetMessageHandler(session->id_);
+   }
+
+   ExpireSessions();
+}
+
+void
+Server::ExpireSessions() {
+   DropExpiredSessions(sessions_, std::chrono::steady_clock::now(), [](Session& session) {
+      session.tenant_->UnsetMessageHandler(session.id_);
+   });
+}
@@ -0,0 +1,274 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Server.h"
+
+#include "Server/WebSockets/Messages/Facilities.h"
+#include "Server/WebSockets/Messages/Messages.h"
+#include "Server/WebSockets/Messages/Records.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+
+// All the snapshot functions run on the server message queue
+
+bool
+Server::Tenant::HandleSnapshotRequest(std::size_t id, ws::Message const& message) {
+   if (std::holds_alternative<ws::msg::GetRecords>(message)) {
+      RequestRecords(id);
+      return true;
+   }
+
+   if (auto const facilities = std::get_if<ws::msg::GetFacilities>(&message)) {
+      RequestFacilities(id, facilities->lat_, facilities->lon_);
+      return true;
+   }
+
+   if (auto const get_blob = std::get_if<ws::msg::GetPlaneBlob>(&message)) {
+      if (auto blob = plane_blobs_.Get(get_blob->id_)) {
+         if (auto const handler = message_handlers_.find(id); handler != message_handlers_.end()) {
+            handler->second(0, std::move(*blob));
+         }
+         return true;
+      }
+
+      if (
+        auto const waiters = plane_blob_waiters_.find(get_blob->id_);
+        waiters != plane_blob_waiters_.end()
+      ) {
+         waiters->second.emplace_back(id);
+         return true;
+      }
+
+      if (relay_) {
+         // Answered to the relay, the requester waits like the others
+         plane_blob_waiters_.emplace(get_blob->id_, std::vector<std::size_t>{id});
+         relay_->Send(ws::msg::GetPlaneBlob{*get_blob});
+         return true;
+      }
+
+      // Forwarded to the EFB
+      plane_blob_waiters_.emplace(get_blob->id_, std::vector<std::size_t>{});
+      return false;
+   }
+
+   if (relay_) {
+      // Read-only, editions don't reach the upstream EFB
+      return false;
+   }
+
+   if (auto const remove = std::get_if<ws::msg::RemoveRecord>(&message)) {
+      if (records_snapshot_) {
+         for (auto const& record : records_snapshot_->records_) {
+            if (record.id_ == remove->id_) {
+               for (auto const blob : record.blobs_) {
+                  plane_blobs_.Remove(blob);
+               }
+            }
+         }
+      }
+   }
+
+   if (
+     std::holds_alternative<ws::msg::EditRecord>(message)
+     || std::holds_alternative<ws::msg::RemoveRecord>(message)
+   ) {
+      // The EFB broadcasts the new records once the edition is done
+      records_snapshot_.reset();
+   }
+
+   return false;
+}
+
+void
+Server::Tenant::OnEFBSnapshot(std::size_t id, ws::Message const& message) {
+   if (auto const records = std::get_if<ws::msg::Records>(&message)) {
+      records_snapshot_  = *records;
+      records_in_flight_ = false;
+
+      // Blobs of removed/cleaned records
+      std::unordered_set<std::size_t> blobs{};
+      for (auto const& record : records->records_) {
+         blobs.insert(record.blobs_.begin(), record.blobs_.end());
+      }
+      plane_blobs_.Retain(blobs);
+
+      auto const waiters = std::exchange(records_waiters_, {});
+      if (id != 1) {
+         // Broadcasts already reach every viewer
+         for (auto const waiter : waiters) {
+            if (waiter != id) {
+               if (
+                 auto const handler = message_handlers_.find(waiter);
+                 handler != message_handlers_.end()
+               ) {
+                  handler->second(0, *records);
+               }
+            }
+         }
+      }
+   } else if (auto const blob = std::get_if<ws::msg::PlaneBlob>(&message)) {
+      plane_blobs_.Put(*blob);
+
+      if (
+        auto const waiters = plane_blob_waiters_.find(blob->id_);
+        waiters != plane_blob_waiters_.end()
+      ) {
+         for (auto const waiter : waiters->second) {
+            if (waiter != id) {
+               if (
+                 auto const handler = message_handlers_.find(waiter);
+                 handler != message_handlers_.end()
+               ) {
+                  handler->second(0, *blob);
+               }
+            }
+         }
+
+         plane_blob_waiters_.erase(waiters);
+      }
+   } else if (auto const facilities = std::get_if<ws::msg::Facilities>(&message)) {
+      auto const request = facilities_requests_.find(id);
+      if (request == facilities_requests_.end()) {
+         return;
+      }
+
+      auto const [lat, lon] = request->second.front();
+      request->second.pop_front();
+      if (request->second.empty()) {
+         facilities_requests_.erase(request);
+      } else if (relay_ && (id == 0)) {
+         auto const [next_lat, next_lon] = request->second.front();
+         relay_->Send(ws::msg::GetFacilities{.lat_ = next_lat, .lon_ = next_lon});
+      }
+
+      auto const snapshot =
+        std::ranges::find_if(facilities_snapshots_, [lat, lon](FacilitiesSnapshot const& snapshot) {
+           return snapshot.lat_ == lat && snapshot.lon_ == lon;
+        });
+      if (snapshot == facilities_snapshots_.end()) {
+         // Invalidated in the meantime
+         return;
+      }
+
+      snapshot->value_ = *facilities;
+      for (auto const waiter : std::exchange(snapshot->waiters_, {})) {
+         if (waiter != id) {
+            if (
+              auto const handler = message_handlers_.find(waiter);
+              handler != message_handlers_.end()
+            ) {
+               handler->second(0, *facilities);
+            }
+         }
+      }
+   }
+}
+
+void
+Server::Tenant::RequestRecords(std::size_t id) {
+   if (records_snapshot_) {
+      if (auto const handler = message_handlers_.find(id); handler != message_handlers_.end()) {
+         handler->second(0, *records_snapshot_);
+      }
+   } else if (records_in_flight_) {
+      records_waiters_.emplace_back(id);
+   } else if (efb_socket_) {
+      records_in_flight_ = true;
+      efb_socket_->VSendMessage(id, ws::msg::GetRecords{});
+   } else if (relay_ && efb_connected_) {
+      records_in_flight_ = true;
+      records_waiters_.emplace_back(id);
+      relay_->Send(ws::msg::GetRecords{});
+   }
+}
+
+void
+Server::Tenant::RequestFacilities(std::size_t id, double lat, double lon) {
+   if (auto const handler = message_handlers_.find(id); handler != message_handlers_.end()) {
+      // Cache latitude and longitude to send GetFacilities later when the EFB reconnects
+      handler->second.lat_ = lat;
+      handler->second.lon_ = lon;
+   }
+
+   // Snapped positions are compared exactly, here and when the answer comes back
+   lat = std::round(lat / FACILITIES_GRID) * FACILITIES_GRID;
+   lon = std::round(lon / FACILITIES_GRID) * FACILITIES_GRID;
+
+   if (!efb_socket_ && !(relay_ && efb_connected_)) {
+      return;
+   }
+
+   auto const snapshot =
+     std::ranges::find_if(facilities_snapshots_, [lat, lon](FacilitiesSnapshot const& snapshot) {
+        return snapshot.lat_ == lat && snapshot.lon_ == lon;
+     });
+
+   if (snapshot != facilities_snapshots_.end()) {
+      if (snapshot->value_) {
+         if (auto const handler = message_handlers_.find(id); handler != message_handlers_.end()) {
+            handler->second(0, *snapshot->value_);
+         }
+      } else {
+         snapshot->waiters_.emplace_back(id);
+      }
+      return;
+   }
+
+   if (facilities_snapshots_.size() >= MAX_FACILITIES_SNAPSHOTS) {
+      // Evict the oldest answered position, in flight ones still have waiters
+      auto const oldest =
+        std::ranges::find_if(facilities_snapshots_, [](FacilitiesSnapshot const& snapshot) {
+           return snapshot.value_.has_value();
+        });
+      if (oldest != facilities_snapshots_.end()) {
+         facilities_snapshots_.erase(oldest);
+      }
+   }
+
+   facilities_snapshots_.emplace_back(FacilitiesSnapshot{.lat_ = lat, .lon_ = lon});
+
+   if (relay_) {
+      // Answered to the relay, the requester waits like the others. Answers don't carry their
+      // position, so a single request is sent upstream at a time.
+      facilities_snapshots_.back().waiters_.emplace_back(id);
+
+      auto& requests = facilities_requests_[0];
+      requests.emplace_back(lat, lon);
+      if (requests.size() == 1) {
+         relay_->Send(ws::msg::GetFacilities{.lat_ = lat, .lon_ = lon});
+      }
+      return;
+   }
+
+   facilities_requests_[id].emplace_back(lat, lon);
+   efb_socket_->VSendMessage(id, ws::msg::GetFacilities{.lat_ = lat, .lon_ = lon});
+}
+
+void
+Server::Tenant::InvalidateSnapshots() {
+   records_snapshot_.reset();
+   records_in_flight_ = false;
+   records_waiters_.clear();
+
+   facilities_snapshots_.clear();
+   facilities_requests_.clear();
+
+   // The blobs themselves stay valid across EFB sessions
+   plane_blob_waiters_.clear();
+}
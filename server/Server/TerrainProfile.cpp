@@ -0,0 +1,258 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "Server.h"
+
+#include "main.h"
+#include "Server/WebSockets/Messages/Messages.h"
+#include "Server/WebSockets/Messages/TerrainProfile.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numbers>
+#include <string>
+#include <utility>
+#include <vector>
+
+// All the terrain profile functions run on the server message queue
+
+namespace {
+
+constexpr double MERCATOR_RADIUS = 6'378'137.;  // meters
+constexpr double EARTH_RADIUS    = 3'440.065;   // nautical miles
+constexpr double DEG             = std::numbers::pi / 180.;
+
+// Longer routes are sampled with a larger spacing
+constexpr std::size_t MAX_SAMPLES = 4096;
+// Samples resolved and sent together
+constexpr std::size_t CHUNK_SAMPLES = 64;
+
+// Map coordinates are web mercator meters
+std::pair<double, double>
+ToLatLon(std::array<double, 2> const& coord) {
+   auto const lat = 2. * std::atan(std::exp(coord[1] / MERCATOR_RADIUS)) - std::numbers::pi / 2.;
+   return {lat / DEG, coord[0] / MERCATOR_RADIUS / DEG};
+}
+
+// Great circle, nautical miles
+double
+Distance(std::pair<double, double> const& from, std::pair<double, double> const& to) {
+   auto const dlat = (to.first - from.first) * DEG;
+   auto const dlon = (to.second - from.second) * DEG;
+
+   auto const a = std::pow(std::sin(dlat / 2.), 2)
+                  + std::cos(from.first * DEG) * std::cos(to.first * DEG)
+                      * std::pow(std::sin(dlon / 2.), 2);
+   return 2. * EARTH_RADIUS * std::asin(std::min(1., std::sqrt(a)));
+}
+
+struct Samples {
+   std::vector<std::pair<double, double>> positions_{};  // lat, lon
+   std::vector<double>                    distances_{};
+};
+
+// Every spacing along each leg (straight on the map), the coords included
+Samples
+Sample(std::vector<std::array<double, 2>> const& coords, double spacing) {
+   Samples samples{};
+   if (coords.empty()) {
+      return samples;
+   }
+
+   std::vector<double> legs{};
+   double              length{};
+   for (std::size_t index = 1; index < coords.size(); ++index) {
+      legs.emplace_back(Distance(ToLatLon(coords[index - 1]), ToLatLon(coords[index])));
+      length += legs.back();
+   }
+
+   if (coords.size() < MAX_SAMPLES) {
+      spacing = std::max(spacing, length / static_cast<double>(MAX_SAMPLES - coords.size()));
+   }
+   if (!(spacing > 0.)) {
+      // Empty route
+      spacing = 1.;
+   }
+
+   double start{};
+   for (std::size_t leg = 0; leg < legs.size(); ++leg) {
+      auto const& from  = coords[leg];
+      auto const& to    = coords[leg + 1];
+      auto const  steps = std::max(1., std::ceil(legs[leg] / spacing));
+
+      for (double step = 0.; step < steps; ++step) {
+         auto const ratio = step / steps;
+         samples.positions_.emplace_back(ToLatLon({
+           std::lerp(from[0], to[0], ratio),
+           std::lerp(from[1], to[1], ratio),
+         }));
+         samples.distances_.emplace_back(start + legs[leg] * ratio);
+      }
+      start += legs[leg];
+   }
+
+   samples.positions_.emplace_back(ToLatLon(coords.back()));
+   samples.distances_.emplace_back(start);
+   return samples;
+}
+
+std::size_t
+RouteKey(std::vector<std::array<double, 2>> const& coords, double spacing) {
+   std::string bytes(
+     reinterpret_cast<char const*>(coords.data()), coords.size() * sizeof(coords.front())
+   );
+   bytes.append(reinterpret_cast<char const*>(&spacing), sizeof(spacing));
+   return std::hash<std::string>{}(bytes);
+}
+
+// Profile being resolved, cached once every chunk succeeded
+struct PendingProfile {
+   ws::msg::TerrainProfile profile_{};
+   std::size_t             remaining_{};
+   bool                    failed_{false};
+};
+
+}  // namespace
+
+void
+Server::Tenant::HandleGetTerrainProfile(
+  std::size_t                       id,
+  ws::msg::GetTerrainProfile const& message
+) {
+   auto const key = RouteKey(message.coords_, message.spacing_);
+
+   if (
+     auto const it = std::ranges::find_if(
+       terrain_profiles_, [key](auto const& entry) { return entry.first == key; }
+     );
+     it != terrain_profiles_.end()
+   ) {
+      // Re-opened plan
+      auto entry = std::move(*it);
+      terrain_profiles_.erase(it);
+      terrain_profiles_.emplace_front(std::move(entry));
+
+      auto profile = terrain_profiles_.front().second;
+      profile.id_  = message.id_;
+      SendTerrainProfile(id, profile);
+      return;
+   }
+
+   auto const samples = Sample(message.coords_, message.spacing_);
+   auto const count   = samples.positions_.size();
+   if (!count) {
+      SendTerrainProfile(id, {.id_ = message.id_, .done_ = true});
+      return;
+   }
+
+   auto const pending = std::make_shared<PendingProfile>(PendingProfile{
+     .profile_ =
+       {
+         .id_         = message.id_,
+         .count_      = count,
+         .distances_  = samples.distances_,
+         .elevations_ = std::vector<double>(count),
+         .done_       = true,
+       },
+     .remaining_ = (count + CHUNK_SAMPLES - 1) / CHUNK_SAMPLES,
+   });
+
+   // Elevations is empty when the chunk failed
+   auto const on_chunk = [this, id, key, pending](
+                           std::size_t                       offset,
+                           std::vector<double> const&        elevations,
+                           std::optional<std::string> const& error
+                         ) {
+      auto&      profile = pending->profile_;
+      auto const size    = std::min(CHUNK_SAMPLES, profile.count_ - offset);
+      --pending->remaining_;
+
+      ws::msg::TerrainProfile message{
+        .id_        = profile.id_,
+        .count_     = profile.count_,
+        .offset_    = offset,
+        .distances_ = {
+          profile.distances_.begin() + offset, profile.distances_.begin() + offset + size
+        },
+        .done_ = (pending->remaining_ == 0),
+      };
+
+      if (error) {
+         pending->failed_ = true;
+         message.error_   = error;
+      } else {
+         assert(elevations.size() == size);
+         std::ranges::copy(elevations, profile.elevations_.begin() + offset);
+         message.elevations_ = elevations;
+      }
+      SendTerrainProfile(id, message);
+
+      if (!pending->remaining_ && !pending->failed_) {
+         terrain_profiles_.emplace_front(key, std::move(profile));
+         if (terrain_profiles_.size() > MAX_TERRAIN_PROFILES) {
+            terrain_profiles_.pop_back();
+         }
+      }
+   };
+
+   // Resolved in parallel, the posts shared by several chunks are probed once
+   for (std::size_t offset = 0; offset < count; offset += CHUNK_SAMPLES) {
+      auto const end = std::min(offset + CHUNK_SAMPLES, count);
+
+      server_.main_.SimConnect()
+        .GetGroundProfile({samples.positions_.begin() + offset, samples.positions_.begin() + end})
+        .Then([this, on_chunk, offset](std::vector<double> const& elevations) {
+           try {
+              (void)server_.Dispatch([on_chunk, offset, elevations]() {
+                 on_chunk(offset, elevations, std::nullopt);
+              });
+           } catch (QueueStopped const&) {
+              std::cerr << "Failed to dispatch terrain profile to the server" << std::endl;
+           }
+        })
+        .Catch([this, on_chunk, offset](std::exception_ptr const& exception) {
+           std::string error{"Unknown error"};
+           try {
+              std::rethrow_exception(exception);
+           } catch (std::exception const& e) {
+              error = e.what();
+           } catch (...) {
+           }
+
+           try {
+              (void)server_.Dispatch([on_chunk, offset, error]() {
+                 on_chunk(offset, {}, error);
+              });
+           } catch (QueueStopped const&) {
+              std::cerr << "Failed to dispatch terrain profile to the server" << std::endl;
+           }
+        })
+        .Detach();
+   }
+}
+
+void
+Server::Tenant::SendTerrainProfile(std::size_t id, ws::msg::TerrainProfile const& message) {
+   if (auto const handler = message_handlers_.find(id); handler != message_handlers_.end()) {
+      handler->second(0, message);
+   }
+}
@@ -0,0 +1,144 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Server.h"
+
+#include "main.h"
+#include "Server/WebSockets/Messages/Messages.h"
+#include "Server/WebSockets/Messages/Traffic.h"
+#include "SimConnect/Traffic.h"
+
+#include <iostream>
+#include <numbers>
+#include <utility>
+
+// All the traffic functions run on the server message queue
+
+namespace {
+
+ws::msg::TrafficAircraft
+ToMessage(smc::TrafficEntry const& entry) {
+   ws::msg::TrafficAircraft aircraft{
+     .id_              = entry.id_,
+     .lat_             = entry.lat_,
+     .lon_             = entry.lon_,
+     .altitude_        = entry.altitude_,
+     .heading_         = entry.heading_ * 180. / std::numbers::pi,
+     .ground_velocity_ = entry.ground_velocity_,
+     .vertical_speed_  = entry.vertical_speed_ * 60.,
+     .on_ground_       = entry.on_ground_,
+     .helicopter_      = entry.helicopter_,
+     .alert_           = static_cast<uint8_t>(entry.alert_),
+   };
+
+   if (entry.static_info_) {
+      aircraft.atc_id_    = entry.static_info_->atc_id_;
+      aircraft.atc_type_  = entry.static_info_->atc_type_;
+      aircraft.atc_model_ = entry.static_info_->atc_model_;
+   }
+
+   return aircraft;
+}
+
+}  // namespace
+
+void
+Server::Tenant::HandleGetTraffic(std::size_t id, ws::msg::GetTraffic const& message) {
+   if (!message.subscribe_) {
+      DropTrafficViewer(id);
+      return;
+   }
+
+   if (!UsesRegistry()) {
+      // Only the default seat flies in the simulator this server is connected to
+      return;
+   }
+
+   if (!traffic_viewers_.emplace(id).second) {
+      return;
+   }
+
+   if (traffic_stream_) {
+      if (traffic_.empty()) {
+         return;
+      }
+
+      // Starts from the aircraft already sent to the others
+      ws::msg::Traffic snapshot{};
+      snapshot.added_.reserve(traffic_.size());
+      for (auto const& [_, aircraft] : traffic_) {
+         snapshot.added_.emplace_back(aircraft);
+      }
+
+      if (auto const handler = message_handlers_.find(id); handler != message_handlers_.end()) {
+         handler->second(0, std::move(snapshot));
+      }
+      return;
+   }
+
+   traffic_stream_ = server_.main_.SimConnect().SubscribeTraffic();
+   traffic_stream_->Attach([this](smc::TrafficDiff const& diff) {
+      // Called on the SimConnect thread
+      try {
+         (void)server_.Dispatch([this, diff]() { OnTraffic(diff); });
+      } catch (QueueStopped const&) {
+         std::cerr << "Failed to dispatch traffic to the server" << std::endl;
+      }
+   });
+}
+
+void
+Server::Tenant::OnTraffic(smc::TrafficDiff const& diff) {
+   if (!traffic_stream_) {
+      // Last viewer gone in the meantime
+      return;
+   }
+
+   ws::msg::Traffic message{};
+
+   message.added_.reserve(diff.added_.size());
+   for (auto const& entry : diff.added_) {
+      auto const& [it, _] = traffic_.insert_or_assign(entry.id_, ToMessage(entry));
+      message.added_.emplace_back(it->second);
+   }
+
+   message.moved_.reserve(diff.moved_.size());
+   for (auto const& entry : diff.moved_) {
+      auto const& [it, _] = traffic_.insert_or_assign(entry.id_, ToMessage(entry));
+      message.moved_.emplace_back(it->second);
+   }
+
+   message.removed_.reserve(diff.removed_.size());
+   for (auto const id : diff.removed_) {
+      traffic_.erase(id);
+      message.removed_.emplace_back(id);
+   }
+
+   for (auto const viewer : traffic_viewers_) {
+      if (auto const handler = message_handlers_.find(viewer); handler != message_handlers_.end()) {
+         handler->second(0, message);
+      }
+   }
+}
+
+void
+Server::Tenant::DropTrafficViewer(std::size_t id) {
+   if (traffic_viewers_.erase(id) && traffic_viewers_.empty() && traffic_stream_) {
+      // Stops the sampling once the last viewer is gone
+      traffic_stream_->Cancel();
+      traffic_stream_.reset();
+      traffic_.clear();
+   }
+}
@@ -36,9 +36,16 @@
 
 using namespace boost::beast;
 
-Server::EFBWebSocket::EFBWebSocket(WebSocket&& socket, bool web_browser)
+Server::EFBWebSocket::EFBWebSocket(
+  WebSocket&&              socket,
+  Tenant&                  tenant,
+  bool                     web_browser,
+  std::shared_ptr<Session> session
+)
    : server_(socket.server_)
+   , tenant_(tenant)
    , web_browser_(web_browser)
+   , session_(std::move(session))
    , buffer_(std::move(socket.buffer_))
    , peer_(std::move(socket.peer_))
    , ws_(std::move(socket.ws_)) {
@@ -49,15 +56,19 @@ Server::EFBWebSocket::~EFBWebSocket() {
    std::cout << "Session " << peer_ << " closed" << std::endl;
 
    if (web_browser_) {
-      server_.Dispatch([&server = server_, id = my_id_]() { server.UnsetMessageHandler(id); });
+      server_.Dispatch([&server = server_, session = session_]() {
+         // The handler is kept until the session expires
+         server.DetachSession(session);
+      });
    } else {
       // EFB MSFS App Closed - Notify server state
 
-      server_.Dispatch([&server = server_, my_id = my_id_]() {
-         server.efb_connected_ = false;
-         server.UnsetMessageHandler(0);
+      server_.Dispatch([&tenant = tenant_, my_id = my_id_]() {
+         tenant.efb_connected_ = false;
+         tenant.UnsetMessageHandler(0);
+         tenant.InvalidateSnapshots();
 
-         for (auto const& [id, handler] : server.message_handlers_) {
+         for (auto const& [id, handler] : tenant.message_handlers_) {
             handler(my_id, ws::msg::EFBState{.state_ = false});
          }
       });
@@ -90,7 +101,7 @@ Server::EFBWebSocket::VDispatchMessage(std::size_t id, ws::Message&& message) {
 
 void
 Server::EFBWebSocket::VSendMessage(std::size_t id, ws::Message&& message) {
-   if (ws_.is_open()) {
+   if (ws_.is_open() || session_) {
       if (
         std::holds_alternative<ws::msg::GetSettings>(message)
         || std::holds_alternative<ws::msg::Settings>(message)
@@ -99,30 +110,31 @@ Server::EFBWebSocket::VSendMessage(std::size_t id, ws::Message&& message) {
       } else if (std::holds_alternative<ws::msg::GetEFBState>(message)) {
          (void)server_.Dispatch([self = shared_from_this(), id = id]() {
             if (
-              auto const message_handler = self->server_.message_handlers_.find(id);
-              message_handler != self->server_.message_handlers_.end()
+              auto const message_handler = self->tenant_.message_handlers_.find(id);
+              message_handler != self->tenant_.message_handlers_.end()
             ) {
                message_handler->second(
-                 1, ws::msg::EFBState{.state_ = self->server_.efb_connected_}
+                 1, ws::msg::EFBState{.state_ = self->tenant_.efb_connected_}
                );
             }
          });
       } else if (std::holds_alternative<ws::msg::GetServerState>(message)) {
          (void)server_.Dispatch([self = shared_from_this(), id = id]() {
             if (
-              auto const message_handler = self->server_.message_handlers_.find(id);
-              message_handler != self->server_.message_handlers_.end()
+              auto const message_handler = self->tenant_.message_handlers_.find(id);
+              message_handler != self->tenant_.message_handlers_.end()
             ) {
                message_handler->second(1, ws::msg::ServerState{.state_ = self->server_.running_});
             }
          });
       } else {
          try {
-            auto const message_str =
-              js::Stringify(ws::Proxy{.id_ = id, .content_ = std::move(message)});
-
-            ws_.text(true);
-            ws_.write(net::buffer(message_str));
+            // Session messages are recorded even when the socket is closed, to be replayed on
+            // resume
+            Write(
+              session_ ? session_->Record(id, std::move(message))
+                       : js::Stringify(ws::Proxy{.id_ = id, .content_ = std::move(message)})
+            );
          } catch (std::exception const& e) {
             std::cerr << "Write error: " << e.what() << std::endl;
          }
@@ -130,6 +142,38 @@ Server::EFBWebSocket::VSendMessage(std::size_t id, ws::Message&& message) {
    }
 }
 
+void
+Server::EFBWebSocket::VDispatchFrame(std::shared_ptr<std::string const> frame) {
+   (void)server_.Dispatch([self = shared_from_this(), frame = std::move(frame)]() {
+      try {
+         if (self->session_ && self->session_->sequenced_) {
+            self->Write(self->session_->Record(*frame));
+         } else {
+            self->Write(*frame);
+         }
+      } catch (std::exception const& e) {
+         std::cerr << "Write error: " << e.what() << std::endl;
+      }
+   });
+}
+
+void
+Server::EFBWebSocket::SendControl(ws::Message&& message) {
+   // Connection messages aren't part of the session sequence
+   try {
+      Write(js::Stringify(ws::Proxy{.id_ = 1, .content_ = std::move(message)}));
+   } catch (std::exception const& e) {
+      std::cerr << "Write error: " << e.what() << std::endl;
+   }
+}
+
+void
+Server::EFBWebSocket::Write(std::string message) {
+   if (ws_.is_open()) {
+      writes_.Write(shared_from_this(), std::move(message));
+   }
+}
+
 void
 Server::EFBWebSocket::Stop() noexcept(false) {
    std::mutex mutex{};
@@ -137,7 +181,8 @@ Server::EFBWebSocket::Stop() noexcept(false) {
    std::condition_variable cv{};
    bool                    closed = false;
 
-   server_.Ensure([self = shared_from_this(), &cv, &mutex, &closed]() {
+   // Behind the pending writes
+   net::dispatch(writes_.GetStrand(), [self = shared_from_this(), &cv, &mutex, &closed]() {
       boost::beast::error_code ec;
       self->ws_.next_layer().cancel(ec);
       ec = {};
@@ -156,41 +201,79 @@ Server::EFBWebSocket::Stop() noexcept(false) {
 }
 
 void
-Server::EFBWebSocket::Start() noexcept(false) {
+Server::EFBWebSocket::Start(std::optional<std::size_t> last_seq) noexcept(false) {
    if (!server_.want_run_) {
       return;
    }
 
-   my_id_ = web_browser_ ? std::bit_cast<std::size_t>(this) : 0;
+   assert(!web_browser_ || session_);
+   my_id_ = web_browser_ ? session_->id_ : 0;
+
+   server_.Dispatch([self = shared_from_this(), last_seq]() {
+      self->SendControl(ws::msg::HelloWorld{.type_ = "Server"});
+
+      if (last_seq) {
+         // Resumed session: its handler is still registered, only replay the missed messages
+         self->SendControl(ws::msg::SetId{
+           .id_ = self->my_id_, .resume_ = self->session_->token_, .resumed_ = true
+         });
+
+         try {
+            for (auto const& [seq, message] : self->session_->ring_) {
+               if (seq > *last_seq) {
+                  self->Write(message);
+               }
+            }
+         } catch (std::exception const& e) {
+            std::cerr << "Write error: " << e.what() << std::endl;
+         }
 
-   server_.Dispatch([self = shared_from_this()]() {
-      self->VSendMessage(1, ws::msg::HelloWorld{.type_ = "Server"});
+         self->VSendMessage(1, ws::msg::EFBState{.state_ = self->tenant_.efb_connected_});
+         return;
+      }
 
-      self->server_.SetMessageHandler(
-        self->my_id_, {[self = self->weak_from_this()](std::size_t id, ws::Message message) {
-           auto const ptr = self.lock();
-           if (ptr) {
-              ptr->VDispatchMessage(id, std::move(message));
-           }
-        }}
-      );
+      MessageHandler handler{[self    = self->weak_from_this(),
+                              session = self->session_](std::size_t id, ws::Message message) {
+         auto const ptr = session ? session->socket_.lock() : self.lock();
+         if (ptr) {
+            ptr->VDispatchMessage(id, std::move(message));
+         } else if (session) {
+            // Viewer disconnected, keep the message for its resumption
+            (void)session->Record(id, std::move(message));
+         }
+      }};
 
       if (self->web_browser_) {
-         self->VSendMessage(1, ws::msg::SetId{.id_ = self->my_id_});
-         self->VSendMessage(1, ws::msg::EFBState{.state_ = self->server_.efb_connected_});
+         handler.frame_ = [session = self->session_](
+                            std::shared_ptr<std::string const> const& frame
+                          ) {
+            if (auto const ptr = session->socket_.lock()) {
+               ptr->VDispatchFrame(frame);
+            } else if (session->sequenced_) {
+               (void)session->Record(*frame);
+            }
+         };
+      }
+
+      self->tenant_.SetMessageHandler(self->my_id_, std::move(handler));
+
+      if (self->web_browser_) {
+         self->SendControl(ws::msg::SetId{.id_ = self->my_id_, .resume_ = self->session_->token_});
+         self->VSendMessage(1, ws::msg::EFBState{.state_ = self->tenant_.efb_connected_});
       } else {
          // EFB MSFS App
-         self->server_.efb_connected_ = true;
+         self->tenant_.efb_connected_ = true;
 
+         // Snapshots of a previous EFB session are outdated
+         self->tenant_.InvalidateSnapshots();
+         self->tenant_.records_in_flight_ = true;
          self->VSendMessage(1, ws::msg::GetRecords{});
 
-         for (auto const& [id, handler] : self->server_.message_handlers_) {
+         for (auto const& [id, handler] : self->tenant_.message_handlers_) {
             handler(1, ws::msg::EFBState{.state_ = true});
 
             if (handler.lat_ > -500) {
-               self->VSendMessage(
-                 id, ws::msg::GetFacilities{.lat_ = handler.lat_, .lon_ = handler.lon_}
-               );
+               self->tenant_.RequestFacilities(id, handler.lat_, handler.lon_);
             }
          }
       }
@@ -205,7 +288,14 @@ Server::EFBWebSocket::Start() noexcept(false) {
 void
 Server::EFBWebSocket::Read() {
    if (server_.want_run_) {
-      ws_.async_read(buffer_, bind_front_handler(&EFBWebSocket::OnRead, shared_from_this()));
+      net::dispatch(writes_.GetStrand(), [self = shared_from_this()]() {
+         self->ws_.async_read(
+           self->buffer_,
+           net::bind_executor(
+             self->writes_.GetStrand(), bind_front_handler(&EFBWebSocket::OnRead, self)
+           )
+         );
+      });
    }
 }
 
@@ -233,8 +323,8 @@ Server::EFBWebSocket::OnRead(error_code ec, size_t n) {
 
             assert(false);
          } else {
-            assert(self->server_.efb_socket_ == self);
-            self->server_.efb_socket_ = nullptr;
+            assert(self->tenant_.efb_socket_ == self);
+            self->tenant_.efb_socket_ = nullptr;
          }
       });
       return;
@@ -249,27 +339,27 @@ Server::EFBWebSocket::OnRead(error_code ec, size_t n) {
          auto message = js::Parse<ws::Proxy>(data);
 
          if (std::holds_alternative<ws::msg::fuel::Presets>(message.content_)) {
-            server_.HandleFuelPresets(my_id_, std::move(message.content_));
+            tenant_.HandleFuelPresets(my_id_, std::move(message.content_));
          } else if (std::holds_alternative<ws::msg::fuel::Curves>(message.content_)) {
-            server_.HandleFuelCurve(my_id_, std::move(message.content_));
+            tenant_.HandleFuelCurve(my_id_, std::move(message.content_));
          } else if (std::holds_alternative<ws::msg::fuel::DefaultPreset>(message.content_)) {
-            server_.HandleDefaultFuelPreset(my_id_, std::move(message.content_));
+            tenant_.HandleDefaultFuelPreset(my_id_, std::move(message.content_));
          } else if (std::holds_alternative<ws::msg::fuel::GetPresets>(message.content_)) {
-            server_.HandleGetFuelPresets(my_id_);
+            tenant_.HandleGetFuelPresets(my_id_);
          } else if (std::holds_alternative<ws::msg::dev::Presets>(message.content_)) {
-            server_.HandleDeviationPresets(my_id_, std::move(message.content_));
+            tenant_.HandleDeviationPresets(my_id_, std::move(message.content_));
          } else if (std::holds_alternative<ws::msg::dev::Curve>(message.content_)) {
-            server_.HandleDeviationCurve(my_id_, std::move(message.content_));
+            tenant_.HandleDeviationCurve(my_id_, std::move(message.content_));
          } else if (std::holds_alternative<ws::msg::dev::DefaultPreset>(message.content_)) {
-            server_.HandleDefaultDeviationPreset(my_id_, std::move(message.content_));
+            tenant_.HandleDefaultDeviationPreset(my_id_, std::move(message.content_));
          } else if (std::holds_alternative<ws::msg::dev::GetPresets>(message.content_)) {
-            server_.HandleGetDeviationPresets(my_id_);
+            tenant_.HandleGetDeviationPresets(my_id_);
          } else if (std::holds_alternative<ws::msg::GetEFBState>(message.content_)) {
             assert(message.id_ != 2);
             assert(message.id_ != 1);
 
             (void)server_.Dispatch([self = shared_from_this(), id = my_id_]() {
-               self->VSendMessage(id, ws::msg::EFBState{.state_ = self->server_.efb_connected_});
+               self->VSendMessage(id, ws::msg::EFBState{.state_ = self->tenant_.efb_connected_});
             });
          } else if (std::holds_alternative<ws::msg::GetServerState>(message.content_)) {
             assert(false);
@@ -340,8 +430,12 @@ Server::EFBWebSocket::OnRead(error_code ec, size_t n) {
             if (message.id_ == 1) {
                // Broadcast
                (void)server_.Dispatch(
-                 [&server = server_, my_id = my_id_, message = std::move(message)]() {
-                    for (auto const message_handler : server.message_handlers_) {
+                 [&tenant = tenant_, my_id = my_id_, message = std::move(message)]() {
+                    if (my_id == 0) {
+                       tenant.OnEFBSnapshot(message.id_, message.content_);
+                    }
+
+                    for (auto const message_handler : tenant.message_handlers_) {
                        if (message_handler.first != my_id) {
                           message_handler.second(my_id, std::move(message.content_));
                        }
@@ -350,10 +444,19 @@ Server::EFBWebSocket::OnRead(error_code ec, size_t n) {
                );
             } else {
                (void)server_.Dispatch(
-                 [&server = server_, my_id = my_id_, message = std::move(message)]() {
+                 [&tenant = tenant_, my_id = my_id_, message = std::move(message)]() {
+                    if (my_id == 0) {
+                       tenant.OnEFBSnapshot(message.id_, message.content_);
+                    } else if (
+                      (message.id_ == 0) && tenant.HandleSnapshotRequest(my_id, message.content_)
+                    ) {
+                       // Viewer request served from the EFB snapshots
+                       return;
+                    }
+
                     if (
-                      auto const message_handler = server.message_handlers_.find(message.id_);
-                      message_handler != server.message_handlers_.end()
+                      auto const message_handler = tenant.message_handlers_.find(message.id_);
+                      message_handler != tenant.message_handlers_.end()
                     ) {
                        message_handler->second(my_id, std::move(message.content_));
                     }
@@ -368,10 +471,3 @@ Server::EFBWebSocket::OnRead(error_code ec, size_t n) {
 
    Read();
 }
-
-void
-Server::EFBWebSocket::OnWrite(error_code ec, size_t) {
-   if (!ec) {
-      Read();
-   }
-}
@@ -17,12 +17,25 @@
 
 #include <json/json.h>
 
+#include <optional>
+#include <string>
+
 namespace ws::msg {
 struct HelloWorld {
-   js::Enum<"EFB", "Web", "Server"> type_{"Server"};
+   js::Enum<"EFB", "Web", "Server", "Relay"> type_{"Server"};
+
+   // Session resumption (Web viewers)
+   std::optional<std::string> resume_{};
+   std::optional<std::size_t> last_seq_{};
+
+   // Sim seat of the EFB / viewer, default one when unset
+   std::optional<std::string> tenant_{};
 
    static constexpr js::Proto PROTOTYPE{
      js::_{"__HELLO_WORLD__", &HelloWorld::type_},
+     js::_{"resume", &HelloWorld::resume_},
+     js::_{"lastSeq", &HelloWorld::last_seq_},
+     js::_{"tenant", &HelloWorld::tenant_},
    };
 };
 
@@ -37,8 +50,13 @@ struct ByeBye {
 struct SetId {
    std::size_t id_{};
 
+   std::optional<std::string> resume_{};
+   bool                       resumed_{false};
+
    static constexpr js::Proto PROTOTYPE{
      js::_{"__SET_ID__", &SetId::id_},
+     js::_{"resume", &SetId::resume_},
+     js::_{"resumed", &SetId::resumed_},
    };
 };
 
@@ -92,6 +110,8 @@ struct GetEFBState {
 #include "PlanePos.h"
 #include "Records.h"
 #include "Settings.h"
+#include "TerrainProfile.h"
+#include "Traffic.h"
 #include "Date.h"
 #include "ATCId.h"
 
@@ -138,6 +158,8 @@ using Message = std::variant<
   msg::GetRecords,
   msg::GetServerState,
   msg::GetSettings,
+  msg::GetTerrainProfile,
+  msg::GetTraffic,
   msg::HelloWorld,
   msg::Icaos,
   msg::ImportNav,
@@ -153,15 +175,21 @@ using Message = std::variant<
   msg::RemoveRecord,
   msg::ServerState,
   msg::SetId,
-  msg::Settings>;
+  msg::Settings,
+  msg::TerrainProfile,
+  msg::Traffic>;
 
 struct Proxy {
    std::size_t id_{};
    Message     content_{};
 
+   // Sequence number of the messages sent to a resumable session
+   std::optional<std::size_t> seq_{};
+
    static constexpr js::Proto PROTOTYPE{
      js::_{"id", &Proxy::id_},
      js::_{"content", &Proxy::content_},
+     js::_{"seq", &Proxy::seq_},
    };
 };
 }  // namespace ws
\ No newline at end of file
@@ -71,6 +71,7 @@ struct Settings {
    bool header_{true};
 
    double      default_speed_{};
+   std::string tenant_{};
    std::string sia_auth_{};
    std::string sia_addr_{};
    std::string sia_azba_addr_{};
@@ -143,6 +144,7 @@ struct Settings {
      js::_{"__SETTINGS__", &Settings::header_},
 
      js::_{"defaultSpeed", &Settings::default_speed_},
+     js::_{"tenant", &Settings::tenant_},
      js::_{"SIAAuth", &Settings::sia_auth_},
      js::_{"SIAAddr", &Settings::sia_addr_},
      js::_{"SIAAZBAAddr", &Settings::sia_azba_addr_},
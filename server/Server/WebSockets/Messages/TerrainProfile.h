@@ -0,0 +1,78 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <json/json.h>
+
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ws::msg {
+
+struct GetTerrainProfile {
+   bool header_{true};
+
+   // Echoed by the TerrainProfile messages
+   std::size_t id_{};
+
+   // Route, in map coordinates like NavData::coords_
+   std::vector<std::array<double, 2>> coords_{};
+   // Between two samples, nautical miles
+   double spacing_{.5};
+
+   static constexpr js::Proto PROTOTYPE{
+     js::_{"__GET_TERRAIN_PROFILE__", &GetTerrainProfile::header_},
+
+     js::_{"id", &GetTerrainProfile::id_},
+     js::_{"coords", &GetTerrainProfile::coords_},
+     js::_{"spacing", &GetTerrainProfile::spacing_},
+   };
+};
+
+// Samples [offset, offset + elevations.size()) of a profile, sent as they are resolved (in any
+// order). The last message of a profile has done set.
+struct TerrainProfile {
+   bool header_{true};
+
+   std::size_t id_{};
+   // Samples of the whole profile
+   std::size_t count_{};
+   std::size_t offset_{};
+
+   std::vector<double> distances_{};   // From the first coord, nautical miles
+   std::vector<double> elevations_{};  // Feet
+
+   bool done_{false};
+   // The samples couldn't be resolved, elevations is empty
+   std::optional<std::string> error_{};
+
+   static constexpr js::Proto PROTOTYPE{
+     js::_{"__TERRAIN_PROFILE__", &TerrainProfile::header_},
+
+     js::_{"id", &TerrainProfile::id_},
+     js::_{"count", &TerrainProfile::count_},
+     js::_{"offset", &TerrainProfile::offset_},
+     js::_{"distances", &TerrainProfile::distances_},
+     js::_{"elevations", &TerrainProfile::elevations_},
+     js::_{"done", &TerrainProfile::done_},
+     js::_{"error", &TerrainProfile::error_},
+   };
+};
+
+}  // namespace ws::msg
@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <json/json.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ws::msg {
+
+struct TrafficAircraft {
+   std::size_t id_{};
+
+   double lat_{};
+   double lon_{};
+   double altitude_{};         // feet
+   double heading_{};          // true, degrees
+   double ground_velocity_{};  // knots
+   double vertical_speed_{};   // feet/minute
+   bool   on_ground_{};
+   bool   helicopter_{};
+
+   // 0 none, 1 proximate, 2 traffic advisory, 3 resolution advisory
+   uint8_t alert_{};
+
+   // Once received by the server
+   std::optional<std::string> atc_id_{};
+   std::optional<std::string> atc_type_{};
+   std::optional<std::string> atc_model_{};
+
+   static constexpr js::Proto PROTOTYPE{
+     js::_{"id", &TrafficAircraft::id_},
+     js::_{"lat", &TrafficAircraft::lat_},
+     js::_{"lon", &TrafficAircraft::lon_},
+     js::_{"altitude", &TrafficAircraft::altitude_},
+     js::_{"heading", &TrafficAircraft::heading_},
+     js::_{"groundVelocity", &TrafficAircraft::ground_velocity_},
+     js::_{"verticalSpeed", &TrafficAircraft::vertical_speed_},
+     js::_{"onGround", &TrafficAircraft::on_ground_},
+     js::_{"helicopter", &TrafficAircraft::helicopter_},
+     js::_{"alert", &TrafficAircraft::alert_},
+     js::_{"atcId", &TrafficAircraft::atc_id_},
+     js::_{"atcType", &TrafficAircraft::atc_type_},
+     js::_{"atcModel", &TrafficAircraft::atc_model_},
+   };
+};
+
+// Changes since the last Traffic message, the first one lists every aircraft as added
+struct Traffic {
+   bool header_{true};
+
+   std::vector<TrafficAircraft> added_{};
+   std::vector<TrafficAircraft> moved_{};
+   std::vector<std::size_t>     removed_{};
+
+   static constexpr js::Proto PROTOTYPE{
+     js::_{"__TRAFFIC__", &Traffic::header_},
+
+     js::_{"added", &Traffic::added_},
+     js::_{"moved", &Traffic::moved_},
+     js::_{"removed", &Traffic::removed_},
+   };
+};
+
+struct GetTraffic {
+   bool header_{true};
+
+   // Stops the Traffic messages when false
+   bool subscribe_{true};
+
+   static constexpr js::Proto PROTOTYPE{
+     js::_{"__GET_TRAFFIC__", &GetTraffic::header_},
+
+     js::_{"subscribe", &GetTraffic::subscribe_},
+   };
+};
+
+}  // namespace ws::msg
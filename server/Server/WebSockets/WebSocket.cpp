@@ -17,6 +17,7 @@
 #include "../Server.h"
 
 #include <memory>
+#include <optional>
 
 using namespace boost::beast;
 
@@ -95,28 +96,48 @@ Server::WebSocket::OnRead(error_code ec, size_t n) {
          (void)server_.Dispatch([self    = shared_from_this(),
                                  message = std::move(message)]() mutable constexpr {
             auto const& hello_world = std::get<ws::msg::HelloWorld>(message);
+            auto&       server      = self->server_;
+            auto&       tenant      = server.GetTenant(hello_world.tenant_);
 
             if (*hello_world.type_ == "EFB") {
-               auto& server = self->server_;
-
                // Close existing EFB connection if present before creating new one
-               if (server.efb_socket_) {
+               if (tenant.efb_socket_) {
                   std::cout << "Replacing existing EFB connection with new one" << std::endl;
-                  server.efb_socket_->Stop();
-                  server.efb_socket_ = nullptr;
+                  tenant.efb_socket_->Stop();
+                  tenant.efb_socket_ = nullptr;
                }
 
-               server.efb_socket_ = std::make_shared<EFBWebSocket>(std::move(*self.get()), false);
-               self               = nullptr;
-               server.efb_socket_->Start();
+               tenant.efb_socket_ =
+                 std::make_shared<EFBWebSocket>(std::move(*self.get()), tenant, false);
+               self = nullptr;
+               tenant.efb_socket_->Start();
             } else {
-               assert(*hello_world.type_ == "Web");
-               auto const socket = self->server_.web_sockets_.emplace_back(
-                 std::make_shared<EFBWebSocket>(std::move(*self.get()), true)
+               assert((*hello_world.type_ == "Web") || (*hello_world.type_ == "Relay"));
+
+               std::shared_ptr<Session>   session{};
+               std::optional<std::size_t> last_seq{};
+               if (*hello_world.type_ == "Relay") {
+                  // Relays request fresh snapshots when reconnecting, they get unsequenced frames
+                  // that they can forward as is
+                  session             = server.OpenSession(tenant);
+                  session->sequenced_ = false;
+               } else if (hello_world.resume_) {
+                  last_seq = hello_world.last_seq_.value_or(0);
+                  session  = server.ResumeSession(tenant, *hello_world.resume_, *last_seq);
+               }
+
+               if (!session) {
+                  last_seq = std::nullopt;
+                  session  = server.OpenSession(tenant);
+               }
+
+               auto const socket = server.web_sockets_.emplace_back(
+                 std::make_shared<EFBWebSocket>(std::move(*self.get()), tenant, true, session)
                );
+               session->socket_ = socket;
 
                self = nullptr;
-               socket->Start();
+               socket->Start(last_seq);
             }
          });
       } else {
@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "WriteQueue.h"
+
+#include <iostream>
+#include <utility>
+
+namespace net = boost::asio;
+
+WriteQueue::WriteQueue(net::io_context& ioc, Stream& ws)
+   : ws_{ws}
+   , strand_{net::make_strand(ioc)} {}
+
+void
+WriteQueue::Write(Owner owner, std::string&& frame) {
+   net::post(strand_, [this, owner = std::move(owner), frame = std::move(frame)]() mutable {
+      queue_.emplace_back(std::move(frame));
+
+      if (queue_.size() == 1) {
+         Next(std::move(owner));
+      }
+   });
+}
+
+WriteQueue::Strand&
+WriteQueue::GetStrand() {
+   return strand_;
+}
+
+std::size_t
+WriteQueue::Size() const {
+   return queue_.size();
+}
+
+void
+WriteQueue::Next(Owner owner) {
+   if (!ws_.is_open()) {
+      queue_.clear();
+      return;
+   }
+
+   ws_.text(true);
+   ws_.async_write(
+     net::buffer(queue_.front()),
+     net::bind_executor(
+       strand_,
+       [this, owner = std::move(owner)](boost::beast::error_code ec, std::size_t n) mutable {
+          OnWrite(std::move(owner), ec, n);
+       }
+     )
+   );
+}
+
+void
+WriteQueue::OnWrite(Owner owner, boost::beast::error_code ec, std::size_t) {
+   if (ec) {
+      if (
+        ec != boost::beast::websocket::error::closed && ec != net::error::operation_aborted
+        && ec != net::error::bad_descriptor
+      ) {
+         std::cerr << "Write error: " << ec.message() << std::endl;
+      }
+
+      // The pending read fails as well and drops the socket
+      queue_.clear();
+      return;
+   }
+
+   queue_.pop_front();
+   if (!queue_.empty()) {
+      Next(std::move(owner));
+   }
+}
@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+
+#ifdef __clang__
+#   pragma clang diagnostic push
+#   pragma clang diagnostic ignored "-Weverything"
+#elif defined(_MSC_VER)
+#   pragma warning(push, 0)
+#endif
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#ifdef __clang__
+#   pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#   pragma warning(pop)
+#endif
+
+// Outgoing frames of a server websocket. The stream is only touched from its strand : Write posts
+// the frame there and the frames are sent one async_write after the other, so a slow peer only
+// grows its own queue and never blocks the caller (the server message queue).
+class WriteQueue {
+public:
+   using Stream = boost::beast::websocket::stream<boost::asio::ip::tcp::socket>;
+   using Strand = boost::asio::strand<boost::asio::io_context::executor_type>;
+   // Keeps the stream (and this queue) alive until the frame is sent
+   using Owner = std::shared_ptr<void const>;
+
+   // ioc runs the stream
+   WriteQueue(boost::asio::io_context& ioc, Stream& ws);
+
+   // From any thread, the frames are sent in call order
+   void Write(Owner owner, std::string&& frame);
+
+   // Reads and closes of the stream must run on it as well
+   Strand& GetStrand();
+
+   // Queued frames, on the strand
+   std::size_t Size() const;
+
+private:
+   void Next(Owner owner);
+   void OnWrite(Owner owner, boost::beast::error_code ec, std::size_t n);
+
+   Stream& ws_;
+   Strand  strand_;
+
+   // Front is being written
+   std::deque<std::string> queue_{};
+};
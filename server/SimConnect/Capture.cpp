@@ -0,0 +1,90 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Capture.h"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace smc {
+
+namespace {
+
+constexpr std::string_view MAGIC = "SMCCAP01";
+
+// Bigger packets are corrupted captures
+constexpr uint32_t MAX_PACKET_SIZE = 16 * 1024 * 1024;
+
+}  // namespace
+
+CaptureWriter::CaptureWriter(std::filesystem::path const& path)
+   : file_{path, std::ios::binary | std::ios::trunc} {
+   if (!file_) {
+      throw std::runtime_error("Couldn't create capture file " + path.string());
+   }
+
+   file_.write(MAGIC.data(), MAGIC.size());
+}
+
+void
+CaptureWriter::Write(std::span<std::byte const> packet) {
+   auto const time = static_cast<uint64_t>(
+     std::chrono::duration_cast<std::chrono::microseconds>(
+       std::chrono::steady_clock::now() - start_
+     )
+       .count()
+   );
+   auto const size = static_cast<uint32_t>(packet.size());
+
+   file_.write(reinterpret_cast<char const*>(&time), sizeof(time));
+   file_.write(reinterpret_cast<char const*>(&size), sizeof(size));
+   file_.write(reinterpret_cast<char const*>(packet.data()), size);
+}
+
+CaptureReader::CaptureReader(std::filesystem::path const& path)
+   : file_{path, std::ios::binary} {
+   std::string magic(MAGIC.size(), '\0');
+   file_.read(magic.data(), magic.size());
+
+   if (!file_ || (magic != MAGIC)) {
+      throw std::runtime_error("Invalid capture file " + path.string());
+   }
+}
+
+std::optional<CapturedPacket>
+CaptureReader::Next() {
+   uint64_t time{};
+   uint32_t size{};
+
+   file_.read(reinterpret_cast<char*>(&time), sizeof(time));
+   file_.read(reinterpret_cast<char*>(&size), sizeof(size));
+   if (!file_ || (size > MAX_PACKET_SIZE)) {
+      return std::nullopt;
+   }
+
+   CapturedPacket packet{.time_ = std::chrono::microseconds{time}, .data_ = {}};
+   packet.data_.resize(size);
+
+   file_.read(reinterpret_cast<char*>(packet.data_.data()), size);
+   if (!file_) {
+      // Truncated capture
+      return std::nullopt;
+   }
+
+   return packet;
+}
+
+}  // namespace smc
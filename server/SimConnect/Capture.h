@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace smc {
+
+// Capture of the raw SIMCONNECT_RECV packets received from the simulator.
+// File layout : "SMCCAP01", then for each packet its time since the capture start (uint64,
+// microseconds), its size (uint32) and its bytes.
+struct CapturedPacket {
+   std::chrono::microseconds time_{};
+   std::vector<std::byte>    data_{};
+};
+
+class CaptureWriter {
+public:
+   CaptureWriter(std::filesystem::path const& path);
+
+   void Write(std::span<std::byte const> packet);
+
+private:
+   std::ofstream                         file_;
+   std::chrono::steady_clock::time_point start_{std::chrono::steady_clock::now()};
+};
+
+class CaptureReader {
+public:
+   CaptureReader(std::filesystem::path const& path);
+
+   std::optional<CapturedPacket> Next();
+
+private:
+   std::ifstream file_;
+};
+
+}  // namespace smc
@@ -0,0 +1,220 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "Conflicts.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#   include <emmintrin.h>
+#   define SMC_CONFLICTS_SSE2
+#endif
+
+namespace smc {
+
+namespace {
+
+constexpr double EARTH_RADIUS = 20'925'646.;  // feet
+constexpr double NM           = 6'076.12;     // feet
+constexpr double DEG          = std::numbers::pi / 180.;
+
+constexpr float PROXIMATE_RANGE    = 6.f * NM;
+constexpr float PROXIMATE_ALTITUDE = 1'200.f;
+
+constexpr float TRAFFIC_TIME     = 40.f;  // seconds
+constexpr float TRAFFIC_RANGE    = .8f * NM;
+constexpr float TRAFFIC_ALTITUDE = 850.f;
+
+constexpr float RESOLUTION_TIME     = 25.f;  // seconds
+constexpr float RESOLUTION_RANGE    = .55f * NM;
+constexpr float RESOLUTION_ALTITUDE = 600.f;
+
+// Nothing outside can raise an alert below 1200 knots and 6000 feet/minute of closure
+constexpr double BOX_RANGE    = 15. * NM;
+constexpr double BOX_ALTITUDE = PROXIMATE_ALTITUDE + TRAFFIC_TIME * 100.;
+
+// Below, the aircraft fly together and the closest point is now
+constexpr float MIN_CLOSURE = 1e-3f;  // (feet/second)^2
+
+int32_t
+Level(float x, float y, float z, float vx, float vy, float vz) {
+   auto const closure = vx * vx + vy * vy;
+   auto const time = closure > MIN_CLOSURE ? std::max(0.f, -(x * vx + y * vy) / closure) : 0.f;
+
+   auto const miss_x = x + vx * time;
+   auto const miss_y = y + vy * time;
+   auto const miss   = miss_x * miss_x + miss_y * miss_y;
+   auto const miss_z = std::abs(z + vz * time);
+
+   auto const traffic = time <= TRAFFIC_TIME && miss <= TRAFFIC_RANGE * TRAFFIC_RANGE
+                        && miss_z <= TRAFFIC_ALTITUDE;
+   auto const resolution = traffic && time <= RESOLUTION_TIME
+                           && miss <= RESOLUTION_RANGE * RESOLUTION_RANGE
+                           && miss_z <= RESOLUTION_ALTITUDE;
+   auto const proximate = traffic
+                          || (x * x + y * y <= PROXIMATE_RANGE * PROXIMATE_RANGE
+                              && std::abs(z) <= PROXIMATE_ALTITUDE);
+
+   return static_cast<int32_t>(proximate) + traffic + resolution;
+}
+
+}  // namespace
+
+void
+ConflictDetector::Detect(
+  TrafficInfo const&     user,
+  ConflictTargets const& targets,
+  std::span<Alert>       alerts
+) {
+   auto const size = targets.lats_.size();
+   assert(alerts.size() == size);
+
+   std::ranges::fill(alerts, Alert::NONE);
+   if (user.sim_on_ground_) {
+      return;
+   }
+
+   rows_.clear();
+   xs_.clear();
+   ys_.clear();
+   zs_.clear();
+   vxs_.clear();
+   vys_.clear();
+   vzs_.clear();
+
+   auto const cos_lat = std::cos(user.lat_ * DEG);
+   auto const lat_box = BOX_RANGE / EARTH_RADIUS / DEG;
+   // Every longitude is close to the poles
+   auto const lon_box = cos_lat * 180. > lat_box ? lat_box / cos_lat : 180.;
+
+   for (std::size_t row = 0; row < size; ++row) {
+      if (targets.on_ground_[row]) {
+         continue;
+      }
+
+      auto const dz = targets.altitudes_[row] - user.altitude_;
+      if (std::abs(dz) > BOX_ALTITUDE) {
+         continue;
+      }
+
+      auto const dlat = targets.lats_[row] - user.lat_;
+      if (std::abs(dlat) > lat_box) {
+         continue;
+      }
+
+      auto const dlon = std::remainder(targets.lons_[row] - user.lon_, 360.);
+      if (std::abs(dlon) > lon_box) {
+         continue;
+      }
+
+      rows_.emplace_back(row);
+      xs_.emplace_back(static_cast<float>(dlon * DEG * cos_lat * EARTH_RADIUS));
+      ys_.emplace_back(static_cast<float>(dlat * DEG * EARTH_RADIUS));
+      zs_.emplace_back(static_cast<float>(dz));
+      vxs_.emplace_back(
+        static_cast<float>(targets.east_velocities_[row] - user.world_lon_velocity_)
+      );
+      vys_.emplace_back(
+        static_cast<float>(targets.north_velocities_[row] - user.world_lat_velocity_)
+      );
+      vzs_.emplace_back(
+        static_cast<float>(targets.vertical_velocities_[row] - user.world_vertical_velocity_)
+      );
+   }
+
+   levels_.resize(rows_.size());
+   Compute(rows_.size());
+
+   for (std::size_t index = 0; index < rows_.size(); ++index) {
+      alerts[rows_[index]] = static_cast<Alert>(levels_[index]);
+   }
+}
+
+void
+ConflictDetector::Compute(std::size_t size) {
+   std::size_t index = 0;
+
+#ifdef SMC_CONFLICTS_SSE2
+   // Same as Level, the conditions are lane masks (all ones when true, that is -1)
+   auto const zero          = _mm_setzero_ps();
+   auto const abs_mask      = _mm_castsi128_ps(_mm_set1_epi32(0x7fff'ffff));
+   auto const min_closure   = _mm_set1_ps(MIN_CLOSURE);
+   auto const proximate_r2  = _mm_set1_ps(PROXIMATE_RANGE * PROXIMATE_RANGE);
+   auto const proximate_z   = _mm_set1_ps(PROXIMATE_ALTITUDE);
+   auto const traffic_t     = _mm_set1_ps(TRAFFIC_TIME);
+   auto const traffic_r2    = _mm_set1_ps(TRAFFIC_RANGE * TRAFFIC_RANGE);
+   auto const traffic_z     = _mm_set1_ps(TRAFFIC_ALTITUDE);
+   auto const resolution_t  = _mm_set1_ps(RESOLUTION_TIME);
+   auto const resolution_r2 = _mm_set1_ps(RESOLUTION_RANGE * RESOLUTION_RANGE);
+   auto const resolution_z  = _mm_set1_ps(RESOLUTION_ALTITUDE);
+
+   for (; index + 4 <= size; index += 4) {
+      auto const x  = _mm_loadu_ps(xs_.data() + index);
+      auto const y  = _mm_loadu_ps(ys_.data() + index);
+      auto const z  = _mm_loadu_ps(zs_.data() + index);
+      auto const vx = _mm_loadu_ps(vxs_.data() + index);
+      auto const vy = _mm_loadu_ps(vys_.data() + index);
+      auto const vz = _mm_loadu_ps(vzs_.data() + index);
+
+      auto const closure = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+      auto const dot     = _mm_add_ps(_mm_mul_ps(x, vx), _mm_mul_ps(y, vy));
+      auto const time    = _mm_and_ps(
+        _mm_cmpgt_ps(closure, min_closure),
+        _mm_max_ps(zero, _mm_div_ps(_mm_sub_ps(zero, dot), _mm_max_ps(closure, min_closure)))
+      );
+
+      auto const miss_x = _mm_add_ps(x, _mm_mul_ps(vx, time));
+      auto const miss_y = _mm_add_ps(y, _mm_mul_ps(vy, time));
+      auto const miss   = _mm_add_ps(_mm_mul_ps(miss_x, miss_x), _mm_mul_ps(miss_y, miss_y));
+      auto const miss_z = _mm_and_ps(abs_mask, _mm_add_ps(z, _mm_mul_ps(vz, time)));
+
+      auto const traffic = _mm_and_ps(
+        _mm_and_ps(_mm_cmple_ps(time, traffic_t), _mm_cmple_ps(miss, traffic_r2)),
+        _mm_cmple_ps(miss_z, traffic_z)
+      );
+      auto const resolution = _mm_and_ps(
+        _mm_and_ps(traffic, _mm_cmple_ps(time, resolution_t)),
+        _mm_and_ps(_mm_cmple_ps(miss, resolution_r2), _mm_cmple_ps(miss_z, resolution_z))
+      );
+      auto const range     = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+      auto const proximate = _mm_or_ps(
+        traffic,
+        _mm_and_ps(
+          _mm_cmple_ps(range, proximate_r2), _mm_cmple_ps(_mm_and_ps(abs_mask, z), proximate_z)
+        )
+      );
+
+      auto const level = _mm_sub_epi32(
+        _mm_setzero_si128(),
+        _mm_add_epi32(
+          _mm_add_epi32(_mm_castps_si128(proximate), _mm_castps_si128(traffic)),
+          _mm_castps_si128(resolution)
+        )
+      );
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(levels_.data() + index), level);
+   }
+#endif
+
+   for (; index < size; ++index) {
+      levels_[index] =
+        Level(xs_[index], ys_[index], zs_[index], vxs_[index], vys_[index], vzs_[index]);
+   }
+}
+
+}  // namespace smc
@@ -0,0 +1,71 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Data/TrafficInfo.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace smc {
+
+// TCAS like alert levels, from the lowest
+enum class Alert : uint8_t {
+   NONE,
+   // Within 6 NM and 1200 feet
+   PROXIMATE,
+   // Closest point of approach within 40 seconds, 0.8 NM and 850 feet
+   TRAFFIC,
+   // Closest point of approach within 25 seconds, 0.55 NM and 600 feet
+   RESOLUTION,
+};
+
+// Positions and world velocities of the aircraft around the user, one row per aircraft
+struct ConflictTargets {
+   std::span<double const>  lats_{};                 // degrees
+   std::span<double const>  lons_{};                 // degrees
+   std::span<double const>  altitudes_{};            // feet
+   std::span<double const>  north_velocities_{};     // feet/second
+   std::span<double const>  east_velocities_{};      // feet/second
+   std::span<double const>  vertical_velocities_{};  // feet/second
+   std::span<uint8_t const> on_ground_{};
+};
+
+// Closest point of approach of every target against the user aircraft. The targets outside of a
+// box around the user are dropped first, the others are projected on a plane tangent at the user
+// position and checked 4 at a time.
+class ConflictDetector {
+public:
+   // alerts has one row per target
+   void Detect(TrafficInfo const& user, ConflictTargets const& targets, std::span<Alert> alerts);
+
+private:
+   void Compute(std::size_t size);
+
+   // Rows kept by the box, relative to the user aircraft in feet and feet/second
+   std::vector<std::size_t> rows_{};
+   std::vector<float>       xs_{};
+   std::vector<float>       ys_{};
+   std::vector<float>       zs_{};
+   std::vector<float>       vxs_{};
+   std::vector<float>       vys_{};
+   std::vector<float>       vzs_{};
+   std::vector<int32_t>     levels_{};
+};
+
+}  // namespace smc
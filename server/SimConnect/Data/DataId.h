@@ -0,0 +1,69 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+namespace smc {
+
+// Data definitions registered on each connection, their value is the SimConnect define id
+enum class DataId : uint32_t {
+   SET_PORT,
+   EVENT_FRAME,
+   TRAFFIC,
+   TRAFFIC_INFO,
+   TRAFFIC_STATIC_INFO,
+   HELI_TRAFFIC_INFO,
+   TRAFFIC_POSITION,
+   HELI_TRAFFIC_POSITION,
+   TAGGED_TRAFFIC_INFO,
+   TAXIWAY_PATH,
+   USER_INFO,
+   GROUND_INFO,
+
+   SET_WAYPOINTS,
+   WAYPOINT_INDEX,
+   SET_AI_HEADING,
+   SET_AI_SPEED,
+
+   GET_SIMRATE,
+
+   GET_AIRPORT_FACILITY,
+
+   SET_AIRSPEED_CONTROL,
+   SET_ALTITUDE_CONTROL,
+   SET_BANK_CONTROL,
+   SET_BREAK,
+   SET_CONTROL_SURFACES,
+   SET_FLAPS,
+   SET_GEAR,
+   SET_GROUND_ALTITUDE_CONTROL,
+   SET_GROUND_ALTITUDE,
+   SET_HEADING_CONTROL,
+   SET_ON_GROUND,
+   SET_PITCH_CONTROL,
+   SET_ROTATION_CONTROL,
+   SET_SPEED_CONTROL,
+   SET_VSPEED_CONTROL,
+   SET_THROTTLE,
+
+   SET_INIT_POSISION,
+
+   MAX_VALUE,
+};
+
+}  // namespace smc
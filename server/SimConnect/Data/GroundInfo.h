@@ -24,12 +24,28 @@ namespace smc {
 struct GroundInfo {
    float altitude_{};
 
+   // Where the object was when sampled, a moved terrain probe may not be there yet
+   double lat_{};
+   double lon_{};
+
    static constexpr auto MEMBERS = std::make_tuple(
      smc::_m{
        &GroundInfo::altitude_,
        "Ground Altitude",
        smc::_t<SIMCONNECT_DATATYPE_FLOAT32>{},
        "feet",
+     },
+     smc::_m{
+       &GroundInfo::lat_,
+       "PLANE LATITUDE",
+       smc::_t<SIMCONNECT_DATATYPE_FLOAT64>{},
+       "degrees",
+     },
+     smc::_m{
+       &GroundInfo::lon_,
+       "PLANE LONGITUDE",
+       smc::_t<SIMCONNECT_DATATYPE_FLOAT64>{},
+       "degrees",
      }
    );
 };
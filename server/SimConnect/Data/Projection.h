@@ -0,0 +1,66 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace smc {
+
+template <auto MEMBER, auto... FIELDS>
+inline constexpr bool IS_PROJECTED = ([] {
+   if constexpr (std::is_same_v<decltype(MEMBER), decltype(FIELDS)>) {
+      return MEMBER == FIELDS;
+   } else {
+      return false;
+   }
+}() || ...);
+
+// The entries of T::MEMBERS for FIELDS, in the T::MEMBERS order
+template <class T, auto... FIELDS>
+constexpr auto
+Project() {
+   constexpr auto COUNT = std::tuple_size_v<std::remove_cvref_t<decltype(T::MEMBERS)>>;
+
+   return []<std::size_t... INDEX>(std::index_sequence<INDEX...>) constexpr {
+      return std::tuple_cat([]<std::size_t I>(std::integral_constant<std::size_t, I>) constexpr {
+         constexpr auto MEMBER = std::get<I>(T::MEMBERS);
+         if constexpr (IS_PROJECTED<MEMBER.member_, FIELDS...>) {
+            return std::make_tuple(MEMBER);
+         } else {
+            return std::tuple<>{};
+         }
+      }(std::integral_constant<std::size_t, INDEX>{})...);
+   }(std::make_index_sequence<COUNT>{});
+}
+
+// T requesting only FIELDS (members of T, listed in T::MEMBERS), registered under its own DataId.
+// Its packets only hold those fields, the other members are left value initialized :
+//   using TrafficPosition = Projection<TrafficInfo, &TrafficInfo::lat_, &TrafficInfo::lon_>;
+template <class T, auto... FIELDS>
+struct Projection : T {
+   static constexpr auto MEMBERS = Project<T, FIELDS...>();
+
+   static_assert(
+     std::tuple_size_v<std::remove_cvref_t<decltype(MEMBERS)>> == sizeof...(FIELDS),
+     "Every field must be listed once in T::MEMBERS"
+   );
+};
+
+}  // namespace smc
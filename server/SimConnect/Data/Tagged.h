@@ -0,0 +1,71 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Projection.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace smc {
+
+// Index of MEMBER in T::MEMBERS
+template <class T, auto MEMBER>
+constexpr std::size_t
+MemberIndex() {
+   constexpr auto COUNT = std::tuple_size_v<std::remove_cvref_t<decltype(T::MEMBERS)>>;
+
+   return []<std::size_t... INDEX>(std::index_sequence<INDEX...>) constexpr {
+      std::size_t index = COUNT;
+      (void)((IS_PROJECTED<std::get<INDEX>(T::MEMBERS).member_, MEMBER> && (index = INDEX, true))
+             || ...);
+      return index;
+   }(std::make_index_sequence<COUNT>{});
+}
+
+// T fed by changed-only samples (SIMCONNECT_DATA_REQUEST_FLAG_CHANGED | TAGGED) : each sample
+// only holds the (datum id, value) pairs that changed, they are applied onto the last value
+template <class T>
+struct Tagged {
+   static constexpr std::size_t FIELDS =
+     std::tuple_size_v<std::remove_cvref_t<decltype(T::MEMBERS)>>;
+   static_assert(FIELDS <= 64, "The dirty mask holds 64 fields");
+
+   T value_{};
+
+   // Bit I is set when std::get<I>(T::MEMBERS) was received by the last sample
+   uint64_t dirty_{};
+
+   template <auto MEMBER>
+   [[nodiscard]] constexpr bool Dirty() const {
+      constexpr auto INDEX = MemberIndex<T, MEMBER>();
+      static_assert(INDEX < FIELDS, "Not listed in T::MEMBERS");
+
+      return (dirty_ >> INDEX) & 1;
+   }
+};
+
+template <class T>
+inline constexpr bool IS_TAGGED = false;
+
+template <class T>
+inline constexpr bool IS_TAGGED<Tagged<T>> = true;
+
+}  // namespace smc
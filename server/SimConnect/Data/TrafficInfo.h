@@ -16,6 +16,7 @@
 #pragma once
 
 #include "DataType.h"
+#include "Projection.h"
 
 #include <algorithm>
 #include <array>
@@ -316,4 +317,18 @@ struct TrafficInfo {
    );
 };
 
+// What the traffic display and the conflict alerts use, 10 of the TrafficInfo SimVars
+using TrafficPosition = Projection<
+  TrafficInfo,
+  &TrafficInfo::altitude_,
+  &TrafficInfo::lat_,
+  &TrafficInfo::lon_,
+  &TrafficInfo::ground_velocity_,
+  &TrafficInfo::true_heading_,
+  &TrafficInfo::sim_on_ground_,
+  &TrafficInfo::vspeed_,
+  &TrafficInfo::world_vertical_velocity_,
+  &TrafficInfo::world_lat_velocity_,
+  &TrafficInfo::world_lon_velocity_>;
+
 }  // namespace smc
\ No newline at end of file
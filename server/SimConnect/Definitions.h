@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Windows.h>
+#include <SimConnect.h>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace smc {
+
+// Registration of the definitions declared by T::MEMBERS (T::SECTIONS for facilities) under the
+// define id, on an open connection. False as soon as SimConnect refuses a field
+
+inline bool
+AddToDataDefinition(
+  HANDLE                          handle,
+  SIMCONNECT_DATA_DEFINITION_ID   define_id,
+  std::string_view                datum_name,
+  SIMCONNECT_DATATYPE             datum_type,
+  std::optional<std::string_view> units_name,
+  std::optional<DWORD>            group_id
+) {
+   return SimConnect_AddToDataDefinition(
+            handle,
+            define_id,
+            datum_name.data(),
+            units_name ? units_name->data() : nullptr,
+            datum_type,
+            0,
+            group_id.value_or(SIMCONNECT_UNUSED)
+          )
+          == S_OK;
+}
+
+template <class T>
+bool
+AddToDataDefinition(HANDLE handle, SIMCONNECT_DATA_DEFINITION_ID define_id) {
+   return std::apply(
+     [&](auto&&... member) constexpr {
+        return (
+          AddToDataDefinition(
+            handle,
+            define_id,
+            std::get<1>(member),
+            std::get<2>(member).VALUE_S,
+            std::get<3>(member),
+            std::get<4>(member)
+          )
+          && ...
+        );
+     },
+     T::MEMBERS
+   );
+}
+
+// The datum ids are the indexes in T::MEMBERS, as read by wire::ApplyTagged
+template <class T>
+bool
+AddToTaggedDataDefinition(HANDLE handle, SIMCONNECT_DATA_DEFINITION_ID define_id) {
+   return [&]<std::size_t... INDEX>(std::index_sequence<INDEX...>) constexpr {
+      return (
+        [&]<std::size_t I>(std::integral_constant<std::size_t, I>) constexpr {
+           auto const& member = std::get<I>(T::MEMBERS);
+           return AddToDataDefinition(
+             handle,
+             define_id,
+             std::get<1>(member),
+             std::get<2>(member).VALUE_S,
+             std::get<3>(member),
+             static_cast<DWORD>(I)
+           );
+        }(std::integral_constant<std::size_t, INDEX>{})
+        && ...
+      );
+   }(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<decltype(T::MEMBERS)>>>{});
+}
+
+inline bool
+AddToFacilityDefinition(
+  HANDLE                        handle,
+  SIMCONNECT_DATA_DEFINITION_ID define_id,
+  std::string_view              field_name
+) {
+   return SimConnect_AddToFacilityDefinition(handle, define_id, field_name.data()) == S_OK;
+}
+
+template <class T>
+bool
+AddToFacilityDefinition(HANDLE handle, SIMCONNECT_DATA_DEFINITION_ID define_id) {
+   if constexpr (requires { T::MEMBERS; }) {
+      if (!std::apply(
+            [&](auto&&... member) constexpr {
+               return (AddToFacilityDefinition(handle, define_id, std::get<0>(member)) && ...);
+            },
+            T::MEMBERS
+          )) {
+         return false;
+      }
+   }
+
+   if constexpr (requires { T::SECTIONS; }) {
+      if (!std::apply(
+            [&](auto&&... members) constexpr {
+               return (
+                 [&](auto&& member) constexpr {
+                    if (!AddToFacilityDefinition(
+                          handle, define_id, "OPEN " + std::string{std::get<0>(member)}
+                        )) {
+                       return false;
+                    }
+
+                    using MEMBER =
+                      std::remove_cvref_t<decltype(std::declval<T>().*std::get<1>(member))>;
+                    if constexpr (requires { typename MEMBER::value_type; }) {
+                       if (!AddToFacilityDefinition<typename MEMBER::value_type>(
+                             handle, define_id
+                           )) {
+                          return false;
+                       }
+                    } else {
+                       if (!AddToFacilityDefinition<MEMBER>(handle, define_id)) {
+                          return false;
+                       }
+                    }
+
+                    return AddToFacilityDefinition(
+                      handle, define_id, "CLOSE " + std::string{std::get<0>(member)}
+                    );
+                 }(members)
+                 && ...
+               );
+            },
+            T::SECTIONS
+          )) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+}  // namespace smc
@@ -0,0 +1,250 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AirportCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace smc::facility {
+
+namespace {
+
+// File layout : "SMCAPT01", the airport position (3 doubles), then for each section the size of
+// its items (uint32), their count (uint32) and their bytes
+constexpr std::string_view MAGIC = "SMCAPT01";
+
+// Bigger sections are corrupted files
+constexpr std::size_t MAX_SECTION_SIZE = 64 * 1024 * 1024;
+
+template <class T>
+void
+WriteSection(std::ofstream& file, std::vector<T> const& items) {
+   static_assert(std::is_trivially_copyable_v<T>);
+
+   uint32_t const header[] = {sizeof(T), static_cast<uint32_t>(items.size())};
+   file.write(reinterpret_cast<char const*>(header), sizeof(header));
+   file.write(reinterpret_cast<char const*>(items.data()), items.size() * sizeof(T));
+}
+
+template <class T>
+bool
+ReadSection(std::ifstream& file, std::vector<T>& items) {
+   static_assert(std::is_trivially_copyable_v<T>);
+
+   uint32_t header[2]{};
+   file.read(reinterpret_cast<char*>(header), sizeof(header));
+
+   // Written by a build with another layout
+   if (!file || (header[0] != sizeof(T)) || (header[1] * sizeof(T) > MAX_SECTION_SIZE)) {
+      return false;
+   }
+
+   items.resize(header[1]);
+   file.read(reinterpret_cast<char*>(items.data()), items.size() * sizeof(T));
+   return static_cast<bool>(file);
+}
+
+}  // namespace
+
+AirportCache::AirportCache(std::optional<std::filesystem::path> path)
+   : path_{std::move(path)} {}
+
+void
+AirportCache::SetVersion(std::string version) {
+   if (version == version_) {
+      return;
+   }
+
+   version_ = std::move(version);
+   entries_.clear();
+   index_.clear();
+
+   if (!path_) {
+      return;
+   }
+
+   try {
+      std::filesystem::create_directories(*path_ / version_);
+
+      for (auto const& entry : std::filesystem::directory_iterator{*path_}) {
+         if (entry.path().filename() != version_) {
+            std::filesystem::remove_all(entry.path());
+         }
+      }
+   } catch (std::exception const& e) {
+      std::cerr << "Airport cache: " << e.what() << std::endl;
+   }
+}
+
+std::string
+AirportCache::Key(std::string_view icao, std::string_view region) {
+   return std::string{icao} + "_" + std::string{region};
+}
+
+std::optional<std::filesystem::path>
+AirportCache::Path(std::string const& key) const {
+   if (
+     !path_ || version_.empty()
+     || !std::ranges::all_of(key, [](char c) {
+           return std::isalnum(static_cast<unsigned char>(c)) || (c == '_');
+        })
+   ) {
+      return std::nullopt;
+   }
+
+   return *path_ / version_ / (key + ".apt");
+}
+
+std::optional<AirportData>
+AirportCache::Get(std::string_view icao, std::string_view region) {
+   auto const key = Key(icao, region);
+
+   if (auto const it = index_.find(key); it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->second;
+   }
+
+   if (auto const path = Path(key)) {
+      if (auto airport = Read(*path)) {
+         Remember(key, *airport);
+         return airport;
+      }
+   }
+
+   return std::nullopt;
+}
+
+void
+AirportCache::Put(std::string_view icao, std::string_view region, AirportData const& airport) {
+   auto const key = Key(icao, region);
+
+   Remember(key, airport);
+   if (auto const path = Path(key)) {
+      Write(*path, airport);
+   }
+}
+
+void
+AirportCache::Remember(std::string const& key, AirportData const& airport) {
+   if (auto const it = index_.find(key); it != index_.end()) {
+      it->second->second = airport;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return;
+   }
+
+   entries_.emplace_front(key, airport);
+   index_.emplace(key, entries_.begin());
+
+   if (entries_.size() > MAX_ENTRIES) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+   }
+}
+
+void
+AirportCache::Invalidate(std::string_view icao, std::string_view region) {
+   auto const key = Key(icao, region);
+
+   if (auto const it = index_.find(key); it != index_.end()) {
+      entries_.erase(it->second);
+      index_.erase(it);
+   }
+
+   if (auto const path = Path(key)) {
+      std::error_code ec{};
+      std::filesystem::remove(*path, ec);
+   }
+}
+
+void
+AirportCache::Clear() {
+   entries_.clear();
+   index_.clear();
+
+   if (path_) {
+      std::error_code ec{};
+      std::filesystem::remove_all(*path_, ec);
+      if (!version_.empty()) {
+         std::filesystem::create_directories(*path_ / version_, ec);
+      }
+   }
+}
+
+std::optional<AirportData>
+AirportCache::Read(std::filesystem::path const& path) const {
+   std::ifstream file{path, std::ios::binary};
+   if (!file) {
+      return std::nullopt;
+   }
+
+   std::string magic(MAGIC.size(), '\0');
+   file.read(magic.data(), magic.size());
+
+   AirportData airport{};
+   file.read(reinterpret_cast<char*>(&airport.lat_), sizeof(airport.lat_));
+   file.read(reinterpret_cast<char*>(&airport.lon_), sizeof(airport.lon_));
+   file.read(reinterpret_cast<char*>(&airport.altitude_), sizeof(airport.altitude_));
+
+   if (
+     !file || (magic != MAGIC) || !ReadSection(file, airport.runways_)
+     || !ReadSection(file, airport.taxi_points_) || !ReadSection(file, airport.taxi_parkings_)
+     || !ReadSection(file, airport.taxi_names_) || !ReadSection(file, airport.taxi_paths_)
+   ) {
+      file.close();
+
+      std::error_code ec{};
+      std::filesystem::remove(path, ec);
+      return std::nullopt;
+   }
+
+   return airport;
+}
+
+void
+AirportCache::Write(std::filesystem::path const& path, AirportData const& airport) {
+   try {
+      {
+         std::ofstream file{path.string() + ".tmp", std::ios::binary | std::ios::trunc};
+         file.write(MAGIC.data(), MAGIC.size());
+         file.write(reinterpret_cast<char const*>(&airport.lat_), sizeof(airport.lat_));
+         file.write(reinterpret_cast<char const*>(&airport.lon_), sizeof(airport.lon_));
+         file.write(reinterpret_cast<char const*>(&airport.altitude_), sizeof(airport.altitude_));
+
+         WriteSection(file, airport.runways_);
+         WriteSection(file, airport.taxi_points_);
+         WriteSection(file, airport.taxi_parkings_);
+         WriteSection(file, airport.taxi_names_);
+         WriteSection(file, airport.taxi_paths_);
+
+         if (!file) {
+            throw std::runtime_error("Couldn't write " + path.string());
+         }
+      }
+
+      std::filesystem::rename(path.string() + ".tmp", path);
+   } catch (std::exception const& e) {
+      std::cerr << "Airport cache: " << e.what() << std::endl;
+   }
+}
+
+}  // namespace smc::facility
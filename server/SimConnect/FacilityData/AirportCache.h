@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "AirportFacility.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace smc::facility {
+
+// Airports received from the simulator, the MAX_ENTRIES most recently used ones in memory and all
+// of them on disk (<path>/<version>/<icao>_<region>.apt) when a path is given.
+// The version identifies the simulator build, the other versions are dropped when it changes.
+// Scenery changes aren't reported by SimConnect, they are invalidated explicitly.
+class AirportCache {
+public:
+   static constexpr std::size_t MAX_ENTRIES = 32;
+
+   AirportCache(std::optional<std::filesystem::path> path);
+
+   void SetVersion(std::string version);
+
+   std::optional<AirportData> Get(std::string_view icao, std::string_view region);
+   void Put(std::string_view icao, std::string_view region, AirportData const& airport);
+
+   void Invalidate(std::string_view icao, std::string_view region);
+   void Clear();
+
+private:
+   using Entries = std::list<std::pair<std::string, AirportData>>;
+
+   static std::string Key(std::string_view icao, std::string_view region);
+
+   // Disk entries are only used for plain idents, they come from the EFB
+   std::optional<std::filesystem::path> Path(std::string const& key) const;
+
+   std::optional<AirportData> Read(std::filesystem::path const& path) const;
+   void                       Write(std::filesystem::path const& path, AirportData const& airport);
+
+   void Remember(std::string const& key, AirportData const& airport);
+
+   std::optional<std::filesystem::path> const path_;
+   std::string                                version_{};
+
+   // Most recently used first
+   Entries                                            entries_{};
+   std::unordered_map<std::string, Entries::iterator> index_{};
+};
+
+}  // namespace smc::facility
@@ -23,10 +23,8 @@
 
 namespace smc::facility {
 
-template struct ProcessorImpl<AirportData::Runway::Threshold>;
-template struct ProcessorImpl<AirportData::Runway>;
-template struct ProcessorImpl<AirportData>;
-template struct ProcessorImpl<Airport>;
+template class Decoder<AirportData>;
+template class Decoder<Airport>;
 
 std::vector<AirportData::TaxiPoint>::const_iterator
 AirportData::FindClosestTaxiPoint(Coords<2> position) const {
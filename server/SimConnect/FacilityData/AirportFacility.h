@@ -24,8 +24,8 @@
 
 namespace smc::facility {
 
-struct AirportData : ProcessorImpl<AirportData> {
-   struct Runway : ProcessorImpl<Runway> {
+struct AirportData {
+   struct Runway {
       enum class Designator : int32_t {
          NONE   = 0,
          LEFT   = 1,
@@ -49,11 +49,10 @@ struct AirportData : ProcessorImpl<AirportData> {
       int32_t    sec_number_{};
       Designator sec_designator_{};
 
-      struct Threshold : ProcessorImpl<Threshold> {
+      struct Threshold {
          float   length_{};
          int32_t enabled_{};
 
-         using ProcessorImpl::GetProcessor;
          static constexpr auto MEMBERS =
            std::make_tuple(_m("LENGTH", &Threshold::length_), _m("ENABLE", &Threshold::enabled_));
       };
@@ -90,7 +89,6 @@ struct AirportData : ProcessorImpl<AirportData> {
          return std::to_string(sec_number_) + GetDesignatorString(sec_designator_);
       }
 
-      using ProcessorImpl::GetProcessor;
       static constexpr auto MEMBERS = std::make_tuple(
         _m("LATITUDE", &Runway::latitude_),
         _m("LONGITUDE", &Runway::longitude_),
@@ -110,7 +108,7 @@ struct AirportData : ProcessorImpl<AirportData> {
    };
    std::vector<Runway> runways_{};
 
-   struct TaxiPath : ProcessorImpl<TaxiPath> {
+   struct TaxiPath {
       enum class Type : int32_t {
          NONE        = 0,
          TAXI        = 1,
@@ -131,7 +129,6 @@ struct AirportData : ProcessorImpl<AirportData> {
       int32_t end_{};
       int32_t name_index_{};
 
-      using ProcessorImpl::GetProcessor;
       static constexpr auto MEMBERS = std::make_tuple(
         _m("TYPE", &TaxiPath::type_),
         _m("RUNWAY_NUMBER", &TaxiPath::runway_number_),
@@ -143,15 +140,14 @@ struct AirportData : ProcessorImpl<AirportData> {
    };
    std::vector<TaxiPath> taxi_paths_{};
 
-   struct TaxiName : ProcessorImpl<TaxiName> {
+   struct TaxiName {
       std::array<char, 32> name_{};
 
-      using ProcessorImpl::GetProcessor;
       static constexpr auto MEMBERS = std::make_tuple(_m("NAME", &TaxiName::name_));
    };
    std::vector<TaxiName> taxi_names_{};
 
-   struct TaxiPoint : ProcessorImpl<TaxiPoint> {
+   struct TaxiPoint {
       enum class Type : int32_t {
          NONE                   = 0,
          NORMAL                 = 1,
@@ -169,7 +165,6 @@ struct AirportData : ProcessorImpl<AirportData> {
       float       x_{};  // meters offset from airport reference point
       float       y_{};  // meters offset from airport reference point
 
-      using ProcessorImpl::GetProcessor;
       static constexpr auto MEMBERS = std::make_tuple(
         _m("TYPE", &TaxiPoint::type_),
         _m("ORIENTATION", &TaxiPoint::orientation_),
@@ -179,7 +174,7 @@ struct AirportData : ProcessorImpl<AirportData> {
    };
    std::vector<TaxiPoint> taxi_points_{};
 
-   struct TaxiParking : ProcessorImpl<TaxiParking> {
+   struct TaxiParking {
       enum class ParkingType : int32_t {
          NONE            = 0,
          RAMP_GA         = 1,
@@ -224,7 +219,6 @@ struct AirportData : ProcessorImpl<AirportData> {
       float x_{};  // meters offset from airport reference point
       float y_{};  // meters offset from airport reference point
 
-      using ProcessorImpl::GetProcessor;
       static constexpr auto MEMBERS = std::make_tuple(
         _m("TYPE", &TaxiParking::parking_type_),
         _m("TAXI_POINT_TYPE", &TaxiParking::type_),
@@ -246,8 +240,6 @@ struct AirportData : ProcessorImpl<AirportData> {
      std::vector<TaxiPoint>::const_iterator to
    ) const;
 
-   using ProcessorImpl::GetProcessor;
-
    double lat_{};
    double lon_{};
    double altitude_{};
@@ -266,10 +258,9 @@ struct AirportData : ProcessorImpl<AirportData> {
    );
 };
 
-struct Airport : ProcessorImpl<Airport> {
+struct Airport {
    AirportData data_{};
 
-   using ProcessorImpl::GetProcessor;
    static constexpr auto SECTIONS = std::make_tuple(_m("AIRPORT", &Airport::data_));
 };
 
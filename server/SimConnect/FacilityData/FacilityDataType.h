@@ -13,15 +13,19 @@
  * not, see <https://www.gnu.org/licenses/>.
  */
 
+
 #pragma once
 
 #include <Windows.h>
 #include <SimConnect.h>
-#include <functional>
-#include <memory>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <type_traits>
 
 namespace smc::facility {
 
@@ -32,26 +36,94 @@ struct _m : std::tuple<std::string_view, T CLASS::*> {
 template <class CLASS, class T>
 _m(std::string_view name, T CLASS::* member) -> _m<CLASS, T>;
 
-struct Processor;
-using ProcessorReturn = std::tuple<std::shared_ptr<Processor>, std::string>;
+// Facility types describe their fields with MEMBERS and their nested facilities with SECTIONS
+// (std::vector members being list sections). Both are compiled into the tables below.
+struct DecoderNode;
+
+struct DecoderSection {
+   std::string_view name_;
+   bool             list_;
+
+   // Object receiving the section data, appended first for list sections
+   void* (*enter_)(void* parent);
+   DecoderNode const* node_;
+};
+
+struct DecoderNode {
+   // Empty on success
+   std::string (*members_)(void* object, SIMCONNECT_RECV_FACILITY_DATA const& data);
+   std::span<DecoderSection const> sections_;
+};
 
-struct Processor : std::function<ProcessorReturn(SIMCONNECT_RECV_FACILITY_DATA const&)> {};
+template <class T, bool LIST>
+struct SectionItem {
+   using type = T;
+};
 
-template <class SELF>
-struct ProcessorImpl {
-protected:
-   std::shared_ptr<Processor>
-   GetProcessor(this SELF& self, std::shared_ptr<Processor> const& parent_processor = nullptr);
+template <class T>
+struct SectionItem<T, true> {
+   using type = typename T::value_type;
+};
+
+template <class SECTION>
+struct SectionTraits;
+
+template <class CLASS, class T>
+struct SectionTraits<_m<CLASS, T>> {
+   static constexpr bool LIST = requires(T& t) { t.emplace_back(); };
+
+   // Type of the facility (list item) holding the section data
+   using type = typename SectionItem<T, LIST>::type;
+};
+
+// Height of the facility tree
+template <class T>
+consteval std::size_t
+Depth() {
+   if constexpr (requires { T::SECTIONS; }) {
+      return 1
+             + std::apply(
+               [](auto const&... sections) {
+                  return std::max(
+                    {std::size_t{0},
+                     Depth<typename SectionTraits<std::remove_cvref_t<decltype(sections)>>::type>(
+                     )...}
+                  );
+               },
+               T::SECTIONS
+             );
+   } else {
+      return 1;
+   }
+}
+
+// Decodes the FACILITY_DATA stream of a ROOT facility : its members, then each of its sections
+// depth first. The position in the facility tree is a fixed size stack, nothing is allocated
+// besides the list items themselves.
+// Objects of the tree are referenced by the stack, non-list sections of ROOT must not move while
+// decoding.
+template <class ROOT>
+class Decoder {
+public:
+   // Empty on success
+   std::string Process(ROOT& root, SIMCONNECT_RECV_FACILITY_DATA const& data);
+
+   bool Started() const { return started_; }
+   bool Done() const { return started_ && !size_; }
 
 private:
-   template <class...>
-      requires(requires { SELF::MEMBERS; })
-   std::string ProcessMembers(this SELF& self, SIMCONNECT_RECV_FACILITY_DATA const& data);
-
-   template <std::size_t INDEX>
-      requires(requires { SELF::SECTIONS; })
-   std::shared_ptr<Processor>
-   MakeSectionProcessor(this SELF& self, std::shared_ptr<Processor> const& parent_processor);
+   struct Frame {
+      DecoderNode const* node_;
+      void*              object_;
+      std::size_t        section_;
+   };
+
+   std::string
+   Enter(DecoderNode const& node, void* object, SIMCONNECT_RECV_FACILITY_DATA const& data);
+
+   std::array<Frame, Depth<ROOT>()> stack_{};
+   std::size_t                      size_{0};
+   bool                             started_{false};
 };
 
 }  // namespace smc::facility
@@ -13,207 +13,168 @@
  * not, see <https://www.gnu.org/licenses/>.
  */
 
+
 #pragma once
 
 #include "FacilityDataType.h"
-#include "utils/Scoped.h"
+#include "../Utils/Packed.h"
+
 #include <cassert>
-#include <memory>
+#include <cstddef>
+#include <string>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace smc::facility {
 
-template <class>
-inline constexpr bool ALWAYS_FALSE = false;
+template <class MEMBERS>
+struct WireOf;
 
-template <class SELF>
-std::shared_ptr<Processor>
-ProcessorImpl<SELF>::GetProcessor(
-  this SELF&                        self,
-  std::shared_ptr<Processor> const& parent_processor
-) {
-   return std::make_shared<Processor>(
-     [&self,
-      parent_processor](SIMCONNECT_RECV_FACILITY_DATA const& data) constexpr -> ProcessorReturn {
-        if constexpr (requires { SELF::MEMBERS; }) {
-           auto const error = self.ProcessMembers(data);
-           if (error.size()) {
-              return std::make_tuple(nullptr, "Failed to process facility data: " + error);
-           }
-        }
-
-        if constexpr (requires { SELF::SECTIONS; }) {
-           auto processor = self.template MakeSectionProcessor<0>(parent_processor);
-           assert(processor);
-
-           return std::make_tuple(processor, "");
-        } else {
-           return std::make_tuple(parent_processor, "");
-        }
-     }
-   );
+template <class... CLASS, class... T>
+struct WireOf<std::tuple<_m<CLASS, T>...>> {
+   using type = Packed<T...>;
+};
+
+// Packet layout of T members, as declared by AddToFacilityDefinition
+template <class T>
+using Wire = typename WireOf<std::remove_cvref_t<decltype(T::MEMBERS)>>::type;
+
+template <class T>
+std::string
+DecodeMembers(void* object, SIMCONNECT_RECV_FACILITY_DATA const& data) {
+   if constexpr (!requires { T::MEMBERS; }) {
+      return {};
+   } else {
+      using WIRE = Wire<T>;
+      static_assert(
+        std::is_trivially_copyable_v<WIRE>, "Unsupported type for facility data member"
+      );
+
+      std::size_t const size =
+        data.dwSize + sizeof(data.Data) - sizeof(SIMCONNECT_RECV_FACILITY_DATA);
+      if (size < sizeof(WIRE)) {
+         return "Received data size " + std::to_string(size) + " is smaller than expected size "
+                + std::to_string(sizeof(WIRE)) + " for facility data members";
+      }
+      assert(size == sizeof(WIRE));
+
+      auto const wire = ReadPacked<WIRE>(&data.Data);
+      auto&      self = *static_cast<T*>(object);
+
+      [&]<std::size_t... INDEX>(std::index_sequence<INDEX...>) constexpr {
+         ((self.*std::get<1>(std::get<INDEX>(T::MEMBERS)) = Get<INDEX>(wire)), ...);
+      }(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<decltype(T::MEMBERS)>>>{});
+
+      return {};
+   }
+}
+
+template <class T, std::size_t INDEX>
+void*
+EnterSection(void* parent) {
+   auto const& [_, member] = std::get<INDEX>(T::SECTIONS);
+   auto&       section     = static_cast<T*>(parent)->*member;
+
+   if constexpr (SectionTraits<std::remove_cvref_t<decltype(std::get<INDEX>(T::SECTIONS))>>::LIST) {
+      return &section.emplace_back();
+   } else {
+      return &section;
+   }
+}
+
+template <class T>
+struct DecoderTable;
+
+template <class T, std::size_t INDEX>
+constexpr DecoderSection
+MakeDecoderSection() {
+   using TRAITS = SectionTraits<std::remove_cvref_t<decltype(std::get<INDEX>(T::SECTIONS))>>;
+
+   return {
+     .name_  = std::get<0>(std::get<INDEX>(T::SECTIONS)),
+     .list_  = TRAITS::LIST,
+     .enter_ = &EnterSection<T, INDEX>,
+     .node_  = &DecoderTable<typename TRAITS::type>::NODE,
+   };
+}
+
+template <class T>
+constexpr auto
+MakeDecoderSections() {
+   if constexpr (requires { T::SECTIONS; }) {
+      return []<std::size_t... INDEX>(std::index_sequence<INDEX...>) constexpr {
+         return std::array<DecoderSection, sizeof...(INDEX)>{MakeDecoderSection<T, INDEX>()...};
+      }(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<decltype(T::SECTIONS)>>>{});
+   } else {
+      return std::array<DecoderSection, 0>{};
+   }
 }
 
-template <class SELF>
-template <class...>
-   requires(requires { SELF::MEMBERS; })
+template <class T>
+struct DecoderTable {
+   static constexpr auto        SECTIONS = MakeDecoderSections<T>();
+   static constexpr DecoderNode NODE{.members_ = &DecodeMembers<T>, .sections_ = SECTIONS};
+};
+
+template <class ROOT>
 std::string
-ProcessorImpl<SELF>::ProcessMembers(this SELF& self, SIMCONNECT_RECV_FACILITY_DATA const& data) {
-   std::string error{};
-
-   std::size_t remaining_size =
-     data.dwSize + sizeof(data.Data) - sizeof(SIMCONNECT_RECV_FACILITY_DATA);
-   auto it = reinterpret_cast<std::byte const*>(&data.Data);
-   std::apply(
-     [&self, &error, &it, &remaining_size](auto const&... members) constexpr {
-        return (
-          [&self, &error, &it, &remaining_size](auto const& member) constexpr {
-             auto& member_ref = self.*std::get<1>(member);
-             if constexpr (
-               std::is_arithmetic_v<std::remove_cvref_t<decltype(member_ref)>>
-               || std::is_enum_v<std::remove_cvref_t<decltype(member_ref)>>
-             ) {
-                if (remaining_size < sizeof(member_ref)) {
-                   error = "Received data size " + std::to_string(remaining_size)
-                           + " is smaller than expected size for facility data member "
-                           + std::string{std::get<0>(member)};
-                   return false;
-                }
-
-                std::copy(it, it + sizeof(member_ref), reinterpret_cast<std::byte*>(&member_ref));
-                it += sizeof(member_ref);
-                remaining_size -= sizeof(member_ref);
-
-                return true;
-             } else if constexpr (requires {
-                                     typename std::remove_cvref_t<decltype(member_ref)>::value_type;
-                                     std::is_arithmetic_v<typename std::remove_cvref_t<
-                                       decltype(member_ref)>::value_type>
-                                       || std::is_enum_v<std::remove_cvref_t<decltype(member_ref)>>;
-                                     member_ref.size();
-                                  }) {
-                using value_type = typename std::remove_cvref_t<decltype(member_ref)>::value_type;
-
-                if (remaining_size < member_ref.size() * sizeof(value_type)) {
-                   error = "Received data size " + std::to_string(remaining_size)
-                           + " is smaller than expected size for facility data member "
-                           + std::string{std::get<0>(member)};
-                   return false;
-                }
-
-                std::copy(
-                  it,
-                  it + member_ref.size() * sizeof(value_type),
-                  reinterpret_cast<std::byte*>(member_ref.data())
-                );
-                it += member_ref.size() * sizeof(value_type);
-                remaining_size -= member_ref.size() * sizeof(value_type);
-
-                return true;
-             } else {
-                static_assert(
-                  ALWAYS_FALSE<decltype(member_ref)>, "Unsupported type for facility data member"
-                );
-             }
-          }(members)
-          && ...
-        );
-     },
-     SELF::MEMBERS
-   );
-
-   assert(error.size() || (remaining_size == 0));
-   return error;
+Decoder<ROOT>::Process(ROOT& root, SIMCONNECT_RECV_FACILITY_DATA const& data) {
+   if (!started_) {
+      // ROOT members
+      started_ = true;
+      return Enter(DecoderTable<ROOT>::NODE, &root, data);
+   }
+
+   if (!size_) {
+      return "Received facility data after the end of the facility";
+   }
+
+   stack_[0].object_ = &root;
+
+   auto&       frame   = stack_[size_ - 1];
+   auto const& section = frame.node_->sections_[frame.section_];
+
+   if (section.list_) {
+      if (!data.IsListItem) {
+         return "Received non-list data for list section " + std::string{section.name_};
+      }
+      assert(data.ItemIndex < data.ListSize);
+
+      if (data.ItemIndex + 1 >= data.ListSize) {
+         ++frame.section_;
+      }
+   } else {
+      if (data.IsListItem) {
+         return "Received unexpected list item for non-list section " + std::string{section.name_};
+      }
+
+      ++frame.section_;
+   }
+
+   return Enter(*section.node_, section.enter_(frame.object_), data);
 }
 
-template <class SELF>
-template <std::size_t INDEX>
-   requires(requires { SELF::SECTIONS; })
-std::shared_ptr<Processor>
-ProcessorImpl<SELF>::MakeSectionProcessor(
-  this SELF&                        self,
-  std::shared_ptr<Processor> const& parent_processor
+template <class ROOT>
+std::string
+Decoder<ROOT>::Enter(
+  DecoderNode const&                   node,
+  void*                                object,
+  SIMCONNECT_RECV_FACILITY_DATA const& data
 ) {
-   auto const process_ptr = std::make_shared<Processor>();
-   *process_ptr           = Processor{
-     [&self, parent_processor, self_processor = std::weak_ptr(process_ptr)](
-       SIMCONNECT_RECV_FACILITY_DATA const& data
-     ) constexpr mutable -> ProcessorReturn {
-        using SECTIONS_TYPE = std::remove_cvref_t<decltype(SELF::SECTIONS)>;
-        static_assert(INDEX < std::tuple_size_v<SECTIONS_TYPE>);
-
-        auto const self_ptr = self_processor.lock();
-        assert(self_ptr && "Section processor should never outlive the facility data processor");
-
-        auto const next_processor = [&self, &parent_processor] constexpr {
-           if constexpr (INDEX + 1 >= std::tuple_size_v<SECTIONS_TYPE>) {
-              (void)self;
-
-              // No more sections, we are done
-              static_assert(INDEX + 1 == std::tuple_size_v<SECTIONS_TYPE>);
-              return parent_processor;
-           } else {
-              // Move to next section
-              return self.template MakeSectionProcessor<INDEX + 1>(parent_processor);
-           }
-        };
-
-        auto const& [section_name, section_member] = std::get<INDEX>(SELF::SECTIONS);
-        using SECTION_TYPE = std::remove_cvref_t<decltype(self.*section_member)>;
-        if constexpr (requires(SECTION_TYPE& t, typename SECTION_TYPE::value_type v) {
-                         t.emplace_back(v);
-                         t.back();
-                      }) {
-           if (!data.IsListItem) {
-              return std::make_tuple(
-                nullptr, "Received non-list data for list section " + std::string{section_name}
-              );
-           }
-           assert(data.ItemIndex < data.ListSize);
-
-           auto& member = self.*section_member;
-           member.emplace_back();
-           assert(data.ItemIndex + 1 == member.size());
-
-           auto processor = member.back().GetProcessor(
-             (data.ItemIndex + 1 == data.ListSize) ? next_processor() : self_ptr
-           );
-           assert(processor);
-
-           std::string error{};
-           std::tie(processor, error) = (*processor)(data);
-
-           if (error.size()) {
-              return std::make_tuple(nullptr, "Failed to process facility data section " + error);
-           } else {
-              return std::make_tuple(processor, "");
-           }
-        } else {
-           if (data.IsListItem) {
-              return std::make_tuple(
-                nullptr,
-                "Received unexpected list item for non-list section " + std::string{section_name}
-              );
-           }
-
-           auto processor = (self.*section_member).GetProcessor(next_processor());
-           assert(processor);
-
-           std::string error{};
-           std::tie(processor, error) = (*processor)(data);
-
-           if (error.size()) {
-              return std::make_tuple(nullptr, "Failed to process facility data section " + error);
-           } else {
-              assert(processor);
-              return std::make_tuple(processor, "");
-           }
-        }
-     }
-   };
+   if (auto error = node.members_(object, data); error.size()) {
+      return error;
+   }
+
+   assert(size_ < stack_.size());
+   stack_[size_++] = {.node_ = &node, .object_ = object, .section_ = 0};
+
+   // The next packet belongs to the first facility with remaining sections
+   while (size_ && (stack_[size_ - 1].section_ == stack_[size_ - 1].node_->sections_.size())) {
+      --size_;
+   }
 
-   return process_ptr;
+   return {};
 }
 
 }  // namespace smc::facility
\ No newline at end of file
@@ -17,7 +17,6 @@
 
 #include "Coords.h"
 
-#include <promise/promise.h>
 #include <Windows.h>
 #include <SimConnect.h>
 #include <limits>
@@ -0,0 +1,90 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "FramePool.h"
+
+#include <array>
+#include <new>
+
+namespace smc {
+
+namespace {
+
+constexpr std::size_t CLASSES = FramePool::MAX_SIZE / FramePool::GRANULE;
+
+// Intrusive singly linked lists, through the first bytes of the free frames
+struct FreeLists {
+   struct Node {
+      Node* next_{};
+   };
+
+   struct List {
+      Node*       head_{};
+      std::size_t size_{};
+   };
+
+   ~FreeLists() {
+      for (auto& list : lists_) {
+         while (list.head_) {
+            ::operator delete(std::exchange(list.head_, list.head_->next_));
+         }
+      }
+   }
+
+   std::array<List, CLASSES> lists_{};
+};
+
+thread_local FreeLists free_lists{};
+
+std::size_t
+SizeClass(std::size_t size) {
+   return (size - 1) / FramePool::GRANULE;
+}
+
+}  // namespace
+
+void*
+FramePool::Allocate(std::size_t size) {
+   if (!size || (size > MAX_SIZE)) {
+      return ::operator new(size);
+   }
+
+   auto& list = free_lists.lists_[SizeClass(size)];
+   if (list.head_) {
+      --list.size_;
+      return std::exchange(list.head_, list.head_->next_);
+   }
+
+   return ::operator new((SizeClass(size) + 1) * GRANULE);
+}
+
+void
+FramePool::Free(void* ptr, std::size_t size) noexcept {
+   if (!size || (size > MAX_SIZE)) {
+      ::operator delete(ptr);
+      return;
+   }
+
+   auto& list = free_lists.lists_[SizeClass(size)];
+   if (list.size_ >= MAX_FREE) {
+      ::operator delete(ptr);
+      return;
+   }
+
+   ++list.size_;
+   list.head_ = new (ptr) FreeLists::Node{list.head_};
+}
+
+}  // namespace smc
@@ -0,0 +1,165 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace smc {
+
+// Coroutine frames recycled by size class (GRANULE bytes steps up to MAX_SIZE) on per-thread free
+// lists of at most MAX_FREE frames each. A frame goes back to the list of the thread ending it,
+// larger frames and full lists go to the heap.
+class FramePool {
+public:
+   static constexpr std::size_t GRANULE  = 64;
+   static constexpr std::size_t MAX_SIZE = 1024;
+   static constexpr std::size_t MAX_FREE = 256;
+
+   static void* Allocate(std::size_t size);
+   static void  Free(void* ptr, std::size_t size) noexcept;
+};
+
+// First parameter of the facade coroutine lambdas wrapped by Pooled, picks PooledPromise
+struct PooledFrame {};
+
+// Awaiter of an initial or final suspend point of PROMISE, suspended with the handle it expects
+template <class PROMISE, class AWAITER>
+struct BaseAwaiter {
+   AWAITER awaiter_;
+
+   bool
+   await_ready() noexcept(noexcept(awaiter_.await_ready())) {
+      return awaiter_.await_ready();
+   }
+
+   template <class HANDLE>
+   static constexpr bool DIRECT = requires(AWAITER awaiter, HANDLE handle) {
+      awaiter.await_suspend(handle);
+   };
+
+   template <class HANDLE>
+   static constexpr bool
+   NoExcept() {
+      if constexpr (DIRECT<HANDLE>) {
+         return noexcept(std::declval<AWAITER&>().await_suspend(std::declval<HANDLE>()));
+      } else {
+         return noexcept(std::declval<AWAITER&>().await_suspend(std::coroutine_handle<PROMISE>{}));
+      }
+   }
+
+   template <class DERIVED>
+   decltype(auto)
+   await_suspend(std::coroutine_handle<DERIVED> handle) noexcept(
+     NoExcept<std::coroutine_handle<DERIVED>>()
+   ) {
+      if constexpr (DIRECT<std::coroutine_handle<DERIVED>>) {
+         return awaiter_.await_suspend(handle);
+      } else {
+         PROMISE& promise = handle.promise();
+         return awaiter_.await_suspend(std::coroutine_handle<PROMISE>::from_promise(promise));
+      }
+   }
+
+   decltype(auto)
+   await_resume() noexcept(noexcept(awaiter_.await_resume())) {
+      return awaiter_.await_resume();
+   }
+};
+
+// The promise type of a coroutine with its frame from the FramePool. It adds no member, the frame
+// layout and the promise handle stay the ones of PROMISE, whose suspend points still get a handle
+// of PROMISE.
+template <class PROMISE>
+struct PooledPromise : PROMISE {
+   using PROMISE::PROMISE;
+
+   auto
+   initial_suspend() noexcept(noexcept(std::declval<PROMISE&>().initial_suspend())) {
+      return BaseAwaiter<PROMISE, decltype(std::declval<PROMISE&>().initial_suspend())>{
+        PROMISE::initial_suspend()
+      };
+   }
+
+   auto
+   final_suspend() noexcept {
+      return BaseAwaiter<PROMISE, decltype(std::declval<PROMISE&>().final_suspend())>{
+        PROMISE::final_suspend()
+      };
+   }
+
+   static void*
+   operator new(std::size_t size) {
+      return FramePool::Allocate(size);
+   }
+
+   static void
+   operator delete(void* ptr, std::size_t size) noexcept {
+      FramePool::Free(ptr, size);
+   }
+};
+
+template <class FN, class CALL = decltype(&FN::operator())>
+class PooledCall;
+
+template <class FN, class RESULT, class... ARGS>
+class PooledCall<FN, RESULT (FN::*)(PooledFrame, ARGS...) const> {
+public:
+   explicit PooledCall(FN fn)
+      : fn_{std::move(fn)} {}
+
+   RESULT
+   operator()(ARGS... args) const {
+      return fn_(PooledFrame{}, std::forward<ARGS>(args)...);
+   }
+
+private:
+   FN fn_;
+};
+
+template <class FN, class RESULT, class... ARGS>
+class PooledCall<FN, RESULT (FN::*)(PooledFrame, ARGS...)> {
+public:
+   explicit PooledCall(FN fn)
+      : fn_{std::move(fn)} {}
+
+   RESULT
+   operator()(ARGS... args) {
+      return fn_(PooledFrame{}, std::forward<ARGS>(args)...);
+   }
+
+private:
+   FN fn_;
+};
+
+// MakePromise(Pooled([...](PooledFrame, <args>) -> Promise<T> { ... })) : the callable keeps the
+// <args> signature of the lambda, whose frame comes from the FramePool
+template <class FN>
+PooledCall<std::remove_cvref_t<FN>>
+Pooled(FN&& fn) {
+   return PooledCall<std::remove_cvref_t<FN>>{std::forward<FN>(fn)};
+}
+
+}  // namespace smc
+
+// Only the coroutines taking a PooledFrame, all of them defined in this tree, get PooledPromise
+template <class RESULT, class CLOSURE, class... ARGS>
+   requires requires { typename RESULT::promise_type; }
+struct std::coroutine_traits<RESULT, CLOSURE, smc::PooledFrame, ARGS...> {
+   using promise_type = smc::PooledPromise<typename RESULT::promise_type>;
+};
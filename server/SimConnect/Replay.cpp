@@ -0,0 +1,186 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Replay.h"
+
+#include "Data/DataId.h"
+#include "Data/TrafficStaticInfo.h"
+#include "Utils/Wire.h"
+
+#include <memory>
+#include <string>
+
+namespace smc {
+
+namespace {
+
+// Payload of data holds a T
+template <class T>
+bool
+Holds(SIMCONNECT_RECV_SIMOBJECT_DATA const& data) {
+   auto const header_size = sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(data.dwData);
+   return data.dwSize >= header_size + wire::WireSize<T>();
+}
+
+}  // namespace
+
+PendingHandler
+ReplaySink::Bind(SIMCONNECT_RECV const& data) {
+   using enum DataId;
+
+   switch (data.dwID) {
+      case SIMCONNECT_RECV_ID_FACILITY_DATA:
+      case SIMCONNECT_RECV_ID_FACILITY_DATA_END: {
+         // GET_AIRPORT_FACILITY is the only facility definition
+         struct Airport {
+            facility::AirportData                   result_{};
+            facility::Decoder<facility::AirportData> decoder_{};
+            bool                                     failed_{false};
+         };
+
+         return FacilityHandler{
+           [this, airport = std::make_unique<Airport>()](FacilityData const& answer) {
+              if (std::holds_alternative<
+                    std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA_END const>>(answer)) {
+                 if (!airport->decoder_.Started() || airport->failed_) {
+                    ++stats_.facility_errors_;
+                 } else {
+                    ++stats_.airports_;
+                 }
+                 return;
+              }
+
+              auto const& packet =
+                std::get<std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA const>>(answer).get();
+              if (!airport->failed_) {
+                 airport->failed_ = !airport->decoder_.Process(airport->result_, packet).empty();
+              }
+           }
+         };
+      }
+
+      case SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE: {
+         auto const id = static_cast<DataId>(
+           static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const&>(data).dwDefineID
+         );
+         if ((id != TRAFFIC_POSITION) && (id != HELI_TRAFFIC_POSITION)) {
+            return SimObjectTypeHandler{[this](SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const&) {
+               ++stats_.objects_;
+            }};
+         }
+
+         return SimObjectTypeHandler{
+           [this, helicopter = id == HELI_TRAFFIC_POSITION](
+             SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const& entry
+           ) { SetTraffic(entry, helicopter); }
+         };
+      }
+
+      case SIMCONNECT_RECV_ID_SIMOBJECT_DATA: {
+         auto const& simobj = static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA const&>(data);
+
+         switch (static_cast<DataId>(simobj.dwDefineID)) {
+            case TRAFFIC_POSITION:
+               // User aircraft, the alerts of the next sample are computed against it
+               return SimObjectHandler{[this](
+                                         SIMCONNECT_RECV_SIMOBJECT_DATA const& answer,
+                                         std::chrono::steady_clock::time_point const&
+                                       ) {
+                  if (!Holds<TrafficPosition>(answer)) {
+                     ++stats_.malformed_;
+                     return;
+                  }
+                  ++stats_.objects_;
+                  user_id_ = answer.dwObjectID;
+                  user_    = wire::Read<TrafficPosition>(answer.dwData);
+               }};
+
+            case TRAFFIC_STATIC_INFO:
+               return SimObjectHandler{[this](
+                                         SIMCONNECT_RECV_SIMOBJECT_DATA const& answer,
+                                         std::chrono::steady_clock::time_point const&
+                                       ) {
+                  if (!Holds<TrafficStaticInfo>(answer)) {
+                     ++stats_.malformed_;
+                     return;
+                  }
+                  ++stats_.objects_;
+                  traffic_.SetStaticInfo(
+                    answer.dwObjectID, wire::Read<TrafficStaticInfo>(answer.dwData)
+                  );
+               }};
+
+            case TAGGED_TRAFFIC_INFO:
+               return SimObjectHandler{[this](
+                                         SIMCONNECT_RECV_SIMOBJECT_DATA const& answer,
+                                         std::chrono::steady_clock::time_point const&
+                                       ) {
+                  if (!wire::ApplyTagged(answer, tagged_[answer.dwObjectID])) {
+                     ++stats_.malformed_;
+                     return;
+                  }
+                  ++stats_.objects_;
+               }};
+
+            default:
+               return SimObjectHandler{[this](
+                                         SIMCONNECT_RECV_SIMOBJECT_DATA const&,
+                                         std::chrono::steady_clock::time_point const&
+                                       ) { ++stats_.objects_; }};
+         }
+      }
+
+      default:
+         // Lists, enumerations and AI objects aren't replayed
+         return std::monostate{};
+   }
+}
+
+void
+ReplaySink::SetTraffic(SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const& data, bool helicopter) {
+   // Samples end with the aircraft answer, like SimConnect::SampleTraffic. The helicopters
+   // answered after it are part of the next sample
+   if (!sampling_) {
+      traffic_.Begin();
+      sampling_ = true;
+   }
+
+   if (data.dwoutof) {
+      if (!Holds<TrafficPosition>(data)) {
+         ++stats_.malformed_;
+      } else {
+         ++stats_.objects_;
+         if (data.dwObjectID != user_id_) {
+            traffic_.Set(data.dwObjectID, wire::Read<TrafficPosition>(data.dwData), helicopter);
+         }
+      }
+   }
+
+   if (!helicopter && (data.dwentrynumber >= data.dwoutof)) {
+      traffic_.Advise(user_);
+      traffic_.End();
+      sampling_ = false;
+
+      ++stats_.traffic_samples_;
+      stats_.aircraft_ = traffic_.Size();
+   }
+}
+
+ReplaySink::Stats const&
+ReplaySink::GetStats() const {
+   return stats_;
+}
+
+}  // namespace smc
@@ -0,0 +1,108 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Data/TrafficInfo.h"
+#include "FacilityData/AirportFacility.h"
+#include "Requests.h"
+#include "Traffic.h"
+
+#include <Windows.h>
+#include <SimConnect.h>
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+namespace smc {
+
+// Replayed answers carry the request ids of the capture, no request issued during the replay
+// knows them. The first answer of a recorded id is bound to a request of its own, its handler
+// made from the packet (kind and define id), the following answers are rewritten to that request.
+class ReplayRoutes {
+public:
+   // BIND(SIMCONNECT_RECV const&) -> PendingHandler, std::monostate for the answers not replayed
+   template <class BIND>
+   Routed
+   Route(SIMCONNECT_RECV& data, BIND&& bind) {
+      auto const field = AnswerRequestIdField(data);
+      if (!field) {
+         return Routed::NOT_AN_ANSWER;
+      }
+
+      if (auto const bound = ids_.find(*field);
+          (bound != ids_.end()) && requests_.Find(bound->second)) {
+         *field = bound->second;
+         return RouteAnswer(requests_, data);
+      }
+
+      auto handler = std::forward<BIND>(bind)(std::as_const(data));
+      if (std::holds_alternative<std::monostate>(handler)) {
+         ++unbound_;
+         return Routed::UNKNOWN_REQUEST;
+      }
+
+      auto const request_id = requests_.Insert({.handler_ = std::move(handler)});
+      ids_[*field]          = request_id;
+      *field                = request_id;
+      return RouteAnswer(requests_, data);
+   }
+
+   // Answers dropped, their request has no replay handler
+   std::size_t
+   Unbound() const {
+      return unbound_;
+   }
+
+private:
+   std::unordered_map<SIMCONNECT_DATA_REQUEST_ID, SIMCONNECT_DATA_REQUEST_ID> ids_{};
+   Requests<void>                                                             requests_{};
+   std::size_t                                                                unbound_{0};
+};
+
+// Processors fed by a replay, the answers are decoded the way the live requests decode them :
+// facilities by the facility decoder, traffic samples into a TrafficTable
+class ReplaySink {
+public:
+   struct Stats {
+      std::size_t airports_{0};
+      std::size_t facility_errors_{0};
+      std::size_t objects_{0};  // SIMOBJECT_DATA(_BYTYPE) entries decoded
+      std::size_t malformed_{0};
+      std::size_t traffic_samples_{0};
+      std::size_t aircraft_{0};  // In the table after the last sample
+   };
+
+   // Handler of the request answered by data, by its kind and define id
+   PendingHandler Bind(SIMCONNECT_RECV const& data);
+
+   Stats const& GetStats() const;
+
+private:
+   void SetTraffic(SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const& data, bool helicopter);
+
+   TrafficTable traffic_{};
+   TrafficInfo  user_{};
+   DWORD        user_id_{SIMCONNECT_OBJECT_ID_USER};
+   bool         sampling_{false};
+
+   std::unordered_map<DWORD, TrafficInfo> tagged_{};
+
+   Stats stats_{};
+};
+
+}  // namespace smc
@@ -0,0 +1,236 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Data/DataId.h"
+#include "TimerWheel.h"
+#include "Utils/SlotMap.h"
+#include "Utils/SmallFunction.h"
+
+#include <Windows.h>
+#include <SimConnect.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <variant>
+
+namespace smc {
+
+using SimObjectHandler = SmallFunction<
+  void(SIMCONNECT_RECV_SIMOBJECT_DATA const&, std::chrono::steady_clock::time_point const&)>;
+using FacilityData = std::variant<
+  std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA const>,
+  std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA_END const>>;
+using FacilityHandler      = SmallFunction<void(FacilityData const&)>;
+using SimObjectTypeHandler = SmallFunction<void(SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const&)>;
+using EnumeratedSimObjectsHandler =
+  SmallFunction<void(SIMCONNECT_RECV_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST const&)>;
+using FacilitiesListHandler = SmallFunction<void(SIMCONNECT_RECV_FACILITIES_LIST const&)>;
+using AssignedObjectHandler = SmallFunction<void(SIMCONNECT_RECV_ASSIGNED_OBJECT_ID const&)>;
+
+// Periodic requests, issued again on each connection
+struct Subscription {
+   DataId            id_;
+   DWORD             object_id_;
+   SIMCONNECT_PERIOD period_;
+   DWORD             flags_;
+   DWORD             interval_;
+   bool              issued_{false};
+
+   SimObjectHandler      push_;
+   SmallFunction<void()> cancel_;
+};
+
+using PendingHandler = std::variant<
+  std::monostate,
+  SimObjectHandler,
+  FacilityHandler,
+  SimObjectTypeHandler,
+  EnumeratedSimObjectsHandler,
+  FacilitiesListHandler,
+  AssignedObjectHandler,
+  Subscription>;
+
+// A request without handler only tracks the send id of a SimConnect call (rejected on
+// exception)
+template <class REJECT>
+struct PendingRequest {
+   PendingHandler                handler_{};
+   std::shared_ptr<REJECT const> reject_{};
+   TimerWheel::Id                watchdog_{};  // WatchProgress timer
+};
+
+// Keys are the SimConnect request ids
+template <class REJECT>
+using Requests = SlotMap<PendingRequest<REJECT>>;
+
+// Runs the handler of the request when it is a HANDLER. It is moved out while running, handlers
+// can settle or issue requests (and so move the registry storage)
+template <class HANDLER, class REJECT, class... ARGS>
+bool
+InvokePending(
+  Requests<REJECT>&          requests,
+  SIMCONNECT_DATA_REQUEST_ID request_id,
+  ARGS const&... args
+) {
+   auto const request = requests.Find(request_id);
+   if (!request || !std::holds_alternative<HANDLER>(request->handler_)) {
+      return false;
+   }
+
+   auto handler = std::get<HANDLER>(std::move(request->handler_));
+   handler(args...);
+
+   if (auto const settled = requests.Find(request_id)) {
+      if (std::holds_alternative<HANDLER>(settled->handler_)) {
+         std::get<HANDLER>(settled->handler_) = std::move(handler);
+      }
+   }
+   return true;
+}
+
+// Request id field of the answers, null for the other packets
+inline DWORD*
+AnswerRequestIdField(SIMCONNECT_RECV& data) {
+   switch (data.dwID) {
+      case SIMCONNECT_RECV_ID_ASSIGNED_OBJECT_ID:
+         return &static_cast<SIMCONNECT_RECV_ASSIGNED_OBJECT_ID&>(data).dwRequestID;
+      case SIMCONNECT_RECV_ID_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST:
+         return &static_cast<SIMCONNECT_RECV_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST&>(data)
+                   .dwRequestID;
+      case SIMCONNECT_RECV_ID_AIRPORT_LIST:
+      case SIMCONNECT_RECV_ID_VOR_LIST:
+      case SIMCONNECT_RECV_ID_NDB_LIST:
+      case SIMCONNECT_RECV_ID_WAYPOINT_LIST:
+         return &static_cast<SIMCONNECT_RECV_FACILITIES_LIST&>(data).dwRequestID;
+      case SIMCONNECT_RECV_ID_SIMOBJECT_DATA:
+      case SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE:
+         return &static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA&>(data).dwRequestID;
+      case SIMCONNECT_RECV_ID_FACILITY_DATA:
+         return &static_cast<SIMCONNECT_RECV_FACILITY_DATA&>(data).UserRequestId;
+      case SIMCONNECT_RECV_ID_FACILITY_DATA_END:
+         return &static_cast<SIMCONNECT_RECV_FACILITY_DATA_END&>(data).RequestId;
+      default:
+         return nullptr;
+   }
+}
+
+// Request id of the answers, nullopt for the other packets
+inline std::optional<SIMCONNECT_DATA_REQUEST_ID>
+AnswerRequestId(SIMCONNECT_RECV const& data) {
+   // Only read
+   if (auto const field = AnswerRequestIdField(const_cast<SIMCONNECT_RECV&>(data))) {
+      return *field;
+   }
+   return std::nullopt;
+}
+
+enum class Routed {
+   ANSWERED,
+   UNKNOWN_REQUEST,  // Settled in the meantime, or not ours
+   NOT_AN_ANSWER,
+};
+
+// Hands an answer to the handler of its request, the SIMOBJECT_DATA of a subscription to its
+// push_ (on the SimConnect thread)
+template <class REJECT>
+Routed
+RouteAnswer(Requests<REJECT>& requests, SIMCONNECT_RECV const& data) {
+   auto const answered = [](bool found) {
+      return found ? Routed::ANSWERED : Routed::UNKNOWN_REQUEST;
+   };
+
+   switch (data.dwID) {
+      case SIMCONNECT_RECV_ID_ASSIGNED_OBJECT_ID: {
+         auto const& assigned = static_cast<SIMCONNECT_RECV_ASSIGNED_OBJECT_ID const&>(data);
+         return answered(InvokePending<AssignedObjectHandler>(
+           requests, assigned.dwRequestID, assigned
+         ));
+      }
+
+      case SIMCONNECT_RECV_ID_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST: {
+         auto const& enumerated =
+           static_cast<SIMCONNECT_RECV_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST const&>(data);
+         return answered(InvokePending<EnumeratedSimObjectsHandler>(
+           requests, enumerated.dwRequestID, enumerated
+         ));
+      }
+
+      case SIMCONNECT_RECV_ID_AIRPORT_LIST:
+      case SIMCONNECT_RECV_ID_VOR_LIST:
+      case SIMCONNECT_RECV_ID_NDB_LIST:
+      case SIMCONNECT_RECV_ID_WAYPOINT_LIST: {
+         auto const& list = static_cast<SIMCONNECT_RECV_FACILITIES_LIST const&>(data);
+         return answered(InvokePending<FacilitiesListHandler>(requests, list.dwRequestID, list));
+      }
+
+      case SIMCONNECT_RECV_ID_SIMOBJECT_DATA: {
+         auto const now = std::chrono::steady_clock::now();
+
+         auto const& simobj  = static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA const&>(data);
+         auto const  request = requests.Find(simobj.dwRequestID);
+         if (
+           auto const subscription =
+             request ? std::get_if<Subscription>(&request->handler_) : nullptr
+         ) {
+            // Moved out while running like in InvokePending : a consumer can call the SimConnect
+            // API inline (Proxy on this thread) and grow the registry under the subscription
+            auto push = std::move(subscription->push_);
+            push(simobj, now);
+
+            if (auto const settled = requests.Find(simobj.dwRequestID)) {
+               if (auto const pushed = std::get_if<Subscription>(&settled->handler_)) {
+                  pushed->push_ = std::move(push);
+               }
+            }
+            return Routed::ANSWERED;
+         }
+
+         return answered(InvokePending<SimObjectHandler>(requests, simobj.dwRequestID, simobj, now)
+         );
+      }
+
+      case SIMCONNECT_RECV_ID_FACILITY_DATA: {
+         auto const& facility = static_cast<SIMCONNECT_RECV_FACILITY_DATA const&>(data);
+         return answered(InvokePending<FacilityHandler>(
+           requests, facility.UserRequestId, FacilityData{facility}
+         ));
+      }
+
+      case SIMCONNECT_RECV_ID_FACILITY_DATA_END: {
+         auto const& facility = static_cast<SIMCONNECT_RECV_FACILITY_DATA_END const&>(data);
+         return answered(
+           InvokePending<FacilityHandler>(requests, facility.RequestId, FacilityData{facility})
+         );
+      }
+
+      case SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE: {
+         auto const& simobj = static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const&>(data);
+         return answered(
+           InvokePending<SimObjectTypeHandler>(requests, simobj.dwRequestID, simobj)
+         );
+      }
+
+      default:
+         return Routed::NOT_AN_ANSWER;
+   }
+}
+
+}  // namespace smc
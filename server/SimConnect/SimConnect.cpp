@@ -28,10 +28,13 @@
 #include "Data/Break.h"
 #include "Data/ManualControl.h"
 #include "FacilityData/AirportFacility.h"
+#include "Registry/Registry.h"
 
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <filesystem>
+#include <format>
 #include <functional>
 #include <iostream>
 #include <limits>
@@ -68,38 +71,69 @@ MakeSimConnectExceptionMessage(
           + std::to_string(exception.dwIndex);
 }
 
-template <class PENDING>
-bool
-RejectPendingOnException(
-  PENDING&                         pending,
-  SIMCONNECT_DATA_REQUEST_ID       request_id,
-  SIMCONNECT_RECV_EXCEPTION const& exception
+std::optional<std::filesystem::path>
+CachePath(
+  SimConnect::Options const&                  options,
+  std::optional<std::filesystem::path> const& path_option,
+  std::string_view                            name,
+  bool                                        clear
 ) {
-   auto request = pending.find(request_id);
-   if (request == pending.end()) {
-      return false;
+   if (options.replay_) {
+      return std::nullopt;
    }
 
-   auto const reject = request->second.second;
-   reject->template Apply<UnknownError>(MakeSimConnectExceptionMessage(exception, request_id));
-   return true;
+   auto path = path_option.value_or(
+     std::filesystem::path{*registry::Get().alx_home_->settings_->destination_} / "Data" / name
+   );
+
+   if (clear) {
+      std::error_code ec{};
+      std::filesystem::remove_all(path, ec);
+   }
+   return path;
 }
 
 }  // namespace
 
-SimConnect::SimConnect(Main& main)
+SimConnect::SimConnect(Main& main, Options options)
    : MessageQueue{"SimConnect"}
    , main_(main)
+   , options_{std::move(options)}
+   , airport_cache_{
+       CachePath(options_, options_.airport_cache_, "AirportCache", options_.clear_airport_cache_)
+     }
+   , terrain_cache_{
+       CachePath(options_, options_.terrain_cache_, "TerrainCache", options_.clear_terrain_cache_)
+     }
    , thread_{[this](std::stop_token stoken) {
       if (!event_) {
          throw std::runtime_error("Couldn't create event");
       }
+      if (!timer_) {
+         throw std::runtime_error("Couldn't create timer");
+      }
 
       ScopeExit _{[this]() {
-         std::cout << "SimConnect: Main loop ended" << std::endl;
+         auto const stats = GetCoalesceStats();
+         std::cout << "SimConnect: Main loop ended, " << stats.suppressed_ + stats.cached_
+                   << " duplicate requests suppressed out of "
+                   << stats.issued_ + stats.suppressed_ + stats.cached_ << std::endl;
          auto const _ = MessageQueue::Dispatch([this]() { connection_promise_.Done(); });
       }};
 
+      if (options_.capture_) {
+         try {
+            capture_.emplace(*options_.capture_);
+         } catch (std::exception const& e) {
+            std::cerr << "SimConnect: " << e.what() << std::endl;
+         }
+      }
+
+      if (options_.replay_) {
+         Replay(stoken);
+         return;
+      }
+
       while (!stoken.stop_requested()) {
          HANDLE handle;
          if (SUCCEEDED(SimConnect_Open(&handle, "MSFS VFRNav'", nullptr, 0, event_, 0))) {
@@ -146,6 +180,12 @@ SimConnect::Stop() {
    }
 }
 
+SIMCONNECT_DATA_REQUEST_ID
+SimConnect::ReserveRequest() {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+   return requests_.Insert({});
+}
+
 bool
 SimConnect::TrackRequestSendId(
   std::shared_ptr<void*> const& handle,
@@ -158,20 +198,12 @@ SimConnect::TrackRequestSendId(
       return false;
    }
 
-   if (
-     auto const existing = request_id_to_send_id_.find(request_id);
-     existing != request_id_to_send_id_.end()
-   ) {
-      assert(false);
-      send_id_to_request_id_.erase(existing->second);
-   }
-
-   request_id_to_send_id_[request_id] = send_id;
-   send_id_to_request_id_[send_id]    = request_id;
+   // Settled in the meantime : the key no longer matches, nothing to check here
+   send_ids_.Insert(send_id, request_id);
    return true;
 }
 
-std::optional<DWORD>
+std::optional<SIMCONNECT_DATA_REQUEST_ID>
 SimConnect::TrackPendingSendId(
   std::shared_ptr<void*> const& handle,
   std::shared_ptr<Reject const> reject
@@ -183,45 +215,65 @@ SimConnect::TrackPendingSendId(
       return std::nullopt;
    }
 
-   send_id_to_reject_[send_id] = std::move(reject);
-   return send_id;
+   auto const request_id = requests_.Insert({.reject_ = std::move(reject)});
+   send_ids_.Insert(send_id, request_id);
+   return request_id;
 }
 
 void
-SimConnect::ClearTrackedSendId(SIMCONNECT_DATA_REQUEST_ID request_id) {
+SimConnect::WatchProgress(
+  SIMCONNECT_DATA_REQUEST_ID         request_id,
+  std::shared_ptr<std::size_t const> remaining,
+  char const*                        message
+) {
    assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-   auto send_id = request_id_to_send_id_.find(request_id);
-   if (send_id == request_id_to_send_id_.end()) {
+   auto const request = requests_.Find(request_id);
+   if (!request || !*remaining) {
+      // Settled, or every entry received
       return;
    }
 
-   send_id_to_request_id_.erase(send_id->second);
-   request_id_to_send_id_.erase(send_id);
+   request->watchdog_ = Schedule(
+     PROGRESS_TIMEOUT,
+     [this, request_id, remaining, last = *remaining, message]() mutable {
+        auto const pending = requests_.Find(request_id);
+        if (!pending) {
+           return;
+        }
+        pending->watchdog_ = {};
+
+        if (*remaining != last) {
+           WatchProgress(request_id, std::move(remaining), message);
+        } else if (auto const reject = pending->reject_) {
+           // Erases the request
+           reject->Apply<Timeout>(message);
+        }
+     }
+   );
 }
 
-std::optional<SIMCONNECT_DATA_REQUEST_ID>
-SimConnect::FindRequestIdForSendId(DWORD send_id) const {
+void
+SimConnect::EraseRequest(SIMCONNECT_DATA_REQUEST_ID request_id) {
    assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-   auto request_id = send_id_to_request_id_.find(send_id);
-   if (request_id == send_id_to_request_id_.end()) {
-      return std::nullopt;
+   if (auto const request = requests_.Find(request_id); request && request->watchdog_) {
+      CancelTimer(request->watchdog_);
    }
-
-   return request_id->second;
+   requests_.Erase(request_id);
 }
 
-std::shared_ptr<Reject const>
-SimConnect::FindRejectForSendId(DWORD send_id) const {
+std::optional<SIMCONNECT_DATA_REQUEST_ID>
+SimConnect::FindRequestIdForSendId(DWORD send_id) {
    assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-   auto reject = send_id_to_reject_.find(send_id);
-   if (reject == send_id_to_reject_.end()) {
-      return {};
+   auto const request_id = send_ids_.Find(send_id);
+   if (!request_id || !requests_.Find(*request_id)) {
+      // Aged out, or settled since
+      return std::nullopt;
    }
 
-   return reject->second;
+   return request_id;
 }
 
 WPromise<SIMCONNECT_RECV_ASSIGNED_OBJECT_ID>
@@ -232,7 +284,7 @@ SimConnect::AICreateSimulatedObject(
 ) {
    assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-   auto const request_id = ++request_id_;
+   auto const request_id = ReserveRequest();
 
    return MakePromise(
             [this, handle, title = std::string{title}, pos, request_id](
@@ -248,17 +300,15 @@ SimConnect::AICreateSimulatedObject(
                   }
                }
 
-               pending_assigned_.try_emplace(
+               SetPending<AssignedObjectHandler>(
                  request_id,
-                 std::function<void(SIMCONNECT_RECV_ASSIGNED_OBJECT_ID const&)>(
-                   [this, resolve = resolve.shared_from_this()](
-                     SIMCONNECT_RECV_ASSIGNED_OBJECT_ID const& assigned
-                   ) {
-                      (void)this;
-                      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-                      (*resolve)(assigned);
-                   }
-                 ),
+                 [this, resolve = resolve.shared_from_this()](
+                   SIMCONNECT_RECV_ASSIGNED_OBJECT_ID const& assigned
+                 ) {
+                    (void)this;
+                    assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+                    (*resolve)(assigned);
+                 },
                  reject.shared_from_this()
                );
 
@@ -276,8 +326,7 @@ SimConnect::AICreateSimulatedObject(
             }
    ).Finally([this, request_id] {
       assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-      ClearTrackedSendId(request_id);
-      pending_assigned_.erase(request_id);
+      requests_.Erase(request_id);
    });
 }
 
@@ -291,7 +340,7 @@ SimConnect::AICreateNonATCAircraft(
 ) {
    assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-   auto const request_id = ++request_id_;
+   auto const request_id = ReserveRequest();
    return MakePromise(
             [this,
              handle,
@@ -312,7 +361,7 @@ SimConnect::AICreateNonATCAircraft(
                   }
                }
 
-               pending_assigned_.try_emplace(
+               SetPending<AssignedObjectHandler>(
                  request_id,
                  [this, resolve = resolve.shared_from_this()](
                    SIMCONNECT_RECV_ASSIGNED_OBJECT_ID const& assigned
@@ -341,11 +390,68 @@ SimConnect::AICreateNonATCAircraft(
             }
    ).Finally([this, request_id] {
       assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-      ClearTrackedSendId(request_id);
-      pending_assigned_.erase(request_id);
+      requests_.Erase(request_id);
    });
 }
 
+void
+SimConnect::IssueSubscription(SIMCONNECT_DATA_REQUEST_ID request_id, Subscription& subscription) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   auto const handle = handle_.lock();
+   if (!handle || !ready_ || subscription.issued_) {
+      // Issued once the simulator is ready
+      return;
+   }
+
+   if (
+     SimConnect_RequestDataOnSimObject(
+       *handle,
+       request_id,
+       static_cast<uint32_t>(subscription.id_),
+       subscription.object_id_,
+       subscription.period_,
+       subscription.flags_,
+       0,
+       subscription.interval_
+     )
+     != S_OK
+   ) {
+      std::cerr << "SimConnect: Failed to subscribe to data on sim object" << std::endl;
+      return;
+   }
+
+   if (!TrackRequestSendId(handle, request_id)) {
+      std::cerr << "SimConnect: Failed to track subscription request" << std::endl;
+   }
+
+   subscription.issued_ = true;
+}
+
+void
+SimConnect::Unsubscribe(SIMCONNECT_DATA_REQUEST_ID request_id) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   auto const request = requests_.Find(request_id);
+   if (!request) {
+      return;
+   }
+
+   auto const& subscription = std::get<Subscription>(request->handler_);
+   if (auto const handle = handle_.lock(); handle && subscription.issued_) {
+      // Stops the periodic sampling
+      SimConnect_RequestDataOnSimObject(
+        *handle,
+        request_id,
+        static_cast<uint32_t>(subscription.id_),
+        subscription.object_id_,
+        SIMCONNECT_PERIOD_NEVER
+      );
+   }
+
+   requests_.Erase(request_id);
+}
+
 void
 SimConnect::Run(std::stop_token const& stoken) {
    using enum DataId;
@@ -359,7 +465,10 @@ SimConnect::Run(std::stop_token const& stoken) {
       std::mutex               mutex{};
       std::atomic<std::size_t> pending_count = 0;
 
-      auto const _ = MessageQueue::Dispatch([this]() { connection_promise_.Done(); });
+      auto const _ = MessageQueue::Dispatch([this]() {
+         connection_promise_.Done();
+         ready_ = false;
+      });
 
       auto const clearPending =
         [this, &cv, &mutex, &pending_count](std::function<void()>&& invoke) {
@@ -380,21 +489,25 @@ SimConnect::Run(std::stop_token const& stoken) {
            }
         };
 
-      auto const makeCleaner = [this]<class M>(M SimConnect::* elem) {
-         return [this, elem] {
-            auto pending = std::move(this->*elem);
-            assert((this->*elem).empty());
-            for (auto& pending_entry : pending) {
-               pending_entry.second.second->template Apply<Disconnected>();
+      clearPending([this] {
+         std::vector<std::shared_ptr<Reject const>> rejects{};
+
+         requests_.ForEach([&rejects](auto, Pending& request) {
+            if (auto const subscription = std::get_if<Subscription>(&request.handler_)) {
+               // Issued again on the next connection
+               subscription->issued_ = false;
+            } else if (!std::holds_alternative<std::monostate>(request.handler_)) {
+               rejects.emplace_back(request.reject_);
             }
-         };
-      };
-      std::apply(
-        [&clearPending, &makeCleaner](auto&&... pending_member) {
-           (clearPending(makeCleaner(pending_member)), ...);
-        },
-        PENDING_MEMBERS
-      );
+         });
+
+         // Rejections erase their request
+         for (auto const& reject : rejects) {
+            reject->template Apply<Disconnected>();
+         }
+
+         send_ids_.Clear();
+      });
 
       // Wait until all pending requests have been cleared.
       std::unique_lock lock{mutex};
@@ -426,6 +539,22 @@ SimConnect::Run(std::stop_token const& stoken) {
       Sleep(5000);
       return;
    }
+   if (!AddToDataDefinition<TRAFFIC_POSITION, TrafficPosition>(handle)) {
+      std::cerr << "SimConnect: Failed to add data definition for traffic position" << std::endl;
+      Sleep(5000);
+      return;
+   }
+   if (!AddToDataDefinition<HELI_TRAFFIC_POSITION, TrafficPosition>(handle)) {
+      std::cerr << "SimConnect: Failed to add data definition for helicopter traffic position"
+                << std::endl;
+      Sleep(5000);
+      return;
+   }
+   if (!AddToTaggedDataDefinition<TAGGED_TRAFFIC_INFO, TrafficInfo>(handle)) {
+      std::cerr << "SimConnect: Failed to add data definition for tagged traffic info" << std::endl;
+      Sleep(5000);
+      return;
+   }
    if (!AddToDataDefinition<GROUND_INFO, GroundInfo>(handle)) {
       std::cerr << "SimConnect: Failed to add data definition for ground info" << std::endl;
       Sleep(5000);
@@ -438,6 +567,13 @@ SimConnect::Run(std::stop_token const& stoken) {
       Sleep(5000);
       return;
    }
+   if (!AddToDataDefinition<SET_INIT_POSISION>(
+         handle, "Initial Position", SIMCONNECT_DATATYPE_INITPOSITION
+       )) {
+      std::cerr << "SimConnect: Failed to add data definition for initial position" << std::endl;
+      Sleep(5000);
+      return;
+   }
    if (!AddToDataDefinition<WAYPOINT_INDEX, WaypointIndex>(handle)) {
       std::cerr << "SimConnect: Failed to add data definition for current waypoint" << std::endl;
       Sleep(5000);
@@ -687,27 +823,113 @@ SimConnect::Run(std::stop_token const& stoken) {
 
    ScopeExit connection_done{[this] { connection_promise_.Done(); }};
 
+   std::array<HANDLE, 2> const events{event_, timer_.get()};
+
    uint32_t result;
-   while ((result = ::WaitForSingleObject(event_, INFINITE)),
-          (result == WAIT_OBJECT_0) && !ShouldStop(stoken)) {
-      MessageQueue::Dispatch([this, handle]() {
-         SimConnect_CallDispatch(
-           *handle,
-           [](SIMCONNECT_RECV* data, DWORD, void* self) {
-              reinterpret_cast<SimConnect*>(self)->Dispatch(*data);
-           },
-           this
-         );
-      }).Detach();
+   while ((result = ::WaitForMultipleObjects(
+             static_cast<DWORD>(events.size()), events.data(), FALSE, INFINITE
+           )),
+          ((result == WAIT_OBJECT_0) || (result == (WAIT_OBJECT_0 + 1))) && !ShouldStop(stoken)) {
+      if (result == (WAIT_OBJECT_0 + 1)) {
+         MessageQueue::Dispatch([this]() { OnTimer(); }).Detach();
+         continue;
+      }
+
+      {
+         std::unique_lock lock{mutex_};
+         ++dispatch_stats_.wakes_;
+      }
+
+      if (!drain_queued_.exchange(true)) {
+         // Otherwise the queued task drains the new packets as well
+         MessageQueue::Dispatch([this, handle]() { Drain(handle); }).Detach();
+      }
    }
    std::cout << "SimConnect: Stopping SimConnect thread, result " << result << std::endl;
 }
 
 WPromise<void>
-SimConnect::Wait(std::chrono::milliseconds timeout) const {
+SimConnect::Wait(std::chrono::milliseconds timeout) {
+   return Wait(timeout, promise::Race(connection_promise_.WaitDone(), main_.WaitTerminate()));
+}
+
+WPromise<void>
+SimConnect::Wait(std::chrono::milliseconds timeout, WPromise<void> interrupt) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   auto const timer = std::make_shared<TimerWheel::Id>();
    return promise::Race(
-     MessageQueue::Dispatch(timeout), connection_promise_.WaitDone(), main_.WaitTerminate()
+            MakePromise(
+              [this, timeout, timer](
+                Resolve<void> const& resolve, Reject const&
+              ) -> Promise<void, true> {
+                 *timer = Schedule(timeout, [resolve = resolve.shared_from_this()]() {
+                    (*resolve)();
+                 });
+                 co_return;
+              }
+            ),
+            std::move(interrupt)
+   ).Finally([this, timer] {
+      // Interrupted, the timer would otherwise stay in the wheel (and hold resolve) until due.
+      // Cancelling an expired timer does nothing.
+      if (std::this_thread::get_id() == MessageQueue::ThreadId()) {
+         CancelTimer(*timer);
+      } else {
+         MessageQueue::Dispatch([this, timer]() { CancelTimer(*timer); }).Detach();
+      }
+   });
+}
+
+TimerWheel::Id
+SimConnect::Schedule(std::chrono::milliseconds delay, TimerWheel::Callback&& callback) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   auto const id = timers_.Schedule(TimerWheel::Clock::now() + delay, std::move(callback));
+   ArmTimer();
+   return id;
+}
+
+void
+SimConnect::CancelTimer(TimerWheel::Id id) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   if (timers_.Cancel(id)) {
+      ArmTimer();
+   }
+}
+
+void
+SimConnect::OnTimer() {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   armed_.reset();
+   timers_.Advance(TimerWheel::Clock::now());
+   ArmTimer();
+}
+
+void
+SimConnect::ArmTimer() {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   auto const next = timers_.NextWake();
+   if (next == armed_) {
+      return;
+   }
+
+   armed_ = next;
+   if (!next) {
+      // Every timer left was cancelled
+      ::CancelWaitableTimer(timer_.get());
+      return;
+   }
+
+   // Relative, in 100 nanoseconds
+   LARGE_INTEGER due{};
+   due.QuadPart = -std::max<LONGLONG>(
+     1, duration_cast<nanoseconds>(*next - TimerWheel::Clock::now()).count() / 100
    );
+   ::SetWaitableTimer(timer_.get(), &due, 0, nullptr, nullptr, FALSE);
 }
 
 WPromise<void>
@@ -715,6 +937,137 @@ SimConnect::Connected() const {
    return promise::Race(connection_promise_.Wait(), main_.WaitTerminate());
 }
 
+WPromise<void>
+SimConnect::RunBatch(std::function<WPromise<void>()>&& func) const {
+   return Proxy(std::move(func));
+}
+
+void
+SimConnect::Drain(std::shared_ptr<void*> const& handle) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   drain_queued_ = false;
+
+   auto const  start = steady_clock::now();
+   std::size_t count = 0;
+
+   SIMCONNECT_RECV* data = nullptr;
+   DWORD            size = 0;
+   while (
+     (count < DISPATCH_BUDGET) && SUCCEEDED(SimConnect_GetNextDispatch(*handle, &data, &size))
+   ) {
+      if (capture_) {
+         capture_->Write({reinterpret_cast<std::byte const*>(data), size});
+      }
+
+      Dispatch(*data);
+      ++count;
+   }
+
+   if ((count == DISPATCH_BUDGET) && !drain_queued_.exchange(true)) {
+      // Leave room for the other queued tasks before draining the rest
+      MessageQueue::Dispatch([this, handle]() { Drain(handle); }).Detach();
+   }
+
+   auto const elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+
+   std::unique_lock lock{mutex_};
+   ++dispatch_stats_.batches_;
+   dispatch_stats_.packets_    += count;
+   dispatch_stats_.batch_time_ += elapsed;
+   dispatch_stats_.max_batch_packets_ =
+     std::max<uint64_t>(dispatch_stats_.max_batch_packets_, count);
+   dispatch_stats_.max_batch_time_ = std::max(dispatch_stats_.max_batch_time_, elapsed);
+}
+
+void
+SimConnect::Replay(std::stop_token const& stoken) {
+   std::cout << "SimConnect: Replaying " << options_.replay_->string() << std::endl;
+
+   try {
+      CaptureReader reader{*options_.replay_};
+      auto const    start = steady_clock::now();
+
+      // Stop sets event_, the timers (watchdogs, Wait, traffic polling) run as in Run
+      std::array<HANDLE, 2> const events{event_, timer_.get()};
+
+      std::size_t count = 0;
+      while (!stoken.stop_requested()) {
+         auto packet = reader.Next();
+         if (!packet) {
+            break;
+         }
+
+         while (true) {
+            auto const wait =
+              options_.replay_fast_
+                ? 0
+                : std::max<int64_t>(
+                    0, ceil<milliseconds>(start + packet->time_ - steady_clock::now()).count()
+                  );
+
+            if (
+              ::WaitForMultipleObjects(
+                static_cast<DWORD>(events.size()), events.data(), FALSE, static_cast<DWORD>(wait)
+              )
+              != (WAIT_OBJECT_0 + 1)
+            ) {
+               // Packet time, or stopping
+               break;
+            }
+            MessageQueue::Dispatch([this]() { OnTimer(); }).Detach();
+         }
+
+         if (packet->data_.size() < sizeof(SIMCONNECT_RECV)) {
+            continue;
+         }
+
+         ++count;
+         MessageQueue::Dispatch([this, packet = std::move(*packet)]() mutable {
+            ReplayPacket(*reinterpret_cast<SIMCONNECT_RECV*>(packet.data_.data()));
+         }).Detach();
+      }
+
+      MessageQueue::Dispatch([this, count]() {
+         auto const& stats = replay_sink_.GetStats();
+         std::cout << "SimConnect: Replayed " << count << " packets, " << stats.airports_
+                   << " airports (" << stats.facility_errors_ << " failed), "
+                   << stats.traffic_samples_ << " traffic samples (" << stats.aircraft_
+                   << " aircraft), " << stats.objects_ << " objects (" << stats.malformed_
+                   << " malformed), " << replay_routes_.Unbound() << " answers not replayed"
+                   << std::endl;
+      }).Detach();
+   } catch (std::exception const& e) {
+      std::cerr << "SimConnect: Replay failed: " << e.what() << std::endl;
+   }
+}
+
+void
+SimConnect::ReplayPacket(SIMCONNECT_RECV& data) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   // Answers go to the replay processors, the recorded request ids are unknown to requests_
+   auto const routed = replay_routes_.Route(data, [this](SIMCONNECT_RECV const& answer) {
+      return replay_sink_.Bind(answer);
+   });
+
+   if (routed == Routed::NOT_AN_ANSWER) {
+      Dispatch(data);
+   }
+}
+
+SimConnect::DispatchStats
+SimConnect::GetDispatchStats() const {
+   std::shared_lock lock{mutex_};
+   return dispatch_stats_;
+}
+
+SimConnect::CoalesceStats
+SimConnect::GetCoalesceStats() const {
+   std::shared_lock lock{mutex_};
+   return coalesce_stats_;
+}
+
 bool
 SimConnect::ShouldStop(std::stop_token const& stoken) const noexcept {
    return stoken.stop_requested() || !handle_.lock();
@@ -727,14 +1080,27 @@ SimConnect::Dispatch(SIMCONNECT_RECV const& data) {
    using enum DataId;
 
    auto const handle = handle_.lock();
-   if (!handle) {
+   if (!handle && !options_.replay_) {
       return;
    }
 
    switch (data.dwID) {
       case SIMCONNECT_RECV_ID_OPEN: {
+         auto const& open = static_cast<SIMCONNECT_RECV_OPEN const&>(data);
          std::cout << "SimConnect: Connection opened" << std::endl;
 
+         // Airports and terrain cached by another simulator build are outdated
+         auto const version = std::format(
+           "{}.{}.{}.{}",
+           open.dwApplicationVersionMajor,
+           open.dwApplicationVersionMinor,
+           open.dwApplicationBuildMajor,
+           open.dwApplicationBuildMinor
+         );
+         airport_cache_.SetVersion(version);
+         terrain_cache_.SetVersion(version);
+         ResetTerrainProbes();
+
          // Leave some time for the simulator to initialize after opening the connection before
          // setting the port and requesting data, otherwise we might get errors from
          // the simulator
@@ -742,6 +1108,13 @@ SimConnect::Dispatch(SIMCONNECT_RECV const& data) {
            [this] {
               assert(std::this_thread::get_id() == MessageQueue::ThreadId());
               connection_promise_.Ready();
+
+              ready_ = true;
+              requests_.ForEach([this](auto const request_id, Pending& request) {
+                 if (auto const subscription = std::get_if<Subscription>(&request.handler_)) {
+                    IssueSubscription(request_id, *subscription);
+                 }
+              });
            },
            1s
          )
@@ -752,148 +1125,31 @@ SimConnect::Dispatch(SIMCONNECT_RECV const& data) {
          auto const& exception = static_cast<SIMCONNECT_RECV_EXCEPTION const&>(data);
 
          if (auto const request_id = FindRequestIdForSendId(exception.dwSendID)) {
-            if (
-              std::apply(
-                [this, request_id, exception](auto&... pending) {
-                   return (RejectPendingOnException(this->*pending, *request_id, exception) || ...);
-                },
-                PENDING_MEMBERS
-              )
-            ) {
+            auto& request = *requests_.Find(*request_id);
+
+            if (auto const subscription = std::get_if<Subscription>(&request.handler_)) {
+               std::cerr << "SimConnect: Subscription cancelled, "
+                         << MakeSimConnectExceptionMessage(exception, *request_id) << std::endl;
+               subscription->cancel_();
+               break;
+            }
+
+            // The rejection erases the request
+            if (auto const reject = request.reject_) {
+               reject->template Apply<UnknownError>(
+                 MakeSimConnectExceptionMessage(exception, *request_id)
+               );
                break;
             }
-         } else if (auto reject = FindRejectForSendId(exception.dwSendID)) {
-            reject->template Apply<UnknownError>(MakeSimConnectExceptionMessage(exception));
-            break;
          }
 
-         assert(false && "Received SimConnect exception for unknown send ID");
-         std::cerr << "SimConnect: Exception (" << exception.dwException
+         // Untracked calls (SetDataOnSimObject, TransmitClientEvent...), send ids aged out of the
+         // ring or replayed from a capture : logged and ignored
+         std::cerr << "SimConnect: Exception for an unknown send ID (" << exception.dwException
                    << ") send_id=" << exception.dwSendID << " index=" << exception.dwIndex
                    << " id=" << exception.dwID << std::endl;
       } break;
 
-      case SIMCONNECT_RECV_ID_ASSIGNED_OBJECT_ID: {
-         // This is the only traffic-related message guaranteed in all SimConnect SDKs
-         auto const& assigned = static_cast<SIMCONNECT_RECV_ASSIGNED_OBJECT_ID const&>(data);
-         auto        request  = pending_assigned_.find(assigned.dwRequestID);
-
-         if (request != pending_assigned_.end()) {
-            request->second.first(assigned);
-         } else {
-            std::cerr << "SimConnect: Received ASSIGNED_OBJECT_ID for unknown request ID "
-                      << assigned.dwRequestID << std::endl;
-         }
-      } break;
-
-      case SIMCONNECT_RECV_ID_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST: {
-         auto const& enumerated =
-           static_cast<SIMCONNECT_RECV_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST const&>(data);
-         auto request = pending_enumerated_simobjects_.find(enumerated.dwRequestID);
-
-         if (request != pending_enumerated_simobjects_.end()) {
-            request->second.first(enumerated);
-         } else {
-            std::cerr << "SimConnect: Received ENUMERATE_SIMOBJECT_AND_LIVERY_LIST for unknown "
-                         "request ID "
-                      << enumerated.dwRequestID << std::endl;
-         }
-      } break;
-
-      case SIMCONNECT_RECV_ID_AIRPORT_LIST: {
-         auto const& facility = static_cast<SIMCONNECT_RECV_AIRPORT_LIST const&>(data);
-         auto        request  = pending_facilities_list_.find(facility.dwRequestID);
-
-         if (request != pending_facilities_list_.end()) {
-            request->second.first(facility);
-         } else {
-            std::cerr << "SimConnect: Received AIRPORT_LIST for unknown request ID "
-                      << facility.dwRequestID << std::endl;
-         }
-      } break;
-
-      case SIMCONNECT_RECV_ID_VOR_LIST: {
-         auto const& facility = static_cast<SIMCONNECT_RECV_VOR_LIST const&>(data);
-         auto        request  = pending_facilities_list_.find(facility.dwRequestID);
-
-         if (request != pending_facilities_list_.end()) {
-            request->second.first(facility);
-         } else {
-            std::cerr << "SimConnect: Received VOR_LIST for unknown request ID "
-                      << facility.dwRequestID << std::endl;
-         }
-      } break;
-
-      case SIMCONNECT_RECV_ID_NDB_LIST: {
-         auto const& facility = static_cast<SIMCONNECT_RECV_NDB_LIST const&>(data);
-         auto        request  = pending_facilities_list_.find(facility.dwRequestID);
-
-         if (request != pending_facilities_list_.end()) {
-            request->second.first(facility);
-         } else {
-            std::cerr << "SimConnect: Received NDB_LIST for unknown request ID "
-                      << facility.dwRequestID << std::endl;
-         }
-      } break;
-
-      case SIMCONNECT_RECV_ID_WAYPOINT_LIST: {
-         auto const& facility = static_cast<SIMCONNECT_RECV_WAYPOINT_LIST const&>(data);
-         auto        request  = pending_facilities_list_.find(facility.dwRequestID);
-
-         if (request != pending_facilities_list_.end()) {
-            request->second.first(facility);
-         } else {
-            std::cerr << "SimConnect: Received WAYPOINT_LIST for unknown request ID "
-                      << facility.dwRequestID << std::endl;
-         }
-      } break;
-
-      case SIMCONNECT_RECV_ID_SIMOBJECT_DATA: {
-         auto const now = std::chrono::steady_clock::now();
-
-         auto const& simobj  = static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA const&>(data);
-         auto        request = pending_simobject_.find(simobj.dwRequestID);
-         if (request != pending_simobject_.end()) {
-            request->second.first(simobj, now);
-         } else {
-            std::cerr << "SimConnect: Received SIMOBJECT_DATA for unknown request ID "
-                      << simobj.dwRequestID << std::endl;
-         }
-      } break;
-
-      case SIMCONNECT_RECV_ID_FACILITY_DATA: {
-         auto const& facility = static_cast<SIMCONNECT_RECV_FACILITY_DATA const&>(data);
-         auto        request  = pending_facility_.find(facility.UserRequestId);
-         if (request != pending_facility_.end()) {
-            request->second.first(facility);
-         } else {
-            std::cerr << "SimConnect: Received FACILITY_DATA for unknown request ID "
-                      << facility.UserRequestId << std::endl;
-         }
-      } break;
-
-      case SIMCONNECT_RECV_ID_FACILITY_DATA_END: {
-         auto const& facility = static_cast<SIMCONNECT_RECV_FACILITY_DATA_END const&>(data);
-         auto        request  = pending_facility_.find(facility.RequestId);
-         if (request != pending_facility_.end()) {
-            request->second.first(facility);
-         } else {
-            std::cerr << "SimConnect: Received FACILITY_DATA_END for unknown request ID "
-                      << facility.RequestId << std::endl;
-         }
-      } break;
-
-      case SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE: {
-         auto const& simobj  = static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const&>(data);
-         auto        request = pending_simobject_type_.find(simobj.dwRequestID);
-         if (request != pending_simobject_type_.end()) {
-            request->second.first(simobj);
-         } else {
-            std::cerr << "SimConnect: Received SIMOBJECT_DATA_BYTYPE for unknown request ID "
-                      << simobj.dwRequestID << std::endl;
-         }
-      } break;
-
       case SIMCONNECT_RECV_ID_QUIT: {
          std::cout << "SimConnect: Simulator quit" << std::endl;
          handle_.reset();
@@ -901,7 +1157,19 @@ SimConnect::Dispatch(SIMCONNECT_RECV const& data) {
       } break;
 
       default:
-         assert(false && "Received unknown SimConnect message type");
+         switch (RouteAnswer(requests_, data)) {
+            case Routed::ANSWERED:
+               break;
+
+            case Routed::UNKNOWN_REQUEST:
+               std::cerr << "SimConnect: Received " << data.dwID << " for unknown request ID "
+                         << *AnswerRequestId(data) << std::endl;
+               break;
+
+            case Routed::NOT_AN_ANSWER:
+               assert(false && "Received unknown SimConnect message type");
+               break;
+         }
    }
 }
 
@@ -15,9 +15,25 @@
 
 #pragma once
 
+#include "Capture.h"
+#include "Data/DataId.h"
+#include "Definitions.h"
+#include "Data/Tagged.h"
 #include "Data/TrafficInfo.h"
 #include "Data/TrafficStaticInfo.h"
+#include "FacilityData/AirportCache.h"
 #include "FacilityData/AirportFacility.h"
+#include "FramePool.h"
+#include "Replay.h"
+#include "Requests.h"
+#include "Stream.h"
+#include "TerrainCache.h"
+#include "TimerWheel.h"
+#include "Traffic.h"
+#include "Utils/ByTypeCount.h"
+#include "Utils/SendIdRing.h"
+#include "Utils/SlotMap.h"
+#include "Utils/SmallFunction.h"
 #include "promise/StatePromise.h"
 
 #include <promise/promise.h>
@@ -38,11 +54,22 @@
 #include <windef.h>
 #include <winnt.h>
 #include <winuser.h>
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <exception>
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <shared_mutex>
 #include <string>
 #include <stdexcept>
 #include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
 
 class Main;
 
@@ -80,48 +107,6 @@ struct Parameter<Message::SIMCONNECT_SET_SERVER_PORT> {
 
 using ServerPortParam = Parameter<Message::SIMCONNECT_SET_SERVER_PORT>;
 
-enum class DataId : uint32_t {
-   SET_PORT,
-   EVENT_FRAME,
-   TRAFFIC,
-   TRAFFIC_INFO,
-   TRAFFIC_STATIC_INFO,
-   HELI_TRAFFIC_INFO,
-   TAXIWAY_PATH,
-   USER_INFO,
-   GROUND_INFO,
-
-   SET_WAYPOINTS,
-   WAYPOINT_INDEX,
-   SET_AI_HEADING,
-   SET_AI_SPEED,
-
-   GET_SIMRATE,
-
-   GET_AIRPORT_FACILITY,
-
-   SET_AIRSPEED_CONTROL,
-   SET_ALTITUDE_CONTROL,
-   SET_BANK_CONTROL,
-   SET_BREAK,
-   SET_CONTROL_SURFACES,
-   SET_FLAPS,
-   SET_GEAR,
-   SET_GROUND_ALTITUDE_CONTROL,
-   SET_GROUND_ALTITUDE,
-   SET_HEADING_CONTROL,
-   SET_ON_GROUND,
-   SET_PITCH_CONTROL,
-   SET_ROTATION_CONTROL,
-   SET_SPEED_CONTROL,
-   SET_VSPEED_CONTROL,
-   SET_THROTTLE,
-
-   SET_INIT_POSISION,
-
-   MAX_VALUE,
-};
-
 enum class EventId : uint32_t {
    AP_MASTER,
    AP_ALT_HOLD,
@@ -188,11 +173,36 @@ inline constexpr bool IS_VECTOR = requires(T t) {
    std::is_same_v<std::remove_cvref_t<T>, std::vector<typename std::remove_cvref_t<T>::value_type>>;
 };
 
+template <class PROMISE>
+struct BatchTraits;
+
+template <class T>
+struct BatchTraits<WPromise<T>> {
+   using Value = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+};
+
 class SimConnect : private promise::MessageQueue {
 public:
    using ObjectId = SIMCONNECT_RECV_ASSIGNED_OBJECT_ID;
 
-   SimConnect(Main& main);
+   struct Options {
+      // Records every received packet
+      std::optional<std::filesystem::path> capture_{};
+      // Feeds a capture to Dispatch instead of connecting to the simulator, at the recorded pace
+      // unless replay_fast_
+      std::optional<std::filesystem::path> replay_{};
+      bool                                 replay_fast_{false};
+      // Airport facilities cache directory, <install>/Data/AirportCache by default. Replays only
+      // cache in memory.
+      std::optional<std::filesystem::path> airport_cache_{};
+      bool                                 clear_airport_cache_{false};
+      // Terrain elevations cache directory, <install>/Data/TerrainCache by default. Replays only
+      // cache in memory.
+      std::optional<std::filesystem::path> terrain_cache_{};
+      bool                                 clear_terrain_cache_{false};
+   };
+
+   SimConnect(Main& main, Options options = {});
    ~SimConnect() override;
 
    void Stop();
@@ -219,13 +229,59 @@ public:
    [[nodiscard]] WPromise<void>
    SetDataOnSimObject(DataId id, SIMCONNECT_OBJECT_ID objectId, DWORD flags, TYPE&& data);
 
+   // Ground altitude in feet, interpolated from the terrain cache. The missing posts are probed
+   // in batches by a pool of probe objects. A point missing from the cache is probed directly,
+   // its posts are filled in the background.
    [[nodiscard]] WPromise<double>            GetGroundInfo(double lat, double lon);
    [[nodiscard]] WPromise<TrafficInfo>       GetUserAircraftInfo() noexcept(true);
    [[nodiscard]] WPromise<TrafficInfo>       GetAircraftInfo(ObjectId id) noexcept(true);
+   // Only the TrafficPosition fields are requested, the others are left at 0
+   [[nodiscard]] WPromise<TrafficPosition>   GetUserAircraftPosition() noexcept(true);
+   [[nodiscard]] WPromise<TrafficPosition>   GetAircraftPosition(ObjectId id) noexcept(true);
    [[nodiscard]] WPromise<TrafficStaticInfo> GetAircraftStaticInfo(ObjectId id) noexcept(true);
    [[nodiscard]] WPromise<facility::AirportData>
    GetAirportFacility(std::string_view icao, std::string_view region = {}) noexcept(true);
 
+   // Same as GetGroundInfo for each lat/lon position, e.g. a route profile
+   [[nodiscard]] WPromise<std::vector<double>>
+   GetGroundProfile(std::vector<std::pair<double, double>> positions);
+
+   // Drops the cached airport (all of them if icao is empty), after a scenery change
+   [[nodiscard]] WPromise<void>
+   InvalidateAirportFacility(std::string_view icao = {}, std::string_view region = {});
+
+   // Periodic samples (SIM_FRAME, VISUAL_FRAME or SECOND period) without a request per sample.
+   // SIMCONNECT_DATA_REQUEST_FLAG_CHANGED only sends the samples that changed, interval is the
+   // number of periods skipped between two samples. Subscriptions survive reconnections.
+   [[nodiscard]] Stream<TrafficInfo> SubscribeUserAircraftInfo(
+     SIMCONNECT_PERIOD period   = SIMCONNECT_PERIOD_SIM_FRAME,
+     DWORD             flags    = SIMCONNECT_DATA_REQUEST_FLAG_CHANGED,
+     DWORD             interval = 0
+   );
+   [[nodiscard]] Stream<TrafficInfo> SubscribeAircraftInfo(
+     ObjectId          id,
+     SIMCONNECT_PERIOD period   = SIMCONNECT_PERIOD_SIM_FRAME,
+     DWORD             flags    = SIMCONNECT_DATA_REQUEST_FLAG_CHANGED,
+     DWORD             interval = 0
+   );
+
+   // Same samples, as the changed fields only (SIMCONNECT_DATA_REQUEST_FLAG_CHANGED | TAGGED).
+   // They are applied onto the last value, dirty_ tells which fields changed
+   [[nodiscard]] Stream<Tagged<TrafficInfo>> SubscribeUserAircraftChanges(
+     SIMCONNECT_PERIOD period   = SIMCONNECT_PERIOD_SIM_FRAME,
+     DWORD             interval = 0
+   );
+   [[nodiscard]] Stream<Tagged<TrafficInfo>> SubscribeAircraftChanges(
+     ObjectId          id,
+     SIMCONNECT_PERIOD period   = SIMCONNECT_PERIOD_SIM_FRAME,
+     DWORD             interval = 0
+   );
+
+   // AI and multiplayer aircraft in range, sampled every period (the shortest one of the live
+   // streams). The first sample of a stream lists every known aircraft as added.
+   [[nodiscard]] Stream<TrafficDiff>
+   SubscribeTraffic(std::chrono::milliseconds period = std::chrono::seconds{1});
+
    [[nodiscard]] WPromise<SIMCONNECT_RECV_ASSIGNED_OBJECT_ID>
    AICreateSimulatedObject(std::string_view title, SIMCONNECT_DATA_INITPOSITION pos);
 
@@ -256,13 +312,69 @@ public:
 
    WPromise<void> Connected() const;
 
+   // Value a Batch func resolves with, void becomes std::monostate
+   template <class FUNC>
+   using BatchValue = typename BatchTraits<std::invoke_result_t<FUNC&>>::Value;
+
+   // Calls every func on the SimConnect thread, where the queries they make skip the thread hops,
+   // and resolves with all their results at once : a single hop there and back for the batch.
+   // The queries are issued together, the first failure rejects the whole batch.
+   //   auto [user, ground] = co_await simconnect.Batch(
+   //     [&] { return simconnect.GetUserAircraftInfo(); },
+   //     [&] { return simconnect.GetGroundInfo(lat, lon); }
+   //   );
+   template <class... FUNCS>
+   [[nodiscard]] WPromise<std::tuple<BatchValue<FUNCS>...>> Batch(FUNCS&&... funcs) const;
+
+   // Packets drained from SimConnect, packets_ / wakes_ is the mean count per wake
+   struct DispatchStats {
+      uint64_t                  wakes_{};
+      uint64_t                  batches_{};
+      uint64_t                  packets_{};
+      uint64_t                  max_batch_packets_{};
+      std::chrono::microseconds batch_time_{};
+      std::chrono::microseconds max_batch_time_{};
+   };
+   [[nodiscard]] DispatchStats GetDispatchStats() const;
+
+   // Identical concurrent queries share one request, suppressed_ / issued_ is the hit rate
+   struct CoalesceStats {
+      uint64_t issued_{};
+      uint64_t suppressed_{};  // Joined an in-flight request
+      uint64_t cached_{};      // Served by a result that hasn't expired yet
+   };
+   [[nodiscard]] CoalesceStats GetCoalesceStats() const;
+
 private:
    bool           ShouldStop(std::stop_token const& stoken) const noexcept;
    void           Run(std::stop_token const& stoken);
-   WPromise<void> Wait(std::chrono::milliseconds timeout) const;
-
+   void           Replay(std::stop_token const& stoken);
+   void           ReplayPacket(SIMCONNECT_RECV& data);
+   // Resolves after timeout, or once disconnected or terminating
+   WPromise<void> Wait(std::chrono::milliseconds timeout);
+   // Resolves after timeout or with interrupt, the timer is cancelled when interrupted
+   WPromise<void> Wait(std::chrono::milliseconds timeout, WPromise<void> interrupt);
+
+   // Timers of the SimConnect thread, timer_ is armed for the next one only
+   TimerWheel::Id Schedule(std::chrono::milliseconds delay, TimerWheel::Callback&& callback);
+   void           CancelTimer(TimerWheel::Id id);
+   void           OnTimer();
+   void           ArmTimer();
+
+   // Runs func on the SimConnect thread and resolves on the main pool. Called from the SimConnect
+   // thread once connected, func is run inline.
    template <class T>
    [[nodiscard]] WPromise<T> Proxy(std::function<WPromise<T>()>&& func) const;
+   WPromise<void>            RunBatch(std::function<WPromise<void>()>&& func) const;
+
+   // Runs func unless a query with the same key is in flight (or answered less than ttl ago), in
+   // which case its result is shared. Must be called on the SimConnect thread.
+   template <class T>
+   [[nodiscard]] WPromise<T> Coalesce(
+     std::string&&                  key,
+     std::function<WPromise<T>()>&& func,
+     std::chrono::milliseconds      ttl = std::chrono::milliseconds{0}
+   );
 
    template <DataId ID>
    [[nodiscard]] bool AddToDataDefinition(
@@ -283,6 +395,9 @@ private:
    [[nodiscard]] bool AddToDataDefinition(std::shared_ptr<void*> const& handle);
    template <DataId ID, class T>
    [[nodiscard]] bool AddToDataDefinition();
+   // The datum ids are the indexes in T::MEMBERS, as read by ApplyTagged
+   template <DataId ID, class T>
+   [[nodiscard]] bool AddToTaggedDataDefinition(std::shared_ptr<void*> const& handle);
 
    template <DataId ID>
    [[nodiscard]] bool AddToFacilityDefinition(std::string_view datumName);
@@ -295,7 +410,7 @@ private:
    [[nodiscard]] bool AddToFacilityDefinition();
 
    template <DataId ID, class T>
-   [[nodiscard]] WPromise<std::vector<T>> RequestDataOnSimObjectType(
+   [[nodiscard]] WPromise<std::vector<SimobjectData<T>>> RequestDataOnSimObjectType(
      SIMCONNECT_SIMOBJECT_TYPE objectType,
      uint32_t                  radius = 0,
      std::shared_ptr<void*>    handle = nullptr
@@ -316,6 +431,14 @@ private:
    [[nodiscard]] WPromise<SimobjectData<DATA_TYPE>>
    RequestDataOnSimObject(uint32_t objectId, std::shared_ptr<void*> handle);
 
+   template <DataId ID, class DATA_TYPE>
+   [[nodiscard]] Stream<DATA_TYPE> SubscribeDataOnSimObject(
+     uint32_t          objectId,
+     SIMCONNECT_PERIOD period,
+     DWORD             flags,
+     DWORD             interval
+   );
+
    [[nodiscard]] WPromise<SIMCONNECT_RECV_ASSIGNED_OBJECT_ID> AICreateSimulatedObject(
      std::string_view             title,
      SIMCONNECT_DATA_INITPOSITION pos,
@@ -330,99 +453,193 @@ private:
      std::shared_ptr<void*>       handle
    );
 
+   [[nodiscard]] WPromise<Liveries> EnumerateSimObjectsAndLiveriesImpl(
+     SIMCONNECT_SIMOBJECT_TYPE objectType
+   );
+
    template <class T>
    static T StaticCast(DWORD const& data);
 
+   // Applies the (datum id, value) pairs of a tagged packet onto into. Returns the dirty mask of
+   // the fields read, nullopt when the packet is malformed
+   template <class T>
+   static std::optional<uint64_t>
+   ApplyTagged(SIMCONNECT_RECV_SIMOBJECT_DATA const& data, T& into);
+
    template <class T>
    static std::size_t Size();
 
+   [[nodiscard]] SIMCONNECT_DATA_REQUEST_ID ReserveRequest();
+   template <class HANDLER, class FUNC>
+   void SetPending(
+     SIMCONNECT_DATA_REQUEST_ID    requestId,
+     FUNC&&                        handler,
+     std::shared_ptr<Reject const> reject
+   );
+
    [[nodiscard]] bool
    TrackRequestSendId(std::shared_ptr<void*> const& handle, SIMCONNECT_DATA_REQUEST_ID requestId);
-   [[nodiscard]] std::optional<DWORD>
+   [[nodiscard]] std::optional<SIMCONNECT_DATA_REQUEST_ID>
    TrackPendingSendId(std::shared_ptr<void*> const& handle, std::shared_ptr<Reject const> reject);
-   void ClearTrackedSendId(SIMCONNECT_DATA_REQUEST_ID requestId);
-   [[nodiscard]] std::optional<SIMCONNECT_DATA_REQUEST_ID> FindRequestIdForSendId(
-     DWORD sendId
-   ) const;
-   [[nodiscard]] std::shared_ptr<Reject const> FindRejectForSendId(DWORD sendId) const;
-
-   void Dispatch(SIMCONNECT_RECV const& data);
+   [[nodiscard]] std::optional<SIMCONNECT_DATA_REQUEST_ID> FindRequestIdForSendId(DWORD sendId);
 
-   SIMCONNECT_DATA_REQUEST_ID request_id_{0};
+   void IssueSubscription(SIMCONNECT_DATA_REQUEST_ID requestId, Subscription& subscription);
+   void Unsubscribe(SIMCONNECT_DATA_REQUEST_ID requestId);
 
-   StatePromise connection_promise_{};
+   // Rejects the request with Timeout when *remaining (entries left to receive) hasn't changed
+   // for PROGRESS_TIMEOUT, its timer is cancelled by EraseRequest
+   static constexpr std::chrono::seconds PROGRESS_TIMEOUT{5};
 
-   using WaitingSimObject = std::map<
-     SIMCONNECT_DATA_REQUEST_ID,
-     std::pair<
-       std::function<
-         void(SIMCONNECT_RECV_SIMOBJECT_DATA const&, std::chrono::steady_clock::time_point const&)>,
-       std::shared_ptr<Reject const>>>;
-   WaitingSimObject pending_simobject_{};
-
-   using WaitingFacility = std::map<
-     SIMCONNECT_DATA_REQUEST_ID,
-     std::pair<
-       std::function<void(std::variant<
-                          std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA const>,
-                          std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA_END const>> const&)>,
-       std::shared_ptr<Reject const>>>;
-   WaitingFacility pending_facility_{};
-
-   using WaitingSimObjectType = std::map<
-     SIMCONNECT_DATA_REQUEST_ID,
-     std::pair<
-       std::function<void(SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const&)>,
-       std::shared_ptr<Reject const>>>;
-   WaitingSimObjectType pending_simobject_type_{};
-
-   using WaitingEnumeratedSimObjects = std::map<
-     SIMCONNECT_DATA_REQUEST_ID,
-     std::pair<
-       std::function<void(SIMCONNECT_RECV_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST const&)>,
-       std::shared_ptr<Reject const>>>;
-   WaitingEnumeratedSimObjects pending_enumerated_simobjects_{};
-   using WaitingFacilitiesList = std::map<
-     SIMCONNECT_DATA_REQUEST_ID,
-     std::pair<
-       std::function<void(SIMCONNECT_RECV_FACILITIES_LIST const&)>,
-       std::shared_ptr<Reject const>>>;
-   WaitingFacilitiesList pending_facilities_list_{};
-
-   using WaitingAssignedObject = std::map<
-     SIMCONNECT_DATA_REQUEST_ID,
-     std::pair<
-       std::function<void(SIMCONNECT_RECV_ASSIGNED_OBJECT_ID const&)>,
-       std::shared_ptr<Reject const>>>;
-   WaitingAssignedObject pending_assigned_{};
-
-   static constexpr auto PENDING_MEMBERS = std::make_tuple(
-     &SimConnect::pending_simobject_,
-     &SimConnect::pending_facility_,
-     &SimConnect::pending_simobject_type_,
-     &SimConnect::pending_enumerated_simobjects_,
-     &SimConnect::pending_facilities_list_,
-     &SimConnect::pending_assigned_
+   void WatchProgress(
+     SIMCONNECT_DATA_REQUEST_ID         requestId,
+     std::shared_ptr<std::size_t const> remaining,
+     char const*                        message
    );
+   void EraseRequest(SIMCONNECT_DATA_REQUEST_ID requestId);
+
+   // Meters, the largest radius allowed by SimConnect
+   static constexpr DWORD TRAFFIC_RADIUS = 200000;
+
+   void                  PollTraffic();
+   WPromise<TrafficDiff> SampleTraffic();
+
+   // Probe objects alive at once, reused (moved) by the terrain probes
+   static constexpr std::size_t TERRAIN_PROBES = 8;
+   // Samples of a moved probe until it is seen at its position, the move may land a frame later
+   static constexpr std::size_t TERRAIN_PROBE_READS = 4;
+
+   struct TerrainProbe {
+      DWORD    id_{};
+      uint64_t generation_{};
+   };
+
+   // Probes the post, then caches its altitude
+   [[nodiscard]] WPromise<float> ProbeTerrain(TerrainCache::Post post);
+   [[nodiscard]] WPromise<float> ProbeGround(double lat, double lon);
+   // Created at position when none is idle
+   [[nodiscard]] WPromise<TerrainProbe>
+   AcquireTerrainProbe(std::shared_ptr<void*> handle, SIMCONNECT_DATA_INITPOSITION position);
+   // Broken probes are forgotten, another one is created instead
+   void ReleaseTerrainProbe(TerrainProbe probe, bool broken);
+   // The probes die with the connection
+   void ResetTerrainProbes();
+
+   // Packets dispatched per queued task, the remaining ones are drained by another task
+   static constexpr std::size_t DISPATCH_BUDGET = 256;
+
+   void Drain(std::shared_ptr<void*> const& handle);
+   void Dispatch(SIMCONNECT_RECV const& data);
 
-   std::map<DWORD, SIMCONNECT_DATA_REQUEST_ID>    send_id_to_request_id_{};
-   std::map<SIMCONNECT_DATA_REQUEST_ID, DWORD>    request_id_to_send_id_{};
-   std::map<DWORD, std::shared_ptr<Reject const>> send_id_to_reject_{};
+   StatePromise connection_promise_{};
 
    using time_point = std::chrono::steady_clock::time_point;
 
-   mutable std::shared_mutex mutex_{};
+   using Pending = PendingRequest<Reject>;
+
+   Requests<Reject> requests_{};
+
+   // Exceptions come back shortly after their call, older send ids are forgotten
+   static constexpr std::size_t SEND_ID_RING = 2048;
+   SendIdRing<SEND_ID_RING>     send_ids_{};
 
-   Main&        main_;
-   win32::Event event_{win32::CreateEvent()};
-   int64_t      server_port_{48578};
-   int64_t      sent_port_{-1};
+   struct FlightBase {
+      std::vector<std::shared_ptr<Resolve<void> const>> waiters_{};
+      std::exception_ptr                                exception_{};
+      time_point                                        expires_{time_point::max()};
+   };
+
+   template <class T>
+   struct Flight : FlightBase {
+      std::optional<T> result_{};
+   };
+
+   // Queries in flight or recently answered, by operation and arguments (Flight<T>)
+   std::unordered_map<std::string, std::shared_ptr<FlightBase>> flights_{};
+   CoalesceStats                                                coalesce_stats_{};
+
+   struct TrafficStream {
+      std::weak_ptr<Stream<TrafficDiff>::State> state_{};
+      std::chrono::milliseconds                 period_{};
+      bool                                      fresh_{true};  // Waiting for its snapshot
+   };
+
+   TrafficTable               traffic_{};
+   std::vector<TrafficStream> traffic_streams_{};
+   bool                       traffic_polling_{false};
+
+   struct TerrainProbes {
+      std::vector<DWORD>                                idle_{};
+      std::size_t                                       created_{};  // Idle or busy
+      uint64_t                                          generation_{};
+      std::vector<std::shared_ptr<Resolve<void> const>> waiters_{};
+   };
+
+   TerrainProbes terrain_probes_{};
+   bool                    ready_{false};
+
+   mutable std::shared_mutex mutex_{};
+   DispatchStats             dispatch_stats_{};
+   std::atomic<bool>         drain_queued_{false};
+
+   Main&                        main_;
+   Options const                options_;
+   std::optional<CaptureWriter> capture_{};
+   ReplayRoutes                 replay_routes_{};  // On the SimConnect thread, like requests_
+   ReplaySink                   replay_sink_{};
+   facility::AirportCache       airport_cache_;
+   TerrainCache                 terrain_cache_;
+   win32::Event                 event_{win32::CreateEvent()};
+   int64_t                      server_port_{48578};
+   int64_t                      sent_port_{-1};
+
+   TimerWheel                                   timers_{};
+   std::optional<TimerWheel::Clock::time_point> armed_{};
+   // Waited on by Run along with event_
+   std::unique_ptr<void, decltype(&::CloseHandle)> timer_{
+     ::CreateWaitableTimerW(nullptr, FALSE, nullptr), &::CloseHandle
+   };
 
    std::weak_ptr<HANDLE> handle_{};
 
    std::jthread thread_{};
 };
 
+template <class... FUNCS>
+WPromise<std::tuple<SimConnect::BatchValue<FUNCS>...>>
+SimConnect::Batch(FUNCS&&... funcs) const {
+   using Result = std::tuple<BatchValue<FUNCS>...>;
+
+   // Shared with the calls still running when one of them fails
+   auto result = std::make_shared<Result>();
+
+   auto issue = [result, funcs = std::make_tuple(std::forward<FUNCS>(funcs)...)]() mutable {
+      return MakePromise([result, funcs = std::move(funcs)]() mutable -> Promise<void> {
+         auto calls = [&]<std::size_t... INDEX>(std::index_sequence<INDEX...>) {
+            return std::array<WPromise<void>, sizeof...(FUNCS)>{
+              MakePromise([result, &func = std::get<INDEX>(funcs)]() -> Promise<void> {
+                 using Value = std::tuple_element_t<INDEX, Result>;
+                 if constexpr (std::is_same_v<Value, std::monostate>) {
+                    co_await func();
+                 } else {
+                    std::get<INDEX>(*result) = co_await func();
+                 }
+              })...
+            };
+         }(std::index_sequence_for<FUNCS...>{});
+
+         // Issued together, awaited in order
+         for (auto& call : calls) {
+            co_await call;
+         }
+      });
+   };
+
+   return MakePromise([this, result, issue = std::move(issue)]() mutable -> Promise<Result> {
+      co_await RunBatch(std::move(issue));
+      co_return std::move(*result);
+   });
+}
+
 }  // namespace smc
 
 using SimConnect = smc::SimConnect;
\ No newline at end of file
@@ -20,6 +20,7 @@
 
 #include <cstdint>
 #include <exception>
+#include <iostream>
 #include <memory>
 #include <SimConnect.h>
 #include <synchapi.h>
@@ -36,7 +37,19 @@ namespace smc {
 template <class T>
 [[nodiscard]] WPromise<T>
 SimConnect::Proxy(std::function<WPromise<T>()>&& func) const {
-   return MakePromise([this, func = std::move(func)] -> Promise<T> {
+   if ((std::this_thread::get_id() == MessageQueue::ThreadId()) && ready_) {
+      // Already connected and on the SimConnect thread (e.g. within a Batch) : no hop, the caller
+      // resumes on this thread
+      return MakePromise(Pooled([func = std::move(func)](PooledFrame) -> Promise<T> {
+         if constexpr (std::is_void_v<T>) {
+            co_await func();
+         } else {
+            co_return co_await func();
+         }
+      }));
+   }
+
+   return MakePromise(Pooled([this, func = std::move(func)](PooledFrame) -> Promise<T> {
       {
          std::exception_ptr exception;
          try {
@@ -74,7 +87,88 @@ SimConnect::Proxy(std::function<WPromise<T>()>&& func) const {
       assert(exception);
       co_await main_.MainPool::Dispatch();
       std::rethrow_exception(exception);
-   });
+   }));
+}
+
+template <class T>
+[[nodiscard]] WPromise<T>
+SimConnect::Coalesce(
+  std::string&&                  key,
+  std::function<WPromise<T>()>&& func,
+  std::chrono::milliseconds      ttl
+) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   auto const now = std::chrono::steady_clock::now();
+   std::erase_if(flights_, [now](auto const& entry) { return entry.second->expires_ <= now; });
+
+   if (
+     auto const it = flights_.find(key);
+     it != flights_.end()
+   ) {
+      auto const flight = std::static_pointer_cast<Flight<T>>(it->second);
+
+      {
+         std::unique_lock lock{mutex_};
+         ++(flight->result_ ? coalesce_stats_.cached_ : coalesce_stats_.suppressed_);
+      }
+
+      return MakePromise(Pooled([flight](PooledFrame) -> Promise<T> {
+         if (!flight->result_) {
+            co_await MakePromise(
+              [flight](Resolve<void> const& resolve, Reject const&) -> Promise<void, true> {
+                 flight->waiters_.emplace_back(resolve.shared_from_this());
+                 co_return;
+              }
+            );
+         }
+
+         if (flight->exception_) {
+            std::rethrow_exception(flight->exception_);
+         }
+         co_return *flight->result_;
+      }));
+   }
+
+   auto const flight = std::make_shared<Flight<T>>();
+   flights_.emplace(key, flight);
+   {
+      std::unique_lock lock{mutex_};
+      ++coalesce_stats_.issued_;
+   }
+
+   return MakePromise(Pooled(
+     [this, key = std::move(key), func = std::move(func), ttl, flight](PooledFrame) -> Promise<T> {
+        std::exception_ptr exception{};
+        try {
+           flight->result_ = co_await func();
+        } catch (...) {
+           exception = std::current_exception();
+        }
+        assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+        // Failures aren't cached
+        flight->exception_ = exception;
+        flight->expires_   = std::chrono::steady_clock::now() + (exception ? 0ms : ttl);
+        if (
+          auto const it = flights_.find(key);
+          (it != flights_.end()) && (it->second == flight) && (exception || (ttl <= 0ms))
+        ) {
+           flights_.erase(it);
+        }
+
+        auto const waiters = std::move(flight->waiters_);
+        flight->waiters_.clear();
+        for (auto const& waiter : waiters) {
+           (*waiter)();
+        }
+
+        if (exception) {
+           std::rethrow_exception(exception);
+        }
+        co_return *flight->result_;
+     }
+   ));
 }
 
 template <typename>
@@ -105,36 +199,21 @@ SimConnect::AddToDataDefinition(
   std::optional<std::string_view> unitsName,
   std::optional<DWORD>            groupId
 ) {
-   return SimConnect_AddToDataDefinition(
-            *handle,
-            static_cast<uint32_t>(ID),
-            datumName.data(),
-            unitsName ? unitsName->data() : nullptr,
-            datumType,
-            0,
-            groupId.value_or(SIMCONNECT_UNUSED)
-          )
-          == S_OK;
+   return smc::AddToDataDefinition(
+     *handle, static_cast<uint32_t>(ID), datumName, datumType, unitsName, groupId
+   );
 }
 
 template <DataId ID, class T>
 bool
 SimConnect::AddToDataDefinition(std::shared_ptr<void*> const& handle) {
-   return std::apply(
-     [&](auto&&... member) constexpr {
-        return (
-          AddToDataDefinition<ID>(
-            handle,
-            std::get<1>(member),
-            std::get<2>(member).VALUE_S,
-            std::get<3>(member),
-            std::get<4>(member)
-          )
-          && ...
-        );
-     },
-     T::MEMBERS
-   );
+   return smc::AddToDataDefinition<T>(*handle, static_cast<uint32_t>(ID));
+}
+
+template <DataId ID, class T>
+bool
+SimConnect::AddToTaggedDataDefinition(std::shared_ptr<void*> const& handle) {
+   return smc::AddToTaggedDataDefinition<T>(*handle, static_cast<uint32_t>(ID));
 }
 
 template <DataId ID>
@@ -151,58 +230,7 @@ SimConnect::AddToFacilityDefinition(std::string_view fieldName) {
 template <DataId ID, class T>
 bool
 SimConnect::AddToFacilityDefinition(std::shared_ptr<void*> const& handle) {
-   if constexpr (requires { T::MEMBERS; }) {
-      if (!std::apply(
-            [&](auto&&... member) constexpr {
-               return (AddToFacilityDefinition<ID>(handle, std::get<0>(member)) && ...);
-            },
-            T::MEMBERS
-          )) {
-         return false;
-      }
-   }
-
-   if constexpr (requires { T::SECTIONS; }) {
-      if (!std::apply(
-            [&](auto&&... members) constexpr {
-               return (
-                 [&](auto&& member) constexpr {
-                    if (!AddToFacilityDefinition<ID>(
-                          handle, "OPEN " + std::string{std::get<0>(member)}
-                        )) {
-                       return false;
-                    }
-
-                    using MEMBER =
-                      std::remove_cvref_t<decltype(std::declval<T>().*std::get<1>(member))>;
-                    if constexpr (requires { typename MEMBER::value_type; }) {
-                       if (!AddToFacilityDefinition<ID, typename MEMBER::value_type>(handle)) {
-                          return false;
-                       }
-                    } else {
-                       if (!AddToFacilityDefinition<ID, MEMBER>(handle)) {
-                          return false;
-                       }
-                    }
-
-                    if (!AddToFacilityDefinition<ID>(
-                          handle, "CLOSE " + std::string{std::get<0>(member)}
-                        )) {
-                       return false;
-                    }
-
-                    return true;
-                 }(members)
-                 && ...
-               );
-            },
-            T::SECTIONS
-          )) {
-         return false;
-      }
-   }
-
-   return true;
+   return smc::AddToFacilityDefinition<T>(*handle, static_cast<uint32_t>(ID));
 }
 
 template <DataId ID>
@@ -211,8 +239,7 @@ SimConnect::AddToFacilityDefinition(
   std::shared_ptr<void*> const& handle,
   std::string_view              fieldName
 ) {
-   return SimConnect_AddToFacilityDefinition(*handle, static_cast<uint32_t>(ID), fieldName.data())
-          == S_OK;
+   return smc::AddToFacilityDefinition(*handle, static_cast<uint32_t>(ID), fieldName);
 }
 
 template <DataId ID, class T>
@@ -225,19 +252,39 @@ SimConnect::AddToDataDefinition() {
    return AddToDataDefinition<ID, T>(handle);
 }
 
+template <class HANDLER, class FUNC>
+void
+SimConnect::SetPending(
+  SIMCONNECT_DATA_REQUEST_ID    request_id,
+  FUNC&&                        handler,
+  std::shared_ptr<Reject const> reject
+) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   auto const request = requests_.Find(request_id);
+   if (!request) {
+      // Settled in the meantime
+      return;
+   }
+
+   request->handler_.template emplace<HANDLER>(std::forward<FUNC>(handler));
+   request->reject_ = std::move(reject);
+}
+
 template <DataId ID, class DATA_TYPE>
-WPromise<std::vector<DATA_TYPE>>
+WPromise<std::vector<SimobjectData<DATA_TYPE>>>
 SimConnect::RequestDataOnSimObjectType(
   SIMCONNECT_SIMOBJECT_TYPE objectType,
   uint32_t                  radius,
   std::shared_ptr<void*>    handle
 ) {
-   auto const request_id = ++request_id_;
+   auto const request_id = ReserveRequest();
 
    return MakePromise(
             [this, handle, objectType, radius, request_id](
-              Resolve<std::vector<DATA_TYPE>> const& resolve, Reject const& reject
-            ) mutable -> Promise<std::vector<DATA_TYPE>, true> {
+              Resolve<std::vector<SimobjectData<DATA_TYPE>>> const& resolve,
+              Reject const&                                         reject
+            ) mutable -> Promise<std::vector<SimobjectData<DATA_TYPE>>, true> {
                if (!handle) {
                   handle = handle_.lock();
                   if (!handle) {
@@ -246,12 +293,21 @@ SimConnect::RequestDataOnSimObjectType(
                   }
                }
 
-               auto const result = std::make_shared<std::vector<DATA_TYPE>>();
-               pending_simobject_type_.try_emplace(
+               auto const count = std::make_shared<ByTypeCount>();
+
+               SetPending<SimObjectTypeHandler>(
                  request_id,
                  [this,
-                  reject = reject.shared_from_this(),
-                  result](SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const& data) {
+                  result  = std::vector<SimobjectData<DATA_TYPE>>{},
+                  resolve = resolve.shared_from_this(),
+                  reject  = reject.shared_from_this(),
+                  count](SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const& data) mutable {
+                    if (!count->Receive(data)) {
+                       // No object in range, a single empty entry is sent
+                       (*resolve)(std::move(result));
+                       return;
+                    }
+
                     if (data.dwDefineID != static_cast<DWORD>(ID)) {
                        MakeReject<UnknownError>(
                          *reject, "Received data for unknown request ID or data type mismatch"
@@ -275,41 +331,26 @@ SimConnect::RequestDataOnSimObjectType(
                     }
 
                     assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-                    result->emplace_back(StaticCast<DATA_TYPE>(data.dwData));
+                    result.emplace_back(SimobjectData<DATA_TYPE>{
+                      .dw_version_       = data.dwVersion,
+                      .dw_id_            = data.dwID,
+                      .dw_request_id_    = data.dwRequestID,
+                      .dw_object_id_     = data.dwObjectID,
+                      .dw_define_id_     = data.dwDefineID,
+                      .dw_flags_         = data.dwFlags,
+                      .dw_entry_number_  = data.dwentrynumber,
+                      .dw_out_of_        = data.dwoutof,
+                      .dw_define_count_  = data.dwDefineCount,
+                      .last_update_time_ = std::chrono::steady_clock::now(),
+                      .dw_data_          = StaticCast<DATA_TYPE>(data.dwData),
+                    });
+
+                    if (count->Done()) {
+                       (*resolve)(std::move(result));
+                    }
                  },
                  reject.shared_from_this()
                );
-
-               MakePromise(
-                 [this,
-                  resolve = resolve.shared_from_this(),
-                  reject  = reject.shared_from_this(),
-                  result,
-                  request_id]() -> Promise<void> {
-                    // Watch for 200ms after receiving the last data, as SimConnect may send
-                    // multiple packets for a single request, and we want to wait until we received
-                    // them all before resolving the promise
-                    std::size_t count = 0;
-                    while (true) {
-                       co_await Wait(1s);
-                       if (!count || (result->size() > count)) {
-                          count = result->size();
-                          continue;
-                       }
-                       break;
-                    }
-
-                    assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-                    auto handle = handle_.lock();
-                    if (!handle) {
-                       MakeReject<Disconnected>(*reject);
-                       co_return;
-                    }
-
-                    std::vector<DATA_TYPE> data = std::move(*result);
-                    (*resolve)(data);
-                 }
-               ).Detach();
                if (
                  SimConnect_RequestDataOnSimObjectType(
                    *handle,
@@ -328,18 +369,24 @@ SimConnect::RequestDataOnSimObjectType(
                   reject.Apply<UnknownError>("Failed to track data-on-simobject-type request");
                   co_return;
                }
+
+               // Safety net, the request normally completes with its last entry
+               WatchProgress(
+                 request_id,
+                 std::shared_ptr<std::size_t const>{count, &count->Remaining()},
+                 "Timed out while requesting data on sim objects"
+               );
             }
    ).Finally([this, request_id]() {
       assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-      ClearTrackedSendId(request_id);
-      pending_simobject_type_.erase(request_id);
+      EraseRequest(request_id);
    });
 }
 
 template <DataId ID, class DATA_TYPE>
 WPromise<DATA_TYPE>
 SimConnect::RequestFacilityData(std::string_view icao, std::string_view region) {
-   auto const request_id = ++request_id_;
+   auto const request_id = ReserveRequest();
    return MakePromise(
             [this, request_id, icao = std::string{icao}, region = std::string{region}](
               Resolve<DATA_TYPE> const& resolve, Reject const& reject
@@ -351,47 +398,36 @@ SimConnect::RequestFacilityData(std::string_view icao, std::string_view region)
                   co_return;
                }
 
-               pending_facility_.try_emplace(
+               SetPending<FacilityHandler>(
                  request_id,
                  [result  = DATA_TYPE{},
-                  process = std::shared_ptr<facility::Processor>{},
+                  decoder = facility::Decoder<DATA_TYPE>{},
                   reject  = reject.shared_from_this(),
                   resolve = resolve.shared_from_this()](
-                   std::variant<
-                     std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA const>,
-                     std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA_END const>> const& data
+                   FacilityData const& data
                  ) constexpr mutable {
-                    if (!process) {
-                       process = result.GetProcessor();
-                    }
-
                     if (
                       std::holds_alternative<
                         std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA_END const>>(data)
                     ) {
-                       if (!process) {
+                       if (!decoder.Started()) {
                           MakeReject<UnknownError>(
                             *reject, "Received facility data end without receiving any data"
                           );
                        } else {
                           (*resolve)(std::move(result));
                        }
-                    } else if (!process) {
+                    } else if (
+                      auto const error = decoder.Process(
+                        result,
+                        std::get<std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA const>>(data)
+                          .get()
+                      );
+                      !error.empty()
+                    ) {
                        MakeReject<UnknownError>(
-                         *reject, "Failed to get processor for facility data, cannot process data"
-                       );
-                    } else {
-                       std::string error{};
-                       std::tie(process, error) = (*process)(
-                         std::get<std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA const>>(data)
-                           .get()
+                         *reject, "Failed to process facility data: " + error
                        );
-
-                       if (!error.empty()) {
-                          MakeReject<UnknownError>(
-                            *reject, "Failed to process facility data: " + error
-                          );
-                       }
                     }
                  },
                  reject.shared_from_this()
@@ -418,15 +454,14 @@ SimConnect::RequestFacilityData(std::string_view icao, std::string_view region)
             }
    ).Finally([this, request_id]() {
       assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-      ClearTrackedSendId(request_id);
-      pending_facility_.erase(request_id);
+      requests_.Erase(request_id);
    });
 }
 
 template <class TYPE>
 WPromise<std::vector<SimConnect::FacilityType<TYPE>>>
 SimConnect::RequestFacilitiesList(SIMCONNECT_FACILITY_LIST_TYPE type) {
-   auto const request_id = ++request_id_;
+   auto const request_id = ReserveRequest();
    return MakePromise(
             [this, type, request_id](
               Resolve<std::vector<FacilityType<TYPE>>> const& resolve, Reject const& reject
@@ -441,24 +476,7 @@ SimConnect::RequestFacilitiesList(SIMCONNECT_FACILITY_LIST_TYPE type) {
                auto const remaining =
                  std::make_shared<std::size_t>(std::numeric_limits<std::size_t>::max());
 
-               MakePromise(
-                 [this, reject = reject.shared_from_this(), remaining]() -> Promise<void> {
-                    co_await Ensure();
-
-                    std::size_t last_remaining = *remaining;
-                    while (last_remaining) {
-                       co_await Wait(5s);
-                       if (*remaining == last_remaining) {
-                          reject->Apply<Timeout>("Timed out while requesting facilities list");
-                       }
-
-                       last_remaining = *remaining;
-                    }
-                    co_return;
-                 }
-               ).Detach();
-
-               pending_facilities_list_.try_emplace(
+               SetPending<FacilitiesListHandler>(
                  request_id,
                  [result  = std::vector<FacilityType<TYPE>>{},
                   resolve = resolve.shared_from_this(),
@@ -498,22 +516,25 @@ SimConnect::RequestFacilitiesList(SIMCONNECT_FACILITY_LIST_TYPE type) {
                   reject.Apply<UnknownError>("Failed to track facilities list request");
                   co_return;
                }
+
+               WatchProgress(request_id, remaining, "Timed out while requesting facilities list");
             }
    ).Finally([this, request_id]() {
       assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-      ClearTrackedSendId(request_id);
-      pending_facilities_list_.erase(request_id);
+      EraseRequest(request_id);
    });
 }
 
 template <DataId ID, class DATA_TYPE>
 WPromise<SimobjectData<DATA_TYPE>>
 SimConnect::RequestDataOnSimObject(uint32_t objectId, std::shared_ptr<void*> handle) {
-   auto const request_id = ++request_id_;
+   auto const request_id = ReserveRequest();
 
-   return MakePromise(
+   return MakePromise(Pooled(
             [this, handle, objectId, request_id](
-              Resolve<SimobjectData<DATA_TYPE>> const& resolve, Reject const& reject
+              PooledFrame,
+              Resolve<SimobjectData<DATA_TYPE>> const& resolve,
+              Reject const&                            reject
             ) mutable -> Promise<SimobjectData<DATA_TYPE>, true> {
                if (!handle) {
                   handle = handle_.lock();
@@ -522,7 +543,7 @@ SimConnect::RequestDataOnSimObject(uint32_t objectId, std::shared_ptr<void*> han
                   }
                }
 
-               pending_simobject_.try_emplace(
+               SetPending<SimObjectHandler>(
                  request_id,
                  [resolve = resolve.shared_from_this(), reject = reject.shared_from_this()](
                    SIMCONNECT_RECV_SIMOBJECT_DATA const&        data,
@@ -587,11 +608,113 @@ SimConnect::RequestDataOnSimObject(uint32_t objectId, std::shared_ptr<void*> han
                   co_return;
                }
             }
-   ).Finally([this, request_id] constexpr {
+   )).Finally([this, request_id] constexpr {
       assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-      ClearTrackedSendId(request_id);
-      pending_simobject_.erase(request_id);
+      requests_.Erase(request_id);
    });
 }
 
+template <DataId ID, class DATA_TYPE>
+Stream<DATA_TYPE>
+SimConnect::SubscribeDataOnSimObject(
+  uint32_t          objectId,
+  SIMCONNECT_PERIOD period,
+  DWORD             flags,
+  DWORD             interval
+) {
+   assert(
+     (period == SIMCONNECT_PERIOD_SIM_FRAME) || (period == SIMCONNECT_PERIOD_VISUAL_FRAME)
+     || (period == SIMCONNECT_PERIOD_SECOND)
+   );
+   // Tagged packets only hold the changed fields, applied onto the last value
+   assert(IS_TAGGED<DATA_TYPE> == ((flags & SIMCONNECT_DATA_REQUEST_FLAG_TAGGED) != 0));
+
+   Stream<DATA_TYPE> stream{};
+
+   MessageQueue::Dispatch([this,
+                           objectId,
+                           period,
+                           flags,
+                           interval,
+                           weak = std::weak_ptr{stream.state_}] {
+      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+      auto const state = weak.lock();
+      if (!state) {
+         // Dropped in the meantime
+         return;
+      }
+
+      auto const request_id = requests_.Insert({
+        .handler_ =
+          Subscription{
+            .id_        = ID,
+            .object_id_ = static_cast<DWORD>(objectId),
+            .period_    = period,
+            .flags_     = flags,
+            .interval_  = interval,
+            .push_ =
+              [weak, last = std::conditional_t<IS_TAGGED<DATA_TYPE>, DATA_TYPE, std::monostate>{}](
+                SIMCONNECT_RECV_SIMOBJECT_DATA const& data,
+                time_point const&
+              ) mutable {
+                 if (data.dwDefineID != static_cast<DWORD>(ID)) {
+                    std::cerr << "SimConnect: Subscription data type mismatch" << std::endl;
+                    return;
+                 }
+
+                 if constexpr (IS_TAGGED<DATA_TYPE>) {
+                    auto const dirty = ApplyTagged(data, last.value_);
+                    if (!dirty) {
+                       std::cerr << "SimConnect: Malformed tagged subscription data" << std::endl;
+                       return;
+                    }
+
+                    last.dirty_ = *dirty;
+                    if (auto const state = weak.lock()) {
+                       state->Push(last);
+                    }
+                 } else {
+                    if (
+                      auto const header_size =
+                        sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(data.dwSize);
+                      Size<DATA_TYPE>() > (data.dwSize - header_size)
+                    ) {
+                       std::cerr << "SimConnect: Subscription data size mismatch ("
+                                 << (data.dwSize - header_size) << " vs " << Size<DATA_TYPE>()
+                                 << ")" << std::endl;
+                       return;
+                    }
+
+                    if (auto const state = weak.lock()) {
+                       state->Push(StaticCast<DATA_TYPE>(data.dwData));
+                    }
+                 }
+              },
+            .cancel_ =
+              [weak] {
+                 if (auto const state = weak.lock()) {
+                    state->Cancel();
+                 }
+              },
+          },
+      });
+
+      if (!state->OnCancel([this, request_id] {
+             try {
+                MessageQueue::Dispatch([this, request_id] { Unsubscribe(request_id); }).Detach();
+             } catch (QueueStopped const&) {
+                // Subscriptions are gone with the queue
+             }
+          })) {
+         requests_.Erase(request_id);
+         return;
+      }
+
+      IssueSubscription(request_id, std::get<Subscription>(requests_.Find(request_id)->handler_));
+   }).Detach();
+
+   return stream;
+}
+
 }  // namespace smc
\ No newline at end of file
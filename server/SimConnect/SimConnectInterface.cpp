@@ -21,6 +21,7 @@
 #include "Data/ServerPort.h"
 #include "Data/TrafficInfo.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
@@ -39,6 +40,12 @@
 
 namespace smc {
 
+namespace {
+
+constexpr auto STATIC_INFO_TTL = 5s;
+
+}  // namespace
+
 WPromise<SIMCONNECT_RECV_ASSIGNED_OBJECT_ID>
 SimConnect::AICreateSimulatedObject(std::string_view title, SIMCONNECT_DATA_INITPOSITION pos) {
    return Proxy<SIMCONNECT_RECV_ASSIGNED_OBJECT_ID>(
@@ -111,7 +118,10 @@ SimConnect::AIReleaseControl(SIMCONNECT_OBJECT_ID objectId) {
             throw Disconnected();
          }
 
-         auto const request_id = ++request_id_;
+         // Nothing answers it : the id is taken from the registry and retired at once, its key
+         // stays unique
+         auto const request_id = ReserveRequest();
+         EraseRequest(request_id);
          if (SimConnect_AIReleaseControl(*handle, object_id, request_id) != S_OK) {
             throw UnknownError("Failed to release AI control");
          }
@@ -121,10 +131,12 @@ SimConnect::AIReleaseControl(SIMCONNECT_OBJECT_ID objectId) {
 
 WPromise<bool>
 SimConnect::SetServerPort(uint32_t port) {
-   auto const set_port_send_id{std::make_shared<std::optional<DWORD>>(std::nullopt)};
-   return Proxy<bool>([this, port, set_port_send_id] {
+   auto const set_port_request{
+     std::make_shared<std::optional<SIMCONNECT_DATA_REQUEST_ID>>(std::nullopt)
+   };
+   return Proxy<bool>([this, port, set_port_request] {
       return MakePromise(
-               [this, port, set_port_send_id](
+               [this, port, set_port_request](
                  Resolve<bool> const& resolve, Reject const& reject
                ) mutable -> Promise<bool, true> {
                   while (true) {
@@ -172,13 +184,13 @@ SimConnect::SetServerPort(uint32_t port) {
                            );
                         } else {
                            assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-                           if (*set_port_send_id) {
-                              this->send_id_to_reject_.erase(**set_port_send_id);
+                           if (*set_port_request) {
+                              requests_.Erase(**set_port_request);
                            }
 
-                           *set_port_send_id =
+                           *set_port_request =
                              TrackPendingSendId(handle, reject.shared_from_this());
-                           if (!*set_port_send_id) {
+                           if (!*set_port_request) {
                               throw UnknownError("Failed to track server port send request");
                            }
 
@@ -221,11 +233,11 @@ SimConnect::SetServerPort(uint32_t port) {
 
                   throw Disconnected();
                }
-      ).Finally([this, set_port_send_id]() {
+      ).Finally([this, set_port_request]() {
          assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-         assert(set_port_send_id);
-         if (*set_port_send_id) {
-            this->send_id_to_reject_.erase(**set_port_send_id);
+         assert(set_port_request);
+         if (*set_port_request) {
+            requests_.Erase(**set_port_request);
          }
       });
    });
@@ -233,76 +245,280 @@ SimConnect::SetServerPort(uint32_t port) {
 
 WPromise<double>
 SimConnect::GetGroundInfo(double lat, double lon) {
-   using enum DataId;
-
    return Proxy<double>([this, lat, lon] {
       return MakePromise([this, lat, lon]() -> Promise<double> {
          assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-         auto handle = handle_.lock();
-         if (!handle) {
-            throw Disconnected();
+         if (auto const elevation = terrain_cache_.Elevation(lat, lon)) {
+            co_return *elevation;
          }
 
-         // Create a temporary AI object on the ground at the specified location, then request
-         // its ground altitude. This is a workaround to get the ground altitude at a specific
-         // location,
-         auto const& ai_object = co_await AICreateSimulatedObject(
-           "TerrainProbe",
-           {
-             .Latitude  = lat,
-             .Longitude = lon,
-             .Altitude  = 1,
-             // The next fields doesn't matter, as the object will be teleported to
-             // ground immediately after creation
-             .Pitch = 0,
-
-             .Bank    = 0,
-             .Heading = 0,
-             // Force the object to be on the ground so that we can get the
-             // ground altitude immediately
-             .OnGround = 1,
-             .Airspeed = INITPOSITION_AIRSPEED_KEEP,
-           },
-           handle
-         );
+         // A single probe for the point itself, issued before its posts take the pool
+         auto altitude = ProbeGround(lat, lon);
+
+         // The posts around are probed in the background for the next requests
+         MakePromise([this, lat, lon]() -> Promise<void> {
+            try {
+               co_await GetGroundProfile({{lat, lon}});
+            } catch (std::exception const& e) {
+               std::cerr << "SimConnect: Terrain posts not probed: " << e.what() << std::endl;
+            }
+         }).Detach();
+
+         co_return co_await altitude;
+      });
+   });
+}
+
+WPromise<std::vector<double>>
+SimConnect::GetGroundProfile(std::vector<std::pair<double, double>> positions) {
+   return Proxy<std::vector<double>>([this, positions = std::move(positions)] {
+      return MakePromise([this, positions]() -> Promise<std::vector<double>> {
          assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-         ScopeExit _{[this, &handle, &ai_object]() {
-            (void)this;
-            assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-            // Remove the probe object
-            SimConnect_AIRemoveObject(*handle, ai_object.dwObjectID, ai_object.dwRequestID);
-         }};
+         // Neighbour positions share their posts
+         std::vector<TerrainCache::Post> missing{};
+         for (auto const& [lat, lon] : positions) {
+            for (auto const post : TerrainCache::Corners(lat, lon)) {
+               if (!terrain_cache_.Get(post)) {
+                  missing.emplace_back(post);
+               }
+            }
+         }
+         std::ranges::sort(missing);
+         auto const [last, end] = std::ranges::unique(missing);
+         missing.erase(last, end);
+
+         // Issued together, the probe pool bounds the ones in flight
+         std::vector<WPromise<float>> probes{};
+         probes.reserve(missing.size());
+         for (auto const post : missing) {
+            probes.emplace_back(ProbeTerrain(post));
+         }
+         for (auto& probe : probes) {
+            co_await probe;
+         }
+         assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+         terrain_cache_.Flush();
+
+         std::vector<double> result{};
+         result.reserve(positions.size());
+         for (auto const& [lat, lon] : positions) {
+            auto const elevation = terrain_cache_.Elevation(lat, lon);
+            if (!elevation) {
+               // Only when the profile spans more tiles than the cache holds
+               throw UnknownError("Terrain evicted before being read");
+            }
+            result.emplace_back(*elevation);
+         }
+         co_return result;
+      });
+   });
+}
 
-         // Request ground altitude once the probe exists
-         auto const& ground_object =
-           co_await RequestDataOnSimObject<GROUND_INFO, GroundInfo>(ai_object.dwObjectID, handle);
+WPromise<float>
+SimConnect::ProbeTerrain(TerrainCache::Post post) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   auto key = "terrain " + std::to_string(post.lat_) + " " + std::to_string(post.lon_);
+   return Coalesce<float>(std::move(key), [this, post] {
+      return MakePromise([this, post]() -> Promise<float> {
+         auto const [lat, lon] = TerrainCache::Position(post);
+         auto const altitude   = co_await ProbeGround(lat, lon);
          assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-         auto const& ground_info = ground_object.dw_data_;
-         co_return ground_info.altitude_;
+         terrain_cache_.Put(post, altitude);
+         co_return altitude;
       });
    });
 }
 
+WPromise<float>
+SimConnect::ProbeGround(double lat, double lon) {
+   using enum DataId;
+
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   return MakePromise([this, lat, lon]() -> Promise<float> {
+      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+      auto handle = handle_.lock();
+      if (!handle) {
+         throw Disconnected();
+      }
+
+      // On the ground at the position
+      SIMCONNECT_DATA_INITPOSITION position{
+        .Latitude  = lat,
+        .Longitude = lon,
+        .Altitude  = 1,
+        .Pitch     = 0,
+        .Bank      = 0,
+        .Heading   = 0,
+        .OnGround  = 1,
+        .Airspeed  = INITPOSITION_AIRSPEED_KEEP,
+      };
+
+      auto const probe = co_await AcquireTerrainProbe(handle, position);
+      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+      float              altitude{};
+      std::exception_ptr exception{};
+      try {
+         // Moves an idle probe, harmless for a new one
+         if (
+           SimConnect_SetDataOnSimObject(
+             *handle,
+             static_cast<uint32_t>(SET_INIT_POSISION),
+             probe.id_,
+             0,
+             0,
+             sizeof(position),
+             &position
+           )
+           != S_OK
+         ) {
+            throw UnknownError("Failed to move terrain probe");
+         }
+
+         // The altitude of an idle probe still at its previous position would be returned here
+         for (std::size_t read = 1;; ++read) {
+            auto const ground =
+              (co_await RequestDataOnSimObject<GROUND_INFO, GroundInfo>(probe.id_, handle))
+                .dw_data_;
+
+            if (TerrainCache::SamePosition(lat, lon, ground.lat_, ground.lon_)) {
+               altitude = ground.altitude_;
+               break;
+            }
+
+            if (read == TERRAIN_PROBE_READS) {
+               throw UnknownError("Terrain probe didn't reach its position");
+            }
+         }
+      } catch (...) {
+         exception = std::current_exception();
+      }
+      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+      ReleaseTerrainProbe(probe, static_cast<bool>(exception));
+      if (exception) {
+         std::rethrow_exception(exception);
+      }
+
+      co_return altitude;
+   });
+}
+
+WPromise<SimConnect::TerrainProbe>
+SimConnect::AcquireTerrainProbe(
+  std::shared_ptr<void*>       handle,
+  SIMCONNECT_DATA_INITPOSITION position
+) {
+   return MakePromise([this, handle, position]() -> Promise<TerrainProbe> {
+      while (true) {
+         assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+         auto const generation = terrain_probes_.generation_;
+
+         if (!terrain_probes_.idle_.empty()) {
+            auto const id = terrain_probes_.idle_.back();
+            terrain_probes_.idle_.pop_back();
+            co_return TerrainProbe{.id_ = id, .generation_ = generation};
+         }
+
+         if (terrain_probes_.created_ < TERRAIN_PROBES) {
+            ++terrain_probes_.created_;
+
+            std::exception_ptr exception{};
+            try {
+               auto const& object =
+                 co_await AICreateSimulatedObject("TerrainProbe", position, handle);
+               co_return TerrainProbe{.id_ = object.dwObjectID, .generation_ = generation};
+            } catch (...) {
+               exception = std::current_exception();
+            }
+            assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+            if (generation == terrain_probes_.generation_) {
+               --terrain_probes_.created_;
+            }
+            std::rethrow_exception(exception);
+         }
+
+         // Every probe is busy
+         co_await MakePromise(
+           [this](Resolve<void> const& resolve, Reject const&) -> Promise<void, true> {
+              terrain_probes_.waiters_.emplace_back(resolve.shared_from_this());
+              co_return;
+           }
+         );
+      }
+   });
+}
+
+void
+SimConnect::ReleaseTerrainProbe(TerrainProbe probe, bool broken) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   if (probe.generation_ != terrain_probes_.generation_) {
+      // Died with its connection
+      return;
+   }
+
+   if (broken) {
+      if (auto handle = handle_.lock()) {
+         auto const request_id = ReserveRequest();
+         EraseRequest(request_id);
+         SimConnect_AIRemoveObject(*handle, probe.id_, request_id);
+      }
+      --terrain_probes_.created_;
+   } else {
+      terrain_probes_.idle_.emplace_back(probe.id_);
+   }
+
+   if (!terrain_probes_.waiters_.empty()) {
+      auto const waiter = std::move(terrain_probes_.waiters_.front());
+      terrain_probes_.waiters_.erase(terrain_probes_.waiters_.begin());
+      (*waiter)();
+   }
+}
+
+void
+SimConnect::ResetTerrainProbes() {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+   ++terrain_probes_.generation_;
+   terrain_probes_.idle_.clear();
+   terrain_probes_.created_ = 0;
+
+   // Create new probes
+   auto const waiters = std::move(terrain_probes_.waiters_);
+   terrain_probes_.waiters_.clear();
+   for (auto const& waiter : waiters) {
+      (*waiter)();
+   }
+}
+
 WPromise<TrafficInfo>
 SimConnect::GetUserAircraftInfo() noexcept(true) {
    using enum DataId;
 
    return Proxy<TrafficInfo>([this] {
-      return MakePromise([this]() -> Promise<TrafficInfo> {
-         assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+      return Coalesce<TrafficInfo>("user info", [this] {
+         return MakePromise(Pooled([this](PooledFrame) -> Promise<TrafficInfo> {
+            assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-         auto handle = handle_.lock();
-         if (!handle) {
-            throw Disconnected();
-         }
+            auto handle = handle_.lock();
+            if (!handle) {
+               throw Disconnected();
+            }
 
-         co_return std::move((co_await RequestDataOnSimObject<TRAFFIC_INFO, TrafficInfo>(
-                                SIMCONNECT_OBJECT_ID_USER, handle
-                              ))
-                               .dw_data_);
+            co_return std::move((co_await RequestDataOnSimObject<TRAFFIC_INFO, TrafficInfo>(
+                                   SIMCONNECT_OBJECT_ID_USER, handle
+                                 ))
+                                  .dw_data_);
+         }));
       });
    });
 }
@@ -311,43 +527,288 @@ WPromise<TrafficInfo>
 SimConnect::GetAircraftInfo(ObjectId id) noexcept(true) {
    using enum DataId;
 
-   return Proxy<TrafficInfo>([this, id = std::move(id)] {
-      return MakePromise([this, id = std::move(id)]() -> Promise<TrafficInfo> {
-         assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+   return Proxy<TrafficInfo>([this, object_id = id.dwObjectID] {
+      return Coalesce<TrafficInfo>("aircraft info " + std::to_string(object_id), [this, object_id] {
+         return MakePromise(Pooled([this, object_id](PooledFrame) -> Promise<TrafficInfo> {
+            assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-         auto handle = handle_.lock();
-         if (!handle) {
-            throw Disconnected();
-         }
+            auto handle = handle_.lock();
+            if (!handle) {
+               throw Disconnected();
+            }
 
-         co_return std::move(
-           (co_await RequestDataOnSimObject<TRAFFIC_INFO, TrafficInfo>(id.dwObjectID, handle))
-             .dw_data_
-         );
+            co_return std::move(
+              (co_await RequestDataOnSimObject<TRAFFIC_INFO, TrafficInfo>(object_id, handle))
+                .dw_data_
+            );
+         }));
+      });
+   });
+}
+
+WPromise<TrafficPosition>
+SimConnect::GetUserAircraftPosition() noexcept(true) {
+   using enum DataId;
+
+   return Proxy<TrafficPosition>([this] {
+      return Coalesce<TrafficPosition>("user position", [this] {
+         return MakePromise(Pooled([this](PooledFrame) -> Promise<TrafficPosition> {
+            assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+            auto handle = handle_.lock();
+            if (!handle) {
+               throw Disconnected();
+            }
+
+            co_return std::move((co_await RequestDataOnSimObject<TRAFFIC_POSITION, TrafficPosition>(
+                                   SIMCONNECT_OBJECT_ID_USER, handle
+                                 ))
+                                  .dw_data_);
+         }));
       });
    });
 }
 
+WPromise<TrafficPosition>
+SimConnect::GetAircraftPosition(ObjectId id) noexcept(true) {
+   using enum DataId;
+
+   return Proxy<TrafficPosition>([this, object_id = id.dwObjectID] {
+      return Coalesce<TrafficPosition>(
+        "aircraft position " + std::to_string(object_id),
+        [this, object_id] {
+           return MakePromise(Pooled([this, object_id](PooledFrame) -> Promise<TrafficPosition> {
+              assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+              auto handle = handle_.lock();
+              if (!handle) {
+                 throw Disconnected();
+              }
+
+              co_return std::move(
+                (co_await RequestDataOnSimObject<TRAFFIC_POSITION, TrafficPosition>(
+                   object_id, handle
+                 ))
+                  .dw_data_
+              );
+           }));
+        }
+      );
+   });
+}
+
 WPromise<TrafficStaticInfo>
 SimConnect::GetAircraftStaticInfo(ObjectId id) noexcept(true) {
    using enum DataId;
 
-   return Proxy<TrafficStaticInfo>([this, id = std::move(id)] {
-      return MakePromise([this, id = std::move(id)]() -> Promise<TrafficStaticInfo> {
+   return Proxy<TrafficStaticInfo>([this, object_id = id.dwObjectID] {
+      // Title and livery don't change during a flight
+      return Coalesce<TrafficStaticInfo>(
+        "aircraft static info " + std::to_string(object_id),
+        [this, object_id] {
+           return MakePromise(Pooled([this, object_id](PooledFrame) -> Promise<TrafficStaticInfo> {
+              assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+              auto handle = handle_.lock();
+              if (!handle) {
+                 throw Disconnected();
+              }
+
+              co_return std::move(
+                (co_await RequestDataOnSimObject<TRAFFIC_STATIC_INFO, TrafficStaticInfo>(
+                   object_id, handle
+                 ))
+                  .dw_data_
+              );
+           }));
+        },
+        STATIC_INFO_TTL
+      );
+   });
+}
+
+Stream<TrafficInfo>
+SimConnect::SubscribeUserAircraftInfo(SIMCONNECT_PERIOD period, DWORD flags, DWORD interval) {
+   return SubscribeDataOnSimObject<DataId::TRAFFIC_INFO, TrafficInfo>(
+     SIMCONNECT_OBJECT_ID_USER, period, flags, interval
+   );
+}
+
+Stream<TrafficInfo>
+SimConnect::SubscribeAircraftInfo(
+  ObjectId          id,
+  SIMCONNECT_PERIOD period,
+  DWORD             flags,
+  DWORD             interval
+) {
+   return SubscribeDataOnSimObject<DataId::TRAFFIC_INFO, TrafficInfo>(
+     id.dwObjectID, period, flags, interval
+   );
+}
+
+Stream<Tagged<TrafficInfo>>
+SimConnect::SubscribeUserAircraftChanges(SIMCONNECT_PERIOD period, DWORD interval) {
+   return SubscribeDataOnSimObject<DataId::TAGGED_TRAFFIC_INFO, Tagged<TrafficInfo>>(
+     SIMCONNECT_OBJECT_ID_USER,
+     period,
+     SIMCONNECT_DATA_REQUEST_FLAG_CHANGED | SIMCONNECT_DATA_REQUEST_FLAG_TAGGED,
+     interval
+   );
+}
+
+Stream<Tagged<TrafficInfo>>
+SimConnect::SubscribeAircraftChanges(ObjectId id, SIMCONNECT_PERIOD period, DWORD interval) {
+   return SubscribeDataOnSimObject<DataId::TAGGED_TRAFFIC_INFO, Tagged<TrafficInfo>>(
+     id.dwObjectID,
+     period,
+     SIMCONNECT_DATA_REQUEST_FLAG_CHANGED | SIMCONNECT_DATA_REQUEST_FLAG_TAGGED,
+     interval
+   );
+}
+
+Stream<TrafficDiff>
+SimConnect::SubscribeTraffic(std::chrono::milliseconds period) {
+   Stream<TrafficDiff> stream{};
+
+   MessageQueue::Dispatch([this, period, weak = std::weak_ptr{stream.state_}] {
+      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+      if (weak.expired()) {
+         // Dropped in the meantime
+         return;
+      }
+
+      traffic_streams_.emplace_back(TrafficStream{.state_ = weak, .period_ = period});
+      if (!traffic_polling_) {
+         traffic_polling_ = true;
+         PollTraffic();
+      }
+   }).Detach();
+
+   return stream;
+}
+
+void
+SimConnect::PollTraffic() {
+   MakePromise([this]() -> Promise<void> {
+      while (true) {
          assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
-         auto handle = handle_.lock();
-         if (!handle) {
-            throw Disconnected();
+         std::erase_if(traffic_streams_, [](TrafficStream const& stream) {
+            auto const state = stream.state_.lock();
+            if (!state) {
+               return true;
+            }
+
+            std::lock_guard lock{state->mutex_};
+            return state->cancelled_;
+         });
+
+         if (traffic_streams_.empty() || main_.Terminated()) {
+            // Rebuilt by the next subscription
+            traffic_         = {};
+            traffic_streams_ = {};
+            traffic_polling_ = false;
+            co_return;
+         }
+
+         auto const period =
+           std::ranges::min(traffic_streams_, {}, &TrafficStream::period_).period_;
+         // On the timer wheel, not cut short by a disconnection : the sample then clears the table
+         co_await Wait(period, main_.WaitTerminate());
+
+         auto const                 diff = co_await SampleTraffic();
+         std::optional<TrafficDiff> snapshot{};
+
+         for (auto& stream : traffic_streams_) {
+            auto const state = stream.state_.lock();
+            if (!state) {
+               continue;
+            }
+
+            if (stream.fresh_) {
+               stream.fresh_ = false;
+               if (!snapshot) {
+                  snapshot = traffic_.Snapshot();
+               }
+               state->Push(*snapshot);
+            } else if (!diff.Empty()) {
+               state->Push(diff);
+            }
          }
+      }
+   }).Detach();
+}
+
+WPromise<TrafficDiff>
+SimConnect::SampleTraffic() {
+   using enum DataId;
+
+   return MakePromise([this]() -> Promise<TrafficDiff> {
+      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+      auto handle = handle_.lock();
+      if (!handle) {
+         // The aircraft left with the simulator
+         co_return traffic_.Clear();
+      }
 
-         co_return std::move(
-           (co_await RequestDataOnSimObject<TRAFFIC_STATIC_INFO, TrafficStaticInfo>(
-              id.dwObjectID, handle
-            ))
-             .dw_data_
+      // Only the fields used by the table, about a quarter of TrafficInfo per aircraft
+      SimobjectData<TrafficPosition>              user{};
+      std::vector<SimobjectData<TrafficPosition>> aircraft{};
+      std::vector<SimobjectData<TrafficPosition>> helicopters{};
+      try {
+         // Issued together, awaited in order
+         auto user_request = RequestDataOnSimObject<TRAFFIC_POSITION, TrafficPosition>(
+           SIMCONNECT_OBJECT_ID_USER, handle
          );
-      });
+         auto aircraft_request = RequestDataOnSimObjectType<TRAFFIC_POSITION, TrafficPosition>(
+           SIMCONNECT_SIMOBJECT_TYPE_AIRCRAFT, TRAFFIC_RADIUS, handle
+         );
+         auto helicopters_request =
+           RequestDataOnSimObjectType<HELI_TRAFFIC_POSITION, TrafficPosition>(
+             SIMCONNECT_SIMOBJECT_TYPE_HELICOPTER, TRAFFIC_RADIUS, handle
+           );
+
+         user        = co_await user_request;
+         aircraft    = co_await aircraft_request;
+         helicopters = co_await helicopters_request;
+      } catch (std::exception const& e) {
+         // Kept as is until the next sample
+         std::cerr << "SimConnect: Failed to sample traffic: " << e.what() << std::endl;
+         co_return TrafficDiff{};
+      }
+      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+      traffic_.Begin();
+      for (auto const& object : aircraft) {
+         if (object.dw_object_id_ != user.dw_object_id_) {
+            traffic_.Set(object.dw_object_id_, object.dw_data_, false);
+         }
+      }
+      for (auto const& object : helicopters) {
+         if (object.dw_object_id_ != user.dw_object_id_) {
+            traffic_.Set(object.dw_object_id_, object.dw_data_, true);
+         }
+      }
+      traffic_.Advise(user.dw_data_);
+      auto diff = traffic_.End();
+
+      // Once per aircraft, reported as moved once received
+      for (auto const id : traffic_.TakeMissingStaticInfo()) {
+         MakePromise([this, id, handle]() -> Promise<void> {
+            try {
+               auto info = co_await RequestDataOnSimObject<TRAFFIC_STATIC_INFO, TrafficStaticInfo>(
+                 id, handle
+               );
+               traffic_.SetStaticInfo(id, std::move(info.dw_data_));
+            } catch (std::exception const&) {
+               traffic_.ForgetStaticInfo(id);
+            }
+         }).Detach();
+      }
+
+      co_return diff;
    });
 }
 
@@ -359,17 +820,49 @@ SimConnect::GetAirportFacility(std::string_view icao, std::string_view region) n
      [this, icao = std::string{icao}, region = std::string{region}] {
         assert(std::this_thread::get_id() == MessageQueue::ThreadId());
 
+        if (auto airport = airport_cache_.Get(icao, region)) {
+           return MakePromise([airport = std::move(*airport)]() -> Promise<facility::AirportData> {
+              co_return airport;
+           });
+        }
+
         auto handle = handle_.lock();
         if (!handle) {
            throw Disconnected();
         }
-        return RequestFacilityData<GET_AIRPORT_FACILITY, facility::AirportData>(
-          std::move(icao), std::move(region)
+        return Coalesce<facility::AirportData>(
+          "airport " + icao + " " + region,
+          [this, icao = std::move(icao), region = std::move(region)] {
+             return MakePromise([this, icao, region]() -> Promise<facility::AirportData> {
+                auto airport =
+                  co_await RequestFacilityData<GET_AIRPORT_FACILITY, facility::AirportData>(
+                    icao, region
+                  );
+                assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+                airport_cache_.Put(icao, region, airport);
+                co_return airport;
+             });
+          }
         );
      }
    );
 }
 
+WPromise<void>
+SimConnect::InvalidateAirportFacility(std::string_view icao, std::string_view region) {
+   return Proxy<void>([this, icao = std::string{icao}, region = std::string{region}] {
+      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+      if (icao.empty()) {
+         airport_cache_.Clear();
+      } else {
+         airport_cache_.Invalidate(icao, region);
+      }
+      return Promise<void>::Resolve();
+   });
+}
+
 WPromise<SIMCONNECT_RECV_ASSIGNED_OBJECT_ID>
 SimConnect::AICreateNonATCAircraft(
   std::string_view             title,
@@ -398,96 +891,83 @@ SimConnect::AICreateNonATCAircraft(
 WPromise<Liveries>
 SimConnect::EnumerateSimObjectsAndLiveries(SIMCONNECT_SIMOBJECT_TYPE objectType) {
    return Proxy<Liveries>([this, objectType] {
-      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-      auto const request_id = ++request_id_;
-
-      return MakePromise(
-               [this, objectType, request_id](
-                 Resolve<Liveries> const& resolve, Reject const& reject
-               ) -> Promise<Liveries, true> {
-                  assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-
-                  auto const handle = handle_.lock();
-                  if (!handle) {
-                     throw Disconnected();
-                  }
-
-                  auto const remaining =
-                    std::make_shared<std::size_t>(std::numeric_limits<std::size_t>::max());
+      return Coalesce<Liveries>(
+        "liveries " + std::to_string(static_cast<DWORD>(objectType)),
+        [this, objectType] { return EnumerateSimObjectsAndLiveriesImpl(objectType); }
+      );
+   });
+}
 
-                  auto handler = MakePromise(
-                    [this, reject = reject.shared_from_this(), remaining]() -> Promise<void> {
-                       assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+WPromise<Liveries>
+SimConnect::EnumerateSimObjectsAndLiveriesImpl(SIMCONNECT_SIMOBJECT_TYPE objectType) {
+   assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+   auto const request_id = ReserveRequest();
+
+   return MakePromise(
+            [this, objectType, request_id](
+              Resolve<Liveries> const& resolve, Reject const& reject
+            ) -> Promise<Liveries, true> {
+               assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+
+               auto const handle = handle_.lock();
+               if (!handle) {
+                  throw Disconnected();
+               }
 
-                       std::size_t last_remaining = *remaining;
-                       while (last_remaining && *reject) {
-                          co_await Wait(5s);
-                          assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+               auto const remaining =
+                 std::make_shared<std::size_t>(std::numeric_limits<std::size_t>::max());
+
+               SetPending<EnumeratedSimObjectsHandler>(
+                 request_id,
+                 [result  = Liveries{},
+                  resolve = resolve.shared_from_this(),
+                  reject  = reject.shared_from_this(),
+                  remaining](
+                   SIMCONNECT_RECV_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST const& data
+                 ) mutable {
+                    if (*remaining == std::numeric_limits<std::size_t>::max()) {
+                       *remaining = data.dwOutOf;
+                    }
+                    if (*remaining == 0) {
+                       reject->Apply<UnknownError>(
+                         "Received sim object enumeration with zero total count"
+                       );
+                       return;
+                    }
 
-                          if (*remaining == last_remaining) {
-                             reject->Apply<Timeout>(
-                               "Timed out while requesting data on sim object"
-                             );
-                             break;
-                          }
+                    --*remaining;
 
-                          last_remaining = *remaining;
-                       }
-                       co_return;
+                    for (std::size_t i = 0; i < data.dwArraySize; ++i) {
+                       auto const& livery = data.rgData[i];
+                       result.emplace(livery.AircraftTitle, livery.LiveryName);
                     }
-                  );
-
-                  pending_enumerated_simobjects_.try_emplace(
-                    request_id,
-                    [result  = Liveries{},
-                     resolve = resolve.shared_from_this(),
-                     reject  = reject.shared_from_this(),
-                     handler = std::move(handler),
-                     remaining](
-                      SIMCONNECT_RECV_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST const& data
-                    ) mutable {
-                       if (*remaining == std::numeric_limits<std::size_t>::max()) {
-                          *remaining = data.dwOutOf;
-                       }
-                       if (*remaining == 0) {
-                          reject->Apply<UnknownError>(
-                            "Received sim object enumeration with zero total count"
-                          );
-                          return;
-                       }
-
-                       --*remaining;
-
-                       for (std::size_t i = 0; i < data.dwArraySize; ++i) {
-                          auto const& livery = data.rgData[i];
-                          result.emplace(livery.AircraftTitle, livery.LiveryName);
-                       }
-
-                       if (data.dwEntryNumber == (data.dwOutOf - 1)) {
-                          assert(*remaining == 0);
-                          (*resolve)(std::move(result));
-                       }
-                    },
-                    reject.shared_from_this()
-                  );
-                  if (
-                    SimConnect_EnumerateSimObjectsAndLiveries(*handle, request_id, objectType)
-                    != S_OK
-                  ) {
-                     throw UnknownError("Failed to enumerate sim objects and liveries");
-                  }
 
-                  if (!TrackRequestSendId(handle, request_id)) {
-                     throw UnknownError("Failed to track sim object enumeration request");
-                  }
+                    if (data.dwEntryNumber == (data.dwOutOf - 1)) {
+                       assert(*remaining == 0);
+                       (*resolve)(std::move(result));
+                    }
+                 },
+                 reject.shared_from_this()
+               );
+               if (
+                 SimConnect_EnumerateSimObjectsAndLiveries(*handle, request_id, objectType)
+                 != S_OK
+               ) {
+                  throw UnknownError("Failed to enumerate sim objects and liveries");
+               }
 
-                  co_return;
+               if (!TrackRequestSendId(handle, request_id)) {
+                  throw UnknownError("Failed to track sim object enumeration request");
                }
-      ).Finally([this, request_id]() {
-         assert(std::this_thread::get_id() == MessageQueue::ThreadId());
-         ClearTrackedSendId(request_id);
-         pending_enumerated_simobjects_.erase(request_id);
-      });
+
+               WatchProgress(
+                 request_id, remaining, "Timed out while requesting data on sim object"
+               );
+               co_return;
+            }
+   ).Finally([this, request_id]() {
+      assert(std::this_thread::get_id() == MessageQueue::ThreadId());
+      EraseRequest(request_id);
    });
 }
 
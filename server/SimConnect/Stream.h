@@ -0,0 +1,146 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace smc {
+
+class SimConnect;
+
+// Samples of a periodic SimConnect request, shared by any number of consumers.
+// Consumers are called on the SimConnect thread and must not block it. The request is cancelled
+// with Cancel() or once the last copy of the stream is dropped.
+template <class T>
+class Stream {
+public:
+   using Consumer = std::function<void(T const&)>;
+
+   Stream()
+      : state_{std::make_shared<State>()} {}
+
+   std::size_t
+   Attach(Consumer&& consumer) const {
+      return state_->Attach(std::move(consumer));
+   }
+
+   void
+   Detach(std::size_t id) const {
+      state_->Detach(id);
+   }
+
+   void
+   Cancel() const {
+      state_->Cancel();
+   }
+
+   bool
+   Cancelled() const {
+      std::lock_guard lock{state_->mutex_};
+      return state_->cancelled_;
+   }
+
+private:
+   friend class SimConnect;
+
+   struct State {
+      using Consumers = std::vector<std::pair<std::size_t, Consumer>>;
+
+      ~State() { Cancel(); }
+
+      std::size_t
+      Attach(Consumer&& consumer) {
+         std::lock_guard lock{mutex_};
+
+         auto const id = next_id_++;
+         if (!cancelled_) {
+            // Copied on write, samples are pushed without holding the lock
+            auto consumers = std::make_shared<Consumers>(*consumers_);
+            consumers->emplace_back(id, std::move(consumer));
+            consumers_ = std::move(consumers);
+         }
+         return id;
+      }
+
+      void
+      Detach(std::size_t id) {
+         std::lock_guard lock{mutex_};
+
+         auto consumers = std::make_shared<Consumers>(*consumers_);
+         std::erase_if(*consumers, [id](auto const& consumer) { return consumer.first == id; });
+         consumers_ = std::move(consumers);
+      }
+
+      void
+      Push(T const& sample) {
+         std::shared_ptr<Consumers const> consumers{};
+         {
+            std::lock_guard lock{mutex_};
+            consumers = consumers_;
+         }
+
+         for (auto const& [id, consumer] : *consumers) {
+            consumer(sample);
+         }
+      }
+
+      // Registers the request cancellation, false if the stream is already cancelled
+      bool
+      OnCancel(std::function<void()>&& cancel) {
+         std::lock_guard lock{mutex_};
+         if (cancelled_) {
+            return false;
+         }
+
+         cancel_ = std::move(cancel);
+         return true;
+      }
+
+      void
+      Cancel() {
+         std::function<void()> cancel{};
+         {
+            std::lock_guard lock{mutex_};
+            if (cancelled_) {
+               return;
+            }
+
+            cancelled_ = true;
+            consumers_ = std::make_shared<Consumers const>();
+            cancel     = std::move(cancel_);
+         }
+
+         if (cancel) {
+            cancel();
+         }
+      }
+
+      std::mutex                       mutex_{};
+      std::shared_ptr<Consumers const> consumers_{std::make_shared<Consumers const>()};
+      std::size_t                      next_id_{0};
+      bool                             cancelled_{false};
+      std::function<void()>            cancel_{};
+   };
+
+   std::shared_ptr<State> state_;
+};
+
+}  // namespace smc
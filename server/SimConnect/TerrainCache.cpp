@@ -0,0 +1,302 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "TerrainCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+namespace smc {
+
+namespace {
+
+// File layout : "SMCTER01" then the TILE_POSTS x TILE_POSTS altitudes (float)
+constexpr std::string_view MAGIC = "SMCTER01";
+
+constexpr int32_t LAT_POSTS = 90 * TerrainCache::POSTS_PER_DEGREE;
+constexpr int32_t LON_POSTS = 360 * TerrainCache::POSTS_PER_DEGREE;
+
+constexpr std::size_t TILE_SIZE =
+  static_cast<std::size_t>(TerrainCache::TILE_POSTS) * TerrainCache::TILE_POSTS;
+
+int32_t
+FloorDiv(int32_t value, int32_t divisor) {
+   return (value >= 0) ? (value / divisor) : ((value - divisor + 1) / divisor);
+}
+
+// Longitudes wrap around the antimeridian
+int32_t
+WrapLon(int32_t lon) {
+   return (lon >= LON_POSTS / 2) ? (lon - LON_POSTS) : lon;
+}
+
+struct GridPosition {
+   TerrainCache::Post post_{};
+   // From the south west post, between 0 and 1
+   double lat_fraction_{};
+   double lon_fraction_{};
+};
+
+GridPosition
+Locate(double lat, double lon) {
+   auto const y = std::clamp(lat * TerrainCache::POSTS_PER_DEGREE, -1. * LAT_POSTS, 1. * LAT_POSTS);
+   auto const lon_posts = lon * TerrainCache::POSTS_PER_DEGREE;
+   auto const x = lon_posts - LON_POSTS * std::floor((lon_posts + LON_POSTS / 2) / LON_POSTS);
+
+   // The north pole is the north edge of the last row
+   auto const lat_post = std::min(static_cast<int32_t>(std::floor(y)), LAT_POSTS - 1);
+   auto const lon_post = static_cast<int32_t>(std::floor(x));
+
+   return {
+     .post_         = {.lat_ = lat_post, .lon_ = WrapLon(lon_post)},
+     .lat_fraction_ = y - lat_post,
+     .lon_fraction_ = x - lon_post,
+   };
+}
+
+}  // namespace
+
+TerrainCache::TerrainCache(std::optional<std::filesystem::path> path)
+   : path_{std::move(path)} {}
+
+TerrainCache::~TerrainCache() { Flush(); }
+
+void
+TerrainCache::SetVersion(std::string version) {
+   if (version == version_) {
+      return;
+   }
+
+   // Probed by another simulator build
+   version_ = std::move(version);
+   entries_.clear();
+   index_.clear();
+
+   if (!path_) {
+      return;
+   }
+
+   try {
+      std::filesystem::create_directories(*path_ / version_);
+
+      for (auto const& entry : std::filesystem::directory_iterator{*path_}) {
+         if (entry.path().filename() != version_) {
+            std::filesystem::remove_all(entry.path());
+         }
+      }
+   } catch (std::exception const& e) {
+      std::cerr << "Terrain cache: " << e.what() << std::endl;
+   }
+}
+
+std::array<TerrainCache::Post, 4>
+TerrainCache::Corners(double lat, double lon) {
+   auto const post  = Locate(lat, lon).post_;
+   auto const north = post.lat_ + 1;
+   auto const east  = WrapLon(post.lon_ + 1);
+
+   return {{
+     post,
+     {.lat_ = north, .lon_ = post.lon_},
+     {.lat_ = north, .lon_ = east},
+     {.lat_ = post.lat_, .lon_ = east},
+   }};
+}
+
+std::pair<double, double>
+TerrainCache::Position(Post post) {
+   return {
+     static_cast<double>(post.lat_) / POSTS_PER_DEGREE,
+     static_cast<double>(post.lon_) / POSTS_PER_DEGREE,
+   };
+}
+
+bool
+TerrainCache::SamePosition(double lat, double lon, double other_lat, double other_lon) {
+   return (std::abs(lat - other_lat) <= POST_TOLERANCE)
+          && (std::abs(std::remainder(lon - other_lon, 360.)) <= POST_TOLERANCE);
+}
+
+uint64_t
+TerrainCache::Key(Post post) {
+   auto const lat = static_cast<uint32_t>(FloorDiv(post.lat_, TILE_POSTS));
+   auto const lon = static_cast<uint32_t>(FloorDiv(post.lon_, TILE_POSTS));
+   return (static_cast<uint64_t>(lat) << 32) | lon;
+}
+
+std::optional<float>
+TerrainCache::Get(Post post) {
+   auto const& tile = Load(Key(post));
+
+   auto const row      = post.lat_ - FloorDiv(post.lat_, TILE_POSTS) * TILE_POSTS;
+   auto const column   = post.lon_ - FloorDiv(post.lon_, TILE_POSTS) * TILE_POSTS;
+   auto const altitude = tile.altitudes_[row * TILE_POSTS + column];
+
+   if (std::isnan(altitude)) {
+      return std::nullopt;
+   }
+   return altitude;
+}
+
+void
+TerrainCache::Put(Post post, float altitude) {
+   auto& tile = Load(Key(post));
+
+   auto const row    = post.lat_ - FloorDiv(post.lat_, TILE_POSTS) * TILE_POSTS;
+   auto const column = post.lon_ - FloorDiv(post.lon_, TILE_POSTS) * TILE_POSTS;
+
+   tile.altitudes_[row * TILE_POSTS + column] = altitude;
+   tile.dirty_                                = true;
+}
+
+std::optional<double>
+TerrainCache::Elevation(double lat, double lon) {
+   auto const [_, lat_fraction, lon_fraction] = Locate(lat, lon);
+   auto const corners                         = Corners(lat, lon);
+
+   std::array<double, 4> altitudes{};
+   for (std::size_t index = 0; index < corners.size(); ++index) {
+      auto const altitude = Get(corners[index]);
+      if (!altitude) {
+         return std::nullopt;
+      }
+      altitudes[index] = *altitude;
+   }
+
+   auto const south = altitudes[0] + (altitudes[3] - altitudes[0]) * lon_fraction;
+   auto const north = altitudes[1] + (altitudes[2] - altitudes[1]) * lon_fraction;
+   return south + (north - south) * lat_fraction;
+}
+
+void
+TerrainCache::Flush() {
+   for (auto& [key, tile] : entries_) {
+      Write(key, tile);
+   }
+}
+
+void
+TerrainCache::Clear() {
+   entries_.clear();
+   index_.clear();
+
+   if (path_) {
+      std::error_code ec{};
+      std::filesystem::remove_all(*path_, ec);
+      if (!version_.empty()) {
+         std::filesystem::create_directories(*path_ / version_, ec);
+      }
+   }
+}
+
+std::optional<std::filesystem::path>
+TerrainCache::Path(uint64_t key) const {
+   if (!path_ || version_.empty()) {
+      return std::nullopt;
+   }
+
+   auto const lat = static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+   auto const lon = static_cast<int32_t>(static_cast<uint32_t>(key));
+   return *path_ / version_ / (std::to_string(lat) + "_" + std::to_string(lon) + ".ter");
+}
+
+TerrainCache::Tile&
+TerrainCache::Load(uint64_t key) {
+   if (auto const it = index_.find(key); it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->second;
+   }
+
+   Tile tile{};
+   if (auto const path = Path(key); !path || !Read(*path, tile)) {
+      tile.altitudes_.assign(TILE_SIZE, std::numeric_limits<float>::quiet_NaN());
+   }
+
+   entries_.emplace_front(key, std::move(tile));
+   index_.emplace(key, entries_.begin());
+
+   if (entries_.size() > MAX_TILES) {
+      auto& [last_key, last_tile] = entries_.back();
+      Write(last_key, last_tile);
+
+      index_.erase(last_key);
+      entries_.pop_back();
+   }
+
+   return entries_.front().second;
+}
+
+bool
+TerrainCache::Read(std::filesystem::path const& path, Tile& tile) const {
+   std::ifstream file{path, std::ios::binary};
+   if (!file) {
+      return false;
+   }
+
+   std::string magic(MAGIC.size(), '\0');
+   file.read(magic.data(), magic.size());
+
+   tile.altitudes_.resize(TILE_SIZE);
+   file.read(reinterpret_cast<char*>(tile.altitudes_.data()), TILE_SIZE * sizeof(float));
+
+   if (!file || (magic != MAGIC)) {
+      file.close();
+
+      std::error_code ec{};
+      std::filesystem::remove(path, ec);
+      return false;
+   }
+
+   return true;
+}
+
+void
+TerrainCache::Write(uint64_t key, Tile& tile) {
+   if (!tile.dirty_) {
+      return;
+   }
+   tile.dirty_ = false;
+
+   auto const path = Path(key);
+   if (!path) {
+      return;
+   }
+
+   try {
+      {
+         std::ofstream file{path->string() + ".tmp", std::ios::binary | std::ios::trunc};
+         file.write(MAGIC.data(), MAGIC.size());
+         file.write(
+           reinterpret_cast<char const*>(tile.altitudes_.data()), TILE_SIZE * sizeof(float)
+         );
+
+         if (!file) {
+            throw std::runtime_error("Couldn't write " + path->string());
+         }
+      }
+
+      std::filesystem::rename(path->string() + ".tmp", *path);
+   } catch (std::exception const& e) {
+      std::cerr << "Terrain cache: " << e.what() << std::endl;
+   }
+}
+
+}  // namespace smc
@@ -0,0 +1,102 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace smc {
+
+// Ground altitudes (feet) on a grid of POSTS_PER_DEGREE posts per degree, the altitudes between
+// the posts are interpolated. The posts are stored by tiles of TILE_POSTS x TILE_POSTS, the
+// MAX_TILES most recently used ones in memory and all of them on disk
+// (<path>/<version>/<lat>_<lon>.ter) when a path is given.
+// The version identifies the simulator build, the other versions are dropped when it changes.
+class TerrainCache {
+public:
+   // About 870 meters between two posts of latitude
+   static constexpr int32_t     POSTS_PER_DEGREE = 128;
+   static constexpr int32_t     TILE_POSTS       = 64;
+   static constexpr std::size_t MAX_TILES        = 256;
+
+   // About 11 meters, a hundredth of the distance between two posts
+   static constexpr double POST_TOLERANCE = 1e-4;
+
+   // Grid coordinates, the position times POSTS_PER_DEGREE rounded down
+   struct Post {
+      int32_t lat_{};
+      int32_t lon_{};
+
+      auto operator<=>(Post const&) const = default;
+   };
+
+   TerrainCache(std::optional<std::filesystem::path> path);
+   ~TerrainCache();
+
+   void SetVersion(std::string version);
+
+   // The posts around a position, south west first then clockwise
+   static std::array<Post, 4> Corners(double lat, double lon);
+   static std::pair<double, double> Position(Post post);
+   // Within POST_TOLERANCE degrees of each other
+   static bool SamePosition(double lat, double lon, double other_lat, double other_lon);
+
+   std::optional<float> Get(Post post);
+   void                 Put(Post post, float altitude);
+
+   // Bilinear interpolation of the posts around, nullopt until they are all known
+   std::optional<double> Elevation(double lat, double lon);
+
+   // Writes the tiles changed since the last flush
+   void Flush();
+   void Clear();
+
+private:
+   struct Tile {
+      // Row by row from the south west post, NaN until probed
+      std::vector<float> altitudes_{};
+      bool               dirty_{false};
+   };
+
+   using Entries = std::list<std::pair<uint64_t, Tile>>;
+
+   static uint64_t Key(Post post);
+
+   std::optional<std::filesystem::path> Path(uint64_t key) const;
+
+   Tile& Load(uint64_t key);
+   bool  Read(std::filesystem::path const& path, Tile& tile) const;
+   void  Write(uint64_t key, Tile& tile);
+
+   std::optional<std::filesystem::path> const path_;
+   std::string                                version_{};
+
+   // Most recently used first
+   Entries                                         entries_{};
+   std::unordered_map<uint64_t, Entries::iterator> index_{};
+};
+
+}  // namespace smc
@@ -0,0 +1,220 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+namespace smc {
+
+namespace {
+
+constexpr uint64_t SLOT_MASK = TimerWheel::SLOTS - 1;
+
+uint64_t
+FloorTicks(TimerWheel::Clock::duration duration) {
+   return duration <= TimerWheel::Clock::duration::zero()
+            ? 0
+            : static_cast<uint64_t>(duration / TimerWheel::TICK);
+}
+
+uint64_t
+CeilTicks(TimerWheel::Clock::duration duration) {
+   return duration <= TimerWheel::Clock::duration::zero()
+            ? 0
+            : static_cast<uint64_t>((duration + TimerWheel::TICK - TimerWheel::Clock::duration{1})
+                                    / TimerWheel::TICK);
+}
+
+}  // namespace
+
+TimerWheel::TimerWheel(Clock::time_point start)
+   : start_{start} {}
+
+TimerWheel::Id
+TimerWheel::Schedule(Clock::time_point deadline, Callback&& callback) {
+   if (timers_.empty()) {
+      // Not advanced while idle, the upper levels would be cascaded for nothing
+      now_ = std::max(now_, FloorTicks(Clock::now() - start_));
+   }
+
+   auto const id = timers_.Insert({
+     .deadline_ = std::max(CeilTicks(deadline - start_), now_ + 1),
+     .callback_ = std::move(callback),
+   });
+   Insert(id, *timers_.Find(id));
+   return id;
+}
+
+bool
+TimerWheel::Cancel(Id id) {
+   auto const timer = timers_.Find(id);
+   if (!timer) {
+      return false;
+   }
+
+   if (timer->level_ != EXPIRING) {
+      auto& slot = slots_[timer->level_][timer->slot_];
+      if (!--slot.live_) {
+         // Only cancelled ids left
+         slot.ids_.clear();
+         occupied_[timer->level_] &= ~(uint64_t{1} << timer->slot_);
+      }
+   }
+
+   timers_.Erase(id);
+   return true;
+}
+
+void
+TimerWheel::Advance(Clock::time_point now) {
+   auto const target = FloorTicks(now - start_);
+
+   while (now_ < target) {
+      // Straight to the next tick with work, the ones between have none
+      auto const next = NextTick();
+      if (!next || (*next > target)) {
+         now_ = target;
+         break;
+      }
+
+      now_ = *next;
+      for (auto level = LEVELS - 1; level; --level) {
+         if (!(now_ & ((uint64_t{1} << (SLOT_BITS * level)) - 1))) {
+            Cascade(level);
+         }
+      }
+      Expire();
+   }
+}
+
+std::optional<TimerWheel::Clock::time_point>
+TimerWheel::NextWake() const {
+   auto const tick = NextTick();
+   if (!tick) {
+      return std::nullopt;
+   }
+
+   return start_ + *tick * TICK;
+}
+
+std::size_t
+TimerWheel::Size() const {
+   return timers_.size();
+}
+
+void
+TimerWheel::Insert(Id id, Timer& timer) {
+   assert(timer.deadline_ >= now_);
+   auto const delta = timer.deadline_ - now_;
+
+   std::size_t level = 0;
+   while (((level + 1) < LEVELS) && (delta >> (SLOT_BITS * (level + 1)))) {
+      ++level;
+   }
+
+   // Farther than the last level : parked in its farthest slot, cascaded there again
+   auto const span = uint64_t{1} << (SLOT_BITS * LEVELS);
+   auto const tick = std::min(timer.deadline_, now_ + span - 1);
+
+   timer.level_ = static_cast<uint8_t>(level);
+   timer.slot_  = static_cast<uint8_t>((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+
+   auto& slot = slots_[level][timer.slot_];
+   slot.ids_.emplace_back(id);
+   ++slot.live_;
+   occupied_[level] |= uint64_t{1} << timer.slot_;
+}
+
+void
+TimerWheel::Cascade(std::size_t level) {
+   auto const index = (now_ >> (SLOT_BITS * level)) & SLOT_MASK;
+   auto&      slot  = slots_[level][index];
+   if (!slot.live_) {
+      return;
+   }
+
+   // Moved out first, a timer may land in the same slot again
+   auto ids = std::move(slot.ids_);
+   slot     = {};
+   occupied_[level] &= ~(uint64_t{1} << index);
+
+   for (auto const id : ids) {
+      if (auto const timer = timers_.Find(id)) {
+         Insert(id, *timer);
+      }
+   }
+}
+
+void
+TimerWheel::Expire() {
+   auto const index = now_ & SLOT_MASK;
+   auto&      slot  = slots_[0][index];
+   if (!slot.live_) {
+      return;
+   }
+
+   auto ids = std::move(slot.ids_);
+   slot     = {};
+   occupied_[0] &= ~(uint64_t{1} << index);
+
+   // Out of the slot, the callbacks may cancel the timers expiring with theirs
+   for (auto const id : ids) {
+      if (auto const timer = timers_.Find(id)) {
+         timer->level_ = EXPIRING;
+      }
+   }
+
+   for (auto const id : ids) {
+      auto const timer = timers_.Find(id);
+      if (!timer) {
+         // Cancelled
+         continue;
+      }
+      assert(timer->deadline_ <= now_);
+
+      // Erased first, the callback may schedule or cancel timers
+      auto callback = std::move(timer->callback_);
+      timers_.Erase(id);
+      callback();
+   }
+}
+
+std::optional<uint64_t>
+TimerWheel::NextTick() const {
+   std::optional<uint64_t> result{};
+
+   for (std::size_t level = 0; level < LEVELS; ++level) {
+      if (!occupied_[level]) {
+         continue;
+      }
+
+      // First occupied slot after the current one, a whole turn at most
+      auto const shift   = SLOT_BITS * level;
+      auto const next    = (now_ >> shift) + 1;
+      auto const rotated = std::rotr(occupied_[level], static_cast<int>(next & SLOT_MASK));
+      auto const tick    = (next + static_cast<uint64_t>(std::countr_zero(rotated))) << shift;
+
+      result = std::min(result.value_or(tick), tick);
+   }
+
+   return result;
+}
+
+}  // namespace smc
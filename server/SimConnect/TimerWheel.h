@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Utils/SlotMap.h"
+#include "Utils/SmallFunction.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace smc {
+
+// Hierarchical timer wheel : LEVELS wheels of SLOTS slots, a slot of a level spans a whole turn
+// of the level below. Timers far enough are kept in the upper levels and moved down (cascaded)
+// as their deadline gets closer, scheduling and cancelling are O(1).
+// Nothing runs on its own, the owner calls Advance at NextWake : cancelled timers are dropped
+// from it, they never wake the owner.
+class TimerWheel {
+public:
+   using Clock    = std::chrono::steady_clock;
+   using Id       = uint64_t;  // Never 0, never reused
+   using Callback = SmallFunction<void()>;
+
+   static constexpr std::chrono::milliseconds TICK{10};
+   static constexpr std::size_t               LEVELS    = 3;
+   static constexpr uint32_t                  SLOT_BITS = 6;
+   static constexpr std::size_t               SLOTS     = std::size_t{1} << SLOT_BITS;
+
+   explicit TimerWheel(Clock::time_point start = Clock::now());
+
+   // Deadlines are rounded up to the next tick
+   Id   Schedule(Clock::time_point deadline, Callback&& callback);
+   bool Cancel(Id id);
+
+   // Runs the callbacks due by now in deadline order, they may schedule and cancel timers
+   void Advance(Clock::time_point now);
+
+   // When Advance has work to do (a timer expiring or cascading), nullopt without timers
+   std::optional<Clock::time_point> NextWake() const;
+
+   std::size_t Size() const;
+
+private:
+   // Level of the timers taken out of their slot to run
+   static constexpr uint8_t EXPIRING = LEVELS;
+
+   struct Timer {
+      uint64_t deadline_{};  // Ticks since start_
+      Callback callback_{};
+      uint8_t  level_{};
+      uint8_t  slot_{};
+   };
+
+   struct Slot {
+      // Cancelled ids are left behind until the slot is run
+      std::vector<Id> ids_{};
+      std::size_t     live_{};
+   };
+
+   void                    Insert(Id id, Timer& timer);
+   void                    Cascade(std::size_t level);
+   void                    Expire();
+   std::optional<uint64_t> NextTick() const;
+
+   Clock::time_point start_;
+   uint64_t          now_{};  // Ticks since start_, up to which the timers ran
+
+   SlotMap<Timer, Id>                          timers_{};
+   std::array<std::array<Slot, SLOTS>, LEVELS> slots_{};
+   std::array<uint64_t, LEVELS>                occupied_{};  // A bit per slot with live timers
+};
+
+}  // namespace smc
@@ -0,0 +1,251 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Traffic.h"
+
+#include <cassert>
+#include <utility>
+
+namespace smc {
+
+bool
+TrafficDiff::Empty() const {
+   return added_.empty() && moved_.empty() && removed_.empty();
+}
+
+void
+TrafficTable::Begin() {
+   for (auto& flags : flags_) {
+      flags &= ~SEEN;
+   }
+}
+
+void
+TrafficTable::Set(DWORD id, TrafficInfo const& info, bool helicopter) {
+   auto const on_ground = static_cast<uint8_t>(info.sim_on_ground_ != 0);
+
+   auto const [it, inserted] = rows_.try_emplace(id, ids_.size());
+   if (inserted) {
+      ids_.emplace_back(id);
+      lats_.emplace_back(info.lat_);
+      lons_.emplace_back(info.lon_);
+      altitudes_.emplace_back(info.altitude_);
+      headings_.emplace_back(info.true_heading_);
+      ground_velocities_.emplace_back(info.ground_velocity_);
+      vertical_speeds_.emplace_back(info.vspeed_);
+      north_velocities_.emplace_back(info.world_lat_velocity_);
+      east_velocities_.emplace_back(info.world_lon_velocity_);
+      vertical_velocities_.emplace_back(info.world_vertical_velocity_);
+      on_ground_.emplace_back(on_ground);
+      helicopters_.emplace_back(helicopter);
+      alerts_.emplace_back(Alert::NONE);
+      flags_.emplace_back(SEEN | ADDED);
+      static_infos_.emplace_back();
+      return;
+   }
+
+   auto const row = it->second;
+
+   // Only used by Advise, they follow the position changes
+   north_velocities_[row]    = info.world_lat_velocity_;
+   east_velocities_[row]     = info.world_lon_velocity_;
+   vertical_velocities_[row] = info.world_vertical_velocity_;
+
+   if (
+     (lats_[row] != info.lat_) || (lons_[row] != info.lon_) || (altitudes_[row] != info.altitude_)
+     || (headings_[row] != info.true_heading_) || (ground_velocities_[row] != info.ground_velocity_)
+     || (vertical_speeds_[row] != info.vspeed_) || (on_ground_[row] != on_ground)
+   ) {
+      lats_[row]              = info.lat_;
+      lons_[row]              = info.lon_;
+      altitudes_[row]         = info.altitude_;
+      headings_[row]          = info.true_heading_;
+      ground_velocities_[row] = info.ground_velocity_;
+      vertical_speeds_[row]   = info.vspeed_;
+      on_ground_[row]         = on_ground;
+      flags_[row]            |= CHANGED;
+   }
+
+   // Listed by both requests
+   helicopters_[row] |= static_cast<uint8_t>(helicopter);
+   flags_[row]       |= SEEN;
+}
+
+void
+TrafficTable::Advise(TrafficInfo const& user) {
+   advised_.resize(ids_.size());
+   conflicts_.Detect(
+     user,
+     {
+       .lats_                = lats_,
+       .lons_                = lons_,
+       .altitudes_           = altitudes_,
+       .north_velocities_    = north_velocities_,
+       .east_velocities_     = east_velocities_,
+       .vertical_velocities_ = vertical_velocities_,
+       .on_ground_           = on_ground_,
+     },
+     advised_
+   );
+
+   for (std::size_t row = 0; row < ids_.size(); ++row) {
+      if (alerts_[row] != advised_[row]) {
+         alerts_[row]  = advised_[row];
+         flags_[row]  |= CHANGED;
+      }
+   }
+}
+
+TrafficDiff
+TrafficTable::End() {
+   TrafficDiff diff{};
+
+   // Backward, removals move the last row in place
+   for (auto row = ids_.size(); row--;) {
+      auto const flags = flags_[row];
+
+      if (!(flags & SEEN)) {
+         diff.removed_.emplace_back(ids_[row]);
+         Remove(row);
+         continue;
+      }
+
+      if (flags & ADDED) {
+         diff.added_.emplace_back(Entry(row));
+      } else if (flags & CHANGED) {
+         diff.moved_.emplace_back(Entry(row));
+      }
+      flags_[row] &= ~(ADDED | CHANGED);
+   }
+
+   return diff;
+}
+
+std::vector<DWORD>
+TrafficTable::TakeMissingStaticInfo() {
+   std::vector<DWORD> result{};
+
+   for (std::size_t row = 0; row < ids_.size(); ++row) {
+      if (!(flags_[row] & STATIC_REQUESTED)) {
+         flags_[row] |= STATIC_REQUESTED;
+         result.emplace_back(ids_[row]);
+      }
+   }
+
+   return result;
+}
+
+void
+TrafficTable::SetStaticInfo(DWORD id, TrafficStaticInfo&& info) {
+   if (auto const it = rows_.find(id); it != rows_.end()) {
+      static_infos_[it->second]  = std::make_shared<TrafficStaticInfo const>(std::move(info));
+      flags_[it->second]        |= CHANGED;
+   }
+}
+
+void
+TrafficTable::ForgetStaticInfo(DWORD id) {
+   if (auto const it = rows_.find(id); it != rows_.end()) {
+      flags_[it->second] &= ~STATIC_REQUESTED;
+   }
+}
+
+TrafficDiff
+TrafficTable::Snapshot() const {
+   TrafficDiff diff{};
+
+   diff.added_.reserve(ids_.size());
+   for (std::size_t row = 0; row < ids_.size(); ++row) {
+      diff.added_.emplace_back(Entry(row));
+   }
+
+   return diff;
+}
+
+TrafficDiff
+TrafficTable::Clear() {
+   TrafficDiff diff{.removed_ = std::move(ids_)};
+
+   *this = {};
+   return diff;
+}
+
+std::size_t
+TrafficTable::Size() const {
+   return ids_.size();
+}
+
+TrafficEntry
+TrafficTable::Entry(std::size_t row) const {
+   return {
+     .id_              = ids_[row],
+     .lat_             = lats_[row],
+     .lon_             = lons_[row],
+     .altitude_        = altitudes_[row],
+     .heading_         = headings_[row],
+     .ground_velocity_ = ground_velocities_[row],
+     .vertical_speed_  = vertical_speeds_[row],
+     .on_ground_       = on_ground_[row] != 0,
+     .helicopter_      = helicopters_[row] != 0,
+     .alert_           = alerts_[row],
+     .static_info_     = static_infos_[row],
+   };
+}
+
+void
+TrafficTable::Remove(std::size_t row) {
+   auto const last = ids_.size() - 1;
+   rows_.erase(ids_[row]);
+
+   if (row != last) {
+      rows_[ids_[last]] = row;
+
+      ids_[row]                 = ids_[last];
+      lats_[row]                = lats_[last];
+      lons_[row]                = lons_[last];
+      altitudes_[row]           = altitudes_[last];
+      headings_[row]            = headings_[last];
+      ground_velocities_[row]   = ground_velocities_[last];
+      vertical_speeds_[row]     = vertical_speeds_[last];
+      north_velocities_[row]    = north_velocities_[last];
+      east_velocities_[row]     = east_velocities_[last];
+      vertical_velocities_[row] = vertical_velocities_[last];
+      on_ground_[row]           = on_ground_[last];
+      helicopters_[row]         = helicopters_[last];
+      alerts_[row]              = alerts_[last];
+      flags_[row]               = flags_[last];
+      static_infos_[row]        = std::move(static_infos_[last]);
+   }
+
+   ids_.pop_back();
+   lats_.pop_back();
+   lons_.pop_back();
+   altitudes_.pop_back();
+   headings_.pop_back();
+   ground_velocities_.pop_back();
+   vertical_speeds_.pop_back();
+   north_velocities_.pop_back();
+   east_velocities_.pop_back();
+   vertical_velocities_.pop_back();
+   on_ground_.pop_back();
+   helicopters_.pop_back();
+   alerts_.pop_back();
+   flags_.pop_back();
+   static_infos_.pop_back();
+
+   assert(rows_.size() == ids_.size());
+}
+
+}  // namespace smc
@@ -0,0 +1,119 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Conflicts.h"
+#include "Data/TrafficInfo.h"
+#include "Data/TrafficStaticInfo.h"
+
+#include <Windows.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace smc {
+
+// Last sampled state of an aircraft, in the simulator units
+struct TrafficEntry {
+   DWORD id_{};
+
+   double lat_{};              // degrees
+   double lon_{};              // degrees
+   double altitude_{};         // feet
+   double heading_{};          // true, radians
+   double ground_velocity_{};  // knots
+   double vertical_speed_{};   // feet/second
+   bool   on_ground_{};
+   bool   helicopter_{};
+
+   // Against the user aircraft
+   Alert alert_{Alert::NONE};
+
+   // Requested once per aircraft, null until received
+   std::shared_ptr<TrafficStaticInfo const> static_info_{};
+};
+
+// Changes between two samples of the traffic
+struct TrafficDiff {
+   std::vector<TrafficEntry> added_{};
+   // Also the aircraft whose static info was received since the last sample
+   std::vector<TrafficEntry> moved_{};
+   std::vector<DWORD>        removed_{};
+
+   bool Empty() const;
+};
+
+// Aircraft in range (user aircraft excluded), fed by full samples of the simulator objects.
+// Values are stored column by column, rows are found by object id and removed by moving the last
+// row in their place.
+class TrafficTable {
+public:
+   // A sample is every Set between Begin and End, the aircraft missing from it are removed
+   void        Begin();
+   void        Set(DWORD id, TrafficInfo const& info, bool helicopter);
+   // Alert levels against the user aircraft, the aircraft whose level changed are reported as moved
+   void        Advise(TrafficInfo const& user);
+   TrafficDiff End();
+
+   // Aircraft whose static info wasn't requested yet, they are then marked as requested
+   std::vector<DWORD> TakeMissingStaticInfo();
+   void               SetStaticInfo(DWORD id, TrafficStaticInfo&& info);
+   // Failed request, asked again after the next sample
+   void ForgetStaticInfo(DWORD id);
+
+   // Every aircraft, as added
+   TrafficDiff Snapshot() const;
+   // Removes every aircraft
+   TrafficDiff Clear();
+
+   std::size_t Size() const;
+
+private:
+   enum Flag : uint8_t {
+      SEEN             = 1 << 0,
+      ADDED            = 1 << 1,
+      CHANGED          = 1 << 2,
+      STATIC_REQUESTED = 1 << 3,
+   };
+
+   TrafficEntry Entry(std::size_t row) const;
+   void         Remove(std::size_t row);
+
+   std::unordered_map<DWORD, std::size_t> rows_{};
+
+   std::vector<DWORD>                                    ids_{};
+   std::vector<double>                                   lats_{};
+   std::vector<double>                                   lons_{};
+   std::vector<double>                                   altitudes_{};
+   std::vector<double>                                   headings_{};
+   std::vector<double>                                   ground_velocities_{};
+   std::vector<double>                                   vertical_speeds_{};
+   std::vector<double>                                   north_velocities_{};
+   std::vector<double>                                   east_velocities_{};
+   std::vector<double>                                   vertical_velocities_{};
+   std::vector<uint8_t>                                  on_ground_{};
+   std::vector<uint8_t>                                  helicopters_{};
+   std::vector<Alert>                                    alerts_{};
+   std::vector<uint8_t>                                  flags_{};
+   std::vector<std::shared_ptr<TrafficStaticInfo const>> static_infos_{};
+
+   ConflictDetector   conflicts_{};
+   std::vector<Alert> advised_{};
+};
+
+}  // namespace smc
@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <Windows.h>
+#include <SimConnect.h>
+
+#include <cstddef>
+#include <limits>
+
+namespace smc {
+
+// Entries left of a RequestDataOnSimObjectType answer : one packet per object in range with
+// dwentrynumber counting from 1 to dwoutof, or a single empty packet (dwoutof 0) when nothing is
+// in range.
+class ByTypeCount {
+public:
+   // Before the first packet
+   static constexpr std::size_t UNKNOWN = std::numeric_limits<std::size_t>::max();
+
+   // Whether the packet carries an object
+   bool
+   Receive(SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const& data) {
+      if (remaining_ == UNKNOWN) {
+         remaining_ = data.dwoutof;
+      }
+
+      if (remaining_ == 0) {
+         return false;
+      }
+
+      --remaining_;
+      return true;
+   }
+
+   bool
+   Done() const {
+      return remaining_ == 0;
+   }
+
+   // Watched for progress
+   std::size_t const&
+   Remaining() const {
+      return remaining_;
+   }
+
+private:
+   std::size_t remaining_{UNKNOWN};
+};
+
+}  // namespace smc
@@ -0,0 +1,62 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+namespace smc {
+
+// Values laid out back to back without padding, the way SimConnect sends them. The facility data
+// members are copied with a single memcpy (ReadPacked), then read with Get<INDEX>
+#pragma pack(push, 1)
+template <class T, class... REST>
+struct Packed {
+   T               value_;
+   Packed<REST...> rest_;
+};
+
+template <class T>
+struct Packed<T> {
+   T value_;
+};
+#pragma pack(pop)
+
+// By value, the members are not aligned
+template <std::size_t INDEX, class T, class... REST>
+constexpr auto
+Get(Packed<T, REST...> const& packed) {
+   if constexpr (INDEX == 0) {
+      return packed.value_;
+   } else {
+      return Get<INDEX - 1>(packed.rest_);
+   }
+}
+
+template <class PACKED>
+PACKED
+ReadPacked(void const* data) {
+   static_assert(std::is_trivially_copyable_v<PACKED>);
+   static_assert(alignof(PACKED) == 1);
+
+   PACKED result;
+   std::memcpy(&result, data, sizeof(PACKED));
+   return result;
+}
+
+}  // namespace smc
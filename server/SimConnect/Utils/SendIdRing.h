@@ -0,0 +1,69 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace smc {
+
+// Request ids of the last SIZE SimConnect calls, by send id. Send ids grow by one per call, so an
+// entry is overwritten (aged out) SIZE calls later : O(1) insert and find, nothing allocated.
+// Keys are never 0, which marks the unused entries.
+template <std::size_t SIZE>
+class SendIdRing {
+   static_assert(std::has_single_bit(SIZE));
+
+public:
+   using Key = uint32_t;
+
+   void
+   Insert(uint32_t send_id, Key key) {
+      entries_[send_id & MASK] = {.send_id_ = send_id, .key_ = key};
+   }
+
+   std::optional<Key>
+   Find(uint32_t send_id) const {
+      auto const& entry = entries_[send_id & MASK];
+      if (!entry.key_ || (entry.send_id_ != send_id)) {
+         return std::nullopt;
+      }
+
+      return entry.key_;
+   }
+
+   // Send ids start over with each connection
+   void
+   Clear() {
+      entries_.fill({});
+   }
+
+private:
+   static constexpr std::size_t MASK = SIZE - 1;
+
+   struct Entry {
+      uint32_t send_id_{};
+      Key      key_{};
+   };
+
+   std::array<Entry, SIZE> entries_{};
+};
+
+}  // namespace smc
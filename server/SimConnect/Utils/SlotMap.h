@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace smc {
+
+// Values stored contiguously, addressed by generation checked keys (O(1) insert, find and
+// erase). A key outlives its value: once erased, it never matches the value reusing its slot.
+// A slot is retired once its generation is exhausted instead of wrapping back to keys already
+// handed out : with 32 bits keys that is after 4095 reuses, the map runs out of keys after ~2^32
+// insertions (asserted). 64 bits keys are never exhausted.
+// Erasing moves the last value in place of the erased one, pointers are invalidated by any
+// Insert/Erase.
+template <class T, class KEY = uint32_t>
+class SlotMap {
+public:
+   using Key = KEY;
+
+   static_assert(std::is_unsigned_v<KEY> && (sizeof(KEY) >= sizeof(uint32_t)));
+
+   static constexpr uint32_t INDEX_BITS      = 20;
+   static constexpr uint32_t INDEX_MASK      = (1u << INDEX_BITS) - 1;
+   static constexpr Key      GENERATION_MASK = std::numeric_limits<Key>::max() >> INDEX_BITS;
+
+   Key
+   Insert(T&& value) {
+      uint32_t index{};
+      if (free_ != NONE) {
+         index = free_;
+         free_ = slots_[index].dense_;
+      } else {
+         assert((slots_.size() < INDEX_MASK) && "Slot map keys exhausted");
+         index = static_cast<uint32_t>(slots_.size());
+         slots_.emplace_back();
+      }
+
+      auto& slot  = slots_[index];
+      slot.dense_ = static_cast<uint32_t>(values_.size());
+
+      values_.emplace_back(std::move(value));
+      keys_.emplace_back((slot.generation_ << INDEX_BITS) | index);
+      return keys_.back();
+   }
+
+   T*
+   Find(Key key) {
+      auto const index = static_cast<uint32_t>(key & INDEX_MASK);
+      if ((index >= slots_.size()) || (slots_[index].generation_ != (key >> INDEX_BITS))) {
+         return nullptr;
+      }
+
+      return &values_[slots_[index].dense_];
+   }
+
+   bool
+   Erase(Key key) {
+      if (!Find(key)) {
+         return false;
+      }
+
+      auto const index = static_cast<uint32_t>(key & INDEX_MASK);
+      auto&      slot  = slots_[index];
+
+      if (auto const last = values_.size() - 1; slot.dense_ != last) {
+         values_[slot.dense_]                     = std::move(values_.back());
+         keys_[slot.dense_]                       = keys_.back();
+         slots_[keys_.back() & INDEX_MASK].dense_ = slot.dense_;
+      }
+      values_.pop_back();
+      keys_.pop_back();
+
+      // Invalidates the key
+      if (slot.generation_ == GENERATION_MASK) {
+         // Every key of the slot was handed out, it is never used again
+         slot.generation_ = RETIRED;
+         slot.dense_      = NONE;
+         return true;
+      }
+
+      ++slot.generation_;
+      slot.dense_ = free_;
+      free_       = index;
+      return true;
+   }
+
+   template <class FUNC>
+   void
+   ForEach(FUNC&& func) {
+      for (std::size_t i = 0; i < values_.size(); ++i) {
+         func(keys_[i], values_[i]);
+      }
+   }
+
+   std::size_t
+   size() const {
+      return values_.size();
+   }
+
+   bool
+   empty() const {
+      return values_.empty();
+   }
+
+private:
+   static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+   // Matches no key. Generations start at 1, 0 is never a valid key
+   static constexpr Key RETIRED = GENERATION_MASK + 1;
+
+   struct Slot {
+      Key      generation_{1};
+      uint32_t dense_{NONE};  // Index in values_, next free slot once erased
+   };
+
+   std::vector<Slot> slots_{};
+   std::vector<T>    values_{};
+   std::vector<Key>  keys_{};
+   uint32_t          free_{NONE};
+};
+
+}  // namespace smc
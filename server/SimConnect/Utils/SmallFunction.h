@@ -0,0 +1,139 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace smc {
+
+template <class SIGNATURE, std::size_t SIZE = 64>
+class SmallFunction;
+
+// Move only std::function, callables up to SIZE bytes are stored inline (no allocation)
+template <class R, class... ARGS, std::size_t SIZE>
+class SmallFunction<R(ARGS...), SIZE> {
+public:
+   SmallFunction() = default;
+
+   template <class F>
+      requires(
+        !std::is_same_v<std::remove_cvref_t<F>, SmallFunction>
+        && std::is_invocable_r_v<R, std::remove_cvref_t<F>&, ARGS...>
+      )
+   SmallFunction(F&& func)
+      : vtable_{&VTABLE<std::remove_cvref_t<F>>} {
+      using FUNC = std::remove_cvref_t<F>;
+
+      if constexpr (IS_INLINE<FUNC>) {
+         new (storage_) FUNC(std::forward<F>(func));
+      } else {
+         *reinterpret_cast<FUNC**>(storage_) = new FUNC(std::forward<F>(func));
+      }
+   }
+
+   SmallFunction(SmallFunction&& other) noexcept { MoveFrom(other); }
+
+   SmallFunction&
+   operator=(SmallFunction&& other) noexcept {
+      if (this != &other) {
+         Reset();
+         MoveFrom(other);
+      }
+      return *this;
+   }
+
+   SmallFunction(SmallFunction const&)            = delete;
+   SmallFunction& operator=(SmallFunction const&) = delete;
+
+   ~SmallFunction() { Reset(); }
+
+   explicit operator bool() const { return vtable_ != nullptr; }
+
+   R
+   operator()(ARGS... args) {
+      assert(vtable_);
+      return vtable_->invoke_(storage_, std::forward<ARGS>(args)...);
+   }
+
+private:
+   struct VTable {
+      R (*invoke_)(void*, ARGS&&...);
+      void (*move_)(void*, void*) noexcept;
+      void (*destroy_)(void*) noexcept;
+   };
+
+   template <class F>
+   static constexpr bool IS_INLINE = (sizeof(F) <= SIZE)
+                                     && (alignof(F) <= alignof(std::max_align_t))
+                                     && std::is_nothrow_move_constructible_v<F>;
+
+   template <class F>
+   static F&
+   Get(void* storage) {
+      if constexpr (IS_INLINE<F>) {
+         return *std::launder(reinterpret_cast<F*>(storage));
+      } else {
+         return **reinterpret_cast<F**>(storage);
+      }
+   }
+
+   template <class F>
+   static constexpr VTable VTABLE{
+     .invoke_ = [](void* storage, ARGS&&... args) -> R {
+        return std::invoke(Get<F>(storage), std::forward<ARGS>(args)...);
+     },
+     .move_ = [](void* to, void* from) noexcept {
+        if constexpr (IS_INLINE<F>) {
+           new (to) F(std::move(Get<F>(from)));
+           Get<F>(from).~F();
+        } else {
+           *reinterpret_cast<F**>(to) = *reinterpret_cast<F**>(from);
+        }
+     },
+     .destroy_ = [](void* storage) noexcept {
+        if constexpr (IS_INLINE<F>) {
+           Get<F>(storage).~F();
+        } else {
+           delete &Get<F>(storage);
+        }
+     },
+   };
+
+   void
+   MoveFrom(SmallFunction& other) noexcept {
+      if (other.vtable_) {
+         other.vtable_->move_(storage_, other.storage_);
+         vtable_ = std::exchange(other.vtable_, nullptr);
+      }
+   }
+
+   void
+   Reset() noexcept {
+      if (vtable_) {
+         std::exchange(vtable_, nullptr)->destroy_(storage_);
+      }
+   }
+
+   alignas(std::max_align_t) std::byte storage_[SIZE];
+   VTable const* vtable_{nullptr};
+};
+
+}  // namespace smc
@@ -31,14 +31,19 @@ template GroundInfo        SimConnect::StaticCast<GroundInfo>(DWORD const& data)
 template ServerPort        SimConnect::StaticCast<ServerPort>(DWORD const& data);
 template SimRate           SimConnect::StaticCast<SimRate>(DWORD const& data);
 template TrafficInfo       SimConnect::StaticCast<TrafficInfo>(DWORD const& data);
+template TrafficPosition   SimConnect::StaticCast<TrafficPosition>(DWORD const& data);
 template TrafficStaticInfo SimConnect::StaticCast<TrafficStaticInfo>(DWORD const& data);
 
+template std::optional<uint64_t>
+SimConnect::ApplyTagged<TrafficInfo>(SIMCONNECT_RECV_SIMOBJECT_DATA const& data, TrafficInfo& into);
+
 template std::size_t SimConnect::Size<Break>();
 template std::size_t SimConnect::Size<Flaps>();
 template std::size_t SimConnect::Size<GroundInfo>();
 template std::size_t SimConnect::Size<ServerPort>();
 template std::size_t SimConnect::Size<SimRate>();
 template std::size_t SimConnect::Size<TrafficInfo>();
+template std::size_t SimConnect::Size<TrafficPosition>();
 template std::size_t SimConnect::Size<TrafficStaticInfo>();
 
 }  // namespace smc
\ No newline at end of file
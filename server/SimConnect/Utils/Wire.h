@@ -0,0 +1,243 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../Data/DataType.h"
+
+#include <Windows.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Decoding of the SIMCONNECT_RECV_SIMOBJECT_DATA payloads, for the data types declaring their
+// definition in T::MEMBERS (SimConnect::StaticCast, SimConnect::ApplyTagged)
+namespace smc::wire {
+
+template <typename>
+inline constexpr bool ALWAYS_FALSE = false;
+
+template <SIMCONNECT_DATATYPE TYPE>
+struct WireType {
+   static_assert(ALWAYS_FALSE<Type<TYPE>>, "Unsupported type");
+};
+
+template <>
+struct WireType<SIMCONNECT_DATATYPE_STRING256> {
+   using type = std::array<char, 256>;
+};
+
+template <>
+struct WireType<SIMCONNECT_DATATYPE_STRING32> {
+   using type = std::array<char, 32>;
+};
+
+template <>
+struct WireType<SIMCONNECT_DATATYPE_STRING8> {
+   using type = std::array<char, 8>;
+};
+
+template <>
+struct WireType<SIMCONNECT_DATATYPE_FLOAT64> {
+   using type = double;
+};
+
+template <>
+struct WireType<SIMCONNECT_DATATYPE_FLOAT32> {
+   using type = float;
+};
+
+template <>
+struct WireType<SIMCONNECT_DATATYPE_INT8> {
+   using type = int8_t;
+};
+
+template <>
+struct WireType<SIMCONNECT_DATATYPE_INT32> {
+   using type = int32_t;
+};
+
+template <>
+struct WireType<SIMCONNECT_DATATYPE_INT64> {
+   using type = int64_t;
+};
+
+template <class T>
+constexpr std::size_t
+WireSize() {
+   std::size_t size = 0;
+
+   std::apply(
+     [&](auto const&... member) constexpr {
+        (
+          [&]<class M>(M const&) constexpr {
+             if constexpr (std::tuple_element_t<2, M>::VALUE_S == SIMCONNECT_DATATYPE_STRING256) {
+                size += 256;
+             } else if constexpr (
+               std::tuple_element_t<2, M>::VALUE_S == SIMCONNECT_DATATYPE_STRING32
+             ) {
+                size += 32;
+             } else if constexpr (
+               std::tuple_element_t<2, M>::VALUE_S == SIMCONNECT_DATATYPE_STRING8
+             ) {
+                size += 8;
+             } else if constexpr (
+               std::tuple_element_t<2, M>::VALUE_S == SIMCONNECT_DATATYPE_FLOAT64
+             ) {
+                size += sizeof(double);
+             } else if constexpr (
+               std::tuple_element_t<2, M>::VALUE_S == SIMCONNECT_DATATYPE_FLOAT32
+             ) {
+                size += sizeof(float);
+             } else if constexpr (std::tuple_element_t<2, M>::VALUE_S == SIMCONNECT_DATATYPE_INT8) {
+                size += sizeof(int8_t);
+             } else if constexpr (
+               std::tuple_element_t<2, M>::VALUE_S == SIMCONNECT_DATATYPE_INT32
+             ) {
+                size += sizeof(int32_t);
+             } else if constexpr (
+               std::tuple_element_t<2, M>::VALUE_S == SIMCONNECT_DATATYPE_INT64
+             ) {
+                size += sizeof(int64_t);
+             } else {
+                static_assert(ALWAYS_FALSE<M>, "Unsupported type");
+             }
+          }(member),
+          ...);
+     },
+     T::MEMBERS
+   );
+
+   return size;
+}
+
+template <class MEMBER, class VALUE>
+void
+Assign(MEMBER& member, VALUE const& value) {
+   if constexpr (requires { value.size(); }) {
+      // Strings are null terminated, unless they fill the whole field
+      member = std::string_view{value.data(), strnlen(value.data(), value.size())};
+   } else {
+      static_assert(std::is_same_v<MEMBER, VALUE>);
+      member = value;
+   }
+}
+
+// Reads the value of std::get<I>(T::MEMBERS) into its member, returns the bytes read (0 when
+// truncated)
+template <class T, std::size_t I>
+std::size_t
+ReadDatum(std::byte const* data, std::size_t size, T& into) {
+   using MEMBER = std::tuple_element_t<I, std::remove_cvref_t<decltype(T::MEMBERS)>>;
+   using WIRE   = typename WireType<std::tuple_element_t<2, MEMBER>::VALUE_S>::type;
+
+   if (size < sizeof(WIRE)) {
+      return 0;
+   }
+
+   WIRE value;
+   std::memcpy(&value, data, sizeof(WIRE));
+   Assign(into.*std::get<0>(std::get<I>(T::MEMBERS)), value);
+   return sizeof(WIRE);
+}
+
+// Readers by datum id, the index in T::MEMBERS
+template <class T>
+constexpr auto DATUM_READERS = []<std::size_t... INDEX>(std::index_sequence<INDEX...>) {
+   return std::array<std::size_t (*)(std::byte const*, std::size_t, T&), sizeof...(INDEX)>{
+     &ReadDatum<T, INDEX>...
+   };
+}(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<decltype(T::MEMBERS)>>>{});
+
+// Decodes a packet laid out as T::MEMBERS, field by field. The packet size is checked once by the
+// caller against WireSize<T>()
+template <class T>
+T
+Read(DWORD const& data) {
+   auto const* it = reinterpret_cast<std::byte const*>(&data);
+
+   T result{};
+   [&]<std::size_t... INDEX>(std::index_sequence<INDEX...>) constexpr {
+      (
+        [&]<std::size_t I>(std::integral_constant<std::size_t, I>) constexpr {
+           using MEMBER = std::tuple_element_t<I, std::remove_cvref_t<decltype(T::MEMBERS)>>;
+           using VALUE  = typename WireType<std::tuple_element_t<2, MEMBER>::VALUE_S>::type;
+
+           auto& member = result.*std::get<0>(std::get<I>(T::MEMBERS));
+
+           if constexpr (requires(VALUE v) { v.size(); }) {
+              // Strings are read in place, null terminated unless they fill the whole field
+              auto const text = reinterpret_cast<char const*>(it);
+              auto const end  = static_cast<char const*>(std::memchr(text, 0, sizeof(VALUE)));
+              member          = std::string_view{text, end ? end : text + sizeof(VALUE)};
+           } else {
+              static_assert(std::is_same_v<std::remove_cvref_t<decltype(member)>, VALUE>);
+              std::memcpy(&member, it, sizeof(VALUE));
+           }
+           it += sizeof(VALUE);
+        }(std::integral_constant<std::size_t, INDEX>{}),
+        ...
+      );
+   }(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<decltype(T::MEMBERS)>>>{});
+
+   return result;
+}
+
+// Applies the (datum id, value) pairs of a tagged packet onto into. Returns the dirty mask of the
+// fields read, nullopt when the packet is malformed
+template <class T>
+std::optional<uint64_t>
+ApplyTagged(SIMCONNECT_RECV_SIMOBJECT_DATA const& data, T& into) {
+   static_assert(DATUM_READERS<T>.size() <= 64, "The dirty mask holds 64 fields");
+
+   auto const header_size = sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(data.dwData);
+   if (data.dwSize < header_size) {
+      return std::nullopt;
+   }
+
+   auto const* cursor = reinterpret_cast<std::byte const*>(&data.dwData);
+   auto const* end    = cursor + (data.dwSize - header_size);
+
+   uint64_t dirty = 0;
+   for (DWORD i = 0; i < data.dwDefineCount; ++i) {
+      DWORD datum;
+      if (static_cast<std::size_t>(end - cursor) < sizeof(datum)) {
+         return std::nullopt;
+      }
+      std::memcpy(&datum, cursor, sizeof(datum));
+      cursor += sizeof(datum);
+
+      if (datum >= DATUM_READERS<T>.size()) {
+         return std::nullopt;
+      }
+
+      auto const read = DATUM_READERS<T>[datum](cursor, end - cursor, into);
+      if (!read) {
+         return std::nullopt;
+      }
+      cursor += read;
+      dirty  |= uint64_t{1} << datum;
+   }
+
+   return dirty;
+}
+
+}  // namespace smc::wire
@@ -42,12 +42,14 @@
 #include <winreg.h>
 #include <winuser.h>
 
+#include <charconv>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
 #include <format>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <io.h>
@@ -60,11 +62,14 @@ enum class Uninstall {
 
 auto
 ParseArgs(std::string_view cmd) {
-   bool      minimized{false};
-   Uninstall uninstall{Uninstall::NONE};
-   bool      configure{false};
-   bool      open_web{false};
-   bool      open_efb{false};
+   bool            minimized{false};
+   Uninstall       uninstall{Uninstall::NONE};
+   bool            configure{false};
+   bool            open_web{false};
+   bool            open_efb{false};
+   Server::Options server_options{};
+
+   smc::SimConnect::Options sim_connect_options{};
 
    auto constexpr split = [](std::string_view cmd) constexpr -> std::string_view {
       auto const pos = cmd.find_first_of(' ');
@@ -97,13 +102,58 @@ ParseArgs(std::string_view cmd) {
          open_efb = true;
       } else if (value == "--open-web") {
          open_web = true;
+      } else if (value == "--relay") {
+         // --relay <host>[:<port>]
+         cmd   = next(cmd);
+         value = split(cmd);
+
+         if (value.size()) {
+            server_options.relay_ = std::string{value};
+         }
+      } else if (value == "--port") {
+         cmd   = next(cmd);
+         value = split(cmd);
+
+         if (
+           uint16_t port{};
+           value.size()
+           && (std::from_chars(value.data(), value.data() + value.size(), port).ec == std::errc{})
+         ) {
+            server_options.port_ = port;
+         }
+      } else if (value == "--capture") {
+         // --capture <file>, records the SimConnect packets
+         cmd   = next(cmd);
+         value = split(cmd);
+
+         if (value.size()) {
+            sim_connect_options.capture_ = std::filesystem::path{value};
+         }
+      } else if (value == "--replay") {
+         // --replay <file>, replays a capture instead of connecting to the simulator
+         cmd   = next(cmd);
+         value = split(cmd);
+
+         if (value.size()) {
+            sim_connect_options.replay_ = std::filesystem::path{value};
+         }
+      } else if (value == "--replay-fast") {
+         sim_connect_options.replay_fast_ = true;
+      } else if (value == "--clear-airport-cache") {
+         // After a scenery change, airports are fetched again from the simulator
+         sim_connect_options.clear_airport_cache_ = true;
+      } else if (value == "--clear-terrain-cache") {
+         // After a scenery change, ground altitudes are probed again
+         sim_connect_options.clear_terrain_cache_ = true;
       }
    }
 
-   if (!minimized && !configure && !open_web) {
+   if (!minimized && !configure && !open_web && !server_options.relay_) {
       open_efb = true;
    }
-   return std::make_tuple(minimized, uninstall, configure, open_web, open_efb);
+   return std::make_tuple(
+     minimized, uninstall, configure, open_web, open_efb, server_options, sim_connect_options
+   );
 }
 
 #ifdef _WIN32
@@ -120,7 +170,9 @@ main() {
       std::cerr << "Coinitialized failed (" << hr << ")" << std::endl;
    }
 
-   auto const [minimized, uninstall, configure, open_web, open_efb] = ParseArgs(lpCmdLine);
+   auto const
+     [minimized, uninstall, configure, open_web, open_efb, server_options, sim_connect_options] =
+       ParseArgs(lpCmdLine);
 
    if (uninstall == Uninstall::STEP1) {
 
@@ -240,8 +292,18 @@ main() {
       return EXIT_SUCCESS;
    }
 
-   auto const lock = win32::CreateLock("MSFS_VFR_NAV_SERVER");
+   // Relays may run next to the server, one per port
+   auto const lock_name = server_options.relay_
+                          ? std::format("MSFS_VFR_NAV_RELAY_{}", server_options.port_.value_or(0))
+                          : std::string{"MSFS_VFR_NAV_SERVER"};
+
+   auto const lock = win32::CreateLock(lock_name.c_str());
    if (!lock) {
+      if (server_options.relay_) {
+         std::cerr << "A relay already runs on this port" << std::endl;
+         return EXIT_FAILURE;
+      }
+
       if (auto window = FindWindow("system_tray", "MSFS2024 VFRNav' Server"); window) {
          if (configure) {
             SendMessageA(window, WM_OPEN_SETTINGS, 0ul, 0ul);
@@ -281,7 +343,7 @@ main() {
       _setmode(_fileno(stdout), _O_BINARY);
 #endif  // DEBUG
 
-      Main main{minimized, configure, open_efb, open_web};
+      Main main{minimized, configure, open_efb, open_web, server_options, sim_connect_options};
    } catch (const webview::Exception& e) {
       std::cerr << e.what() << '\n';
       return 1;
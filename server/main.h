@@ -38,7 +38,14 @@ class Main
    : public win32::SystemTray
    , public MainPool {
 public:
-   Main(bool minimized, bool configure, bool open_efb, bool open_web);
+   Main(
+     bool                     minimized,
+     bool                     configure,
+     bool                     open_efb,
+     bool                     open_web,
+     Server::Options          server_options,
+     smc::SimConnect::Options sim_connect_options
+   );
    ~Main() override;
 
 public:
@@ -88,8 +95,8 @@ private:
    std::atomic<bool> terminated_{false};
 
    // Must be before windows to resolve every promises
-   ::SimConnect sim_connect_{*this};
-   Server       server_{*this};
+   ::SimConnect sim_connect_;
+   Server       server_;
 
    Window<WIN::TASKBAR>         taskbar_{*this, [this]() { taskbar_.OnTerminate(); }};
    Window<WIN::TASKBAR_TOOLTIP> taskbar_tooltip_{*this, [this]() {
@@ -0,0 +1,515 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Subset of the MSFS 2024 SDK SimConnect.h implemented by the stand-in library.
+// Names, values and packed layouts follow the SDK so that sources and captures are interchangeable.
+
+#pragma once
+
+#include <cstdint>
+
+#ifdef _WIN32
+#   include <Windows.h>
+#   define SIMCONNECTAPI extern "C" HRESULT __stdcall
+#else
+using DWORD   = uint32_t;
+using HRESULT = int32_t;
+using HANDLE  = void*;
+using HWND    = void*;
+
+#   define S_OK          static_cast<HRESULT>(0)
+#   define E_FAIL        static_cast<HRESULT>(0x80004005)
+#   define E_INVALIDARG  static_cast<HRESULT>(0x80070057)
+#   define SUCCEEDED(hr) (static_cast<HRESULT>(hr) >= 0)
+#   define FAILED(hr)    (static_cast<HRESULT>(hr) < 0)
+#   define CALLBACK
+#   define SIMCONNECTAPI extern "C" HRESULT
+#endif
+
+using SIMCONNECT_OBJECT_ID             = DWORD;
+using SIMCONNECT_DATA_DEFINITION_ID    = DWORD;
+using SIMCONNECT_DATA_REQUEST_ID       = DWORD;
+using SIMCONNECT_CLIENT_EVENT_ID       = DWORD;
+using SIMCONNECT_NOTIFICATION_GROUP_ID = DWORD;
+
+static constexpr DWORD SIMCONNECT_UNUSED         = 0xFFFFFFFF;
+static constexpr DWORD SIMCONNECT_OBJECT_ID_USER = 0;
+
+static constexpr DWORD SIMCONNECT_GROUP_PRIORITY_HIGHEST = 1;
+
+using SIMCONNECT_EVENT_FLAG                                 = DWORD;
+static constexpr DWORD SIMCONNECT_EVENT_FLAG_DEFAULT        = 0x00000000;
+static constexpr DWORD SIMCONNECT_EVENT_FLAG_GROUPID_IS_PRIORITY = 0x00000010;
+
+using SIMCONNECT_DATA_REQUEST_FLAG                    = DWORD;
+static constexpr DWORD SIMCONNECT_DATA_REQUEST_FLAG_DEFAULT = 0x00000000;
+static constexpr DWORD SIMCONNECT_DATA_REQUEST_FLAG_CHANGED = 0x00000001;
+static constexpr DWORD SIMCONNECT_DATA_REQUEST_FLAG_TAGGED  = 0x00000002;
+
+using SIMCONNECT_DATA_SET_FLAG                         = DWORD;
+static constexpr DWORD SIMCONNECT_DATA_SET_FLAG_DEFAULT = 0x00000000;
+static constexpr DWORD SIMCONNECT_DATA_SET_FLAG_TAGGED  = 0x00000001;
+
+using SIMCONNECT_WAYPOINT_FLAGS                                 = DWORD;
+static constexpr DWORD SIMCONNECT_WAYPOINT_NONE                 = 0x00;
+static constexpr DWORD SIMCONNECT_WAYPOINT_SPEED_REQUESTED      = 0x04;
+static constexpr DWORD SIMCONNECT_WAYPOINT_THROTTLE_REQUESTED   = 0x08;
+static constexpr DWORD SIMCONNECT_WAYPOINT_COMPUTE_VERTICAL_SPEED = 0x10;
+static constexpr DWORD SIMCONNECT_WAYPOINT_ALTITUDE_IS_AGL      = 0x20;
+static constexpr DWORD SIMCONNECT_WAYPOINT_ON_GROUND            = 0x00100000;
+static constexpr DWORD SIMCONNECT_WAYPOINT_REVERSE              = 0x00200000;
+static constexpr DWORD SIMCONNECT_WAYPOINT_WRAP_TO_FIRST        = 0x00400000;
+
+enum SIMCONNECT_RECV_ID : DWORD {
+   SIMCONNECT_RECV_ID_NULL,
+   SIMCONNECT_RECV_ID_EXCEPTION,
+   SIMCONNECT_RECV_ID_OPEN,
+   SIMCONNECT_RECV_ID_QUIT,
+   SIMCONNECT_RECV_ID_EVENT,
+   SIMCONNECT_RECV_ID_EVENT_OBJECT_ADDREMOVE,
+   SIMCONNECT_RECV_ID_EVENT_FILENAME,
+   SIMCONNECT_RECV_ID_EVENT_FRAME,
+   SIMCONNECT_RECV_ID_SIMOBJECT_DATA,
+   SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE,
+   SIMCONNECT_RECV_ID_WEATHER_OBSERVATION,
+   SIMCONNECT_RECV_ID_CLOUD_STATE,
+   SIMCONNECT_RECV_ID_ASSIGNED_OBJECT_ID,
+   SIMCONNECT_RECV_ID_RESERVED_KEY,
+   SIMCONNECT_RECV_ID_CUSTOM_ACTION,
+   SIMCONNECT_RECV_ID_SYSTEM_STATE,
+   SIMCONNECT_RECV_ID_CLIENT_DATA,
+   SIMCONNECT_RECV_ID_EVENT_WEATHER_MODE,
+   SIMCONNECT_RECV_ID_AIRPORT_LIST,
+   SIMCONNECT_RECV_ID_VOR_LIST,
+   SIMCONNECT_RECV_ID_NDB_LIST,
+   SIMCONNECT_RECV_ID_WAYPOINT_LIST,
+   SIMCONNECT_RECV_ID_EVENT_MULTIPLAYER_SERVER_STARTED,
+   SIMCONNECT_RECV_ID_EVENT_MULTIPLAYER_CLIENT_STARTED,
+   SIMCONNECT_RECV_ID_EVENT_MULTIPLAYER_SESSION_ENDED,
+   SIMCONNECT_RECV_ID_EVENT_RACE_END,
+   SIMCONNECT_RECV_ID_EVENT_RACE_LAP,
+   SIMCONNECT_RECV_ID_EVENT_EX1,
+   SIMCONNECT_RECV_ID_FACILITY_DATA,
+   SIMCONNECT_RECV_ID_FACILITY_DATA_END,
+   SIMCONNECT_RECV_ID_FACILITY_MINIMAL_LIST,
+   SIMCONNECT_RECV_ID_JETWAY_DATA,
+   SIMCONNECT_RECV_ID_CONTROLLERS_LIST,
+   SIMCONNECT_RECV_ID_ACTION_CALLBACK,
+   SIMCONNECT_RECV_ID_ENUMERATE_INPUT_EVENTS,
+   SIMCONNECT_RECV_ID_GET_INPUT_EVENT,
+   SIMCONNECT_RECV_ID_SUBSCRIBE_INPUT_EVENT,
+   SIMCONNECT_RECV_ID_ENUMERATE_INPUT_EVENT_PARAMS,
+   SIMCONNECT_RECV_ID_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST,
+};
+
+enum SIMCONNECT_DATATYPE : DWORD {
+   SIMCONNECT_DATATYPE_INVALID,
+   SIMCONNECT_DATATYPE_INT32,
+   SIMCONNECT_DATATYPE_INT64,
+   SIMCONNECT_DATATYPE_FLOAT32,
+   SIMCONNECT_DATATYPE_FLOAT64,
+   SIMCONNECT_DATATYPE_STRING8,
+   SIMCONNECT_DATATYPE_STRING32,
+   SIMCONNECT_DATATYPE_STRING64,
+   SIMCONNECT_DATATYPE_STRING128,
+   SIMCONNECT_DATATYPE_STRING256,
+   SIMCONNECT_DATATYPE_STRING260,
+   SIMCONNECT_DATATYPE_STRINGV,
+   SIMCONNECT_DATATYPE_INITPOSITION,
+   SIMCONNECT_DATATYPE_MARKERSTATE,
+   SIMCONNECT_DATATYPE_WAYPOINT,
+   SIMCONNECT_DATATYPE_LATLONALT,
+   SIMCONNECT_DATATYPE_XYZ,
+   SIMCONNECT_DATATYPE_INT8,  // MSFS 2024
+   SIMCONNECT_DATATYPE_MAX,
+};
+
+enum SIMCONNECT_EXCEPTION : DWORD {
+   SIMCONNECT_EXCEPTION_NONE,
+   SIMCONNECT_EXCEPTION_ERROR,
+   SIMCONNECT_EXCEPTION_SIZE_MISMATCH,
+   SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID,
+   SIMCONNECT_EXCEPTION_UNOPENED,
+   SIMCONNECT_EXCEPTION_VERSION_MISMATCH,
+   SIMCONNECT_EXCEPTION_TOO_MANY_GROUPS,
+   SIMCONNECT_EXCEPTION_NAME_UNRECOGNIZED,
+   SIMCONNECT_EXCEPTION_TOO_MANY_EVENT_NAMES,
+   SIMCONNECT_EXCEPTION_EVENT_ID_DUPLICATE,
+   SIMCONNECT_EXCEPTION_TOO_MANY_MAPS,
+   SIMCONNECT_EXCEPTION_TOO_MANY_OBJECTS,
+   SIMCONNECT_EXCEPTION_TOO_MANY_REQUESTS,
+   SIMCONNECT_EXCEPTION_WEATHER_INVALID_PORT,
+   SIMCONNECT_EXCEPTION_WEATHER_INVALID_METAR,
+   SIMCONNECT_EXCEPTION_WEATHER_UNABLE_TO_GET_OBSERVATION,
+   SIMCONNECT_EXCEPTION_WEATHER_UNABLE_TO_CREATE_STATION,
+   SIMCONNECT_EXCEPTION_WEATHER_UNABLE_TO_REMOVE_STATION,
+   SIMCONNECT_EXCEPTION_INVALID_DATA_TYPE,
+   SIMCONNECT_EXCEPTION_INVALID_DATA_SIZE,
+   SIMCONNECT_EXCEPTION_DATA_ERROR,
+   SIMCONNECT_EXCEPTION_INVALID_ARRAY,
+   SIMCONNECT_EXCEPTION_CREATE_OBJECT_FAILED,
+   SIMCONNECT_EXCEPTION_LOAD_FLIGHTPLAN_FAILED,
+   SIMCONNECT_EXCEPTION_OPERATION_INVALID_FOR_OBJECT_TYPE,
+   SIMCONNECT_EXCEPTION_ILLEGAL_OPERATION,
+   SIMCONNECT_EXCEPTION_ALREADY_SUBSCRIBED,
+   SIMCONNECT_EXCEPTION_INVALID_ENUM,
+   SIMCONNECT_EXCEPTION_DEFINITION_ERROR,
+   SIMCONNECT_EXCEPTION_DUPLICATE_ID,
+   SIMCONNECT_EXCEPTION_DATUM_ID,
+   SIMCONNECT_EXCEPTION_OUT_OF_BOUNDS,
+};
+
+enum SIMCONNECT_SIMOBJECT_TYPE : DWORD {
+   SIMCONNECT_SIMOBJECT_TYPE_USER,
+   SIMCONNECT_SIMOBJECT_TYPE_ALL,
+   SIMCONNECT_SIMOBJECT_TYPE_AIRCRAFT,
+   SIMCONNECT_SIMOBJECT_TYPE_HELICOPTER,
+   SIMCONNECT_SIMOBJECT_TYPE_BOAT,
+   SIMCONNECT_SIMOBJECT_TYPE_GROUND,
+};
+
+enum SIMCONNECT_PERIOD : DWORD {
+   SIMCONNECT_PERIOD_NEVER,
+   SIMCONNECT_PERIOD_ONCE,
+   SIMCONNECT_PERIOD_VISUAL_FRAME,
+   SIMCONNECT_PERIOD_SIM_FRAME,
+   SIMCONNECT_PERIOD_SECOND,
+};
+
+enum SIMCONNECT_FACILITY_LIST_TYPE : DWORD {
+   SIMCONNECT_FACILITY_LIST_TYPE_AIRPORT,
+   SIMCONNECT_FACILITY_LIST_TYPE_WAYPOINT,
+   SIMCONNECT_FACILITY_LIST_TYPE_NDB,
+   SIMCONNECT_FACILITY_LIST_TYPE_VOR,
+   SIMCONNECT_FACILITY_LIST_TYPE_COUNT,
+};
+
+enum SIMCONNECT_FACILITY_DATA_TYPE : DWORD {
+   SIMCONNECT_FACILITY_DATA_AIRPORT,
+   SIMCONNECT_FACILITY_DATA_RUNWAY,
+   SIMCONNECT_FACILITY_DATA_START,
+   SIMCONNECT_FACILITY_DATA_FREQUENCY,
+   SIMCONNECT_FACILITY_DATA_HELIPAD,
+   SIMCONNECT_FACILITY_DATA_APPROACH,
+   SIMCONNECT_FACILITY_DATA_APPROACH_TRANSITION,
+   SIMCONNECT_FACILITY_DATA_APPROACH_LEG,
+   SIMCONNECT_FACILITY_DATA_FINAL_APPROACH_LEG,
+   SIMCONNECT_FACILITY_DATA_MISSED_APPROACH_LEG,
+   SIMCONNECT_FACILITY_DATA_DEPARTURE,
+   SIMCONNECT_FACILITY_DATA_ARRIVAL,
+   SIMCONNECT_FACILITY_DATA_RUNWAY_TRANSITION,
+   SIMCONNECT_FACILITY_DATA_ENROUTE_TRANSITION,
+   SIMCONNECT_FACILITY_DATA_TAXI_POINT,
+   SIMCONNECT_FACILITY_DATA_TAXI_PARKING,
+   SIMCONNECT_FACILITY_DATA_TAXI_PATH,
+   SIMCONNECT_FACILITY_DATA_TAXI_NAME,
+   SIMCONNECT_FACILITY_DATA_JETWAY,
+   SIMCONNECT_FACILITY_DATA_VOR,
+   SIMCONNECT_FACILITY_DATA_NDB,
+   SIMCONNECT_FACILITY_DATA_WAYPOINT,
+   SIMCONNECT_FACILITY_DATA_ROUTE,
+   SIMCONNECT_FACILITY_DATA_PAVEMENT,
+   SIMCONNECT_FACILITY_DATA_APPROACH_LIGHTS,
+   SIMCONNECT_FACILITY_DATA_VASI,
+};
+
+#pragma pack(push, 1)
+
+struct SIMCONNECT_RECV {
+   DWORD dwSize;
+   DWORD dwVersion;
+   DWORD dwID;
+};
+
+struct SIMCONNECT_RECV_EXCEPTION : SIMCONNECT_RECV {
+   static constexpr DWORD UNKNOWN_SENDID = 0;
+   static constexpr DWORD UNKNOWN_INDEX  = 0xFFFFFFFF;
+
+   DWORD dwException;
+   DWORD dwSendID;
+   DWORD dwIndex;
+};
+
+struct SIMCONNECT_RECV_OPEN : SIMCONNECT_RECV {
+   char  szApplicationName[256];
+   DWORD dwApplicationVersionMajor;
+   DWORD dwApplicationVersionMinor;
+   DWORD dwApplicationBuildMajor;
+   DWORD dwApplicationBuildMinor;
+   DWORD dwSimConnectVersionMajor;
+   DWORD dwSimConnectVersionMinor;
+   DWORD dwSimConnectBuildMajor;
+   DWORD dwSimConnectBuildMinor;
+   DWORD dwReserved1;
+   DWORD dwReserved2;
+};
+
+struct SIMCONNECT_RECV_QUIT : SIMCONNECT_RECV {};
+
+struct SIMCONNECT_RECV_ASSIGNED_OBJECT_ID : SIMCONNECT_RECV {
+   DWORD dwRequestID;
+   DWORD dwObjectID;
+};
+
+struct SIMCONNECT_RECV_SIMOBJECT_DATA : SIMCONNECT_RECV {
+   DWORD dwRequestID;
+   DWORD dwObjectID;
+   DWORD dwDefineID;
+   DWORD dwFlags;
+   DWORD dwentrynumber;
+   DWORD dwoutof;
+   DWORD dwDefineCount;
+   DWORD dwData;  // Start of the data, dwSize - sizeof(dwData) bytes
+};
+
+struct SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE : SIMCONNECT_RECV_SIMOBJECT_DATA {};
+
+struct SIMCONNECT_RECV_LIST_TEMPLATE : SIMCONNECT_RECV {
+   DWORD dwRequestID;
+   DWORD dwArraySize;
+   DWORD dwEntryNumber;
+   DWORD dwOutOf;
+};
+
+struct SIMCONNECT_RECV_FACILITIES_LIST : SIMCONNECT_RECV {
+   DWORD dwRequestID;
+   DWORD dwArraySize;
+   DWORD dwEntryNumber;
+   DWORD dwOutOf;
+};
+
+struct SIMCONNECT_DATA_FACILITY_AIRPORT {
+   char   Ident[6];
+   char   Region[3];
+   double Latitude;
+   double Longitude;
+   double Altitude;
+};
+
+struct SIMCONNECT_DATA_FACILITY_WAYPOINT : SIMCONNECT_DATA_FACILITY_AIRPORT {
+   float fMagVar;
+};
+
+struct SIMCONNECT_DATA_FACILITY_NDB : SIMCONNECT_DATA_FACILITY_WAYPOINT {
+   DWORD fFrequency;
+};
+
+struct SIMCONNECT_DATA_FACILITY_VOR : SIMCONNECT_DATA_FACILITY_NDB {
+   DWORD  Flags;
+   float  fLocalizer;
+   double GlideLat;
+   double GlideLon;
+   double GlideAlt;
+   float  fGlideSlopeAngle;
+};
+
+struct SIMCONNECT_RECV_AIRPORT_LIST : SIMCONNECT_RECV_FACILITIES_LIST {
+   SIMCONNECT_DATA_FACILITY_AIRPORT rgData[1];
+};
+
+struct SIMCONNECT_RECV_WAYPOINT_LIST : SIMCONNECT_RECV_FACILITIES_LIST {
+   SIMCONNECT_DATA_FACILITY_WAYPOINT rgData[1];
+};
+
+struct SIMCONNECT_RECV_NDB_LIST : SIMCONNECT_RECV_FACILITIES_LIST {
+   SIMCONNECT_DATA_FACILITY_NDB rgData[1];
+};
+
+struct SIMCONNECT_RECV_VOR_LIST : SIMCONNECT_RECV_FACILITIES_LIST {
+   SIMCONNECT_DATA_FACILITY_VOR rgData[1];
+};
+
+struct SIMCONNECT_RECV_FACILITY_DATA : SIMCONNECT_RECV {
+   DWORD UserRequestId;
+   DWORD UniqueRequestId;
+   DWORD ParentUniqueRequestId;
+   DWORD Type;
+   DWORD IsListItem;
+   DWORD ItemIndex;
+   DWORD ListSize;
+   DWORD Data;  // Start of the data, dwSize - sizeof(Data) bytes
+};
+
+struct SIMCONNECT_RECV_FACILITY_DATA_END : SIMCONNECT_RECV {
+   DWORD RequestId;
+};
+
+struct SIMCONNECT_ENUMERATE_SIMOBJECT_LIVERY {
+   char AircraftTitle[256];
+   char LiveryName[256];
+};
+
+struct SIMCONNECT_RECV_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST : SIMCONNECT_RECV_LIST_TEMPLATE {
+   SIMCONNECT_ENUMERATE_SIMOBJECT_LIVERY rgData[1];
+};
+
+struct SIMCONNECT_DATA_INITPOSITION {
+   double Latitude;
+   double Longitude;
+   double Altitude;  // Feet
+   double Pitch;
+   double Bank;
+   double Heading;
+   DWORD  OnGround;
+   DWORD  Airspeed;  // Knots
+};
+
+struct SIMCONNECT_DATA_WAYPOINT {
+   double Latitude;
+   double Longitude;
+   double Altitude;  // Feet
+   DWORD  Flags;
+   double ktsSpeed;
+   double percentThrottle;
+};
+
+struct SIMCONNECT_DATA_LATLONALT {
+   double Latitude;
+   double Longitude;
+   double Altitude;
+};
+
+struct SIMCONNECT_DATA_XYZ {
+   double x;
+   double y;
+   double z;
+};
+
+#pragma pack(pop)
+
+using DispatchProc = void(CALLBACK*)(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext);
+
+SIMCONNECTAPI SimConnect_Open(
+  HANDLE*     phSimConnect,
+  char const* szName,
+  HWND        hWnd,
+  DWORD       UserEventWin32,
+  HANDLE      hEventHandle,
+  DWORD       ConfigIndex
+);
+SIMCONNECTAPI SimConnect_Close(HANDLE hSimConnect);
+
+SIMCONNECTAPI
+SimConnect_CallDispatch(HANDLE hSimConnect, DispatchProc pfcnDispatch, void* pContext);
+SIMCONNECTAPI
+SimConnect_GetNextDispatch(HANDLE hSimConnect, SIMCONNECT_RECV** ppData, DWORD* pcbData);
+SIMCONNECTAPI SimConnect_GetLastSentPacketID(HANDLE hSimConnect, DWORD* pdwError);
+
+SIMCONNECTAPI SimConnect_AddToDataDefinition(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  char const*                   DatumName,
+  char const*                   UnitsName,
+  SIMCONNECT_DATATYPE           DatumType = SIMCONNECT_DATATYPE_FLOAT64,
+  float                         fEpsilon  = 0,
+  DWORD                         DatumID   = SIMCONNECT_UNUSED
+);
+SIMCONNECTAPI SimConnect_RequestDataOnSimObject(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_REQUEST_ID    RequestID,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  SIMCONNECT_OBJECT_ID          ObjectID,
+  SIMCONNECT_PERIOD             Period,
+  SIMCONNECT_DATA_REQUEST_FLAG  Flags    = 0,
+  DWORD                         origin   = 0,
+  DWORD                         interval = 0,
+  DWORD                         limit    = 0
+);
+SIMCONNECTAPI SimConnect_RequestDataOnSimObjectType(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_REQUEST_ID    RequestID,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  DWORD                         dwRadiusMeters,
+  SIMCONNECT_SIMOBJECT_TYPE     type
+);
+SIMCONNECTAPI SimConnect_SetDataOnSimObject(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  SIMCONNECT_OBJECT_ID          ObjectID,
+  SIMCONNECT_DATA_SET_FLAG      Flags,
+  DWORD                         ArrayCount,
+  DWORD                         cbUnitSize,
+  void*                         pDataSet
+);
+
+SIMCONNECTAPI SimConnect_AddToFacilityDefinition(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  char const*                   FieldName
+);
+SIMCONNECTAPI SimConnect_RequestFacilityData(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  SIMCONNECT_DATA_REQUEST_ID    RequestID,
+  char const*                   ICAO,
+  char const*                   Region = "",
+  char                          Type   = 0
+);
+SIMCONNECTAPI SimConnect_RequestFacilitiesList(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_FACILITY_LIST_TYPE type,
+  SIMCONNECT_DATA_REQUEST_ID    RequestID
+);
+
+SIMCONNECTAPI SimConnect_AICreateSimulatedObject(
+  HANDLE                       hSimConnect,
+  char const*                  szContainerTitle,
+  SIMCONNECT_DATA_INITPOSITION InitPos,
+  SIMCONNECT_DATA_REQUEST_ID   RequestID
+);
+SIMCONNECTAPI SimConnect_AICreateNonATCAircraft(
+  HANDLE                       hSimConnect,
+  char const*                  szContainerTitle,
+  char const*                  szTailNumber,
+  SIMCONNECT_DATA_INITPOSITION InitPos,
+  SIMCONNECT_DATA_REQUEST_ID   RequestID
+);
+SIMCONNECTAPI SimConnect_AICreateNonATCAircraft_EX1(
+  HANDLE                       hSimConnect,
+  char const*                  szContainerTitle,
+  char const*                  szLivery,
+  char const*                  szTailNumber,
+  SIMCONNECT_DATA_INITPOSITION InitPos,
+  SIMCONNECT_DATA_REQUEST_ID   RequestID
+);
+SIMCONNECTAPI SimConnect_AIRemoveObject(
+  HANDLE                     hSimConnect,
+  SIMCONNECT_OBJECT_ID       ObjectID,
+  SIMCONNECT_DATA_REQUEST_ID RequestID
+);
+SIMCONNECTAPI SimConnect_AIReleaseControl(
+  HANDLE                     hSimConnect,
+  SIMCONNECT_OBJECT_ID       ObjectID,
+  SIMCONNECT_DATA_REQUEST_ID RequestID
+);
+SIMCONNECTAPI SimConnect_EnumerateSimObjectsAndLiveries(
+  HANDLE                     hSimConnect,
+  SIMCONNECT_DATA_REQUEST_ID RequestID,
+  SIMCONNECT_SIMOBJECT_TYPE  Type
+);
+
+SIMCONNECTAPI SimConnect_MapClientEventToSimEvent(
+  HANDLE                     hSimConnect,
+  SIMCONNECT_CLIENT_EVENT_ID EventID,
+  char const*                EventName = ""
+);
+SIMCONNECTAPI SimConnect_TransmitClientEvent(
+  HANDLE                           hSimConnect,
+  SIMCONNECT_OBJECT_ID             ObjectID,
+  SIMCONNECT_CLIENT_EVENT_ID       EventID,
+  DWORD                            dwData,
+  SIMCONNECT_NOTIFICATION_GROUP_ID GroupID,
+  SIMCONNECT_EVENT_FLAG            Flags
+);
@@ -0,0 +1,52 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace smc::standin {
+
+// Simulated world served by the stand-in SimConnect library
+struct Config {
+   std::size_t ai_aircraft_{500};
+   std::size_t airports_{20'000};
+
+   // User aircraft spawn position, the AI traffic is spread around it
+   double origin_lat_{45.7};
+   double origin_lon_{5.1};
+   double traffic_radius_{1.};  // Degrees
+
+   std::chrono::milliseconds sim_frame_{33};
+
+   // Delay of every answer, the jitter is drawn uniformly in [0, jitter_]
+   std::chrono::microseconds latency_{0};
+   std::chrono::microseconds jitter_{0};
+
+   // Probability for a request to be answered by a SIMCONNECT_EXCEPTION_ERROR
+   double exception_rate_{0.};
+
+   uint32_t seed_{1};
+};
+
+// Defaults overridden by the SMC_STANDIN_* environment variables
+Config DefaultConfig();
+
+// Applies to the connections opened afterwards
+void SetConfig(Config const& config);
+
+}  // namespace smc::standin
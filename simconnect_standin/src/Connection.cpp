@@ -0,0 +1,943 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Connection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+namespace smc::standin {
+
+namespace {
+
+constexpr DWORD       VERSION             = 6;
+constexpr DWORD       MAX_RADIUS          = 200'000;  // Meters
+constexpr double      METERS_PER_DEG      = 111'120.;
+constexpr std::size_t AIRPORTS_PER_PACKET = 64;
+constexpr std::size_t LIVERIES_PER_PACKET = 16;
+
+// Packs a header and its payload, PLACEHOLDER is the trailing dwData/Data member of the header
+template <class HEADER, std::size_t PLACEHOLDER = 0>
+std::vector<std::byte>
+MakePacket(HEADER header, SIMCONNECT_RECV_ID id, std::span<std::byte const> payload = {}) {
+   auto const header_size = sizeof(HEADER) - PLACEHOLDER;
+
+   header.dwSize    = static_cast<DWORD>(header_size + payload.size());
+   header.dwVersion = VERSION;
+   header.dwID      = id;
+
+   std::vector<std::byte> packet(header.dwSize);
+   std::memcpy(packet.data(), &header, header_size);
+   if (payload.size()) {
+      std::memcpy(packet.data() + header_size, payload.data(), payload.size());
+   }
+   return packet;
+}
+
+template <class T>
+void
+Append(std::vector<std::byte>& out, T const& value) {
+   auto const bytes = reinterpret_cast<std::byte const*>(&value);
+   out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+void
+AppendString(std::vector<std::byte>& out, std::string_view value, std::size_t size) {
+   auto const offset = out.size();
+   out.resize(offset + size);
+   std::memcpy(out.data() + offset, value.data(), std::min(value.size(), size - 1));
+}
+
+// Distance in meters, flat earth approximation (radius of a few hundreds kilometers at most)
+double
+Distance(Object const& lhs, Object const& rhs) {
+   auto const d_lat = lhs.lat_ - rhs.lat_;
+   auto const d_lon = (lhs.lon_ - rhs.lon_) * std::cos(lhs.lat_ * std::numbers::pi / 180.);
+   return std::hypot(d_lat, d_lon) * METERS_PER_DEG;
+}
+
+bool
+Matches(Object const& object, SIMCONNECT_SIMOBJECT_TYPE type) {
+   switch (type) {
+      case SIMCONNECT_SIMOBJECT_TYPE_USER:
+         return object.user_;
+      case SIMCONNECT_SIMOBJECT_TYPE_ALL:
+         return true;
+      default:
+         return object.type_ == type;
+   }
+}
+
+SIMCONNECT_FACILITY_DATA_TYPE
+FacilityType(std::string_view name) {
+   static constexpr std::pair<std::string_view, SIMCONNECT_FACILITY_DATA_TYPE> TYPES[]{
+     {"AIRPORT", SIMCONNECT_FACILITY_DATA_AIRPORT},
+     {"RUNWAY", SIMCONNECT_FACILITY_DATA_RUNWAY},
+     {"START", SIMCONNECT_FACILITY_DATA_START},
+     {"FREQUENCY", SIMCONNECT_FACILITY_DATA_FREQUENCY},
+     {"HELIPAD", SIMCONNECT_FACILITY_DATA_HELIPAD},
+     {"TAXI_POINT", SIMCONNECT_FACILITY_DATA_TAXI_POINT},
+     {"TAXI_PARKING", SIMCONNECT_FACILITY_DATA_TAXI_PARKING},
+     {"TAXI_PATH", SIMCONNECT_FACILITY_DATA_TAXI_PATH},
+     {"TAXI_NAME", SIMCONNECT_FACILITY_DATA_TAXI_NAME},
+     {"JETWAY", SIMCONNECT_FACILITY_DATA_JETWAY},
+   };
+
+   for (auto const& [type_name, type] : TYPES) {
+      if (type_name == name) {
+         return type;
+      }
+   }
+   return SIMCONNECT_FACILITY_DATA_PAVEMENT;
+}
+
+// Number of items of a list section, nullopt for single child sections (runway thresholds...)
+std::optional<std::size_t>
+ListSize(std::string_view name, AirportLayout const& layout) {
+   if (name == "RUNWAY") {
+      return layout.runways_.size();
+   }
+   if ((name == "TAXI_POINT") || (name == "TAXI_PATH")) {
+      return layout.taxi_points_;
+   }
+   if (name == "TAXI_PARKING") {
+      return layout.taxi_parkings_;
+   }
+   if (name == "TAXI_NAME") {
+      return layout.taxi_names_;
+   }
+   if (
+     name.ends_with("_THRESHOLD") || name.ends_with("_BLASTPAD") || name.ends_with("_OVERRUN")
+     || name.ends_with("_APPROACH_LIGHTS") || name.ends_with("_VASI")
+   ) {
+      return std::nullopt;
+   }
+
+   // Not simulated (frequencies, procedures, jetways...)
+   return 0;
+}
+
+// Field types follow the SDK facility documentation, unknown fields are sent as a 0 INT32
+void
+AppendFacilityField(
+  std::vector<std::byte>& out,
+  std::string_view        section,
+  std::string_view        field,
+  Airport const&          airport,
+  AirportLayout const&    layout,
+  std::size_t             index
+) {
+   auto const ring = [&](double radius, bool x) {
+      auto const count = std::max<std::size_t>(
+        (section == "TAXI_PARKING") ? layout.taxi_parkings_ : layout.taxi_points_, 1
+      );
+      auto const angle = 2. * std::numbers::pi * static_cast<double>(index) / count;
+      return static_cast<float>(radius * (x ? std::sin(angle) : std::cos(angle)));
+   };
+
+   if (section == "AIRPORT") {
+      if (field == "LATITUDE") {
+         return Append(out, airport.lat_);
+      }
+      if (field == "LONGITUDE") {
+         return Append(out, airport.lon_);
+      }
+      if (field == "ALTITUDE") {
+         return Append(out, airport.altitude_);
+      }
+      if ((field == "ICAO") || (field == "REGION")) {
+         return AppendString(out, (field == "ICAO") ? airport.ident_ : airport.region_, 8);
+      }
+      if (field == "NAME") {
+         return AppendString(out, "StandIn " + airport.ident_, 32);
+      }
+   } else if (section == "RUNWAY") {
+      auto const& runway = layout.runways_[index];
+
+      if (field == "LATITUDE") {
+         return Append(out, runway.lat_);
+      }
+      if (field == "LONGITUDE") {
+         return Append(out, runway.lon_);
+      }
+      if (field == "ALTITUDE") {
+         return Append(out, airport.altitude_);
+      }
+      if (field == "LENGTH") {
+         return Append(out, runway.length_);
+      }
+      if (field == "WIDTH") {
+         return Append(out, 30.f);
+      }
+      if (field == "HEADING") {
+         return Append(out, runway.heading_);
+      }
+      if (field == "PRIMARY_NUMBER") {
+         return Append(out, runway.number_);
+      }
+      if (field == "SECONDARY_NUMBER") {
+         return Append(out, runway.number_ + 18);
+      }
+   } else if (section.ends_with("_THRESHOLD")) {
+      if ((field == "LENGTH") || (field == "WIDTH")) {
+         return Append(out, 0.f);
+      }
+   } else if (section == "TAXI_POINT") {
+      if (field == "TYPE") {
+         return Append(out, int32_t{1});
+      }
+      if ((field == "BIAS_X") || (field == "BIAS_Z")) {
+         return Append(out, ring(300., field == "BIAS_X"));
+      }
+   } else if (section == "TAXI_PARKING") {
+      if ((field == "TYPE") || (field == "TAXI_POINT_TYPE")) {
+         return Append(out, int32_t{1});
+      }
+      if (field == "HEADING") {
+         return Append(out, static_cast<float>(index * 360 / layout.taxi_parkings_));
+      }
+      if ((field == "BIAS_X") || (field == "BIAS_Z")) {
+         return Append(out, ring(350., field == "BIAS_X"));
+      }
+      if ((field == "RADIUS") || (field == "NUMBER")) {
+         return (field == "RADIUS") ? Append(out, 10.f)
+                                    : Append(out, static_cast<uint32_t>(index + 1));
+      }
+   } else if (section == "TAXI_PATH") {
+      if (field == "TYPE") {
+         return Append(out, int32_t{1});
+      }
+      if (field == "WIDTH") {
+         return Append(out, 15.f);
+      }
+      if (field == "START") {
+         return Append(out, static_cast<int32_t>(index));
+      }
+      if (field == "END") {
+         return Append(out, static_cast<int32_t>((index + 1) % layout.taxi_points_));
+      }
+      if (field == "NAME_INDEX") {
+         return Append(out, static_cast<int32_t>(index % layout.taxi_names_));
+      }
+   } else if ((section == "TAXI_NAME") && (field == "NAME")) {
+      return AppendString(out, std::string{1, static_cast<char>('A' + index % 26)}, 32);
+   }
+
+   Append(out, int32_t{0});
+}
+
+}  // namespace
+
+Connection::Connection(Config const& config, HANDLE event)
+   : config_{config}
+   , world_{config}
+   , engine_{config.seed_}
+   , event_{event}
+   , worker_{[this](std::stop_token stop_token) { Run(stop_token); }} {
+   SIMCONNECT_RECV_OPEN open{};
+   std::strncpy(open.szApplicationName, "SimConnect StandIn", sizeof(open.szApplicationName) - 1);
+   open.dwApplicationVersionMajor = 12;
+   open.dwSimConnectVersionMajor  = 12;
+
+   std::lock_guard lock{mutex_};
+   Queue(MakePacket(open, SIMCONNECT_RECV_ID_OPEN));
+}
+
+Connection::~Connection() {
+   worker_.request_stop();
+   worker_.join();
+}
+
+HRESULT
+Connection::GetNextDispatch(SIMCONNECT_RECV** data, DWORD* size) {
+   std::lock_guard lock{mutex_};
+   if (ready_.empty()) {
+      return E_FAIL;
+   }
+
+   current_ = std::move(ready_.front());
+   ready_.pop_front();
+
+   *data = reinterpret_cast<SIMCONNECT_RECV*>(current_.data());
+   *size = static_cast<DWORD>(current_.size());
+   return S_OK;
+}
+
+HRESULT
+Connection::CallDispatch(DispatchProc dispatch, void* context) {
+   while (true) {
+      Packet packet{};
+      {
+         std::lock_guard lock{mutex_};
+         if (ready_.empty()) {
+            return S_OK;
+         }
+
+         packet = std::move(ready_.front());
+         ready_.pop_front();
+      }
+
+      // The dispatch procedure may call back into the connection
+      dispatch(
+        reinterpret_cast<SIMCONNECT_RECV*>(packet.data()),
+        static_cast<DWORD>(packet.size()),
+        context
+      );
+   }
+}
+
+DWORD
+Connection::LastSendId() {
+   std::lock_guard lock{mutex_};
+   return send_id_;
+}
+
+HRESULT
+Connection::AddToDataDefinition(SIMCONNECT_DATA_DEFINITION_ID define_id, Datum&& datum) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   if (!DatumSize(datum.type_)) {
+      Exception(SIMCONNECT_EXCEPTION_INVALID_DATA_TYPE, send_id, 5);
+      return S_OK;
+   }
+
+   definitions_[define_id].emplace_back(std::move(datum));
+   return S_OK;
+}
+
+HRESULT
+Connection::RequestDataOnSimObject(
+  SIMCONNECT_DATA_REQUEST_ID    request_id,
+  SIMCONNECT_DATA_DEFINITION_ID define_id,
+  SIMCONNECT_OBJECT_ID          object_id,
+  SIMCONNECT_PERIOD             period,
+  SIMCONNECT_DATA_REQUEST_FLAG  flags,
+  DWORD                         interval
+) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   if (period == SIMCONNECT_PERIOD_NEVER) {
+      periodic_.erase(request_id);
+      return S_OK;
+   }
+
+   if (!definitions_.contains(define_id)) {
+      Exception(SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID, send_id, 3);
+      return S_OK;
+   }
+
+   auto const object = world_.Find(object_id);
+   if (!object) {
+      Exception(SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID, send_id, 4);
+      return S_OK;
+   }
+
+   if (Inject(send_id)) {
+      return S_OK;
+   }
+
+   if (period == SIMCONNECT_PERIOD_ONCE) {
+      if (auto packet = Sample(request_id, define_id, *object, 0, nullptr)) {
+         Queue(std::move(*packet));
+      }
+      return S_OK;
+   }
+
+   // A request id is reused to change the period of an existing request
+   periodic_[request_id] = Periodic{
+     .define_id_  = define_id,
+     .object_id_  = object_id,
+     .period_     = period,
+     .flags_      = flags,
+     .interval_   = interval,
+     .next_frame_ = frame_ + 1,
+     .next_time_  = clock::now(),
+   };
+   return S_OK;
+}
+
+HRESULT
+Connection::RequestDataOnSimObjectType(
+  SIMCONNECT_DATA_REQUEST_ID    request_id,
+  SIMCONNECT_DATA_DEFINITION_ID define_id,
+  DWORD                         radius,
+  SIMCONNECT_SIMOBJECT_TYPE     type
+) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   if (!definitions_.contains(define_id)) {
+      Exception(SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID, send_id, 3);
+      return S_OK;
+   }
+
+   if (Inject(send_id)) {
+      return S_OK;
+   }
+
+   // A null radius only returns the user aircraft
+   auto const&                user = world_.User();
+   std::vector<Object const*> objects{};
+   world_.ForEach([&](Object const& object) {
+      if (
+        Matches(object, radius ? type : SIMCONNECT_SIMOBJECT_TYPE_USER)
+        && (Distance(user, object) <= std::min(radius, MAX_RADIUS))
+      ) {
+         objects.emplace_back(&object);
+      }
+   });
+
+   if (objects.empty()) {
+      SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE data{};
+      data.dwRequestID = request_id;
+      data.dwDefineID  = define_id;
+      Queue(MakePacket<SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE, sizeof(DWORD)>(
+        data, SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE
+      ));
+      return S_OK;
+   }
+
+   for (std::size_t i = 0; i < objects.size(); ++i) {
+      auto packet = *Sample(request_id, define_id, *objects[i], 0, nullptr);
+
+      auto& data         = *reinterpret_cast<SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE*>(packet.data());
+      data.dwID          = SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE;
+      data.dwentrynumber = static_cast<DWORD>(i + 1);
+      data.dwoutof       = static_cast<DWORD>(objects.size());
+      Queue(std::move(packet));
+   }
+   return S_OK;
+}
+
+HRESULT
+Connection::SetDataOnSimObject(
+  SIMCONNECT_DATA_DEFINITION_ID define_id,
+  SIMCONNECT_OBJECT_ID          object_id,
+  DWORD                         count,
+  DWORD                         unit_size,
+  std::byte const*              data
+) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   auto const definition = definitions_.find(define_id);
+   if (definition == definitions_.end()) {
+      Exception(SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID, send_id, 2);
+      return S_OK;
+   }
+
+   auto const object = world_.Find(object_id);
+   if (!object) {
+      Exception(SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID, send_id, 3);
+      return S_OK;
+   }
+
+   std::size_t size{};
+   for (auto const& datum : definition->second) {
+      size += DatumSize(datum.type_);
+   }
+
+   if (!count || (unit_size < size)) {
+      Exception(SIMCONNECT_EXCEPTION_SIZE_MISMATCH, send_id, 6);
+      return S_OK;
+   }
+
+   // Waypoint lists only steer toward their first waypoint
+   for (auto const& datum : definition->second) {
+      world_.Apply(*object, datum, data);
+      data += DatumSize(datum.type_);
+   }
+   return S_OK;
+}
+
+HRESULT
+Connection::AddToFacilityDefinition(
+  SIMCONNECT_DATA_DEFINITION_ID define_id,
+  std::string_view              field
+) {
+   std::lock_guard lock{mutex_};
+   Send();
+
+   facility_definitions_[define_id].emplace_back(field);
+   return S_OK;
+}
+
+HRESULT
+Connection::RequestFacilityData(
+  SIMCONNECT_DATA_DEFINITION_ID define_id,
+  SIMCONNECT_DATA_REQUEST_ID    request_id,
+  std::string_view              icao
+) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   auto const definition = facility_definitions_.find(define_id);
+   if (definition == facility_definitions_.end()) {
+      Exception(SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID, send_id, 1);
+      return S_OK;
+   }
+
+   auto const airport = world_.FindAirport(icao);
+   if (!airport) {
+      Exception(SIMCONNECT_EXCEPTION_ERROR, send_id, 3);
+      return S_OK;
+   }
+
+   if (Inject(send_id)) {
+      return S_OK;
+   }
+
+   // Rebuilds the OPEN/CLOSE tree of the definition
+   FacilityNode                root{};
+   std::vector<FacilityNode*> stack{&root};
+   for (auto const& field : definition->second) {
+      if (field.starts_with("OPEN ")) {
+         auto& child = stack.back()->children_.emplace_back(FacilityNode{.name_ = field.substr(5)});
+         stack.push_back(&child);
+      } else if (field.starts_with("CLOSE ")) {
+         if (stack.size() == 1) {
+            Exception(SIMCONNECT_EXCEPTION_DEFINITION_ERROR, send_id, 1);
+            return S_OK;
+         }
+         stack.pop_back();
+      } else {
+         stack.back()->fields_.emplace_back(field);
+      }
+   }
+
+   if ((root.children_.size() != 1) || (root.children_.front().name_ != "AIRPORT")) {
+      Exception(SIMCONNECT_EXCEPTION_DEFINITION_ERROR, send_id, 1);
+      return S_OK;
+   }
+
+   auto const layout    = world_.Layout(*airport);
+   DWORD      unique_id = 0;
+   EmitFacility(root.children_.front(), request_id, 0, *airport, layout, 0, 0, false, unique_id);
+
+   SIMCONNECT_RECV_FACILITY_DATA_END end{};
+   end.RequestId = request_id;
+   Queue(MakePacket(end, SIMCONNECT_RECV_ID_FACILITY_DATA_END));
+   return S_OK;
+}
+
+HRESULT
+Connection::RequestFacilitiesList(
+  SIMCONNECT_FACILITY_LIST_TYPE type,
+  SIMCONNECT_DATA_REQUEST_ID    request_id
+) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   if (type >= SIMCONNECT_FACILITY_LIST_TYPE_COUNT) {
+      Exception(SIMCONNECT_EXCEPTION_INVALID_ENUM, send_id, 1);
+      return S_OK;
+   }
+
+   if (Inject(send_id)) {
+      return S_OK;
+   }
+
+   SIMCONNECT_RECV_FACILITIES_LIST list{};
+   list.dwRequestID = request_id;
+
+   if (type != SIMCONNECT_FACILITY_LIST_TYPE_AIRPORT) {
+      // Only airports are simulated, other lists are sent empty
+      list.dwOutOf = 1;
+      Queue(MakePacket(
+        list,
+        (type == SIMCONNECT_FACILITY_LIST_TYPE_WAYPOINT) ? SIMCONNECT_RECV_ID_WAYPOINT_LIST
+        : (type == SIMCONNECT_FACILITY_LIST_TYPE_NDB)    ? SIMCONNECT_RECV_ID_NDB_LIST
+                                                         : SIMCONNECT_RECV_ID_VOR_LIST
+      ));
+      return S_OK;
+   }
+
+   auto const& airports = world_.Airports();
+   list.dwOutOf         = static_cast<DWORD>(
+     std::max<std::size_t>((airports.size() + AIRPORTS_PER_PACKET - 1) / AIRPORTS_PER_PACKET, 1)
+   );
+
+   for (std::size_t first = 0; list.dwEntryNumber < list.dwOutOf; first += AIRPORTS_PER_PACKET) {
+      auto const last = std::min(first + AIRPORTS_PER_PACKET, airports.size());
+
+      std::vector<std::byte> payload{};
+      for (auto i = first; i < last; ++i) {
+         SIMCONNECT_DATA_FACILITY_AIRPORT entry{};
+         std::strncpy(entry.Ident, airports[i].ident_.c_str(), sizeof(entry.Ident) - 1);
+         std::strncpy(entry.Region, airports[i].region_.c_str(), sizeof(entry.Region) - 1);
+         entry.Latitude  = airports[i].lat_;
+         entry.Longitude = airports[i].lon_;
+         entry.Altitude  = airports[i].altitude_;
+         Append(payload, entry);
+      }
+
+      list.dwArraySize = static_cast<DWORD>(last - first);
+      Queue(MakePacket(list, SIMCONNECT_RECV_ID_AIRPORT_LIST, payload));
+      ++list.dwEntryNumber;
+   }
+   return S_OK;
+}
+
+HRESULT
+Connection::AICreate(
+  std::string_view                    title,
+  std::string_view                    livery,
+  std::string_view                    tail_number,
+  SIMCONNECT_DATA_INITPOSITION const& position,
+  SIMCONNECT_DATA_REQUEST_ID          request_id
+) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   if (title.empty()) {
+      Exception(SIMCONNECT_EXCEPTION_CREATE_OBJECT_FAILED, send_id, 1);
+      return S_OK;
+   }
+
+   if (Inject(send_id)) {
+      return S_OK;
+   }
+
+   SIMCONNECT_RECV_ASSIGNED_OBJECT_ID assigned{};
+   assigned.dwRequestID = request_id;
+   assigned.dwObjectID  = world_.Spawn(title, livery, tail_number, position).id_;
+   Queue(MakePacket(assigned, SIMCONNECT_RECV_ID_ASSIGNED_OBJECT_ID));
+   return S_OK;
+}
+
+HRESULT
+Connection::AIRemoveObject(SIMCONNECT_OBJECT_ID object_id) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   if (!world_.Remove(object_id)) {
+      Exception(SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID, send_id, 1);
+   }
+   return S_OK;
+}
+
+HRESULT
+Connection::AIReleaseControl(SIMCONNECT_OBJECT_ID object_id) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   if (auto const object = world_.Find(object_id); object && !object->user_) {
+      object->ai_controlled_ = false;
+      object->target_.reset();
+   } else {
+      Exception(SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID, send_id, 1);
+   }
+   return S_OK;
+}
+
+HRESULT
+Connection::EnumerateSimObjectsAndLiveries(SIMCONNECT_DATA_REQUEST_ID request_id) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   if (Inject(send_id)) {
+      return S_OK;
+   }
+
+   auto const& liveries = world_.Liveries();
+
+   SIMCONNECT_RECV_LIST_TEMPLATE list{};
+   list.dwRequestID = request_id;
+   list.dwOutOf =
+     static_cast<DWORD>((liveries.size() + LIVERIES_PER_PACKET - 1) / LIVERIES_PER_PACKET);
+
+   for (std::size_t first = 0; first < liveries.size(); first += LIVERIES_PER_PACKET) {
+      auto const last = std::min(first + LIVERIES_PER_PACKET, liveries.size());
+
+      std::vector<std::byte> payload{};
+      for (auto i = first; i < last; ++i) {
+         AppendString(payload, liveries[i].first, 256);
+         AppendString(payload, liveries[i].second, 256);
+      }
+
+      list.dwArraySize = static_cast<DWORD>(last - first);
+      Queue(MakePacket(list, SIMCONNECT_RECV_ID_ENUMERATE_SIMOBJECT_AND_LIVERY_LIST, payload));
+      ++list.dwEntryNumber;
+   }
+   return S_OK;
+}
+
+HRESULT
+Connection::MapClientEventToSimEvent(SIMCONNECT_CLIENT_EVENT_ID event_id, std::string_view name) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   if (!events_.emplace(event_id, name).second) {
+      Exception(SIMCONNECT_EXCEPTION_EVENT_ID_DUPLICATE, send_id, 1);
+   }
+   return S_OK;
+}
+
+HRESULT
+Connection::TransmitClientEvent(
+  SIMCONNECT_OBJECT_ID       object_id,
+  SIMCONNECT_CLIENT_EVENT_ID event_id
+) {
+   std::lock_guard lock{mutex_};
+   auto const      send_id = Send();
+
+   // Events are accepted but have no effect on the world
+   if (!events_.contains(event_id)) {
+      Exception(SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID, send_id, 2);
+   } else if (!world_.Find(object_id)) {
+      Exception(SIMCONNECT_EXCEPTION_UNRECOGNIZED_ID, send_id, 1);
+   }
+   return S_OK;
+}
+
+DWORD
+Connection::Send() {
+   return ++send_id_;
+}
+
+bool
+Connection::Inject(DWORD send_id) {
+   if (
+     (config_.exception_rate_ <= 0.)
+     || !std::bernoulli_distribution{std::min(config_.exception_rate_, 1.)}(engine_)
+   ) {
+      return false;
+   }
+
+   Exception(SIMCONNECT_EXCEPTION_ERROR, send_id, SIMCONNECT_RECV_EXCEPTION::UNKNOWN_INDEX);
+   return true;
+}
+
+void
+Connection::Exception(SIMCONNECT_EXCEPTION exception, DWORD send_id, DWORD index) {
+   SIMCONNECT_RECV_EXCEPTION data{};
+   data.dwException = exception;
+   data.dwSendID    = send_id;
+   data.dwIndex     = index;
+   Queue(MakePacket(data, SIMCONNECT_RECV_ID_EXCEPTION));
+}
+
+void
+Connection::Queue(Packet&& packet) {
+   if ((config_.latency_.count() <= 0) && (config_.jitter_.count() <= 0) && in_flight_.empty()) {
+      ready_.emplace_back(std::move(packet));
+      Signal();
+      return;
+   }
+
+   auto delay = config_.latency_;
+   if (config_.jitter_.count() > 0) {
+      delay += std::chrono::microseconds{
+        std::uniform_int_distribution<int64_t>{0, config_.jitter_.count()}(engine_)
+      };
+   }
+
+   // Answers never overtake each other
+   last_due_ = std::max(last_due_, clock::now() + delay);
+   in_flight_.emplace_back(last_due_, std::move(packet));
+   cv_.notify_one();
+}
+
+void
+Connection::Signal() {
+#ifdef _WIN32
+   if (event_) {
+      SetEvent(event_);
+   }
+#endif
+}
+
+void
+Connection::Run(std::stop_token const& stop_token) {
+   auto next_frame = clock::now() + config_.sim_frame_;
+
+   std::unique_lock lock{mutex_};
+   while (!stop_token.stop_requested()) {
+      auto const wake_up =
+        in_flight_.empty() ? next_frame : std::min(next_frame, in_flight_.front().first);
+      cv_.wait_until(lock, stop_token, wake_up, [] { return false; });
+
+      auto const now = clock::now();
+      if (now >= next_frame) {
+         Tick(now);
+         next_frame += config_.sim_frame_;
+
+         // Frames aren't caught up after a stall
+         next_frame = std::max(next_frame, now);
+      }
+
+      bool delivered = false;
+      while (!in_flight_.empty() && (in_flight_.front().first <= now)) {
+         ready_.emplace_back(std::move(in_flight_.front().second));
+         in_flight_.pop_front();
+         delivered = true;
+      }
+
+      if (delivered) {
+         Signal();
+      }
+   }
+}
+
+void
+Connection::Tick(time_point now) {
+   ++frame_;
+   world_.Step(config_.sim_frame_);
+
+   for (auto it = periodic_.begin(); it != periodic_.end();) {
+      auto& [request_id, request] = *it;
+
+      auto const object = world_.Find(request.object_id_);
+      if (!object) {
+         // Removed objects stop their requests
+         it = periodic_.erase(it);
+         continue;
+      }
+
+      bool due{};
+      if (request.period_ == SIMCONNECT_PERIOD_SECOND) {
+         due = now >= request.next_time_;
+         if (due) {
+            request.next_time_ = now + std::chrono::seconds{request.interval_ + 1};
+         }
+      } else {
+         due = frame_ >= request.next_frame_;
+         if (due) {
+            request.next_frame_ = frame_ + request.interval_ + 1;
+         }
+      }
+
+      if (due) {
+         if (
+           auto packet =
+             Sample(request_id, request.define_id_, *object, request.flags_, &request.last_)
+         ) {
+            Queue(std::move(*packet));
+         }
+      }
+      ++it;
+   }
+}
+
+std::optional<Connection::Packet>
+Connection::Sample(
+  SIMCONNECT_DATA_REQUEST_ID    request_id,
+  SIMCONNECT_DATA_DEFINITION_ID define_id,
+  Object const&                 object,
+  SIMCONNECT_DATA_REQUEST_FLAG  flags,
+  Packet*                       last
+) {
+   auto const& definition = definitions_.at(define_id);
+
+   Packet values{};
+   for (auto const& datum : definition) {
+      auto const offset = values.size();
+      values.resize(offset + DatumSize(datum.type_));
+      world_.Sample(object, datum, values.data() + offset);
+   }
+
+   auto const changed = !last || (*last != values);
+   if ((flags & SIMCONNECT_DATA_REQUEST_FLAG_CHANGED) && !changed) {
+      return std::nullopt;
+   }
+
+   SIMCONNECT_RECV_SIMOBJECT_DATA data{};
+   data.dwRequestID   = request_id;
+   data.dwObjectID    = object.id_;
+   data.dwDefineID    = define_id;
+   data.dwFlags       = flags;
+   data.dwentrynumber = 1;
+   data.dwoutof       = 1;
+
+   Packet payload{};
+   if (flags & SIMCONNECT_DATA_REQUEST_FLAG_TAGGED) {
+      // Datum id followed by its value, only the changed ones with FLAG_CHANGED
+      std::size_t offset = 0;
+      for (std::size_t i = 0; i < definition.size(); ++i) {
+         auto const size = DatumSize(definition[i].type_);
+         if (
+           !(flags & SIMCONNECT_DATA_REQUEST_FLAG_CHANGED) || !last || last->empty()
+           || std::memcmp(last->data() + offset, values.data() + offset, size)
+         ) {
+            auto const id = (definition[i].id_ == SIMCONNECT_UNUSED) ? static_cast<DWORD>(i)
+                                                                     : definition[i].id_;
+            Append(payload, id);
+            payload.insert(payload.end(), values.begin() + offset, values.begin() + offset + size);
+            ++data.dwDefineCount;
+         }
+         offset += size;
+      }
+   } else {
+      payload             = values;
+      data.dwDefineCount = static_cast<DWORD>(definition.size());
+   }
+
+   if (last) {
+      *last = std::move(values);
+   }
+
+   return MakePacket<SIMCONNECT_RECV_SIMOBJECT_DATA, sizeof(DWORD)>(
+     data, SIMCONNECT_RECV_ID_SIMOBJECT_DATA, payload
+   );
+}
+
+void
+Connection::EmitFacility(
+  FacilityNode const&  node,
+  DWORD                request_id,
+  DWORD                parent_id,
+  Airport const&       airport,
+  AirportLayout const& layout,
+  std::size_t          index,
+  std::size_t          count,
+  bool                 list_item,
+  DWORD&               unique_id
+) {
+   SIMCONNECT_RECV_FACILITY_DATA data{};
+   data.UserRequestId         = request_id;
+   data.UniqueRequestId       = ++unique_id;
+   data.ParentUniqueRequestId = parent_id;
+   data.Type                  = FacilityType(node.name_);
+   data.IsListItem            = list_item;
+   data.ItemIndex             = static_cast<DWORD>(index);
+   data.ListSize              = static_cast<DWORD>(count);
+
+   Packet payload{};
+   for (auto const& field : node.fields_) {
+      AppendFacilityField(payload, node.name_, field, airport, layout, index);
+   }
+   Queue(MakePacket<SIMCONNECT_RECV_FACILITY_DATA, sizeof(DWORD)>(
+     data, SIMCONNECT_RECV_ID_FACILITY_DATA, payload
+   ));
+
+   // Children are sent depth first, in the definition order
+   auto const self_id = data.UniqueRequestId;
+   for (auto const& child : node.children_) {
+      if (auto const size = ListSize(child.name_, layout)) {
+         for (std::size_t i = 0; i < *size; ++i) {
+            EmitFacility(child, request_id, self_id, airport, layout, i, *size, true, unique_id);
+         }
+      } else {
+         // Single child sections belong to the current list item (runway thresholds)
+         EmitFacility(child, request_id, self_id, airport, layout, 0, 0, false, unique_id);
+      }
+   }
+}
+
+}  // namespace smc::standin
@@ -0,0 +1,184 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "World.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace smc::standin {
+
+// One SimConnect client: answers are queued in order, delayed by the configured latency and
+// served by GetNextDispatch/CallDispatch. Periodic requests are sampled by a worker thread
+// stepping the world once per sim frame.
+class Connection {
+public:
+   Connection(Config const& config, HANDLE event);
+   ~Connection();
+
+   Connection(Connection const&)            = delete;
+   Connection& operator=(Connection const&) = delete;
+
+   HRESULT GetNextDispatch(SIMCONNECT_RECV** data, DWORD* size);
+   HRESULT CallDispatch(DispatchProc dispatch, void* context);
+   DWORD   LastSendId();
+
+   HRESULT AddToDataDefinition(SIMCONNECT_DATA_DEFINITION_ID define_id, Datum&& datum);
+   HRESULT RequestDataOnSimObject(
+     SIMCONNECT_DATA_REQUEST_ID    request_id,
+     SIMCONNECT_DATA_DEFINITION_ID define_id,
+     SIMCONNECT_OBJECT_ID          object_id,
+     SIMCONNECT_PERIOD             period,
+     SIMCONNECT_DATA_REQUEST_FLAG  flags,
+     DWORD                         interval
+   );
+   HRESULT RequestDataOnSimObjectType(
+     SIMCONNECT_DATA_REQUEST_ID    request_id,
+     SIMCONNECT_DATA_DEFINITION_ID define_id,
+     DWORD                         radius,
+     SIMCONNECT_SIMOBJECT_TYPE     type
+   );
+   HRESULT SetDataOnSimObject(
+     SIMCONNECT_DATA_DEFINITION_ID define_id,
+     SIMCONNECT_OBJECT_ID          object_id,
+     DWORD                         count,
+     DWORD                         unit_size,
+     std::byte const*              data
+   );
+
+   HRESULT
+   AddToFacilityDefinition(SIMCONNECT_DATA_DEFINITION_ID define_id, std::string_view field);
+   HRESULT RequestFacilityData(
+     SIMCONNECT_DATA_DEFINITION_ID define_id,
+     SIMCONNECT_DATA_REQUEST_ID    request_id,
+     std::string_view              icao
+   );
+   HRESULT RequestFacilitiesList(
+     SIMCONNECT_FACILITY_LIST_TYPE type,
+     SIMCONNECT_DATA_REQUEST_ID    request_id
+   );
+
+   HRESULT AICreate(
+     std::string_view                    title,
+     std::string_view                    livery,
+     std::string_view                    tail_number,
+     SIMCONNECT_DATA_INITPOSITION const& position,
+     SIMCONNECT_DATA_REQUEST_ID          request_id
+   );
+   HRESULT AIRemoveObject(SIMCONNECT_OBJECT_ID object_id);
+   HRESULT AIReleaseControl(SIMCONNECT_OBJECT_ID object_id);
+   HRESULT EnumerateSimObjectsAndLiveries(SIMCONNECT_DATA_REQUEST_ID request_id);
+
+   HRESULT MapClientEventToSimEvent(SIMCONNECT_CLIENT_EVENT_ID event_id, std::string_view name);
+   HRESULT
+   TransmitClientEvent(SIMCONNECT_OBJECT_ID object_id, SIMCONNECT_CLIENT_EVENT_ID event_id);
+
+private:
+   using clock      = std::chrono::steady_clock;
+   using time_point = clock::time_point;
+   using Packet     = std::vector<std::byte>;
+
+   struct Periodic {
+      SIMCONNECT_DATA_DEFINITION_ID define_id_{};
+      SIMCONNECT_OBJECT_ID          object_id_{};
+      SIMCONNECT_PERIOD             period_{};
+      SIMCONNECT_DATA_REQUEST_FLAG  flags_{};
+      DWORD                         interval_{};
+
+      uint64_t   next_frame_{};
+      time_point next_time_{};
+      Packet     last_{};  // Last sampled values, for SIMCONNECT_DATA_REQUEST_FLAG_CHANGED
+   };
+
+   struct FacilityNode {
+      std::string               name_{};
+      std::vector<std::string>  fields_{};
+      std::vector<FacilityNode> children_{};
+   };
+
+   // Every call sends one packet, exceptions refer to it by its send id
+   DWORD Send();
+   bool  Inject(DWORD send_id);
+   void  Exception(SIMCONNECT_EXCEPTION exception, DWORD send_id, DWORD index);
+
+   void Queue(Packet&& packet);
+   void Signal();
+   void Run(std::stop_token const& stop_token);
+   void Tick(time_point now);
+
+   std::optional<Packet> Sample(
+     SIMCONNECT_DATA_REQUEST_ID    request_id,
+     SIMCONNECT_DATA_DEFINITION_ID define_id,
+     Object const&                 object,
+     SIMCONNECT_DATA_REQUEST_FLAG  flags,
+     Packet*                       last
+   );
+
+   void EmitFacility(
+     FacilityNode const&  node,
+     DWORD                request_id,
+     DWORD                parent_id,
+     Airport const&       airport,
+     AirportLayout const& layout,
+     std::size_t          index,
+     std::size_t          count,
+     bool                 list_item,
+     DWORD&               unique_id
+   );
+
+   std::mutex                  mutex_{};
+   std::condition_variable_any cv_{};
+
+   Config       config_;
+   World        world_;
+   std::mt19937 engine_;
+   HANDLE       event_;
+
+   DWORD    send_id_{0};
+   uint64_t frame_{0};
+
+   std::unordered_map<DWORD, std::vector<Datum>>       definitions_{};
+   std::unordered_map<DWORD, std::vector<std::string>> facility_definitions_{};
+   std::unordered_map<DWORD, std::string>              events_{};
+   std::map<DWORD, Periodic>                           periodic_{};
+
+   // Answers not yet delivered, then answers waiting for GetNextDispatch (FIFO, like the pipe)
+   std::deque<std::pair<time_point, Packet>> in_flight_{};
+   std::deque<Packet>                        ready_{};
+   time_point                                last_due_{};
+
+   // Packet returned by the last GetNextDispatch, valid until the next call
+   Packet current_{};
+
+   std::jthread worker_;
+};
+
+}  // namespace smc::standin
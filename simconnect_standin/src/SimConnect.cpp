@@ -0,0 +1,324 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SimConnect.h"
+#include "SimConnectStandIn.h"
+
+#include "Connection.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+using smc::standin::Connection;
+
+namespace smc::standin {
+
+namespace {
+
+std::mutex            s__config_mutex{};
+std::optional<Config> s__config{};
+
+std::optional<std::string>
+Env(char const* name) {
+#ifdef _WIN32
+   char*       value = nullptr;
+   std::size_t size  = 0;
+   if (_dupenv_s(&value, &size, name) || !value) {
+      return std::nullopt;
+   }
+
+   std::string result{value};
+   std::free(value);
+   return result;
+#else
+   auto const value = std::getenv(name);
+   return value ? std::optional<std::string>{value} : std::nullopt;
+#endif
+}
+
+template <class T>
+void
+Override(char const* name, T& value) {
+   if (auto const env = Env(name)) {
+      try {
+         if constexpr (std::is_floating_point_v<T>) {
+            value = static_cast<T>(std::stod(*env));
+         } else if constexpr (std::is_integral_v<T>) {
+            value = static_cast<T>(std::stoull(*env));
+         } else {
+            value = T{std::stoll(*env)};
+         }
+      } catch (std::exception const&) {
+         // Malformed values keep the default
+      }
+   }
+}
+
+Connection*
+Get(HANDLE handle) {
+   return static_cast<Connection*>(handle);
+}
+
+}  // namespace
+
+Config
+DefaultConfig() {
+   Config config{};
+   Override("SMC_STANDIN_AI_AIRCRAFT", config.ai_aircraft_);
+   Override("SMC_STANDIN_AIRPORTS", config.airports_);
+   Override("SMC_STANDIN_ORIGIN_LAT", config.origin_lat_);
+   Override("SMC_STANDIN_ORIGIN_LON", config.origin_lon_);
+   Override("SMC_STANDIN_SIM_FRAME_MS", config.sim_frame_);
+   Override("SMC_STANDIN_LATENCY_US", config.latency_);
+   Override("SMC_STANDIN_JITTER_US", config.jitter_);
+   Override("SMC_STANDIN_EXCEPTION_RATE", config.exception_rate_);
+   Override("SMC_STANDIN_SEED", config.seed_);
+   return config;
+}
+
+void
+SetConfig(Config const& config) {
+   std::lock_guard lock{s__config_mutex};
+   s__config = config;
+}
+
+}  // namespace smc::standin
+
+SIMCONNECTAPI
+SimConnect_Open(
+  HANDLE* phSimConnect,
+  char const*,
+  HWND,
+  DWORD,
+  HANDLE hEventHandle,
+  DWORD
+) {
+   if (!phSimConnect) {
+      return E_INVALIDARG;
+   }
+
+   smc::standin::Config config{};
+   {
+      std::lock_guard lock{smc::standin::s__config_mutex};
+      config = smc::standin::s__config.value_or(smc::standin::DefaultConfig());
+   }
+
+   *phSimConnect = new Connection(config, hEventHandle);
+   return S_OK;
+}
+
+SIMCONNECTAPI
+SimConnect_Close(HANDLE hSimConnect) {
+   delete smc::standin::Get(hSimConnect);
+   return S_OK;
+}
+
+SIMCONNECTAPI
+SimConnect_CallDispatch(HANDLE hSimConnect, DispatchProc pfcnDispatch, void* pContext) {
+   return smc::standin::Get(hSimConnect)->CallDispatch(pfcnDispatch, pContext);
+}
+
+SIMCONNECTAPI
+SimConnect_GetNextDispatch(HANDLE hSimConnect, SIMCONNECT_RECV** ppData, DWORD* pcbData) {
+   return smc::standin::Get(hSimConnect)->GetNextDispatch(ppData, pcbData);
+}
+
+SIMCONNECTAPI
+SimConnect_GetLastSentPacketID(HANDLE hSimConnect, DWORD* pdwError) {
+   *pdwError = smc::standin::Get(hSimConnect)->LastSendId();
+   return S_OK;
+}
+
+SIMCONNECTAPI
+SimConnect_AddToDataDefinition(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  char const*                   DatumName,
+  char const*                   UnitsName,
+  SIMCONNECT_DATATYPE           DatumType,
+  float,
+  DWORD DatumID
+) {
+   return smc::standin::Get(hSimConnect)
+     ->AddToDataDefinition(
+       DefineID,
+       {.name_  = DatumName ? DatumName : "",
+        .units_ = UnitsName ? UnitsName : "",
+        .type_  = DatumType,
+        .id_    = DatumID}
+     );
+}
+
+SIMCONNECTAPI
+SimConnect_RequestDataOnSimObject(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_REQUEST_ID    RequestID,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  SIMCONNECT_OBJECT_ID          ObjectID,
+  SIMCONNECT_PERIOD             Period,
+  SIMCONNECT_DATA_REQUEST_FLAG  Flags,
+  DWORD,
+  DWORD interval,
+  DWORD
+) {
+   return smc::standin::Get(hSimConnect)
+     ->RequestDataOnSimObject(RequestID, DefineID, ObjectID, Period, Flags, interval);
+}
+
+SIMCONNECTAPI
+SimConnect_RequestDataOnSimObjectType(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_REQUEST_ID    RequestID,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  DWORD                         dwRadiusMeters,
+  SIMCONNECT_SIMOBJECT_TYPE     type
+) {
+   return smc::standin::Get(hSimConnect)
+     ->RequestDataOnSimObjectType(RequestID, DefineID, dwRadiusMeters, type);
+}
+
+SIMCONNECTAPI
+SimConnect_SetDataOnSimObject(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  SIMCONNECT_OBJECT_ID          ObjectID,
+  SIMCONNECT_DATA_SET_FLAG,
+  DWORD ArrayCount,
+  DWORD cbUnitSize,
+  void* pDataSet
+) {
+   return smc::standin::Get(hSimConnect)
+     ->SetDataOnSimObject(
+       DefineID, ObjectID, ArrayCount, cbUnitSize, static_cast<std::byte const*>(pDataSet)
+     );
+}
+
+SIMCONNECTAPI
+SimConnect_AddToFacilityDefinition(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  char const*                   FieldName
+) {
+   return smc::standin::Get(hSimConnect)->AddToFacilityDefinition(DefineID, FieldName);
+}
+
+SIMCONNECTAPI
+SimConnect_RequestFacilityData(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_DATA_DEFINITION_ID DefineID,
+  SIMCONNECT_DATA_REQUEST_ID    RequestID,
+  char const*                   ICAO,
+  char const*,
+  char
+) {
+   return smc::standin::Get(hSimConnect)->RequestFacilityData(DefineID, RequestID, ICAO);
+}
+
+SIMCONNECTAPI
+SimConnect_RequestFacilitiesList(
+  HANDLE                        hSimConnect,
+  SIMCONNECT_FACILITY_LIST_TYPE type,
+  SIMCONNECT_DATA_REQUEST_ID    RequestID
+) {
+   return smc::standin::Get(hSimConnect)->RequestFacilitiesList(type, RequestID);
+}
+
+SIMCONNECTAPI
+SimConnect_AICreateSimulatedObject(
+  HANDLE                       hSimConnect,
+  char const*                  szContainerTitle,
+  SIMCONNECT_DATA_INITPOSITION InitPos,
+  SIMCONNECT_DATA_REQUEST_ID   RequestID
+) {
+   return smc::standin::Get(hSimConnect)->AICreate(szContainerTitle, "", "", InitPos, RequestID);
+}
+
+SIMCONNECTAPI
+SimConnect_AICreateNonATCAircraft(
+  HANDLE                       hSimConnect,
+  char const*                  szContainerTitle,
+  char const*                  szTailNumber,
+  SIMCONNECT_DATA_INITPOSITION InitPos,
+  SIMCONNECT_DATA_REQUEST_ID   RequestID
+) {
+   return smc::standin::Get(hSimConnect)
+     ->AICreate(szContainerTitle, "", szTailNumber, InitPos, RequestID);
+}
+
+SIMCONNECTAPI
+SimConnect_AICreateNonATCAircraft_EX1(
+  HANDLE                       hSimConnect,
+  char const*                  szContainerTitle,
+  char const*                  szLivery,
+  char const*                  szTailNumber,
+  SIMCONNECT_DATA_INITPOSITION InitPos,
+  SIMCONNECT_DATA_REQUEST_ID   RequestID
+) {
+   return smc::standin::Get(hSimConnect)
+     ->AICreate(szContainerTitle, szLivery, szTailNumber, InitPos, RequestID);
+}
+
+SIMCONNECTAPI
+SimConnect_AIRemoveObject(
+  HANDLE               hSimConnect,
+  SIMCONNECT_OBJECT_ID ObjectID,
+  SIMCONNECT_DATA_REQUEST_ID
+) {
+   return smc::standin::Get(hSimConnect)->AIRemoveObject(ObjectID);
+}
+
+SIMCONNECTAPI
+SimConnect_AIReleaseControl(
+  HANDLE               hSimConnect,
+  SIMCONNECT_OBJECT_ID ObjectID,
+  SIMCONNECT_DATA_REQUEST_ID
+) {
+   return smc::standin::Get(hSimConnect)->AIReleaseControl(ObjectID);
+}
+
+SIMCONNECTAPI
+SimConnect_EnumerateSimObjectsAndLiveries(
+  HANDLE                     hSimConnect,
+  SIMCONNECT_DATA_REQUEST_ID RequestID,
+  SIMCONNECT_SIMOBJECT_TYPE
+) {
+   return smc::standin::Get(hSimConnect)->EnumerateSimObjectsAndLiveries(RequestID);
+}
+
+SIMCONNECTAPI
+SimConnect_MapClientEventToSimEvent(
+  HANDLE                     hSimConnect,
+  SIMCONNECT_CLIENT_EVENT_ID EventID,
+  char const*                EventName
+) {
+   return smc::standin::Get(hSimConnect)
+     ->MapClientEventToSimEvent(EventID, EventName ? EventName : "");
+}
+
+SIMCONNECTAPI
+SimConnect_TransmitClientEvent(
+  HANDLE                     hSimConnect,
+  SIMCONNECT_OBJECT_ID       ObjectID,
+  SIMCONNECT_CLIENT_EVENT_ID EventID,
+  DWORD,
+  SIMCONNECT_NOTIFICATION_GROUP_ID,
+  SIMCONNECT_EVENT_FLAG
+) {
+   return smc::standin::Get(hSimConnect)->TransmitClientEvent(ObjectID, EventID);
+}
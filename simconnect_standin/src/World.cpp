@@ -0,0 +1,533 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "World.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+namespace smc::standin {
+
+namespace {
+
+constexpr double FEET_PER_METER = 3.28084;
+constexpr double FPS_PER_KNOT   = 1.68781;
+constexpr double NM_PER_DEGREE  = 60.;
+
+constexpr double
+Radians(double degrees) {
+   return degrees * std::numbers::pi / 180.;
+}
+
+// Indexed simvars ("GEAR IS ON GROUND:0") share the value of their base name
+std::string_view
+BaseName(std::string_view name) {
+   return name.substr(0, name.find(':'));
+}
+
+double
+Angle(double radians, std::string_view units) {
+   return units.contains("radian") ? radians : radians * 180. / std::numbers::pi;
+}
+
+double
+Length(double feet, std::string_view units) {
+   return units.starts_with("meter") ? feet / FEET_PER_METER : feet;
+}
+
+std::optional<double>
+Numeric(Object const& object, std::string_view name, std::string_view units) {
+   auto const ground_speed = object.speed_ * FPS_PER_KNOT;
+
+   if (name == "PLANE LATITUDE") {
+      return units.contains("radian") ? Radians(object.lat_) : object.lat_;
+   }
+   if (name == "PLANE LONGITUDE") {
+      return units.contains("radian") ? Radians(object.lon_) : object.lon_;
+   }
+   if (name == "PLANE ALTITUDE") {
+      return Length(object.altitude_, units);
+   }
+   if (name == "PLANE ALT ABOVE GROUND") {
+      return Length(object.on_ground_ ? 0. : object.altitude_, units);
+   }
+   if ((name == "PLANE HEADING DEGREES TRUE") || (name == "AI DESIRED HEADING")) {
+      return Angle(object.heading_, units);
+   }
+   if (name == "PLANE PITCH DEGREES") {
+      return Angle(object.pitch_, units);
+   }
+   if (name == "PLANE BANK DEGREES") {
+      return Angle(object.bank_, units);
+   }
+   if (
+     (name == "GROUND VELOCITY") || (name == "AIRSPEED TRUE") || (name == "AI DESIRED SPEED")
+   ) {
+      return object.speed_;
+   }
+   if (name == "VERTICAL SPEED") {
+      return units.contains("minute") ? object.vspeed_ : object.vspeed_ / 60.;
+   }
+   if (name == "VELOCITY WORLD X") {
+      return ground_speed * std::sin(object.heading_);
+   }
+   if (name == "VELOCITY WORLD Y") {
+      return object.vspeed_ / 60.;
+   }
+   if ((name == "VELOCITY WORLD Z") || (name == "VELOCITY BODY Z")) {
+      return ground_speed * ((name == "VELOCITY WORLD Z") ? std::cos(object.heading_) : 1.);
+   }
+   if (name == "ROTATION VELOCITY BODY Y") {
+      return Angle(object.turn_rate_, units);
+   }
+   if ((name == "SIM ON GROUND") || (name == "GEAR IS ON GROUND")) {
+      return object.on_ground_ ? 1. : 0.;
+   }
+   if (name == "CONTACT POINT COMPRESSION") {
+      return object.on_ground_ ? 0.5 : 0.;
+   }
+   if (name == "IS USER SIM") {
+      return object.user_ ? 1. : 0.;
+   }
+   if (name == "TRANSPONDER CODE") {
+      return 1200.;
+   }
+
+   return std::nullopt;
+}
+
+std::optional<std::string>
+Text(Object const& object, std::string_view name) {
+   if ((name == "TITLE") || (name == "ATC MODEL")) {
+      return object.title_;
+   }
+   if (name == "ATC ID") {
+      return object.atc_id_;
+   }
+   if (name == "ATC TYPE") {
+      return "StandIn";
+   }
+   if (name == "CATEGORY") {
+      return (object.type_ == SIMCONNECT_SIMOBJECT_TYPE_HELICOPTER) ? "Helicopter" : "Airplane";
+   }
+
+   return std::nullopt;
+}
+
+template <class T>
+void
+Store(T value, std::byte* out) {
+   std::memcpy(out, &value, sizeof(value));
+}
+
+template <class T>
+T
+Load(std::byte const* in) {
+   T value{};
+   std::memcpy(&value, in, sizeof(value));
+   return value;
+}
+
+// 32 bits FNV-1a, stable across platforms unlike std::hash
+uint32_t
+Hash(std::string_view value) {
+   uint32_t hash = 2166136261u;
+   for (auto const c : value) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+   }
+   return hash;
+}
+
+}  // namespace
+
+std::size_t
+DatumSize(SIMCONNECT_DATATYPE type) {
+   switch (type) {
+      case SIMCONNECT_DATATYPE_INT8:
+         return 1;
+      case SIMCONNECT_DATATYPE_INT32:
+      case SIMCONNECT_DATATYPE_FLOAT32:
+         return 4;
+      case SIMCONNECT_DATATYPE_INT64:
+      case SIMCONNECT_DATATYPE_FLOAT64:
+      case SIMCONNECT_DATATYPE_STRING8:
+         return 8;
+      case SIMCONNECT_DATATYPE_STRING32:
+         return 32;
+      case SIMCONNECT_DATATYPE_STRING64:
+         return 64;
+      case SIMCONNECT_DATATYPE_STRING128:
+         return 128;
+      case SIMCONNECT_DATATYPE_STRING256:
+         return 256;
+      case SIMCONNECT_DATATYPE_STRING260:
+         return 260;
+      case SIMCONNECT_DATATYPE_INITPOSITION:
+         return sizeof(SIMCONNECT_DATA_INITPOSITION);
+      case SIMCONNECT_DATATYPE_WAYPOINT:
+         return sizeof(SIMCONNECT_DATA_WAYPOINT);
+      case SIMCONNECT_DATATYPE_LATLONALT:
+         return sizeof(SIMCONNECT_DATA_LATLONALT);
+      case SIMCONNECT_DATATYPE_XYZ:
+         return sizeof(SIMCONNECT_DATA_XYZ);
+      default:
+         // Variable length strings and marker states aren't simulated
+         return 0;
+   }
+}
+
+World::World(Config const& config)
+   : config_{config}
+   , engine_{config.seed_} {
+   std::uniform_real_distribution<double> unit{0., 1.};
+
+   // Airports idents are "S" followed by their index in base 36, the first one is at the origin
+   airports_.reserve(config.airports_);
+   for (std::size_t i = 0; i < config.airports_; ++i) {
+      static constexpr std::string_view DIGITS = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+      Airport airport{};
+      airport.ident_ = "S";
+      for (std::size_t index = i, n = 0; n < 3; ++n, index /= DIGITS.size()) {
+         airport.ident_.insert(1, 1, DIGITS[index % DIGITS.size()]);
+      }
+      airport.region_   = {static_cast<char>('A' + (i / 26) % 26), static_cast<char>('A' + i % 26)};
+      airport.lat_      = i ? unit(engine_) * 140. - 70. : config.origin_lat_;
+      airport.lon_      = i ? unit(engine_) * 360. - 180. : config.origin_lon_;
+      airport.altitude_ = unit(engine_) * 2000.;
+
+      airport_index_.emplace(airport.ident_, airports_.size());
+      airports_.emplace_back(std::move(airport));
+   }
+
+   for (std::size_t title = 0; title < 8; ++title) {
+      for (std::size_t livery = 0; livery < 4; ++livery) {
+         liveries_.emplace_back(
+           "StandIn Aircraft " + std::to_string(title), "Livery " + std::to_string(livery)
+         );
+      }
+   }
+
+   auto& user = Spawn(
+     liveries_.front().first,
+     liveries_.front().second,
+     "F-USER",
+     {.Latitude  = config.origin_lat_,
+      .Longitude = config.origin_lon_,
+      .Altitude  = 3000.,
+      .Pitch     = 0.,
+      .Bank      = 0.,
+      .Heading   = 0.,
+      .OnGround  = 0,
+      .Airspeed  = 110}
+   );
+   user.user_          = true;
+   user.ai_controlled_ = false;
+
+   for (std::size_t i = 0; i < config.ai_aircraft_; ++i) {
+      auto const& [title, livery] = liveries_[i % liveries_.size()];
+
+      auto const angle    = unit(engine_) * 2. * std::numbers::pi;
+      auto const distance = std::sqrt(unit(engine_)) * config.traffic_radius_;
+
+      auto& object = Spawn(
+        title,
+        livery,
+        "SI" + std::to_string(1000 + i),
+        {.Latitude  = config.origin_lat_ + distance * std::cos(angle),
+         .Longitude = config.origin_lon_ + distance * std::sin(angle),
+         .Altitude  = 1500. + unit(engine_) * 33500.,
+         .Pitch     = 0.,
+         .Bank      = 0.,
+         .Heading   = unit(engine_) * 360.,
+         .OnGround  = 0,
+         .Airspeed  = static_cast<DWORD>(90. + unit(engine_) * 360.)}
+      );
+
+      // Slow turns keep the traffic around the origin
+      object.turn_rate_ = Radians(unit(engine_) * 2. - 1.);
+   }
+}
+
+void
+World::Step(std::chrono::duration<double> dt) {
+   auto const seconds = dt.count();
+
+   for (auto& [id, object] : objects_) {
+      if (object.ai_controlled_ && object.target_) {
+         auto const& target = *object.target_;
+
+         auto const d_lat = target.Latitude - object.lat_;
+         auto const d_lon = (target.Longitude - object.lon_) * std::cos(Radians(object.lat_));
+         auto const delta =
+           std::remainder(std::atan2(d_lon, d_lat) - object.heading_, 2. * std::numbers::pi);
+
+         // Standard rate turn and 1000 ft/min toward the waypoint
+         auto const max_turn = Radians(3.) * seconds;
+         object.heading_ += std::clamp(delta, -max_turn, max_turn);
+
+         if (target.Flags & SIMCONNECT_WAYPOINT_SPEED_REQUESTED) {
+            object.speed_ = target.ktsSpeed;
+         }
+
+         if (!(target.Flags & SIMCONNECT_WAYPOINT_ON_GROUND)) {
+            object.vspeed_ = std::clamp((target.Altitude - object.altitude_) * 60., -1000., 1000.);
+         }
+
+         if (std::hypot(d_lat, d_lon) * NM_PER_DEGREE < object.speed_ * seconds / 3600.) {
+            object.target_.reset();
+            object.vspeed_ = 0.;
+         }
+      } else if (!object.on_ground_) {
+         object.heading_ += object.turn_rate_ * seconds;
+      }
+
+      object.heading_ = std::remainder(object.heading_, 2. * std::numbers::pi);
+      if (object.heading_ < 0.) {
+         object.heading_ += 2. * std::numbers::pi;
+      }
+
+      auto const distance = object.speed_ * seconds / 3600. / NM_PER_DEGREE;
+      object.lat_ += distance * std::cos(object.heading_);
+      object.lon_ += distance * std::sin(object.heading_) / std::cos(Radians(object.lat_));
+
+      if (!object.on_ground_) {
+         object.altitude_ = std::max(0., object.altitude_ + object.vspeed_ * seconds / 60.);
+      }
+   }
+}
+
+Object&
+World::Spawn(
+  std::string_view                    title,
+  std::string_view                    livery,
+  std::string_view                    tail_number,
+  SIMCONNECT_DATA_INITPOSITION const& position
+) {
+   auto const id = next_object_id_++;
+
+   auto& object      = objects_[id];
+   object.id_        = id;
+   object.title_     = title;
+   object.livery_    = livery;
+   object.atc_id_    = tail_number;
+   object.lat_       = position.Latitude;
+   object.lon_       = position.Longitude;
+   object.altitude_  = position.Altitude;
+   object.pitch_     = Radians(position.Pitch);
+   object.bank_      = Radians(position.Bank);
+   object.heading_   = Radians(position.Heading);
+   object.speed_     = position.Airspeed;
+   object.on_ground_ = position.OnGround;
+   return object;
+}
+
+bool
+World::Remove(SIMCONNECT_OBJECT_ID id) {
+   auto const it = objects_.find(id);
+   if ((it == objects_.end()) || it->second.user_) {
+      return false;
+   }
+
+   objects_.erase(it);
+   return true;
+}
+
+Object*
+World::Find(SIMCONNECT_OBJECT_ID id) {
+   if (id == SIMCONNECT_OBJECT_ID_USER) {
+      return &objects_.begin()->second;
+   }
+
+   auto const it = objects_.find(id);
+   return (it == objects_.end()) ? nullptr : &it->second;
+}
+
+Object const&
+World::User() const {
+   assert(objects_.begin()->second.user_);
+   return objects_.begin()->second;
+}
+
+Airport const*
+World::FindAirport(std::string_view ident) const {
+   auto const it = airport_index_.find(std::string{ident});
+   return (it == airport_index_.end()) ? nullptr : &airports_[it->second];
+}
+
+std::vector<Airport> const&
+World::Airports() const {
+   return airports_;
+}
+
+AirportLayout
+World::Layout(Airport const& airport) const {
+   std::mt19937                           engine{Hash(airport.ident_)};
+   std::uniform_real_distribution<double> unit{0., 1.};
+
+   AirportLayout layout{};
+   layout.runways_.resize(1 + engine() % 3);
+   for (auto& runway : layout.runways_) {
+      runway.lat_     = airport.lat_ + (unit(engine) - 0.5) * 0.01;
+      runway.lon_     = airport.lon_ + (unit(engine) - 0.5) * 0.01;
+      runway.length_  = static_cast<float>(800. + unit(engine) * 3000.);
+      runway.number_  = 1 + static_cast<int32_t>(engine() % 18);
+      runway.heading_ = static_cast<float>(runway.number_ * 10);
+   }
+
+   layout.taxi_points_   = 8 + engine() % 25;
+   layout.taxi_parkings_ = 4 + engine() % 13;
+   layout.taxi_names_    = 4;
+   return layout;
+}
+
+std::vector<std::pair<std::string, std::string>> const&
+World::Liveries() const {
+   return liveries_;
+}
+
+void
+World::Sample(Object const& object, Datum const& datum, std::byte* out) const {
+   auto const name = BaseName(datum.name_);
+   auto const size = DatumSize(datum.type_);
+
+   switch (datum.type_) {
+      case SIMCONNECT_DATATYPE_INT8:
+      case SIMCONNECT_DATATYPE_INT32:
+      case SIMCONNECT_DATATYPE_INT64:
+      case SIMCONNECT_DATATYPE_FLOAT32:
+      case SIMCONNECT_DATATYPE_FLOAT64: {
+         auto value = Numeric(object, name, datum.units_);
+         if (!value) {
+            auto const var = object.vars_.find(datum.name_);
+            value          = (var == object.vars_.end()) ? 0. : var->second;
+         }
+
+         if (datum.type_ == SIMCONNECT_DATATYPE_INT8) {
+            Store(static_cast<int8_t>(*value), out);
+         } else if (datum.type_ == SIMCONNECT_DATATYPE_INT32) {
+            Store(static_cast<int32_t>(*value), out);
+         } else if (datum.type_ == SIMCONNECT_DATATYPE_INT64) {
+            Store(static_cast<int64_t>(*value), out);
+         } else if (datum.type_ == SIMCONNECT_DATATYPE_FLOAT32) {
+            Store(static_cast<float>(*value), out);
+         } else {
+            Store(*value, out);
+         }
+      } break;
+
+      case SIMCONNECT_DATATYPE_INITPOSITION:
+         Store(
+           SIMCONNECT_DATA_INITPOSITION{
+             .Latitude  = object.lat_,
+             .Longitude = object.lon_,
+             .Altitude  = object.altitude_,
+             .Pitch     = Angle(object.pitch_, "degrees"),
+             .Bank      = Angle(object.bank_, "degrees"),
+             .Heading   = Angle(object.heading_, "degrees"),
+             .OnGround  = object.on_ground_,
+             .Airspeed  = static_cast<DWORD>(object.speed_)
+           },
+           out
+         );
+         break;
+
+      case SIMCONNECT_DATATYPE_WAYPOINT:
+         Store(object.target_.value_or(SIMCONNECT_DATA_WAYPOINT{}), out);
+         break;
+
+      case SIMCONNECT_DATATYPE_LATLONALT:
+         Store(
+           SIMCONNECT_DATA_LATLONALT{
+             .Latitude = object.lat_, .Longitude = object.lon_, .Altitude = object.altitude_
+           },
+           out
+         );
+         break;
+
+      default: {
+         // Strings are null terminated and truncated to the datum size
+         std::memset(out, 0, size);
+         if (auto const text = Text(object, name); text && size) {
+            std::memcpy(out, text->data(), std::min(text->size(), size - 1));
+         }
+      } break;
+   }
+}
+
+void
+World::Apply(Object& object, Datum const& datum, std::byte const* in) {
+   auto const name = BaseName(datum.name_);
+
+   switch (datum.type_) {
+      case SIMCONNECT_DATATYPE_INT8:
+      case SIMCONNECT_DATATYPE_INT32:
+      case SIMCONNECT_DATATYPE_INT64:
+      case SIMCONNECT_DATATYPE_FLOAT32:
+      case SIMCONNECT_DATATYPE_FLOAT64: {
+         double value{};
+         if (datum.type_ == SIMCONNECT_DATATYPE_INT8) {
+            value = Load<int8_t>(in);
+         } else if (datum.type_ == SIMCONNECT_DATATYPE_INT32) {
+            value = Load<int32_t>(in);
+         } else if (datum.type_ == SIMCONNECT_DATATYPE_INT64) {
+            value = static_cast<double>(Load<int64_t>(in));
+         } else if (datum.type_ == SIMCONNECT_DATATYPE_FLOAT32) {
+            value = Load<float>(in);
+         } else {
+            value = Load<double>(in);
+         }
+
+         auto const radians = datum.units_.contains("radian");
+         if (name == "PLANE LATITUDE") {
+            object.lat_ = radians ? value * 180. / std::numbers::pi : value;
+         } else if (name == "PLANE LONGITUDE") {
+            object.lon_ = radians ? value * 180. / std::numbers::pi : value;
+         } else if (name == "PLANE ALTITUDE") {
+            object.altitude_ = datum.units_.starts_with("meter") ? value * FEET_PER_METER : value;
+         } else if (name == "PLANE HEADING DEGREES TRUE") {
+            object.heading_ = radians ? value : Radians(value);
+         } else if ((name == "AIRSPEED TRUE") || (name == "GROUND VELOCITY")) {
+            object.speed_ = value;
+         } else if ((name == "SIM ON GROUND") || (name == "SIM SHOULD SET ON GROUND")) {
+            object.on_ground_ = value != 0.;
+         } else {
+            object.vars_[datum.name_] = value;
+         }
+      } break;
+
+      case SIMCONNECT_DATATYPE_INITPOSITION: {
+         auto const position = Load<SIMCONNECT_DATA_INITPOSITION>(in);
+         object.lat_         = position.Latitude;
+         object.lon_         = position.Longitude;
+         object.altitude_    = position.Altitude;
+         object.heading_     = Radians(position.Heading);
+         object.speed_       = position.Airspeed;
+         object.on_ground_   = position.OnGround;
+      } break;
+
+      case SIMCONNECT_DATATYPE_WAYPOINT:
+         object.target_ = Load<SIMCONNECT_DATA_WAYPOINT>(in);
+         break;
+
+      default:
+         break;
+   }
+}
+
+}  // namespace smc::standin
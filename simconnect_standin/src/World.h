@@ -0,0 +1,140 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "SimConnect.h"
+#include "SimConnectStandIn.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace smc::standin {
+
+struct Datum {
+   std::string         name_{};
+   std::string         units_{};
+   SIMCONNECT_DATATYPE type_{};
+   DWORD               id_{SIMCONNECT_UNUSED};
+};
+
+std::size_t DatumSize(SIMCONNECT_DATATYPE type);
+
+struct Object {
+   SIMCONNECT_OBJECT_ID      id_{};
+   SIMCONNECT_SIMOBJECT_TYPE type_{SIMCONNECT_SIMOBJECT_TYPE_AIRCRAFT};
+   bool                      user_{false};
+   bool                      ai_controlled_{true};
+
+   std::string title_{};
+   std::string livery_{};
+   std::string atc_id_{};
+
+   double lat_{};       // Degrees
+   double lon_{};       // Degrees
+   double altitude_{};  // Feet
+   double heading_{};   // Radians
+   double pitch_{};     // Radians
+   double bank_{};      // Radians
+   double speed_{};     // Knots
+   double vspeed_{};    // Feet per minute
+   double turn_rate_{};  // Radians per second
+   bool   on_ground_{false};
+
+   std::optional<SIMCONNECT_DATA_WAYPOINT> target_{};
+
+   // Values written with SetDataOnSimObject that aren't simulated
+   std::unordered_map<std::string, double> vars_{};
+};
+
+struct Airport {
+   std::string ident_{};
+   std::string region_{};
+   double      lat_{};
+   double      lon_{};
+   double      altitude_{};  // Meters
+};
+
+// Ground layout of an airport, derived from its ident
+struct AirportLayout {
+   struct Runway {
+      double  lat_{};
+      double  lon_{};
+      float   length_{};
+      float   heading_{};
+      int32_t number_{};
+   };
+
+   std::vector<Runway> runways_{};
+   std::size_t         taxi_points_{};
+   std::size_t         taxi_parkings_{};
+   std::size_t         taxi_names_{};
+};
+
+class World {
+public:
+   explicit World(Config const& config);
+
+   void Step(std::chrono::duration<double> dt);
+
+   Object& Spawn(
+     std::string_view                    title,
+     std::string_view                    livery,
+     std::string_view                    tail_number,
+     SIMCONNECT_DATA_INITPOSITION const& position
+   );
+   bool    Remove(SIMCONNECT_OBJECT_ID id);
+   Object* Find(SIMCONNECT_OBJECT_ID id);
+
+   template <class FUNC>
+   void
+   ForEach(FUNC&& func) {
+      for (auto& [id, object] : objects_) {
+         func(object);
+      }
+   }
+
+   Object const& User() const;
+
+   Airport const*              FindAirport(std::string_view ident) const;
+   std::vector<Airport> const& Airports() const;
+   AirportLayout               Layout(Airport const& airport) const;
+
+   std::vector<std::pair<std::string, std::string>> const& Liveries() const;
+
+   // Encodes/decodes a datum of an object, unknown datums read as 0
+   void Sample(Object const& object, Datum const& datum, std::byte* out) const;
+   void Apply(Object& object, Datum const& datum, std::byte const* in);
+
+private:
+   Config               config_;
+   std::mt19937         engine_;
+   std::vector<Airport> airports_{};
+
+   std::unordered_map<std::string, std::size_t>     airport_index_{};
+   std::map<SIMCONNECT_OBJECT_ID, Object>           objects_{};
+   SIMCONNECT_OBJECT_ID                             next_object_id_{1};
+   std::vector<std::pair<std::string, std::string>> liveries_{};
+};
+
+}  // namespace smc::standin
@@ -0,0 +1,100 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace bench {
+
+// Exit code telling ctest that the test could not run in this environment
+static constexpr int SKIPPED = 77;
+
+using Clock = std::chrono::steady_clock;
+
+class Samples {
+public:
+   void
+   Add(double value) {
+      values_.emplace_back(value);
+   }
+
+   std::size_t
+   Size() const {
+      return values_.size();
+   }
+
+   double
+   Percentile(double percent) {
+      if (values_.empty()) {
+         return 0.;
+      }
+
+      auto const rank = static_cast<std::size_t>(
+        percent / 100. * static_cast<double>(values_.size() - 1)
+      );
+      std::nth_element(values_.begin(), values_.begin() + rank, values_.end());
+      return values_[rank];
+   }
+
+   void
+   Report(std::string_view name, std::string_view unit) {
+      std::cout << name << ": n=" << values_.size() << " p50=" << Percentile(50.) << unit
+                << " p99=" << Percentile(99.) << unit << " max=" << Percentile(100.) << unit
+                << std::endl;
+   }
+
+private:
+   std::vector<double> values_{};
+};
+
+template <class FN>
+double
+Seconds(FN&& fn) {
+   auto const start = Clock::now();
+   fn();
+   return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+inline double
+Micros(Clock::duration duration) {
+   return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+// Keeps the computation of value from being optimized out
+template <class T>
+void
+Keep(T const& value) {
+   asm volatile("" : : "r"(&value) : "memory");
+}
+
+}  // namespace bench
+
+// Unlike assert, kept in release builds where the benchmarks run
+#define CHECK(CONDITION)                                                                 \
+   do {                                                                                  \
+      if (!(CONDITION)) {                                                                \
+         std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #CONDITION ") failed"    \
+                   << std::endl;                                                         \
+         std::exit(EXIT_FAILURE);                                                        \
+      }                                                                                  \
+   } while (false)
@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// RequestDataOnSimObjectType against the stand-in : the request completes with the entry
+// dwentrynumber == dwoutof, the empty answer (dwoutof 0) completes at once, and the progress
+// watchdog (SimConnect::WatchProgress rule on the timer wheel) never fires.
+
+#include "Bench.h"
+
+#include "SimConnect/TimerWheel.h"
+#include "SimConnect/Utils/ByTypeCount.h"
+
+#include <SimConnectStandIn.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace {
+
+// SimConnect::PROGRESS_TIMEOUT
+constexpr std::chrono::seconds PROGRESS_TIMEOUT{5};
+constexpr DWORD                DEFINITION = 1;
+
+struct Answer {
+   std::size_t objects_{};
+   std::size_t packets_{};
+   bool        stalled_{false};
+};
+
+Answer
+Request(HANDLE handle, DWORD request_id, SIMCONNECT_SIMOBJECT_TYPE type) {
+   CHECK(
+     SimConnect_RequestDataOnSimObjectType(handle, request_id, DEFINITION, 200'000, type) == S_OK
+   );
+
+   Answer              answer{};
+   auto const          count = std::make_shared<smc::ByTypeCount>();
+   smc::TimerWheel     wheel{};
+   smc::TimerWheel::Id watchdog{};
+
+   // Re-armed as long as entries keep coming
+   auto watch = [&](auto& self, std::size_t last) -> void {
+      watchdog = wheel.Schedule(
+        smc::TimerWheel::Clock::now() + PROGRESS_TIMEOUT,
+        [&, self, last] {
+           watchdog = {};
+           if (count->Remaining() != last) {
+              self(self, count->Remaining());
+           } else {
+              answer.stalled_ = true;
+           }
+        }
+      );
+   };
+   watch(watch, count->Remaining());
+
+   DWORD last_entry{};
+   while (!count->Done() && !answer.stalled_) {
+      SIMCONNECT_RECV* data{};
+      DWORD            size{};
+
+      if (SimConnect_GetNextDispatch(handle, &data, &size) != S_OK) {
+         wheel.Advance(smc::TimerWheel::Clock::now());
+         std::this_thread::sleep_for(std::chrono::milliseconds{1});
+         continue;
+      }
+
+      if (data->dwID != SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE) {
+         continue;
+      }
+
+      auto const& entry = *static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const*>(data);
+      CHECK(entry.dwRequestID == request_id);
+      ++answer.packets_;
+
+      if (count->Receive(entry)) {
+         ++answer.objects_;
+         CHECK(entry.dwentrynumber == ++last_entry);
+
+         // Done exactly with the last entry
+         CHECK(count->Done() == (entry.dwentrynumber == entry.dwoutof));
+      } else {
+         CHECK(entry.dwoutof == 0);
+         break;
+      }
+   }
+
+   // Settled : EraseRequest cancels the watchdog, nothing runs afterwards
+   if (watchdog) {
+      CHECK(wheel.Cancel(watchdog));
+   }
+   wheel.Advance(smc::TimerWheel::Clock::now() + 2 * PROGRESS_TIMEOUT);
+   CHECK(!answer.stalled_);
+   return answer;
+}
+
+}  // namespace
+
+int
+main() {
+   auto config         = smc::standin::DefaultConfig();
+   config.ai_aircraft_ = 300;
+   config.latency_     = std::chrono::milliseconds{2};
+   config.jitter_      = std::chrono::milliseconds{2};
+   smc::standin::SetConfig(config);
+
+   HANDLE handle{};
+   CHECK(SimConnect_Open(&handle, "by_type_completion", nullptr, 0, nullptr, 0) == S_OK);
+   CHECK(
+     SimConnect_AddToDataDefinition(handle, DEFINITION, "PLANE LATITUDE", "degrees") == S_OK
+   );
+
+   // AI traffic and the user aircraft in range
+   auto const aircraft = Request(handle, 1, SIMCONNECT_SIMOBJECT_TYPE_AIRCRAFT);
+   CHECK(aircraft.objects_ > 1);
+   CHECK(aircraft.packets_ == aircraft.objects_);
+
+   // No boat in the stand-in world, a single empty entry
+   auto const boats = Request(handle, 2, SIMCONNECT_SIMOBJECT_TYPE_BOAT);
+   CHECK(boats.objects_ == 0);
+   CHECK(boats.packets_ == 1);
+
+   CHECK(SimConnect_Close(handle) == S_OK);
+
+   std::cout << "by type completion: " << aircraft.objects_ << " aircraft, empty answer"
+             << std::endl;
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Closest point of approach of the traffic against the user aircraft (ConflictDetector, run by
+// TrafficTable::Advise every sample), next to a plain double precision pass over every aircraft.
+// The alert levels of both must agree, but for the float rounding at the thresholds.
+//
+// conflicts_bench [aircraft...] [--runs N]
+
+#include "Bench.h"
+
+#include "SimConnect/Conflicts.h"
+#include "SimConnect/Data/TrafficInfo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <numbers>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr double EARTH_RADIUS = 20'925'646.;  // feet
+constexpr double NM           = 6'076.12;     // feet
+constexpr double DEG          = std::numbers::pi / 180.;
+
+struct Targets {
+   std::vector<double>  lats_{};
+   std::vector<double>  lons_{};
+   std::vector<double>  altitudes_{};
+   std::vector<double>  north_velocities_{};
+   std::vector<double>  east_velocities_{};
+   std::vector<double>  vertical_velocities_{};
+   std::vector<uint8_t> on_ground_{};
+
+   smc::ConflictTargets
+   View() const {
+      return {
+        .lats_                = lats_,
+        .lons_                = lons_,
+        .altitudes_           = altitudes_,
+        .north_velocities_    = north_velocities_,
+        .east_velocities_     = east_velocities_,
+        .vertical_velocities_ = vertical_velocities_,
+        .on_ground_           = on_ground_,
+      };
+   }
+};
+
+// Aircraft within range NM and 3000 feet of the user, 5% of them on the ground
+Targets
+Generate(smc::TrafficInfo const& user, std::size_t size, double range, std::mt19937& rng) {
+   std::uniform_real_distribution<double> unit{0., 1.};
+   Targets                                targets{};
+
+   for (std::size_t i = 0; i < size; ++i) {
+      auto const distance = range * NM * std::sqrt(unit(rng));
+      auto const bearing  = unit(rng) * 2. * std::numbers::pi;
+      auto const heading  = unit(rng) * 2. * std::numbers::pi;
+      auto const speed    = (100. + unit(rng) * 350.) * 1.68781;  // feet/second
+
+      targets.lats_.emplace_back(user.lat_ + distance * std::cos(bearing) / EARTH_RADIUS / DEG);
+      targets.lons_.emplace_back(
+        user.lon_ + distance * std::sin(bearing) / (EARTH_RADIUS * std::cos(user.lat_ * DEG)) / DEG
+      );
+      targets.altitudes_.emplace_back(user.altitude_ + (unit(rng) - .5) * 6000.);
+      targets.north_velocities_.emplace_back(speed * std::cos(heading));
+      targets.east_velocities_.emplace_back(speed * std::sin(heading));
+      targets.vertical_velocities_.emplace_back((unit(rng) - .5) * 40.);
+      targets.on_ground_.emplace_back(unit(rng) < .05);
+   }
+
+   return targets;
+}
+
+// Every target, in double precision, same thresholds as the detector
+std::vector<smc::Alert>
+Reference(smc::TrafficInfo const& user, Targets const& targets) {
+   std::vector<smc::Alert> alerts(targets.lats_.size(), smc::Alert::NONE);
+   auto const              cos_lat = std::cos(user.lat_ * DEG);
+
+   for (std::size_t row = 0; row < alerts.size(); ++row) {
+      if (targets.on_ground_[row]) {
+         continue;
+      }
+
+      auto const x = std::remainder(targets.lons_[row] - user.lon_, 360.) * DEG * cos_lat
+                     * EARTH_RADIUS;
+      auto const y  = (targets.lats_[row] - user.lat_) * DEG * EARTH_RADIUS;
+      auto const z  = targets.altitudes_[row] - user.altitude_;
+      auto const vx = targets.east_velocities_[row] - user.world_lon_velocity_;
+      auto const vy = targets.north_velocities_[row] - user.world_lat_velocity_;
+      auto const vz = targets.vertical_velocities_[row] - user.world_vertical_velocity_;
+
+      auto const closure = vx * vx + vy * vy;
+      auto const time    = closure > 1e-3 ? std::max(0., -(x * vx + y * vy) / closure) : 0.;
+      auto const miss    = std::hypot(x + vx * time, y + vy * time);
+      auto const miss_z  = std::abs(z + vz * time);
+
+      auto const traffic    = time <= 40. && miss <= .8 * NM && miss_z <= 850.;
+      auto const resolution = traffic && time <= 25. && miss <= .55 * NM && miss_z <= 600.;
+      auto const proximate  = traffic || (std::hypot(x, y) <= 6. * NM && std::abs(z) <= 1200.);
+
+      alerts[row] = static_cast<smc::Alert>(proximate + traffic + resolution);
+   }
+
+   return alerts;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   std::vector<std::size_t> sizes{};
+   std::size_t              runs = 200;
+
+   for (int i = 1; i < argc; ++i) {
+      std::string_view const arg{argv[i]};
+      if ((arg == "--runs") && (i + 1 < argc)) {
+         runs = static_cast<std::size_t>(std::atof(argv[++i]));
+      } else {
+         sizes.emplace_back(static_cast<std::size_t>(std::atof(argv[i])));
+      }
+   }
+
+   if (sizes.empty()) {
+      sizes = {500, 2000, 5000};
+   }
+
+   smc::TrafficInfo user{};
+   user.lat_                = 40.6399;
+   user.lon_                = -73.7787;
+   user.altitude_           = 5000.;
+   user.world_lat_velocity_ = 200.;
+
+   std::mt19937 rng{42};
+
+   for (auto const size : sizes) {
+      // Spread over a region, most are dropped by the box, then all of them close to the user
+      for (auto const range : {120., 12.}) {
+         auto const targets = Generate(user, size, range, rng);
+         auto const name    = std::to_string(size) + " aircraft within "
+                           + std::to_string(static_cast<int>(range)) + "NM";
+
+         smc::ConflictDetector   detector{};
+         std::vector<smc::Alert> alerts(size);
+         bench::Samples          detect{};
+         bench::Samples          reference{};
+
+         for (std::size_t run = 0; run < runs; ++run) {
+            auto start = bench::Clock::now();
+            detector.Detect(user, targets.View(), alerts);
+            detect.Add(bench::Micros(bench::Clock::now() - start));
+
+            start         = bench::Clock::now();
+            auto expected = Reference(user, targets);
+            reference.Add(bench::Micros(bench::Clock::now() - start));
+            bench::Keep(expected);
+         }
+
+         auto const expected = Reference(user, targets);
+
+         std::size_t mismatches = 0;
+         std::size_t raised[4]{};
+         for (std::size_t row = 0; row < size; ++row) {
+            mismatches += alerts[row] != expected[row];
+            ++raised[static_cast<std::size_t>(alerts[row])];
+         }
+
+         detect.Report(name + " detector", "us");
+         reference.Report(name + " reference", "us");
+         std::cout << "  alerts : " << raised[1] << " proximate, " << raised[2] << " traffic, "
+                   << raised[3] << " resolution, " << mismatches << " mismatches" << std::endl;
+
+         CHECK(mismatches * 1000 <= size);
+         if (size <= 2000) {
+            CHECK(detect.Percentile(99.) < 1000.);
+         }
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
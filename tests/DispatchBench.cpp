@@ -0,0 +1,171 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Answers routed by smc::RouteAnswer (SimConnect::Dispatch) at a steady state of subscriptions
+// and one shot requests, next to the std::map + std::function tables it replaced.
+//
+// dispatch_bench [packets] [subscriptions]
+
+#include "Bench.h"
+
+#include "SimConnect/Requests.h"
+
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace {
+
+struct Reject {};
+
+using Clock = std::chrono::steady_clock;
+
+SIMCONNECT_RECV_SIMOBJECT_DATA
+Packet(DWORD request_id) {
+   SIMCONNECT_RECV_SIMOBJECT_DATA data{};
+   data.dwSize      = sizeof(data);
+   data.dwID        = SIMCONNECT_RECV_ID_SIMOBJECT_DATA;
+   data.dwRequestID = request_id;
+   data.dwDefineID  = static_cast<DWORD>(smc::DataId::TRAFFIC_POSITION);
+   data.dwoutof     = 1;
+   data.dwData      = request_id;
+   return data;
+}
+
+// Every 16th packet answers a one shot request issued just before, settled by its handler
+template <class ISSUE, class ROUTE>
+double
+Run(std::size_t packets, std::vector<DWORD> const& subscriptions, ISSUE&& issue, ROUTE&& route) {
+   return bench::Seconds([&] {
+      for (std::size_t i = 0; i < packets; ++i) {
+         auto const request_id =
+           (i % 16) ? subscriptions[i % subscriptions.size()] : static_cast<DWORD>(issue());
+         CHECK(route(Packet(request_id)));
+      }
+   });
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   auto const packets = static_cast<std::size_t>(argc > 1 ? std::atof(argv[1]) : 2e6);
+   auto const count   = static_cast<std::size_t>(argc > 2 ? std::atof(argv[2]) : 256);
+
+   DWORD sum{};
+
+   // Slot map registry
+   smc::Requests<Reject> requests{};
+   std::vector<DWORD>    subscriptions{};
+   for (std::size_t i = 0; i < count; ++i) {
+      subscriptions.emplace_back(requests.Insert({
+        .handler_ = smc::Subscription{
+          .id_        = smc::DataId::TRAFFIC_POSITION,
+          .object_id_ = static_cast<DWORD>(i),
+          .period_    = SIMCONNECT_PERIOD_SECOND,
+          .flags_     = 0,
+          .interval_  = 0,
+          .push_ = [&sum](SIMCONNECT_RECV_SIMOBJECT_DATA const& data, Clock::time_point const&) {
+             sum += data.dwData;
+          },
+          .cancel_ = {},
+        },
+      }));
+   }
+
+   auto const registry = Run(
+     packets,
+     subscriptions,
+     [&] {
+        auto const request_id = requests.Insert({});
+        requests.Find(request_id)->handler_ = smc::SimObjectHandler{
+          [&requests, &sum, request_id](
+            SIMCONNECT_RECV_SIMOBJECT_DATA const& data, Clock::time_point const&
+          ) {
+             sum += data.dwData;
+             requests.Erase(request_id);
+          }
+        };
+        return request_id;
+     },
+     [&](SIMCONNECT_RECV const& data) {
+        return smc::RouteAnswer(requests, data) == smc::Routed::ANSWERED;
+     }
+   );
+   CHECK(requests.size() == count);
+
+   // Former tables : a std::map per kind of request, keyed by an increasing id
+   using Handler = std::function<void(SIMCONNECT_RECV_SIMOBJECT_DATA const&, Clock::time_point)>;
+   std::map<DWORD, Handler> pending_subscriptions{};
+   std::map<DWORD, Handler> pending_simobjects{};
+   DWORD                    request_id{};
+
+   subscriptions.clear();
+   for (std::size_t i = 0; i < count; ++i) {
+      subscriptions.emplace_back(++request_id);
+      pending_subscriptions.emplace(
+        request_id,
+        [&sum](SIMCONNECT_RECV_SIMOBJECT_DATA const& data, Clock::time_point) {
+           sum += data.dwData;
+        }
+      );
+   }
+
+   auto const maps = Run(
+     packets,
+     subscriptions,
+     [&] {
+        auto const id = ++request_id;
+        pending_simobjects.emplace(
+          id,
+          [&pending_simobjects, &sum, id](
+            SIMCONNECT_RECV_SIMOBJECT_DATA const& data, Clock::time_point
+          ) {
+             sum += data.dwData;
+             pending_simobjects.erase(id);
+          }
+        );
+        return id;
+     },
+     [&](SIMCONNECT_RECV const& recv) {
+        auto const& data = static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA const&>(recv);
+        auto const  now  = Clock::now();
+
+        if (auto const it = pending_subscriptions.find(data.dwRequestID);
+            it != pending_subscriptions.end()) {
+           it->second(data, now);
+           return true;
+        }
+        if (auto it = pending_simobjects.find(data.dwRequestID); it != pending_simobjects.end()) {
+           auto handler = std::move(it->second);
+           handler(data, now);
+           return true;
+        }
+        return false;
+     }
+   );
+   CHECK(pending_simobjects.empty());
+
+   auto const rate = [&](double seconds) { return static_cast<double>(packets) / seconds; };
+   std::cout << "dispatch (" << count << " subscriptions): " << rate(registry)
+             << " packets/s slot map, " << rate(maps) << " packets/s std::map ("
+             << maps / registry << "x), checksum " << sum << std::endl;
+
+   // Tens of thousands per second are asked for
+   CHECK(rate(registry) > 50'000.);
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,460 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Airport facility stream decoded by facility::Decoder (SimConnect::RequestFacilityData) next to
+// the std::function processor chain it replaced, ported below as it was. Both results must match.
+//
+// facility_decode_bench [capture] [iterations]
+// The capture holds the answer to an airport facility request (e.g. KJFK recorded by the server
+// capture option), without one a stream of KJFK size is generated.
+
+#include "Bench.h"
+
+#include "SimConnect/Capture.h"
+#include "SimConnect/FacilityData/AirportFacility.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+std::size_t allocations{0};
+
+}  // namespace
+
+void*
+operator new(std::size_t size) {
+   ++allocations;
+   if (auto const ptr = std::malloc(size ? size : 1)) {
+      return ptr;
+   }
+   throw std::bad_alloc{};
+}
+
+void
+operator delete(void* ptr) noexcept {
+   std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept {
+   std::free(ptr);
+}
+
+namespace {
+
+using namespace smc::facility;
+
+// The processor chain as of before the decoder tables
+namespace legacy {
+
+struct Processor;
+using ProcessorReturn = std::tuple<std::shared_ptr<Processor>, std::string>;
+
+struct Processor : std::function<ProcessorReturn(SIMCONNECT_RECV_FACILITY_DATA const&)> {};
+
+template <class SELF>
+std::string
+ProcessMembers(SELF& self, SIMCONNECT_RECV_FACILITY_DATA const& data) {
+   std::string error{};
+
+   std::size_t remaining_size =
+     data.dwSize + sizeof(data.Data) - sizeof(SIMCONNECT_RECV_FACILITY_DATA);
+   auto it = reinterpret_cast<std::byte const*>(&data.Data);
+   std::apply(
+     [&](auto const&... members) {
+        return (
+          [&](auto const& member) {
+             auto& member_ref = self.*std::get<1>(member);
+             if (remaining_size < sizeof(member_ref)) {
+                error = "Received data size " + std::to_string(remaining_size)
+                        + " is smaller than expected size for facility data member "
+                        + std::string{std::get<0>(member)};
+                return false;
+             }
+
+             std::copy(it, it + sizeof(member_ref), reinterpret_cast<std::byte*>(&member_ref));
+             it += sizeof(member_ref);
+             remaining_size -= sizeof(member_ref);
+             return true;
+          }(members)
+          && ...
+        );
+     },
+     SELF::MEMBERS
+   );
+
+   return error;
+}
+
+template <std::size_t INDEX, class SELF>
+std::shared_ptr<Processor> MakeSectionProcessor(SELF&, std::shared_ptr<Processor> const&);
+
+template <class SELF>
+std::shared_ptr<Processor>
+GetProcessor(SELF& self, std::shared_ptr<Processor> const& parent_processor = nullptr) {
+   return std::make_shared<Processor>(
+     [&self, parent_processor](SIMCONNECT_RECV_FACILITY_DATA const& data) -> ProcessorReturn {
+        if constexpr (requires { SELF::MEMBERS; }) {
+           auto const error = ProcessMembers(self, data);
+           if (error.size()) {
+              return std::make_tuple(nullptr, "Failed to process facility data: " + error);
+           }
+        }
+
+        if constexpr (requires { SELF::SECTIONS; }) {
+           return std::make_tuple(MakeSectionProcessor<0>(self, parent_processor), "");
+        } else {
+           return std::make_tuple(parent_processor, "");
+        }
+     }
+   );
+}
+
+template <std::size_t INDEX, class SELF>
+std::shared_ptr<Processor>
+MakeSectionProcessor(SELF& self, std::shared_ptr<Processor> const& parent_processor) {
+   auto const process_ptr = std::make_shared<Processor>();
+   *process_ptr           = Processor{
+     [&self, parent_processor, self_processor = std::weak_ptr(process_ptr)](
+       SIMCONNECT_RECV_FACILITY_DATA const& data
+     ) mutable -> ProcessorReturn {
+        using SECTIONS_TYPE = std::remove_cvref_t<decltype(SELF::SECTIONS)>;
+
+        auto const self_ptr       = self_processor.lock();
+        auto const next_processor = [&self, &parent_processor] {
+           if constexpr (INDEX + 1 >= std::tuple_size_v<SECTIONS_TYPE>) {
+              (void)self;
+              return parent_processor;
+           } else {
+              return MakeSectionProcessor<INDEX + 1>(self, parent_processor);
+           }
+        };
+
+        auto const& [section_name, section_member] = std::get<INDEX>(SELF::SECTIONS);
+        using SECTION_TYPE = std::remove_cvref_t<decltype(self.*section_member)>;
+
+        std::shared_ptr<Processor> processor{};
+        if constexpr (requires(SECTION_TYPE& t) { t.emplace_back(); }) {
+           if (!data.IsListItem) {
+              return std::make_tuple(
+                nullptr, "Received non-list data for list section " + std::string{section_name}
+              );
+           }
+
+           auto& member = self.*section_member;
+           member.emplace_back();
+           processor = GetProcessor(
+             member.back(), (data.ItemIndex + 1 == data.ListSize) ? next_processor() : self_ptr
+           );
+        } else {
+           if (data.IsListItem) {
+              return std::make_tuple(
+                nullptr,
+                "Received unexpected list item for non-list section " + std::string{section_name}
+              );
+           }
+
+           processor = GetProcessor(self.*section_member, next_processor());
+        }
+
+        std::string error{};
+        std::tie(processor, error) = (*processor)(data);
+
+        if (error.size()) {
+           return std::make_tuple(nullptr, "Failed to process facility data section " + error);
+        }
+        return std::make_tuple(processor, "");
+     }
+   };
+
+   return process_ptr;
+}
+
+}  // namespace legacy
+
+using Packet = std::vector<std::byte>;
+
+SIMCONNECT_RECV_FACILITY_DATA const&
+Data(Packet const& packet) {
+   return *reinterpret_cast<SIMCONNECT_RECV_FACILITY_DATA const*>(packet.data());
+}
+
+// FACILITY_DATA packets of an object then of its sections, depth first, as the simulator sends them
+template <class T>
+void
+Serialize(T const& object, DWORD list, DWORD index, DWORD size, std::vector<Packet>& stream) {
+   SIMCONNECT_RECV_FACILITY_DATA data{};
+   constexpr auto                HEADER = sizeof(data) - sizeof(data.Data);
+
+   data.dwID       = SIMCONNECT_RECV_ID_FACILITY_DATA;
+   data.IsListItem = list;
+   data.ItemIndex  = index;
+   data.ListSize   = size;
+
+   Packet packet(HEADER);
+   if constexpr (requires { T::MEMBERS; }) {
+      std::apply(
+        [&](auto const&... members) {
+           (
+             [&](auto const& member) {
+                auto const bytes = std::as_bytes(std::span{&(object.*std::get<1>(member)), 1});
+                packet.insert(packet.end(), bytes.begin(), bytes.end());
+             }(members),
+             ...
+           );
+        },
+        T::MEMBERS
+      );
+   }
+
+   data.dwSize = static_cast<DWORD>(packet.size());
+   std::memcpy(packet.data(), &data, HEADER);
+   packet.resize(std::max(packet.size(), sizeof(data)));
+   stream.emplace_back(std::move(packet));
+
+   if constexpr (requires { T::SECTIONS; }) {
+      std::apply(
+        [&](auto const&... sections) {
+           (
+             [&](auto const& section) {
+                auto const& value = object.*std::get<1>(section);
+                if constexpr (SectionTraits<std::remove_cvref_t<decltype(section)>>::LIST) {
+                   for (std::size_t i = 0; i < value.size(); ++i) {
+                      Serialize(
+                        value[i], 1, static_cast<DWORD>(i), static_cast<DWORD>(value.size()), stream
+                      );
+                   }
+                } else {
+                   Serialize(value, 0, 0, 0, stream);
+                }
+             }(sections),
+             ...
+           );
+        },
+        T::SECTIONS
+      );
+   }
+}
+
+std::vector<Packet>
+Serialize(AirportData const& airport) {
+   std::vector<Packet> stream{};
+   Serialize(airport, 0, 0, 0, stream);
+   return stream;
+}
+
+// About the size of KJFK : 4 runways, ~1900 taxi points, ~450 parkings, ~120 names, ~2600 paths
+AirportData
+Generate() {
+   std::mt19937                          rng{42};
+   std::uniform_real_distribution<float> offset{-2000.f, 2000.f};
+   std::uniform_int_distribution<int>    pick{0, 6};
+
+   AirportData airport{.lat_ = 40.6399, .lon_ = -73.7787, .altitude_ = 4.};
+
+   for (int i = 0; i < 4; ++i) {
+      airport.runways_.push_back({
+        .latitude_            = airport.lat_ + offset(rng) * 1e-5,
+        .longitude_           = airport.lon_ + offset(rng) * 1e-5,
+        .altitude_            = 4.,
+        .length_              = 3000.f + offset(rng),
+        .heading_             = 40.f + static_cast<float>(i) * 90.f,
+        .prim_number_         = 4 + i,
+        .prim_designator_     = AirportData::Runway::Designator::LEFT,
+        .sec_number_          = 22 + i,
+        .sec_designator_      = AirportData::Runway::Designator::RIGHT,
+        .primary_threshold_   = {.length_ = 100.f, .enabled_ = 1},
+        .secondary_threshold_ = {.length_ = 200.f, .enabled_ = i % 2},
+      });
+   }
+
+   for (int i = 0; i < 1900; ++i) {
+      airport.taxi_points_.push_back({
+        .type_        = static_cast<AirportData::TaxiPoint::Type>(pick(rng)),
+        .orientation_ = static_cast<AirportData::TaxiPoint::Orientation>(i % 2),
+        .x_           = offset(rng),
+        .y_           = offset(rng),
+      });
+   }
+
+   for (int i = 0; i < 450; ++i) {
+      airport.taxi_parkings_.push_back({
+        .parking_type_ = static_cast<AirportData::TaxiParking::ParkingType>(pick(rng)),
+        .type_         = AirportData::TaxiParking::Type::NORMAL,
+        .orientation_  = AirportData::TaxiParking::Orientation::FORWARD,
+        .name_         = pick(rng),
+        .suffix_       = 0,
+        .number_       = static_cast<uint32_t>(i),
+        .heading_      = offset(rng),
+        .x_            = offset(rng),
+        .y_            = offset(rng),
+      });
+   }
+
+   for (int i = 0; i < 120; ++i) {
+      AirportData::TaxiName name{};
+      auto const            text = "TWY " + std::to_string(i);
+      std::copy(text.begin(), text.end(), name.name_.begin());
+      airport.taxi_names_.push_back(name);
+   }
+
+   for (int i = 0; i < 2600; ++i) {
+      airport.taxi_paths_.push_back({
+        .type_       = static_cast<AirportData::TaxiPath::Type>(pick(rng)),
+        .start_      = i % 1900,
+        .end_        = (i + 1) % 1900,
+        .name_index_ = i % 120,
+      });
+   }
+
+   return airport;
+}
+
+// FACILITY_DATA packets answering the first facility request of the capture
+std::vector<Packet>
+Load(char const* path) {
+   smc::CaptureReader   reader{path};
+   std::vector<Packet>  stream{};
+   std::optional<DWORD> request_id{};
+
+   while (auto packet = reader.Next()) {
+      if (packet->data_.size() < sizeof(SIMCONNECT_RECV_FACILITY_DATA_END)) {
+         continue;
+      }
+
+      auto const& recv = *reinterpret_cast<SIMCONNECT_RECV const*>(packet->data_.data());
+      if (recv.dwID == SIMCONNECT_RECV_ID_FACILITY_DATA_END) {
+         auto const& end =
+           *reinterpret_cast<SIMCONNECT_RECV_FACILITY_DATA_END const*>(packet->data_.data());
+         if (request_id == end.RequestId) {
+            break;
+         }
+      } else if (
+        recv.dwID == SIMCONNECT_RECV_ID_FACILITY_DATA
+        && packet->data_.size() >= sizeof(SIMCONNECT_RECV_FACILITY_DATA)
+      ) {
+         auto const& data = Data(packet->data_);
+         if (!request_id) {
+            request_id = data.UserRequestId;
+         }
+
+         if (*request_id == data.UserRequestId) {
+            stream.emplace_back(std::move(packet->data_));
+         }
+      }
+   }
+
+   return stream;
+}
+
+AirportData
+DecodeLegacy(std::vector<Packet> const& stream) {
+   AirportData airport{};
+   auto        process = legacy::GetProcessor(airport);
+
+   for (auto const& packet : stream) {
+      CHECK(process);
+
+      std::string error{};
+      std::tie(process, error) = (*process)(Data(packet));
+      CHECK(error.empty());
+   }
+
+   CHECK(!process);
+   return airport;
+}
+
+AirportData
+Decode(std::vector<Packet> const& stream) {
+   AirportData          airport{};
+   Decoder<AirportData> decoder{};
+
+   for (auto const& packet : stream) {
+      CHECK(decoder.Process(airport, Data(packet)).empty());
+   }
+
+   CHECK(decoder.Done());
+   return airport;
+}
+
+struct Result {
+   bench::Samples time_{};  // us per airport
+   std::size_t    allocations_{};
+};
+
+template <class DECODE>
+Result
+Run(std::vector<Packet> const& stream, std::size_t iterations, DECODE&& decode) {
+   Result result{};
+
+   for (std::size_t i = 0; i < iterations; ++i) {
+      auto const before = allocations;
+      auto const start  = bench::Clock::now();
+      static_cast<void>(decode(stream));
+      result.time_.Add(bench::Micros(bench::Clock::now() - start));
+      result.allocations_ = allocations - before;
+   }
+
+   return result;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   auto const stream     = argc > 1 && *argv[1] ? Load(argv[1]) : Serialize(Generate());
+   auto const iterations = static_cast<std::size_t>(argc > 2 ? std::atof(argv[2]) : 200);
+
+   CHECK(!stream.empty());
+
+   // Same airport, rebuilt to the same packets
+   auto const decoded = Decode(stream);
+   auto const legacy  = DecodeLegacy(stream);
+   CHECK(Serialize(decoded) == Serialize(legacy));
+   if (argc <= 1) {
+      CHECK(Serialize(decoded) == stream);
+   }
+
+   std::cout << stream.size() << " packets, " << decoded.runways_.size() << " runways, "
+             << decoded.taxi_points_.size() << " taxi points, " << decoded.taxi_parkings_.size()
+             << " parkings, " << decoded.taxi_names_.size() << " names, "
+             << decoded.taxi_paths_.size() << " paths" << std::endl;
+
+   auto processors = Run(stream, iterations, DecodeLegacy);
+   auto tables     = Run(stream, iterations, Decode);
+
+   processors.time_.Report("processors", "us");
+   tables.time_.Report("decoder", "us");
+   std::cout << "allocations per airport : " << processors.allocations_ << " processors, "
+             << tables.allocations_ << " decoder" << std::endl;
+   std::cout << "decoder speedup (p50) : "
+             << processors.time_.Percentile(50.) / tables.time_.Percentile(50.) << "x" << std::endl;
+
+   CHECK(tables.allocations_ < processors.allocations_);
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,263 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Heap allocations per SimConnect::GetUserAircraftInfo call, with the facade coroutine frames from
+// the heap and from the FramePool. The promise library isn't part of this tree : its promises are
+// modeled by lazy coroutine tasks and MakePromise by a coroutine keeping the callable. The chain
+// is the one of the facade : Proxy, Coalesce, the info lambda and RequestDataOnSimObject, each
+// through MakePromise, the std::function of Proxy and Coalesce included.
+//
+// frame_pool_bench [calls]
+
+#include "Bench.h"
+
+#include "SimConnect/FramePool.h"
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace {
+
+std::size_t allocations{0};
+
+}  // namespace
+
+void*
+operator new(std::size_t size) {
+   ++allocations;
+   if (auto const ptr = std::malloc(size ? size : 1)) {
+      return ptr;
+   }
+   throw std::bad_alloc{};
+}
+
+void
+operator delete(void* ptr) noexcept {
+   std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept {
+   std::free(ptr);
+}
+
+namespace {
+
+template <class T>
+class Task {
+public:
+   struct promise_type {
+      std::optional<T>        value_{};
+      std::coroutine_handle<> continuation_{};
+
+      Task
+      get_return_object() {
+         return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+
+      std::suspend_always
+      initial_suspend() noexcept {
+         return {};
+      }
+
+      auto
+      final_suspend() noexcept {
+         struct Final {
+            bool
+            await_ready() const noexcept {
+               return false;
+            }
+
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+               auto const continuation = handle.promise().continuation_;
+               return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void
+            await_resume() const noexcept {}
+         };
+
+         return Final{};
+      }
+
+      void
+      return_value(T value) {
+         value_ = std::move(value);
+      }
+
+      void
+      unhandled_exception() {
+         std::terminate();
+      }
+   };
+
+   Task(Task&& other) noexcept
+      : handle_{std::exchange(other.handle_, nullptr)} {}
+
+   ~Task() {
+      if (handle_) {
+         handle_.destroy();
+      }
+   }
+
+   bool
+   await_ready() const noexcept {
+      return false;
+   }
+
+   std::coroutine_handle<>
+   await_suspend(std::coroutine_handle<> continuation) noexcept {
+      handle_.promise().continuation_ = continuation;
+      return handle_;
+   }
+
+   T
+   await_resume() {
+      return std::move(*handle_.promise().value_);
+   }
+
+   // Runs a task without awaiter to its end, every hop being inline
+   T
+   Get() {
+      handle_.resume();
+      return std::move(*handle_.promise().value_);
+   }
+
+private:
+   explicit Task(std::coroutine_handle<promise_type> handle)
+      : handle_{handle} {}
+
+   std::coroutine_handle<promise_type> handle_;
+};
+
+struct TrafficInfo {
+   double lat_{};
+   double lon_{};
+   double altitude_{};
+   double heading_{};
+   double speed_{};
+};
+
+// The promise library keeps the callable for as long as its coroutine runs
+template <class FN>
+auto
+MakePromise(FN fn) -> decltype(fn()) {
+   co_return co_await fn();
+}
+
+// Frames of the facade lambdas
+struct HeapFrame {};
+
+template <class FRAME, class FN>
+auto
+Make(FN&& fn) {
+   if constexpr (std::is_same_v<FRAME, smc::PooledFrame>) {
+      return MakePromise(smc::Pooled(std::forward<FN>(fn)));
+   } else {
+      return MakePromise([fn = std::forward<FN>(fn)]() { return fn(HeapFrame{}); });
+   }
+}
+
+template <class FRAME>
+Task<TrafficInfo>
+RequestDataOnSimObject() {
+   return Make<FRAME>([](FRAME) -> Task<TrafficInfo> {
+      co_return TrafficInfo{.lat_ = 45.7, .lon_ = 5.1, .altitude_ = 3500.};
+   });
+}
+
+template <class FRAME>
+Task<TrafficInfo>
+Coalesce(std::function<Task<TrafficInfo>()>&& func) {
+   return Make<FRAME>([func = std::move(func)](FRAME) -> Task<TrafficInfo> {
+      co_return co_await func();
+   });
+}
+
+template <class FRAME>
+Task<TrafficInfo>
+Proxy(std::function<Task<TrafficInfo>()>&& func) {
+   return Make<FRAME>([func = std::move(func)](FRAME) -> Task<TrafficInfo> {
+      co_return co_await func();
+   });
+}
+
+template <class FRAME>
+Task<TrafficInfo>
+GetUserAircraftInfo() {
+   return Proxy<FRAME>([] {
+      return Coalesce<FRAME>([] {
+         return Make<FRAME>([](FRAME) -> Task<TrafficInfo> {
+            co_return co_await RequestDataOnSimObject<FRAME>();
+         });
+      });
+   });
+}
+
+struct Result {
+   double allocations_{};
+   double us_{};
+};
+
+template <class FRAME>
+Result
+Run(std::size_t calls) {
+   double altitude{};
+
+   // Fills the free lists
+   for (std::size_t i = 0; i < 16; ++i) {
+      altitude += GetUserAircraftInfo<FRAME>().Get().altitude_;
+   }
+
+   auto const before  = allocations;
+   auto const seconds = bench::Seconds([&] {
+      for (std::size_t i = 0; i < calls; ++i) {
+         altitude += GetUserAircraftInfo<FRAME>().Get().altitude_;
+      }
+   });
+   bench::Keep(altitude);
+   CHECK(altitude == 3500. * static_cast<double>(calls + 16));
+
+   return {
+     .allocations_ = static_cast<double>(allocations - before) / static_cast<double>(calls),
+     .us_          = seconds * 1e6 / static_cast<double>(calls),
+   };
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   auto const calls = argc > 1 ? static_cast<std::size_t>(std::atof(argv[1])) : 1'000'000;
+
+   auto const heap   = Run<HeapFrame>(calls);
+   auto const pooled = Run<smc::PooledFrame>(calls);
+
+   std::cout << "GetUserAircraftInfo: " << heap.allocations_ << " allocations, " << heap.us_
+             << "us per call with the frames from the heap, " << pooled.allocations_
+             << " allocations, " << pooled.us_ << "us from the frame pool" << std::endl;
+
+   CHECK(pooled.allocations_ < heap.allocations_);
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+// Websocket server on 127.0.0.1, one thread per connection running the session handler on the
+// accepted (and handshaked) stream
+class LoopbackServer {
+public:
+   using Socket  = boost::beast::websocket::stream<boost::asio::ip::tcp::socket>;
+   using Session = std::function<void(Socket& ws)>;
+
+   explicit LoopbackServer(Session session)
+      : session_{std::move(session)} {
+      acceptor_thread_ = std::jthread{[this] {
+         while (true) {
+            boost::beast::error_code ec{};
+            auto socket = acceptor_.accept(ec);
+            if (ec || stopping_) {
+               return;
+            }
+
+            auto ws = std::make_shared<Socket>(std::move(socket));
+            {
+               std::lock_guard lock{mutex_};
+               sockets_.emplace_back(ws);
+            }
+
+            sessions_.emplace_back([this, ws] {
+               try {
+                  ws->next_layer().set_option(boost::asio::ip::tcp::no_delay{true});
+                  ws->accept();
+                  ws->text(true);
+                  session_(*ws);
+               } catch (std::exception const&) {
+                  // Connection dropped
+               }
+            });
+         }
+      }};
+   }
+
+   ~LoopbackServer() {
+      // A blocking accept isn't woken by close, connect to it instead
+      stopping_ = true;
+      boost::asio::ip::tcp::socket wake{ioc_};
+      boost::beast::error_code     ec{};
+      wake.connect(acceptor_.local_endpoint(), ec);
+      acceptor_thread_ = {};
+      Drop();
+      sessions_.clear();
+   }
+
+   uint16_t
+   Port() const {
+      return acceptor_.local_endpoint().port();
+   }
+
+   // Closes the accepted connections
+   void
+   Drop() {
+      std::lock_guard lock{mutex_};
+      for (auto const& ws : sockets_) {
+         boost::beast::error_code ec{};
+         ws->next_layer().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+      }
+      sockets_.clear();
+   }
+
+private:
+   Session                        session_;
+   boost::asio::io_context        ioc_{};
+   boost::asio::ip::tcp::acceptor acceptor_{
+     ioc_, {boost::asio::ip::make_address("127.0.0.1"), 0}
+   };
+
+   std::atomic<bool>                    stopping_{false};
+   std::mutex                           mutex_{};
+   std::vector<std::shared_ptr<Socket>> sockets_{};
+   std::vector<std::jthread>            sessions_{};
+   std::jthread                         acceptor_thread_{};
+};
+
+// Reads a frame, throws when the connection is closed
+inline std::string
+ReadFrame(LoopbackServer::Socket& ws) {
+   boost::beast::flat_buffer buffer{};
+   ws.read(buffer);
+   return boost::beast::buffers_to_string(buffer.data());
+}
+
+}  // namespace bench
@@ -0,0 +1,326 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Per call overhead of SimConnect::Proxy : the former path hopping to the SimConnect queue and back
+// to the main pool, the inline path taken on the SimConnect thread, and Batch (one hop there and
+// back for several calls, each taking the inline path).
+// MessageQueue and the promise library aren't part of this tree, the two queues are modeled by a
+// thread resuming the coroutines posted to it, and the promises by lazy coroutine tasks. The
+// request itself is a no-op, only the hops and the frames are measured.
+//
+// proxy_hop_bench [calls] [batch]
+
+#include "Bench.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <latch>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace {
+
+class Queue {
+public:
+   auto
+   Hop() {
+      struct Awaiter {
+         Queue& queue_;
+
+         bool
+         await_ready() const noexcept {
+            return false;
+         }
+
+         void
+         await_suspend(std::coroutine_handle<> handle) {
+            queue_.Post(handle);
+         }
+
+         void
+         await_resume() const noexcept {}
+      };
+
+      return Awaiter{*this};
+   }
+
+private:
+   void
+   Post(std::coroutine_handle<> handle) {
+      {
+         std::lock_guard lock{mutex_};
+         handles_.emplace_back(handle);
+      }
+      condition_.notify_one();
+   }
+
+   void
+   Run(std::stop_token stop) {
+      std::unique_lock lock{mutex_};
+      while (condition_.wait(lock, stop, [this] { return !handles_.empty(); })) {
+         auto const handle = handles_.front();
+         handles_.pop_front();
+
+         lock.unlock();
+         handle.resume();
+         lock.lock();
+      }
+   }
+
+   std::mutex                          mutex_{};
+   std::condition_variable_any         condition_{};
+   std::deque<std::coroutine_handle<>> handles_{};
+   std::jthread                        thread_{[this](std::stop_token stop) { Run(stop); }};
+};
+
+template <class T>
+class Task {
+public:
+   struct promise_type {
+      std::optional<T>        value_{};
+      std::coroutine_handle<> continuation_{};
+
+      // Set by the first of the task completing and its awaiter suspending, the second one resumes
+      // the continuation. A task completing inline returns to its awaiter without a transfer, so
+      // the stack doesn't grow with the calls when the transfers aren't tail calls (unoptimized)
+      std::atomic<bool> arrived_{false};
+
+      Task
+      get_return_object() {
+         return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+
+      std::suspend_always
+      initial_suspend() noexcept {
+         return {};
+      }
+
+      auto
+      final_suspend() noexcept {
+         struct Final {
+            bool
+            await_ready() const noexcept {
+               return false;
+            }
+
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+               auto& promise = handle.promise();
+               if (promise.arrived_.exchange(true, std::memory_order_acq_rel)) {
+                  // Completed after a hop, the awaiter is suspended
+                  return promise.continuation_;
+               }
+               return std::noop_coroutine();
+            }
+
+            void
+            await_resume() const noexcept {}
+         };
+
+         return Final{};
+      }
+
+      void
+      return_value(T value) {
+         value_ = std::move(value);
+      }
+
+      void
+      unhandled_exception() {
+         std::terminate();
+      }
+   };
+
+   Task(Task&& other) noexcept
+      : handle_{std::exchange(other.handle_, nullptr)} {}
+
+   ~Task() {
+      if (handle_) {
+         handle_.destroy();
+      }
+   }
+
+   bool
+   await_ready() const noexcept {
+      return false;
+   }
+
+   bool
+   await_suspend(std::coroutine_handle<> continuation) noexcept {
+      auto& promise         = handle_.promise();
+      promise.continuation_ = continuation;
+      handle_.resume();
+
+      // Resumed right away when the task already completed
+      return !promise.arrived_.exchange(true, std::memory_order_acq_rel);
+   }
+
+   T
+   await_resume() {
+      return std::move(*handle_.promise().value_);
+   }
+
+private:
+   explicit Task(std::coroutine_handle<promise_type> handle)
+      : handle_{handle} {}
+
+   std::coroutine_handle<promise_type> handle_;
+};
+
+struct Detached {
+   struct promise_type {
+      Detached
+      get_return_object() {
+         return {};
+      }
+
+      std::suspend_never
+      initial_suspend() noexcept {
+         return {};
+      }
+
+      std::suspend_never
+      final_suspend() noexcept {
+         return {};
+      }
+
+      void
+      return_void() {}
+
+      void
+      unhandled_exception() {
+         std::terminate();
+      }
+   };
+};
+
+struct Queues {
+   Queue main_{};
+   Queue simconnect_{};
+};
+
+Task<std::size_t>
+Request(std::size_t value) {
+   co_return value + 1;
+}
+
+// Former Proxy : Ensure() then main_.MainPool::Dispatch() around the request
+Task<std::size_t>
+ProxyHops(Queues& queues, std::size_t value) {
+   co_await queues.simconnect_.Hop();
+   auto const result = co_await Request(value);
+   co_await queues.main_.Hop();
+   co_return result;
+}
+
+// Proxy called on the SimConnect thread while connected
+Task<std::size_t>
+ProxyInline(std::size_t value) {
+   co_return co_await Request(value);
+}
+
+Task<std::size_t>
+Batch(Queues& queues, std::size_t first, std::size_t size) {
+   co_await queues.simconnect_.Hop();
+
+   std::size_t result = 0;
+   for (std::size_t i = 0; i < size; ++i) {
+      result += co_await ProxyInline(first + i);
+   }
+
+   co_await queues.main_.Hop();
+   co_return result;
+}
+
+enum class Path { HOPS, INLINE, BATCH };
+
+Detached
+Drive(
+  Queues&     queues,
+  Path        path,
+  std::size_t calls,
+  std::size_t batch,
+  double&     seconds,
+  std::latch& done
+) {
+   // The inline path is only taken by the callers on the SimConnect thread
+   co_await (path == Path::INLINE ? queues.simconnect_ : queues.main_).Hop();
+
+   std::size_t sum   = 0;
+   auto const  start = bench::Clock::now();
+   for (std::size_t i = 0; i < calls;) {
+      switch (path) {
+         case Path::HOPS:
+            sum += co_await ProxyHops(queues, i++);
+            break;
+         case Path::INLINE:
+            sum += co_await ProxyInline(i++);
+            break;
+         case Path::BATCH:
+            sum += co_await Batch(queues, i, batch);
+            i   += batch;
+            break;
+      }
+   }
+   seconds = std::chrono::duration<double>(bench::Clock::now() - start).count();
+
+   bench::Keep(sum);
+   done.count_down();
+}
+
+double
+Measure(Queues& queues, Path path, std::size_t calls, std::size_t batch) {
+   double     seconds{};
+   std::latch done{1};
+
+   Drive(queues, path, calls, batch, seconds, done);
+   done.wait();
+
+   return seconds * 1e9 / static_cast<double>(calls);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   auto const calls = static_cast<std::size_t>(argc > 1 ? std::atof(argv[1]) : 2e5);
+   auto const batch = static_cast<std::size_t>(argc > 2 ? std::atof(argv[2]) : 8);
+
+   CHECK(batch && !(calls % batch));
+
+   Queues queues{};
+
+   auto const hops    = Measure(queues, Path::HOPS, calls, batch);
+   auto const inlined = Measure(queues, Path::INLINE, calls, batch);
+   auto const batched = Measure(queues, Path::BATCH, calls, batch);
+
+   std::cout << "per call : " << hops << "ns with the hops, " << inlined
+             << "ns inline on the SimConnect thread, " << batched << "ns in batches of " << batch
+             << std::endl;
+
+   CHECK(inlined < hops);
+   CHECK(batched < hops);
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Round trip through chained relays on loopback : client -> relay hop x N -> echo server.
+// Each hop re-sends the frames of its downstream connection through its own RelayLink, like a
+// relay server re-serving an upstream one, while SENDERS threads send concurrently.
+
+#include "Bench.h"
+#include "Loopback.h"
+
+#include "Server/RelayLink.h"
+
+#include <boost/asio/io_context.hpp>
+
+#include <charconv>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t SENDERS = 4;
+constexpr auto        RATE    = 1'000;  // Frames per second and sender
+constexpr auto        PERIOD  = std::chrono::seconds{1};
+
+std::shared_ptr<RelayLink>
+MakeLink(boost::asio::io_context& ioc, uint16_t port, RelayLink::OnFrame on_frame) {
+   auto link = std::make_shared<RelayLink>(
+     ioc, "127.0.0.1", std::to_string(port), "hello", std::move(on_frame), [] {}
+   );
+   link->Start();
+
+   for (int i = 0; i < 500 && !link->Connected(); ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+   }
+   CHECK(link->Connected());
+   return link;
+}
+
+}  // namespace
+
+int
+main() {
+   boost::asio::io_context ioc{};
+   auto                    work = boost::asio::make_work_guard(ioc);
+
+   std::vector<std::jthread> io_threads{};
+   for (int i = 0; i < 2; ++i) {
+      io_threads.emplace_back([&ioc] { ioc.run(); });
+   }
+
+   bench::LoopbackServer echo{[](bench::LoopbackServer::Socket& ws) {
+      CHECK(bench::ReadFrame(ws) == "hello");
+      while (true) {
+         ws.write(boost::asio::buffer(bench::ReadFrame(ws)));
+      }
+   }};
+
+   // Hops from the echo server down to the client
+   std::vector<std::unique_ptr<bench::LoopbackServer>> hops{};
+   double                                              direct_p50{};
+
+   for (std::size_t const chain : {0, 1, 2, 4}) {
+      while (hops.size() < chain) {
+         auto const upstream = hops.empty() ? echo.Port() : hops.back()->Port();
+
+         hops.emplace_back(std::make_unique<bench::LoopbackServer>(
+           [&ioc, upstream](bench::LoopbackServer::Socket& ws) {
+              CHECK(bench::ReadFrame(ws) == "hello");
+
+              std::mutex down{};
+              auto const link = MakeLink(ioc, upstream, [&](RelayLink::Frame&& frame) {
+                 std::lock_guard lock{down};
+                 ws.write(boost::asio::buffer(*frame));
+              });
+
+              try {
+                 while (true) {
+                    link->Send(bench::ReadFrame(ws));
+                 }
+              } catch (...) {
+                 link->Stop();
+                 throw;
+              }
+           }
+         ));
+      }
+
+      bench::Samples rtt{};
+      std::mutex     mutex{};
+      std::size_t    received{};
+
+      auto const link =
+        MakeLink(ioc, chain ? hops.back()->Port() : echo.Port(), [&](RelayLink::Frame&& frame) {
+           auto const now = bench::Clock::now().time_since_epoch().count();
+           long long  sent{};
+           std::from_chars(frame->data(), frame->data() + frame->size(), sent);
+
+           std::lock_guard lock{mutex};
+           rtt.Add(static_cast<double>(now - sent) / 1000.);
+           ++received;
+        });
+
+      {
+         std::vector<std::jthread> senders{};
+         for (std::size_t sender = 0; sender < SENDERS; ++sender) {
+            senders.emplace_back([&link] {
+               auto const end  = bench::Clock::now() + PERIOD;
+               auto       next = bench::Clock::now();
+
+               while (next < end) {
+                  link->Send(std::to_string(bench::Clock::now().time_since_epoch().count()));
+                  next += std::chrono::microseconds{1'000'000 / RATE};
+                  std::this_thread::sleep_until(next);
+               }
+            });
+         }
+      }
+
+      for (int i = 0; i < 500; ++i) {
+         {
+            std::lock_guard lock{mutex};
+            if (received == SENDERS * RATE) {
+               break;
+            }
+         }
+         std::this_thread::sleep_for(std::chrono::milliseconds{10});
+      }
+      link->Stop();
+
+      std::lock_guard lock{mutex};
+      CHECK(received == SENDERS * RATE);
+
+      rtt.Report("relay round trip through " + std::to_string(chain) + " hop(s)", "us");
+      if (chain) {
+         std::cout << "  round trip added per hop : "
+                   << (rtt.Percentile(50.) - direct_p50) / static_cast<double>(chain) << "us"
+                   << std::endl;
+      } else {
+         direct_p50 = rtt.Percentile(50.);
+      }
+   }
+
+   hops.clear();
+   work.reset();
+   ioc.stop();
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// RelayLink against an echo server on loopback : the hello goes first, frames sent concurrently
+// from several threads all come back in per-thread order, and the link says hello again after a
+// dropped connection
+
+#include "Bench.h"
+#include "Loopback.h"
+
+#include "Server/RelayLink.h"
+
+#include <boost/asio/io_context.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t SENDERS = 8;
+constexpr std::size_t FRAMES  = 2'000;
+
+struct Received {
+   std::mutex               mutex_{};
+   std::condition_variable  cv_{};
+   std::vector<std::string> frames_{};
+   std::size_t              disconnections_{};
+
+   template <class PREDICATE>
+   bool
+   WaitFor(PREDICATE&& predicate, std::chrono::seconds timeout = std::chrono::seconds{10}) {
+      std::unique_lock lock{mutex_};
+      return cv_.wait_for(lock, timeout, [&] { return predicate(*this); });
+   }
+};
+
+}  // namespace
+
+int
+main() {
+   std::atomic<std::size_t> hellos{};
+
+   bench::LoopbackServer upstream{[&](bench::LoopbackServer::Socket& ws) {
+      CHECK(bench::ReadFrame(ws) == "hello");
+      ++hellos;
+
+      while (true) {
+         ws.write(boost::asio::buffer(bench::ReadFrame(ws)));
+      }
+   }};
+
+   Received received{};
+
+   boost::asio::io_context ioc{};
+   auto const              link = std::make_shared<RelayLink>(
+     ioc,
+     "127.0.0.1",
+     std::to_string(upstream.Port()),
+     "hello",
+     [&](RelayLink::Frame&& frame) {
+        std::lock_guard lock{received.mutex_};
+        received.frames_.emplace_back(*frame);
+        received.cv_.notify_all();
+     },
+     [&] {
+        std::lock_guard lock{received.mutex_};
+        ++received.disconnections_;
+        received.cv_.notify_all();
+     }
+   );
+
+   // Reads and writes on two io threads, the strand keeps them apart
+   auto work = boost::asio::make_work_guard(ioc);
+   link->Start();
+   std::jthread io_a{[&] { ioc.run(); }};
+   std::jthread io_b{[&] { ioc.run(); }};
+
+   auto const wait_connected = [&] {
+      for (int i = 0; i < 500 && !link->Connected(); ++i) {
+         std::this_thread::sleep_for(std::chrono::milliseconds{10});
+      }
+      CHECK(link->Connected());
+   };
+
+   wait_connected();
+
+   {
+      std::vector<std::jthread> senders{};
+      for (std::size_t sender = 0; sender < SENDERS; ++sender) {
+         senders.emplace_back([&link, sender] {
+            for (std::size_t i = 0; i < FRAMES; ++i) {
+               link->Send(std::to_string(sender) + ":" + std::to_string(i));
+            }
+         });
+      }
+   }
+
+   CHECK(received.WaitFor([](Received& r) { return r.frames_.size() == SENDERS * FRAMES; }));
+   CHECK(hellos == 1);
+
+   {
+      std::lock_guard          lock{received.mutex_};
+      std::vector<std::size_t> next(SENDERS, 0);
+      for (auto const& frame : received.frames_) {
+         auto const sep    = frame.find(':');
+         auto const sender = std::stoul(frame.substr(0, sep));
+         CHECK(std::stoul(frame.substr(sep + 1)) == next[sender]++);
+      }
+   }
+
+   // Reconnection
+   upstream.Drop();
+   CHECK(received.WaitFor([](Received& r) { return r.disconnections_ == 1; }));
+
+   wait_connected();
+   CHECK(hellos == 2);
+
+   link->Send("again");
+   CHECK(received.WaitFor([](Received& r) { return r.frames_.back() == "again"; }));
+
+   link->Stop();
+   work.reset();
+   io_a = {};
+   io_b = {};
+
+   std::cout << "relay loopback: " << SENDERS * FRAMES << " frames echoed, reconnected"
+             << std::endl;
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,305 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Replays a capture of the server (--capture) on Linux through the replay processors of
+// SimConnect::Replay (ReplayRoutes, ReplaySink), at the recorded pace or as fast as possible.
+// Without a capture, one is first recorded from the stand-in : traffic samples issued like
+// SimConnect::SampleTraffic, airport facilities and facility lists, with injected exceptions. The
+// replay must then decode everything the recording received.
+//
+// simconnect_replay [capture] [--fast]
+
+#include "Bench.h"
+
+#include "SimConnect/Capture.h"
+#include "SimConnect/Data/DataId.h"
+#include "SimConnect/Data/TrafficInfo.h"
+#include "SimConnect/Data/TrafficStaticInfo.h"
+#include "SimConnect/Definitions.h"
+#include "SimConnect/FacilityData/AirportFacility.h"
+#include "SimConnect/Replay.h"
+
+#include <SimConnectStandIn.h>
+
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+
+namespace {
+
+using smc::DataId;
+
+// SimConnect::TRAFFIC_RADIUS
+constexpr DWORD TRAFFIC_RADIUS = 200'000;
+
+// Answers received by the recording, the replay must find the same
+struct Recorded {
+   std::size_t packets_{};
+   std::size_t traffic_samples_{};
+   std::size_t airports_{};
+   std::size_t list_packets_{};
+   std::size_t exceptions_{};
+};
+
+constexpr SIMCONNECT_DATA_DEFINITION_ID
+Define(DataId id) {
+   return static_cast<SIMCONNECT_DATA_DEFINITION_ID>(id);
+}
+
+Recorded
+Record(std::filesystem::path const& path, std::size_t samples) {
+   auto config            = smc::standin::DefaultConfig();
+   config.ai_aircraft_    = 300;
+   config.airports_       = 200;
+   config.exception_rate_ = 0.02;
+   smc::standin::SetConfig(config);
+
+   HANDLE handle{};
+   CHECK(SimConnect_Open(&handle, "simconnect_replay", nullptr, 0, nullptr, 0) == S_OK);
+   CHECK(smc::AddToDataDefinition<smc::TrafficPosition>(handle, Define(DataId::TRAFFIC_POSITION)));
+   CHECK(smc::AddToDataDefinition<smc::TrafficPosition>(
+     handle, Define(DataId::HELI_TRAFFIC_POSITION)
+   ));
+   CHECK(smc::AddToDataDefinition<smc::TrafficStaticInfo>(
+     handle, Define(DataId::TRAFFIC_STATIC_INFO)
+   ));
+   CHECK(smc::AddToFacilityDefinition<smc::facility::Airport>(
+     handle, Define(DataId::GET_AIRPORT_FACILITY)
+   ));
+
+   smc::CaptureWriter writer{path};
+   Recorded           recorded{};
+   DWORD              request_id{};
+   DWORD              aircraft_request{};
+
+   // Every request is settled by its last answer or by an exception
+   std::size_t pending{};
+   auto const  drain = [&] {
+      auto const deadline = bench::Clock::now() + std::chrono::seconds{10};
+      while (pending) {
+         CHECK(bench::Clock::now() < deadline);
+
+         SIMCONNECT_RECV* data{};
+         DWORD            size{};
+         if (SimConnect_GetNextDispatch(handle, &data, &size) != S_OK) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            continue;
+         }
+
+         writer.Write(std::span{reinterpret_cast<std::byte const*>(data), size});
+         ++recorded.packets_;
+
+         switch (data->dwID) {
+            case SIMCONNECT_RECV_ID_EXCEPTION:
+               ++recorded.exceptions_;
+               --pending;
+               break;
+
+            case SIMCONNECT_RECV_ID_SIMOBJECT_DATA:
+               --pending;
+               break;
+
+            case SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE: {
+               auto const& entry = *static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE*>(data);
+               if (entry.dwentrynumber >= entry.dwoutof) {
+                  --pending;
+                  if (entry.dwRequestID == aircraft_request) {
+                     ++recorded.traffic_samples_;
+                  }
+               }
+            } break;
+
+            case SIMCONNECT_RECV_ID_FACILITY_DATA_END:
+               ++recorded.airports_;
+               --pending;
+               break;
+
+            case SIMCONNECT_RECV_ID_AIRPORT_LIST: {
+               ++recorded.list_packets_;
+               auto const& list = *static_cast<SIMCONNECT_RECV_FACILITIES_LIST*>(data);
+               if (list.dwEntryNumber + 1 >= list.dwOutOf) {
+                  --pending;
+               }
+            } break;
+
+            default:
+               break;
+         }
+      }
+   };
+
+   CHECK(
+     SimConnect_RequestFacilitiesList(handle, SIMCONNECT_FACILITY_LIST_TYPE_AIRPORT, ++request_id)
+     == S_OK
+   );
+   ++pending;
+   drain();
+
+   for (std::size_t i = 0; i < samples; ++i) {
+      CHECK(
+        SimConnect_RequestDataOnSimObject(
+          handle,
+          ++request_id,
+          Define(DataId::TRAFFIC_POSITION),
+          SIMCONNECT_OBJECT_ID_USER,
+          SIMCONNECT_PERIOD_ONCE,
+          0,
+          0,
+          0,
+          0
+        )
+        == S_OK
+      );
+      aircraft_request = ++request_id;
+      CHECK(
+        SimConnect_RequestDataOnSimObjectType(
+          handle,
+          aircraft_request,
+          Define(DataId::TRAFFIC_POSITION),
+          TRAFFIC_RADIUS,
+          SIMCONNECT_SIMOBJECT_TYPE_AIRCRAFT
+        )
+        == S_OK
+      );
+      CHECK(
+        SimConnect_RequestDataOnSimObjectType(
+          handle,
+          ++request_id,
+          Define(DataId::HELI_TRAFFIC_POSITION),
+          TRAFFIC_RADIUS,
+          SIMCONNECT_SIMOBJECT_TYPE_HELICOPTER
+        )
+        == S_OK
+      );
+      pending += 3;
+
+      if (i % 4 == 0) {
+         // Airports "S000", "S001"...
+         auto const icao = "S00" + std::to_string(i / 4 % 10);
+         CHECK(
+           SimConnect_RequestFacilityData(
+             handle, Define(DataId::GET_AIRPORT_FACILITY), ++request_id, icao.c_str(), "", 0
+           )
+           == S_OK
+         );
+         ++pending;
+      }
+
+      drain();
+   }
+
+   CHECK(SimConnect_Close(handle) == S_OK);
+   return recorded;
+}
+
+struct Replayed {
+   smc::ReplaySink::Stats stats_{};
+   std::size_t            packets_{};
+   std::size_t            unbound_{};
+   std::size_t            exceptions_{};
+   double                 seconds_{};
+};
+
+// Same routing as SimConnect::ReplayPacket, the packets that aren't answers are only counted
+Replayed
+Replay(std::filesystem::path const& path, bool fast) {
+   smc::CaptureReader reader{path};
+   smc::ReplayRoutes  routes{};
+   smc::ReplaySink    sink{};
+   Replayed           replayed{};
+
+   auto const start = bench::Clock::now();
+   while (auto packet = reader.Next()) {
+      if (packet->data_.size() < sizeof(SIMCONNECT_RECV)) {
+         continue;
+      }
+
+      if (!fast) {
+         std::this_thread::sleep_until(start + packet->time_);
+      }
+
+      ++replayed.packets_;
+      auto& data = *reinterpret_cast<SIMCONNECT_RECV*>(packet->data_.data());
+      if (routes.Route(data, [&](SIMCONNECT_RECV const& answer) { return sink.Bind(answer); })
+          == smc::Routed::NOT_AN_ANSWER) {
+         if (data.dwID == SIMCONNECT_RECV_ID_EXCEPTION) {
+            ++replayed.exceptions_;
+         }
+      }
+   }
+
+   replayed.seconds_ = std::chrono::duration<double>(bench::Clock::now() - start).count();
+   replayed.stats_   = sink.GetStats();
+   replayed.unbound_ = routes.Unbound();
+   return replayed;
+}
+
+void
+Report(Replayed const& replayed) {
+   auto const& stats = replayed.stats_;
+   std::cout << "replayed " << replayed.packets_ << " packets in " << replayed.seconds_ << "s ("
+             << static_cast<double>(replayed.packets_) / replayed.seconds_ << " packets/s): "
+             << stats.airports_ << " airports (" << stats.facility_errors_ << " failed), "
+             << stats.traffic_samples_ << " traffic samples (" << stats.aircraft_
+             << " aircraft), " << stats.objects_ << " objects (" << stats.malformed_
+             << " malformed), " << replayed.exceptions_ << " exceptions, " << replayed.unbound_
+             << " answers not replayed" << std::endl;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   std::optional<std::filesystem::path> capture{};
+   bool                                 fast{false};
+   for (int i = 1; i < argc; ++i) {
+      if (std::strcmp(argv[i], "--fast") == 0) {
+         fast = true;
+      } else {
+         capture = argv[i];
+      }
+   }
+
+   if (capture) {
+      Report(Replay(*capture, fast));
+      return EXIT_SUCCESS;
+   }
+
+   auto const path     = std::filesystem::temp_directory_path() / "simconnect_replay.smccap";
+   auto const recorded = Record(path, 40);
+
+   // As fast as possible, then at the recorded pace
+   for (auto const as_fast : {true, false}) {
+      auto const  replayed = Replay(path, as_fast);
+      auto const& stats    = replayed.stats_;
+      Report(replayed);
+
+      CHECK(replayed.packets_ == recorded.packets_);
+      CHECK(replayed.exceptions_ == recorded.exceptions_);
+      CHECK(replayed.unbound_ == recorded.list_packets_);
+      CHECK(stats.traffic_samples_ == recorded.traffic_samples_);
+      CHECK(stats.airports_ == recorded.airports_);
+      CHECK(stats.facility_errors_ == 0);
+      CHECK(stats.malformed_ == 0);
+      CHECK(stats.aircraft_ > 0);
+   }
+
+   std::filesystem::remove(path);
+   return EXIT_SUCCESS;
+}
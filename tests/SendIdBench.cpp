@@ -0,0 +1,217 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Send id correlation (SimConnect::TrackRequestSendId, FindRequestIdForSendId) through the
+// SendIdRing, next to what it replaced : the send id stored on each pending request and scanned for
+// on an exception, and before that a std::map by send id. Requests are issued with a window of
+// them in flight, then the exceptions of recent calls are looked up (one per 16 calls).
+//
+// send_id_bench [calls] [in flight...]
+
+#include "Bench.h"
+
+#include "SimConnect/Utils/SendIdRing.h"
+#include "SimConnect/Utils/SlotMap.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Key = uint32_t;
+
+struct Pending {
+   std::optional<uint32_t> send_id_{};
+};
+
+using Requests = smc::SlotMap<Pending>;
+
+constexpr std::size_t RING = 2048;
+
+class Ring {
+public:
+   Key
+   Track(Requests& requests, uint32_t send_id) {
+      auto const key = requests.Insert({});
+      ring_.Insert(send_id, key);
+      return key;
+   }
+
+   void
+   Settle(Requests& requests, Key key) {
+      requests.Erase(key);
+   }
+
+   std::optional<Key>
+   Find(Requests& requests, uint32_t send_id) {
+      auto const key = ring_.Find(send_id);
+      if (!key || !requests.Find(*key)) {
+         return std::nullopt;
+      }
+      return key;
+   }
+
+private:
+   smc::SendIdRing<RING> ring_{};
+};
+
+class Scan {
+public:
+   Key
+   Track(Requests& requests, uint32_t send_id) {
+      return requests.Insert({.send_id_ = send_id});
+   }
+
+   void
+   Settle(Requests& requests, Key key) {
+      requests.Erase(key);
+   }
+
+   std::optional<Key>
+   Find(Requests& requests, uint32_t send_id) {
+      std::optional<Key> result{};
+      requests.ForEach([&](Key key, Pending const& pending) {
+         if (pending.send_id_ == send_id) {
+            result = key;
+         }
+      });
+      return result;
+   }
+};
+
+class Map {
+public:
+   Key
+   Track(Requests& requests, uint32_t send_id) {
+      auto const key = requests.Insert({});
+      by_send_id_.emplace(send_id, key);
+      by_key_.emplace(key, send_id);
+      return key;
+   }
+
+   void
+   Settle(Requests& requests, Key key) {
+      requests.Erase(key);
+      if (auto const it = by_key_.find(key); it != by_key_.end()) {
+         by_send_id_.erase(it->second);
+         by_key_.erase(it);
+      }
+   }
+
+   std::optional<Key>
+   Find(Requests&, uint32_t send_id) {
+      if (auto const it = by_send_id_.find(send_id); it != by_send_id_.end()) {
+         return it->second;
+      }
+      return std::nullopt;
+   }
+
+private:
+   std::map<uint32_t, Key> by_send_id_{};
+   std::map<Key, uint32_t> by_key_{};
+};
+
+struct Result {
+   double      track_{};   // ns per request, tracked then settled
+   double      lookup_{};  // ns per exception
+   std::size_t found_{};
+};
+
+template <class TRACKER>
+Result
+Run(std::size_t calls, std::size_t in_flight) {
+   Requests                             requests{};
+   TRACKER                              tracker{};
+   std::deque<std::pair<uint32_t, Key>> window{};
+   std::mt19937                         rng{42};
+   std::vector<uint32_t>                exceptions{};
+
+   uint32_t send_id = 1;
+   Result   result{};
+
+   auto const track = bench::Seconds([&] {
+      for (std::size_t i = 0; i < calls; ++i, ++send_id) {
+         window.emplace_back(send_id, tracker.Track(requests, send_id));
+
+         if (window.size() > in_flight) {
+            tracker.Settle(requests, window.front().second);
+            window.pop_front();
+         }
+      }
+   });
+
+   // Exceptions of recent calls, half of them settled since
+   for (std::size_t i = 0; i < calls / 16; ++i) {
+      exceptions.emplace_back(send_id - 1 - static_cast<uint32_t>(rng() % (2 * in_flight)));
+   }
+
+   auto const lookup = bench::Seconds([&] {
+      for (auto const id : exceptions) {
+         result.found_ += tracker.Find(requests, id).has_value();
+      }
+   });
+
+   // Exactly the calls still in flight are found
+   for (auto const& [id, key] : window) {
+      CHECK(tracker.Find(requests, id) == key);
+   }
+   CHECK(!tracker.Find(requests, window.front().first - 1));
+
+   result.track_  = track * 1e9 / static_cast<double>(calls);
+   result.lookup_ = lookup * 1e9 / static_cast<double>(exceptions.size());
+   return result;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   auto const calls = static_cast<std::size_t>(argc > 1 ? std::atof(argv[1]) : 1e6);
+
+   std::vector<std::size_t> windows{};
+   for (int i = 2; i < argc; ++i) {
+      windows.emplace_back(static_cast<std::size_t>(std::atof(argv[i])));
+   }
+   if (windows.empty()) {
+      windows = {64, 256, 1024};
+   }
+
+   for (auto const in_flight : windows) {
+      CHECK(in_flight < RING);
+
+      auto const ring = Run<Ring>(calls, in_flight);
+      auto const scan = Run<Scan>(calls, in_flight);
+      auto const map  = Run<Map>(calls, in_flight);
+
+      // Same exceptions, same answers
+      CHECK(ring.found_ == scan.found_ && ring.found_ == map.found_);
+      CHECK(ring.found_ && ring.found_ < calls / 16);
+
+      std::cout << in_flight << " in flight, per request / per exception : ring " << ring.track_
+                << "ns / " << ring.lookup_ << "ns, scan " << scan.track_ << "ns / "
+                << scan.lookup_ << "ns, std::map " << map.track_ << "ns / " << map.lookup_
+                << "ns" << std::endl;
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Sessions dropped by the expiry timer alone : an idle detached session goes once past its TTL,
+// without any other session event, while an attached one and one still within its TTL are kept
+
+#include "Bench.h"
+
+#include "Server/SessionExpiry.h"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+struct Session {
+   std::size_t                           id_{};
+   std::weak_ptr<int>                    socket_{};
+   std::chrono::steady_clock::time_point expiry_{};
+};
+
+constexpr auto TTL    = 100ms;
+constexpr auto PERIOD = 20ms;
+
+}  // namespace
+
+int
+main() {
+   boost::asio::io_context ioc{};
+   auto                    work = boost::asio::make_work_guard(ioc);
+
+   // Stands for the server message queue
+   std::mutex              mutex{};
+   std::condition_variable cv{};
+
+   std::unordered_map<std::string, std::shared_ptr<Session>> sessions{};
+   std::vector<std::size_t>                                  expired{};
+   std::chrono::steady_clock::time_point                     idle_dropped{};
+
+   auto const now    = std::chrono::steady_clock::now();
+   auto const socket = std::make_shared<int>();
+
+   sessions.emplace("idle", std::make_shared<Session>(1, std::weak_ptr<int>{}, now + TTL));
+   sessions.emplace("attached", std::make_shared<Session>(2, socket, now - 1s));
+   sessions.emplace("recent", std::make_shared<Session>(3, std::weak_ptr<int>{}, now + 1h));
+
+   PeriodicTimer timer{ioc, PERIOD, [&] {
+                          std::lock_guard lock{mutex};
+                          DropExpiredSessions(
+                            sessions, std::chrono::steady_clock::now(), [&](Session& session) {
+                               expired.emplace_back(session.id_);
+                               if (session.id_ == 1) {
+                                  idle_dropped = std::chrono::steady_clock::now();
+                               }
+                            }
+                          );
+                          cv.notify_all();
+                       }};
+   timer.Start();
+
+   std::vector<std::jthread> threads{};
+   for (int i = 0; i < 2; ++i) {
+      threads.emplace_back([&ioc] { ioc.run(); });
+   }
+
+   {
+      std::unique_lock lock{mutex};
+
+      CHECK(cv.wait_for(lock, 5s, [&] { return !sessions.contains("idle"); }));
+      CHECK(idle_dropped >= now + TTL);
+
+      CHECK((expired == std::vector<std::size_t>{1}));
+      CHECK(sessions.contains("attached") && sessions.contains("recent"));
+   }
+
+   // Detached past its expiry, dropped by a later tick
+   {
+      std::unique_lock lock{mutex};
+      sessions.at("recent")->expiry_ = std::chrono::steady_clock::now();
+
+      CHECK(cv.wait_for(lock, 5s, [&] { return !sessions.contains("recent"); }));
+      CHECK((expired == std::vector<std::size_t>{1, 3}));
+      CHECK(sessions.contains("attached"));
+   }
+
+   ioc.stop();
+   threads.clear();
+
+   std::cout << "idle detached sessions dropped by the expiry timer" << std::endl;
+   return EXIT_SUCCESS;
+}
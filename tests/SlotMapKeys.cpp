@@ -0,0 +1,97 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// SlotMap keys : an erased key never matches again, a slot whose generations are exhausted is
+// retired instead of wrapping back to keys already handed out, 64 bits keys go past it.
+
+#include "Bench.h"
+
+#include "SimConnect/Utils/SlotMap.h"
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace {
+
+template <class KEY>
+std::vector<KEY>
+Churn(smc::SlotMap<int, KEY>& map, std::size_t count) {
+   std::vector<KEY> keys{};
+   for (std::size_t i = 0; i < count; ++i) {
+      auto const key = map.Insert(static_cast<int>(i));
+      CHECK(key != 0);
+      CHECK(map.Find(key) && *map.Find(key) == static_cast<int>(i));
+      CHECK(map.Erase(key));
+      CHECK(!map.Erase(key));
+      keys.emplace_back(key);
+   }
+   return keys;
+}
+
+}  // namespace
+
+int
+main() {
+   using Map32 = smc::SlotMap<int>;
+
+   // One live value keeps its key while the others churn through the same slots
+   {
+      Map32      map{};
+      auto const live = map.Insert(-1);
+
+      auto const keys = Churn(map, 3 * Map32::GENERATION_MASK);
+      CHECK(std::set(keys.begin(), keys.end()).size() == keys.size());
+      CHECK(map.Find(live) && *map.Find(live) == -1);
+
+      // Every stale key misses, with a value in each of the slots they used
+      std::vector<Map32::Key> fresh{};
+      for (int i = 0; i < 8; ++i) {
+         fresh.emplace_back(map.Insert(int{i}));
+      }
+      for (auto const key : keys) {
+         CHECK(!map.Find(key));
+      }
+      CHECK(map.size() == fresh.size() + 1);
+   }
+
+   // The slot is retired after its last generation, the next insertion takes a new one
+   {
+      Map32      map{};
+      auto const keys = Churn(map, Map32::GENERATION_MASK);
+      for (auto const key : keys) {
+         CHECK((key & Map32::INDEX_MASK) == 0);
+      }
+      CHECK((keys.back() >> Map32::INDEX_BITS) == Map32::GENERATION_MASK);
+
+      auto const next = map.Insert(0);
+      CHECK((next & Map32::INDEX_MASK) == 1);
+      CHECK(!map.Find(keys.front()) && !map.Find(keys.back()));
+   }
+
+   // 64 bits keys keep reusing the slot
+   {
+      smc::SlotMap<int, uint64_t> map{};
+      auto const keys = Churn(map, 2 * Map32::GENERATION_MASK);
+      for (auto const key : keys) {
+         CHECK((key & Map32::INDEX_MASK) == 0);
+      }
+      CHECK((keys.back() >> Map32::INDEX_BITS) == 2 * Map32::GENERATION_MASK);
+   }
+
+   std::cout << "slot map keys: no stale key matched" << std::endl;
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,322 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Load of the request machinery against the stand-in world (500 AI aircraft, 20,000 airports by
+// default, SMC_STANDIN_* to override) : each connection runs on its own thread like the
+// SimConnect thread, keeps in_flight requests outstanding through the request registry, routes
+// the answers with RouteAnswer and the injected exceptions through a SendIdRing. Every request
+// must be settled exactly once, by its answer or by an exception.
+//
+// standin_load [connections] [seconds] [in_flight]
+
+#include "Bench.h"
+
+#include "SimConnect/Data/DataId.h"
+#include "SimConnect/Data/TrafficInfo.h"
+#include "SimConnect/Definitions.h"
+#include "SimConnect/FacilityData/AirportFacility.h"
+#include "SimConnect/Requests.h"
+#include "SimConnect/Utils/ByTypeCount.h"
+#include "SimConnect/Utils/SendIdRing.h"
+
+#include <SimConnectStandIn.h>
+
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using smc::DataId;
+
+enum class Kind { OBJECT, BY_TYPE, AIRPORT };
+
+// Issue time, kept by the registry like the reject of a SimConnect request
+struct Issued {
+   bench::Clock::time_point start_{};
+   Kind                     kind_{};
+};
+
+struct Totals {
+   std::size_t    issued_{};
+   std::size_t    answered_{};
+   std::size_t    exceptions_{};
+   std::size_t    packets_{};
+   std::size_t    lost_exceptions_{};  // Exceptions matching no pending request
+   bench::Samples object_latency_{};  // us
+   bench::Samples by_type_latency_{};
+   bench::Samples airport_latency_{};
+};
+
+constexpr SIMCONNECT_DATA_DEFINITION_ID
+Define(DataId id) {
+   return static_cast<SIMCONNECT_DATA_DEFINITION_ID>(id);
+}
+
+// Stand-in airports are "S" followed by their index in base 36
+std::string
+AirportIdent(std::size_t index) {
+   static constexpr std::string_view DIGITS = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+   std::string ident = "S";
+   for (std::size_t n = 0; n < 3; ++n, index /= DIGITS.size()) {
+      ident.insert(1, 1, DIGITS[index % DIGITS.size()]);
+   }
+   return ident;
+}
+
+class Client {
+public:
+   Client(std::size_t in_flight, uint32_t seed)
+      : in_flight_{in_flight}
+      , engine_{seed} {
+      CHECK(SimConnect_Open(&handle_, "standin_load", nullptr, 0, nullptr, 0) == S_OK);
+      CHECK(
+        smc::AddToDataDefinition<smc::TrafficPosition>(handle_, Define(DataId::TRAFFIC_POSITION))
+      );
+      CHECK(smc::AddToFacilityDefinition<smc::facility::Airport>(
+        handle_, Define(DataId::GET_AIRPORT_FACILITY)
+      ));
+   }
+
+   ~Client() { SimConnect_Close(handle_); }
+
+   Client(Client const&)            = delete;
+   Client& operator=(Client const&) = delete;
+
+   void
+   Run(bench::Clock::time_point end) {
+      auto const deadline = end + std::chrono::seconds{10};
+
+      while (true) {
+         auto const now = bench::Clock::now();
+         if (now < end) {
+            while (requests_.size() < in_flight_) {
+               Issue();
+            }
+         } else if (requests_.empty()) {
+            break;
+         }
+         CHECK(now < deadline);
+
+         SIMCONNECT_RECV* data{};
+         DWORD            size{};
+         if (SimConnect_GetNextDispatch(handle_, &data, &size) != S_OK) {
+            std::this_thread::yield();
+            continue;
+         }
+
+         ++totals_.packets_;
+         if (data->dwID == SIMCONNECT_RECV_ID_EXCEPTION) {
+            OnException(*static_cast<SIMCONNECT_RECV_EXCEPTION*>(data));
+         } else {
+            CHECK(smc::RouteAnswer(requests_, *data) != smc::Routed::UNKNOWN_REQUEST);
+         }
+      }
+   }
+
+   Totals&
+   GetTotals() {
+      return totals_;
+   }
+
+private:
+   void
+   Issue() {
+      auto const roll = std::uniform_int_distribution<int>{0, 99}(engine_);
+      auto const kind = roll < 85 ? Kind::OBJECT : roll < 90 ? Kind::BY_TYPE : Kind::AIRPORT;
+
+      auto const request_id = requests_.Insert({
+        .reject_ = std::make_shared<Issued const>(Issued{bench::Clock::now(), kind}),
+      });
+      auto& request = *requests_.Find(request_id);
+
+      HRESULT result{};
+      switch (kind) {
+         case Kind::OBJECT: {
+            request.handler_ = smc::SimObjectHandler{
+              [this, request_id](
+                SIMCONNECT_RECV_SIMOBJECT_DATA const&, std::chrono::steady_clock::time_point const&
+              ) { Settle(request_id, true); }
+            };
+            // User aircraft or one of the AI, unknown ids are answered by an exception
+            auto const object_id = std::uniform_int_distribution<DWORD>{0, 500}(engine_);
+            result               = SimConnect_RequestDataOnSimObject(
+              handle_,
+              request_id,
+              Define(DataId::TRAFFIC_POSITION),
+              object_id,
+              SIMCONNECT_PERIOD_ONCE,
+              0,
+              0,
+              0,
+              0
+            );
+         } break;
+
+         case Kind::BY_TYPE: {
+            request.handler_ = smc::SimObjectTypeHandler{
+              [this, request_id, count = smc::ByTypeCount{}](
+                SIMCONNECT_RECV_SIMOBJECT_DATA_BYTYPE const& entry
+              ) mutable {
+                 if (!count.Receive(entry) || count.Done()) {
+                    Settle(request_id, true);
+                 }
+              }
+            };
+            result = SimConnect_RequestDataOnSimObjectType(
+              handle_,
+              request_id,
+              Define(DataId::TRAFFIC_POSITION),
+              200'000,
+              SIMCONNECT_SIMOBJECT_TYPE_AIRCRAFT
+            );
+         } break;
+
+         case Kind::AIRPORT: {
+            request.handler_ = smc::FacilityHandler{[this, request_id](
+                                                      smc::FacilityData const& answer
+                                                    ) {
+               if (std::holds_alternative<
+                     std::reference_wrapper<SIMCONNECT_RECV_FACILITY_DATA_END const>>(answer)) {
+                  Settle(request_id, true);
+               }
+            }};
+            auto const ident =
+              AirportIdent(std::uniform_int_distribution<std::size_t>{0, 19'999}(engine_));
+            result = SimConnect_RequestFacilityData(
+              handle_, Define(DataId::GET_AIRPORT_FACILITY), request_id, ident.c_str(), "", 0
+            );
+         } break;
+      }
+      CHECK(result == S_OK);
+
+      DWORD send_id{};
+      CHECK(SimConnect_GetLastSentPacketID(handle_, &send_id) == S_OK);
+      send_ids_.Insert(send_id, request_id);
+      ++totals_.issued_;
+   }
+
+   void
+   OnException(SIMCONNECT_RECV_EXCEPTION const& exception) {
+      auto const request_id = send_ids_.Find(exception.dwSendID);
+      if (!request_id || !requests_.Find(*request_id)) {
+         ++totals_.lost_exceptions_;
+         return;
+      }
+      Settle(*request_id, false);
+   }
+
+   void
+   Settle(SIMCONNECT_DATA_REQUEST_ID request_id, bool answered) {
+      auto const request = requests_.Find(request_id);
+      CHECK(request);
+
+      auto const& issued  = *request->reject_;
+      auto const  latency = bench::Micros(bench::Clock::now() - issued.start_);
+      if (answered) {
+         ++totals_.answered_;
+         switch (issued.kind_) {
+            case Kind::OBJECT:
+               totals_.object_latency_.Add(latency);
+               break;
+            case Kind::BY_TYPE:
+               totals_.by_type_latency_.Add(latency);
+               break;
+            case Kind::AIRPORT:
+               totals_.airport_latency_.Add(latency);
+               break;
+         }
+      } else {
+         ++totals_.exceptions_;
+      }
+
+      CHECK(requests_.Erase(request_id));
+   }
+
+   HANDLE                handle_{};
+   std::size_t           in_flight_;
+   std::mt19937          engine_;
+   smc::Requests<Issued> requests_{};
+   smc::SendIdRing<1024> send_ids_{};
+   Totals                totals_{};
+};
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   auto const arg = [&](int index, double value) {
+      return index < argc ? std::atof(argv[index]) : value;
+   };
+
+   auto const connections = static_cast<std::size_t>(arg(1, 4));
+   auto const duration    = std::chrono::duration<double>{arg(2, 3.)};
+   auto const in_flight   = static_cast<std::size_t>(arg(3, 256));
+
+   auto config            = smc::standin::DefaultConfig();
+   config.latency_        = std::chrono::microseconds{500};
+   config.jitter_         = std::chrono::microseconds{1000};
+   config.exception_rate_ = 0.01;
+   smc::standin::SetConfig(config);
+
+   std::vector<std::unique_ptr<Client>> clients{};
+   for (std::size_t i = 0; i < connections; ++i) {
+      clients.emplace_back(std::make_unique<Client>(in_flight, static_cast<uint32_t>(i + 1)));
+   }
+
+   auto const end = bench::Clock::now()
+                    + std::chrono::duration_cast<bench::Clock::duration>(duration);
+   auto const seconds = bench::Seconds([&] {
+      std::vector<std::jthread> threads{};
+      for (auto& client : clients) {
+         threads.emplace_back([&client, end] { client->Run(end); });
+      }
+   });
+
+   Totals totals{};
+   for (auto& client : clients) {
+      auto& client_totals     = client->GetTotals();
+      totals.issued_          += client_totals.issued_;
+      totals.answered_        += client_totals.answered_;
+      totals.exceptions_      += client_totals.exceptions_;
+      totals.packets_         += client_totals.packets_;
+      totals.lost_exceptions_ += client_totals.lost_exceptions_;
+      totals.object_latency_.Add(client_totals.object_latency_.Percentile(99.));
+      totals.by_type_latency_.Add(client_totals.by_type_latency_.Percentile(99.));
+      totals.airport_latency_.Add(client_totals.airport_latency_.Percentile(99.));
+   }
+
+   // Worst connection, answers are delivered once per sim frame
+   totals.object_latency_.Report("object request p99 latency", "us");
+   totals.by_type_latency_.Report("by type request p99 latency", "us");
+   totals.airport_latency_.Report("airport request p99 latency", "us");
+
+   std::cout << connections << " connections, " << in_flight << " in flight each: "
+             << totals.issued_ << " requests (" << static_cast<double>(totals.issued_) / seconds
+             << "/s), " << totals.packets_ << " packets ("
+             << static_cast<double>(totals.packets_) / seconds << "/s), " << totals.exceptions_
+             << " exceptions" << std::endl;
+
+   // Every request settled once, every exception matched its request
+   CHECK(totals.answered_ + totals.exceptions_ == totals.issued_);
+   CHECK(totals.lost_exceptions_ == 0);
+   CHECK(totals.exceptions_ > 0);
+   return EXIT_SUCCESS;
+}
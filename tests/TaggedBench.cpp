@@ -0,0 +1,356 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// User aircraft subscribed every sim frame twice on the stand-in : the full TrafficInfo, and the
+// changed-only tagged samples (SIMCONNECT_DATA_REQUEST_FLAG_CHANGED | TAGGED) applied onto a
+// persistent struct by wire::ApplyTagged, which must then match the full decode. Bytes per second
+// are compared in flight and parked, then the decoding for a given count of changed fields.
+//
+// tagged_bench [seconds] [--rate HZ]
+
+#include "Bench.h"
+
+#include "SimConnect/Data/DataId.h"
+#include "SimConnect/Data/TrafficInfo.h"
+#include "SimConnect/Definitions.h"
+#include "SimConnect/Utils/Wire.h"
+
+#include <SimConnectStandIn.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using smc::DataId;
+using smc::TrafficInfo;
+
+constexpr SIMCONNECT_DATA_DEFINITION_ID INIT_POSITION = 1000;
+
+constexpr DWORD FULL_REQUEST   = 1;
+constexpr DWORD TAGGED_REQUEST = 2;
+
+using Members = std::remove_cvref_t<decltype(TrafficInfo::MEMBERS)>;
+
+constexpr std::size_t FIELDS = std::tuple_size_v<Members>;
+
+constexpr auto HEADER_SIZE =
+  sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA::dwData);
+
+constexpr SIMCONNECT_DATA_DEFINITION_ID
+Define(DataId id) {
+   return static_cast<SIMCONNECT_DATA_DEFINITION_ID>(id);
+}
+
+bool
+Same(TrafficInfo const& lhs, TrafficInfo const& rhs) {
+   return std::apply(
+     [&](auto const&... member) {
+        return ((lhs.*std::get<0>(member) == rhs.*std::get<0>(member)) && ...);
+     },
+     TrafficInfo::MEMBERS
+   );
+}
+
+struct Stream {
+   std::size_t    packets_{};
+   std::size_t    bytes_{};
+   bench::Samples fields_{};
+};
+
+struct Phase {
+   Stream full_{};
+   Stream tagged_{};
+
+   // Last full payload
+   std::vector<std::byte> payload_{};
+};
+
+// Receives both subscriptions for the given duration, every tagged sample is checked against the
+// full sample of the same frame
+Phase
+Run(HANDLE handle, std::chrono::duration<double> duration, TrafficInfo& full, TrafficInfo& tagged) {
+   Phase      phase{};
+   auto const end = bench::Clock::now() + duration;
+
+   while (bench::Clock::now() < end) {
+      SIMCONNECT_RECV* data{};
+      DWORD            size{};
+      if (SimConnect_GetNextDispatch(handle, &data, &size) != S_OK) {
+         std::this_thread::sleep_for(std::chrono::microseconds{200});
+         continue;
+      }
+
+      CHECK(data->dwID != SIMCONNECT_RECV_ID_EXCEPTION);
+      if (data->dwID != SIMCONNECT_RECV_ID_SIMOBJECT_DATA) {
+         continue;
+      }
+
+      auto const& answer = *static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(data);
+
+      if (answer.dwRequestID == FULL_REQUEST) {
+         CHECK(size == HEADER_SIZE + smc::wire::WireSize<TrafficInfo>());
+         full = smc::wire::Read<TrafficInfo>(answer.dwData);
+
+         auto const payload = reinterpret_cast<std::byte const*>(&answer.dwData);
+         phase.payload_.assign(payload, payload + (size - HEADER_SIZE));
+
+         phase.full_.packets_ += 1;
+         phase.full_.bytes_   += size;
+         phase.full_.fields_.Add(static_cast<double>(answer.dwDefineCount));
+      } else {
+         CHECK(answer.dwRequestID == TAGGED_REQUEST);
+         auto const dirty = smc::wire::ApplyTagged(answer, tagged);
+         CHECK(dirty && (static_cast<std::size_t>(std::popcount(*dirty)) == answer.dwDefineCount));
+         CHECK(Same(tagged, full));
+
+         phase.tagged_.packets_ += 1;
+         phase.tagged_.bytes_   += size;
+         phase.tagged_.fields_.Add(static_cast<double>(answer.dwDefineCount));
+      }
+   }
+
+   return phase;
+}
+
+void
+Report(std::string_view name, Phase& phase, double seconds) {
+   auto const line = [&](std::string_view stream, Stream& values) {
+      auto const per_packet =
+        values.packets_ ? static_cast<double>(values.bytes_) / static_cast<double>(values.packets_)
+                        : 0.;
+
+      std::cout << name << " " << stream << ": " << values.packets_ << " packets, "
+                << per_packet << " B/packet, " << static_cast<double>(values.bytes_) / seconds
+                << " B/s, fields p50=" << values.fields_.Percentile(50.) << std::endl;
+   };
+
+   line("full  ", phase.full_);
+   line("tagged", phase.tagged_);
+   std::cout << name << " tagged/full : "
+             << static_cast<double>(phase.tagged_.bytes_) / static_cast<double>(phase.full_.bytes_)
+             << std::endl;
+}
+
+// Datum sizes and offsets in the full payload, by datum id
+struct Layout {
+   std::array<std::size_t, FIELDS> offsets_{};
+   std::array<std::size_t, FIELDS> sizes_{};
+};
+
+template <std::size_t I>
+using Value = typename smc::wire::WireType<
+  std::tuple_element_t<2, std::tuple_element_t<I, Members>>::VALUE_S>::type;
+
+constexpr Layout LAYOUT = []<std::size_t... INDEX>(std::index_sequence<INDEX...>) {
+   Layout layout{};
+   ((layout.sizes_[INDEX] = sizeof(Value<INDEX>)), ...);
+
+   std::size_t offset = 0;
+   for (std::size_t i = 0; i < FIELDS; ++i) {
+      layout.offsets_[i]  = offset;
+      offset             += layout.sizes_[i];
+   }
+   return layout;
+}(std::make_index_sequence<FIELDS>{});
+
+// SIMOBJECT_DATA packet with the whole payload, or the (datum id, value) pairs of the changed
+// fields spread over the definition
+std::vector<std::byte>
+Packet(std::vector<std::byte> const& payload, std::size_t changed) {
+   SIMCONNECT_RECV_SIMOBJECT_DATA data{};
+   data.dwID          = SIMCONNECT_RECV_ID_SIMOBJECT_DATA;
+   data.dwRequestID   = changed ? TAGGED_REQUEST : FULL_REQUEST;
+   data.dwDefineCount = static_cast<DWORD>(changed ? changed : FIELDS);
+
+   std::vector<std::byte> packet(HEADER_SIZE);
+   auto const             append = [&](void const* value, std::size_t size) {
+      auto const offset = packet.size();
+      packet.resize(offset + size);
+      std::memcpy(packet.data() + offset, value, size);
+   };
+
+   if (!changed) {
+      append(payload.data(), payload.size());
+   } else {
+      for (std::size_t i = 0; i < changed; ++i) {
+         auto const datum = static_cast<DWORD>(i * FIELDS / changed);
+         append(&datum, sizeof(datum));
+         append(payload.data() + LAYOUT.offsets_[datum], LAYOUT.sizes_[datum]);
+      }
+   }
+
+   data.dwSize = static_cast<DWORD>(packet.size());
+   std::memcpy(packet.data(), &data, HEADER_SIZE);
+
+   // Room for the trailing dwData of the struct view
+   packet.resize(std::max(packet.size(), sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA)));
+   return packet;
+}
+
+// Nanoseconds per decode of the packet
+template <class FN>
+double
+Decode(std::size_t runs, FN&& decode) {
+   return bench::Seconds([&] {
+             for (std::size_t i = 0; i < runs; ++i) {
+                decode();
+             }
+          })
+          * 1e9 / static_cast<double>(runs);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   double seconds = 3.;
+   double rate    = 60.;
+
+   for (int i = 1; i < argc; ++i) {
+      std::string_view const arg{argv[i]};
+      if ((arg == "--rate") && (i + 1 < argc)) {
+         rate = std::atof(argv[++i]);
+      } else {
+         seconds = std::atof(argv[i]);
+      }
+   }
+   CHECK((seconds > 0.) && (rate > 0.));
+
+   auto config         = smc::standin::DefaultConfig();
+   config.ai_aircraft_ = 10;
+   config.airports_    = 10;
+   config.sim_frame_   = std::chrono::milliseconds{static_cast<int>(1000. / rate)};
+   config.latency_     = {};
+   config.jitter_      = {};
+   smc::standin::SetConfig(config);
+
+   HANDLE handle{};
+   CHECK(SimConnect_Open(&handle, "tagged_bench", nullptr, 0, nullptr, 0) == S_OK);
+   CHECK(smc::AddToDataDefinition<TrafficInfo>(handle, Define(DataId::TRAFFIC_INFO)));
+   CHECK(smc::AddToTaggedDataDefinition<TrafficInfo>(handle, Define(DataId::TAGGED_TRAFFIC_INFO)));
+   CHECK(smc::AddToDataDefinition(
+     handle, INIT_POSITION, "Initial Position", SIMCONNECT_DATATYPE_INITPOSITION, std::nullopt, 0
+   ));
+
+   // Full first : both are sampled in the request order on each frame
+   CHECK(
+     SimConnect_RequestDataOnSimObject(
+       handle,
+       FULL_REQUEST,
+       Define(DataId::TRAFFIC_INFO),
+       SIMCONNECT_OBJECT_ID_USER,
+       SIMCONNECT_PERIOD_SIM_FRAME
+     )
+     == S_OK
+   );
+   CHECK(
+     SimConnect_RequestDataOnSimObject(
+       handle,
+       TAGGED_REQUEST,
+       Define(DataId::TAGGED_TRAFFIC_INFO),
+       SIMCONNECT_OBJECT_ID_USER,
+       SIMCONNECT_PERIOD_SIM_FRAME,
+       SIMCONNECT_DATA_REQUEST_FLAG_CHANGED | SIMCONNECT_DATA_REQUEST_FLAG_TAGGED
+     )
+     == S_OK
+   );
+
+   TrafficInfo full{};
+   TrafficInfo tagged{};
+   auto const  duration = std::chrono::duration<double>{seconds};
+
+   std::cout << "user aircraft at " << rate << " Hz, " << HEADER_SIZE << " B header, "
+             << smc::wire::WireSize<TrafficInfo>() << " B full TrafficInfo (" << FIELDS
+             << " fields)" << std::endl;
+
+   auto flight = Run(handle, duration, full, tagged);
+   CHECK(flight.full_.packets_ && flight.tagged_.packets_);
+   Report("flight", flight, seconds);
+
+   SIMCONNECT_DATA_INITPOSITION const parked{
+     .Latitude  = full.lat_,
+     .Longitude = full.lon_,
+     .Altitude  = 0.,
+     .Pitch     = 0.,
+     .Bank      = 0.,
+     .Heading   = 0.,
+     .OnGround  = 1,
+     .Airspeed  = 0
+   };
+   CHECK(
+     SimConnect_SetDataOnSimObject(
+       handle,
+       INIT_POSITION,
+       SIMCONNECT_OBJECT_ID_USER,
+       0,
+       1,
+       sizeof(parked),
+       const_cast<SIMCONNECT_DATA_INITPOSITION*>(&parked)
+     )
+     == S_OK
+   );
+
+   // The frames around the landing are left out
+   Run(handle, std::chrono::duration<double>{0.2}, full, tagged);
+   auto ground = Run(handle, duration, full, tagged);
+   CHECK(ground.full_.packets_);
+   Report("parked", ground, seconds);
+
+   CHECK(SimConnect_Close(handle) == S_OK);
+
+   // Decoding of the flight values, for a count of changed fields
+   auto const& payload     = flight.payload_;
+   auto const  full_packet = Packet(payload, 0);
+   auto const& full_data   =
+     *reinterpret_cast<SIMCONNECT_RECV_SIMOBJECT_DATA const*>(full_packet.data());
+
+   constexpr std::size_t RUNS = 1'000'000;
+
+   auto const full_ns = Decode(RUNS, [&] {
+      bench::Keep(smc::wire::Read<TrafficInfo>(full_data.dwData));
+   });
+   std::cout << "decode full  : " << full_packet.size() << " B/packet, "
+             << static_cast<double>(full_packet.size()) * rate << " B/s, " << full_ns << " ns"
+             << std::endl;
+
+   for (std::size_t const changed : {1uz, 3uz, 15uz, FIELDS}) {
+      auto const  packet = Packet(payload, changed);
+      auto const& data   = *reinterpret_cast<SIMCONNECT_RECV_SIMOBJECT_DATA const*>(packet.data());
+      CHECK(smc::wire::ApplyTagged(data, tagged));
+
+      auto const ns = Decode(RUNS, [&] {
+         bench::Keep(smc::wire::ApplyTagged(data, tagged));
+         bench::Keep(tagged);
+      });
+      std::cout << "decode tagged " << changed << " fields : " << data.dwSize << " B/packet, "
+                << static_cast<double>(data.dwSize) * rate << " B/s, " << ns << " ns"
+                << std::endl;
+   }
+
+   return EXIT_SUCCESS;
+}
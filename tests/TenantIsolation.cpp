@@ -0,0 +1,166 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Tenant isolation of the server writes, in process : the sockets of two tenants are written from
+// the same caller (the server message queue) and share the io threads. The viewer of the slow
+// tenant stops reading, its frames pile up in its own queue while the quiet tenant still gets its
+// frames, then the slow viewer catches up with all of its frames in order.
+
+#include "Bench.h"
+
+#include "Server/WriteQueue.h"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace net   = boost::asio;
+namespace beast = boost::beast;
+using tcp       = net::ip::tcp;
+using namespace std::chrono_literals;
+
+// 32 MiB, way past the loopback socket buffers
+constexpr std::size_t SLOW_FRAMES  = 512;
+constexpr std::size_t FRAME_SIZE   = 64 * 1024;
+constexpr std::size_t QUIET_FRAMES = 100;
+
+// Server side socket of a tenant, owned as EFBWebSocket owns it
+struct Seat : std::enable_shared_from_this<Seat> {
+   Seat(net::io_context& ioc, tcp::socket socket)
+      : ws_{std::move(socket)}
+      , writes_{ioc, ws_} {}
+
+   void
+   Write(std::string frame) {
+      writes_.Write(shared_from_this(), std::move(frame));
+   }
+
+   // Queued frames, read on the strand
+   std::size_t
+   Queued() {
+      std::promise<std::size_t> size{};
+      net::post(writes_.GetStrand(), [&] { size.set_value(writes_.Size()); });
+      return size.get_future().get();
+   }
+
+   WriteQueue::Stream ws_;
+   WriteQueue         writes_;
+};
+
+struct Tenant {
+   std::shared_ptr<Seat>               seat_{};
+   std::unique_ptr<WriteQueue::Stream> viewer_{};
+};
+
+Tenant
+Connect(net::io_context& ioc, tcp::acceptor& acceptor) {
+   Tenant tenant{.viewer_ = std::make_unique<WriteQueue::Stream>(ioc)};
+
+   tenant.viewer_->next_layer().connect(acceptor.local_endpoint());
+   tenant.seat_ = std::make_shared<Seat>(ioc, acceptor.accept());
+
+   std::jthread accept{[&seat = *tenant.seat_] { seat.ws_.accept(); }};
+   tenant.viewer_->handshake("127.0.0.1", "/");
+   return tenant;
+}
+
+std::string
+ReadFrame(WriteQueue::Stream& ws) {
+   beast::flat_buffer buffer{};
+   ws.read(buffer);
+   return beast::buffers_to_string(buffer.data());
+}
+
+}  // namespace
+
+int
+main() {
+   net::io_context ioc{};
+   auto            work = net::make_work_guard(ioc);
+   tcp::acceptor   acceptor{ioc, {net::ip::make_address("127.0.0.1"), 0}};
+
+   auto slow  = Connect(ioc, acceptor);
+   auto quiet = Connect(ioc, acceptor);
+
+   std::vector<std::jthread> threads{};
+   for (int i = 0; i < 2; ++i) {
+      threads.emplace_back([&ioc] { ioc.run(); });
+   }
+
+   std::mutex              mutex{};
+   std::condition_variable cv{};
+   std::size_t             received{};
+
+   std::jthread quiet_viewer{[&] {
+      for (std::size_t i = 0; i < QUIET_FRAMES; ++i) {
+         auto const frame = ReadFrame(*quiet.viewer_);
+
+         std::lock_guard lock{mutex};
+         if (frame == std::to_string(i)) {
+            ++received;
+         }
+         cv.notify_all();
+      }
+   }};
+
+   // Stands for the server message queue, the slow tenant is written first
+   auto const queued = bench::Seconds([&] {
+      for (std::size_t i = 0; i < SLOW_FRAMES; ++i) {
+         slow.seat_->Write(std::string(FRAME_SIZE, static_cast<char>('a' + i % 26)));
+      }
+
+      for (std::size_t i = 0; i < QUIET_FRAMES; ++i) {
+         quiet.seat_->Write(std::to_string(i));
+      }
+   });
+
+   auto const start = bench::Clock::now();
+   {
+      std::unique_lock lock{mutex};
+      CHECK(cv.wait_for(lock, 10s, [&] { return received == QUIET_FRAMES; }));
+   }
+   auto const delivered = bench::Clock::now() - start;
+
+   // Still stalled behind its viewer
+   auto const backlog = slow.seat_->Queued();
+   CHECK(backlog > 0);
+
+   for (std::size_t i = 0; i < SLOW_FRAMES; ++i) {
+      auto const frame = ReadFrame(*slow.viewer_);
+      CHECK(frame == std::string(FRAME_SIZE, static_cast<char>('a' + i % 26)));
+   }
+   CHECK(slow.seat_->Queued() == 0);
+
+   std::cout << "writes queued in " << queued * 1e6 << "us, quiet tenant served in "
+             << bench::Micros(delivered) << "us while " << backlog << "/" << SLOW_FRAMES
+             << " frames of the slow tenant were waiting" << std::endl;
+
+   quiet_viewer = {};
+   ioc.stop();
+   threads.clear();
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,301 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Per-tenant latency of a running server: every tenant has an EFB broadcasting plane positions to
+// its viewers. The quiet tenants are first measured alone, then next to a noisy tenant sending
+// NOISY times more, their latency shouldn't move.
+//
+// VFRNAV_SERVER=host:port tenant_load [tenants] [viewers] [rate_hz] [noisy] [seconds]
+
+#include "Bench.h"
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <atomic>
+#include <barrier>
+#include <charconv>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace net       = boost::asio;
+namespace beast     = boost::beast;
+namespace websocket = beast::websocket;
+using tcp           = net::ip::tcp;
+
+struct Target {
+   std::string host_{};
+   std::string port_{};
+};
+
+using Socket = websocket::stream<tcp::socket>;
+
+std::unique_ptr<Socket>
+Connect(
+  net::io_context&   ioc,
+  Target const&      target,
+  std::string const& type,
+  std::string const& tenant
+) {
+   tcp::resolver resolver{ioc};
+   auto          ws = std::make_unique<Socket>(ioc);
+
+   net::connect(ws->next_layer(), resolver.resolve(target.host_, target.port_));
+   ws->next_layer().set_option(tcp::no_delay{true});
+   ws->handshake(target.host_, "/");
+   ws->text(true);
+   ws->write(net::buffer(
+     R"({"__HELLO_WORLD__":")" + type + R"(","tenant":")" + tenant + R"("})"
+   ));
+   return ws;
+}
+
+std::size_t
+Now() {
+   return static_cast<std::size_t>(
+     std::chrono::duration_cast<std::chrono::nanoseconds>(bench::Clock::now().time_since_epoch())
+       .count()
+   );
+}
+
+// Date of a plane position frame, 0 ends the phase, nullopt for other messages
+std::optional<std::size_t>
+PlanePosDate(std::string_view frame) {
+   if (frame.find("__PLANE_POS__") == std::string_view::npos) {
+      return std::nullopt;
+   }
+
+   static constexpr std::string_view DATE{"\"date\":"};
+   auto const                        pos = frame.find(DATE);
+   if (pos == std::string_view::npos) {
+      return std::nullopt;
+   }
+
+   std::size_t date{};
+   auto const  begin = frame.data() + pos + DATE.size();
+   if (std::from_chars(begin, frame.data() + frame.size(), date).ec != std::errc{}) {
+      return std::nullopt;
+   }
+   return date;
+}
+
+std::string
+PlanePos(std::size_t date) {
+   return R"({"id":1,"content":{"__PLANE_POS__":true,"date":)" + std::to_string(date)
+          + R"(,"lat":45.7,"lon":5.1,"altitude":3500,"ground":1200,"heading":270,)"
+            R"("verticalSpeed":0,"windVelocity":10,"windDirection":250}})";
+}
+
+struct Tenant {
+   std::string    name_{};
+   bench::Samples latency_{};  // us
+   std::mutex     mutex_{};
+};
+
+// One phase : the EFB of each sending tenant broadcasts at its rate for the given duration
+void
+RunPhase(
+  Target const&                         target,
+  std::vector<std::unique_ptr<Tenant>>& tenants,
+  std::size_t                           viewers,
+  std::vector<double> const&            rates,
+  std::chrono::seconds                  duration
+) {
+   net::io_context                                   ioc{};
+   std::vector<std::unique_ptr<Socket>>              efbs{};
+   std::vector<std::vector<std::unique_ptr<Socket>>> views(tenants.size());
+
+   for (std::size_t i = 0; i < tenants.size(); ++i) {
+      if (rates[i] > 0.) {
+         efbs.emplace_back(Connect(ioc, target, "EFB", tenants[i]->name_));
+      } else {
+         efbs.emplace_back(nullptr);
+      }
+
+      for (std::size_t j = 0; j < viewers; ++j) {
+         views[i].emplace_back(Connect(ioc, target, "Web", tenants[i]->name_));
+      }
+   }
+
+   std::size_t const         readers = tenants.size() * viewers;
+   std::barrier              ready{static_cast<std::ptrdiff_t>(readers + 1)};
+   std::vector<std::jthread> threads{};
+
+   for (std::size_t i = 0; i < tenants.size(); ++i) {
+      bool const sending = efbs[i] != nullptr;
+
+      for (auto& view : views[i]) {
+         threads.emplace_back([&ready, &tenant = *tenants[i], &ws = *view, sending] {
+            beast::flat_buffer buffer{};
+            bool               registered{false};
+
+            try {
+               while (true) {
+                  buffer.clear();
+                  ws.read(buffer);
+                  auto const frame = beast::buffers_to_string(buffer.data());
+                  auto const now   = Now();
+
+                  if (!registered) {
+                     // The viewer handler is registered once its id is sent
+                     if (frame.find("__SET_ID__") != std::string::npos) {
+                        registered = true;
+                        ready.arrive_and_wait();
+
+                        if (!sending) {
+                           return;
+                        }
+                     }
+                     continue;
+                  }
+
+                  if (auto const date = PlanePosDate(frame)) {
+                     if (*date == 0) {
+                        return;
+                     }
+
+                     std::lock_guard lock{tenant.mutex_};
+                     tenant.latency_.Add(static_cast<double>(now - *date) / 1000.);
+                  }
+               }
+            } catch (std::exception const& e) {
+               std::cerr << "Viewer read error: " << e.what() << std::endl;
+               if (!registered) {
+                  ready.arrive_and_drop();
+               }
+            }
+         });
+      }
+   }
+
+   ready.arrive_and_wait();
+
+   for (std::size_t i = 0; i < tenants.size(); ++i) {
+      if (!efbs[i]) {
+         continue;
+      }
+
+      threads.emplace_back([&ws = *efbs[i], rate = rates[i], duration] {
+         auto const period = std::chrono::duration_cast<bench::Clock::duration>(
+           std::chrono::duration<double>(1. / rate)
+         );
+         auto const end  = bench::Clock::now() + duration;
+         auto       next = bench::Clock::now();
+
+         try {
+            while (next < end) {
+               ws.write(net::buffer(PlanePos(Now())));
+               next += period;
+               std::this_thread::sleep_until(next);
+            }
+            ws.write(net::buffer(PlanePos(0)));
+         } catch (std::exception const& e) {
+            std::cerr << "EFB write error: " << e.what() << std::endl;
+         }
+      });
+   }
+
+   threads.clear();
+
+   for (auto& efb : efbs) {
+      if (efb) {
+         beast::error_code ec{};
+         efb->close(websocket::close_code::normal, ec);
+      }
+   }
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   auto const server = std::getenv("VFRNAV_SERVER");
+   if (!server) {
+      std::cout << "VFRNAV_SERVER=host:port not set, skipped" << std::endl;
+      return bench::SKIPPED;
+   }
+
+   std::string_view const address{server};
+   auto const             colon = address.rfind(':');
+   Target const           target{
+               .host_ = std::string{address.substr(0, colon)},
+               .port_ = colon == std::string_view::npos ? "8080"
+                                                        : std::string{address.substr(colon + 1)},
+   };
+
+   auto const arg = [&](int index, double value) {
+      return index < argc ? std::atof(argv[index]) : value;
+   };
+
+   auto const tenants_count = static_cast<std::size_t>(arg(1, 8));
+   auto const viewers       = static_cast<std::size_t>(arg(2, 4));
+   auto const rate          = arg(3, 30.);
+   auto const noisy         = arg(4, 50.);
+   auto const duration      = std::chrono::seconds{static_cast<int>(arg(5, 10))};
+
+   CHECK(tenants_count >= 2);
+
+   auto const run = [&](bool with_noisy) {
+      std::vector<std::unique_ptr<Tenant>> tenants{};
+      std::vector<double>                  rates{};
+
+      for (std::size_t i = 0; i < tenants_count; ++i) {
+         tenants.emplace_back(std::make_unique<Tenant>());
+         tenants.back()->name_ = "load-" + std::to_string(i);
+         rates.emplace_back(i == 0 ? (with_noisy ? rate * noisy : 0.) : rate);
+      }
+
+      RunPhase(target, tenants, viewers, rates, duration);
+      return tenants;
+   };
+
+   auto const report = [](std::string_view phase, std::vector<std::unique_ptr<Tenant>>& tenants) {
+      bench::Samples quiet{};
+      for (std::size_t i = 0; i < tenants.size(); ++i) {
+         auto& tenant = *tenants[i];
+         tenant.latency_.Report(std::string{phase} + " " + tenant.name_ + " latency", "us");
+
+         if (i) {
+            quiet.Add(tenant.latency_.Percentile(99.));
+         }
+      }
+
+      // Worst quiet tenant
+      return quiet.Percentile(100.);
+   };
+
+   auto alone = run(false);
+   auto mixed = run(true);
+
+   auto const alone_p99 = report("alone", alone);
+   auto const mixed_p99 = report("noisy", mixed);
+
+   CHECK(alone[1]->latency_.Size() && mixed[1]->latency_.Size());
+   std::cout << "quiet tenants p99 : " << alone_p99 << "us alone, " << mixed_p99
+             << "us next to a " << noisy << "x noisy tenant (" << mixed_p99 / alone_p99 << "x)"
+             << std::endl;
+   return EXIT_SUCCESS;
+}
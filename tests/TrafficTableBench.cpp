@@ -0,0 +1,280 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Ticks of the traffic table (SimConnect::SubscribeTraffic) : every aircraft of a by-type sample is
+// decoded and set, the alerts are advised against the user aircraft and the diff to stream to the
+// viewers is taken. 1% of the aircraft leave every tick and are replaced, their static info is
+// received on the next tick.
+//
+// traffic_table_bench [aircraft...] [--ticks N] [--rate HZ]
+
+#include "Bench.h"
+
+#include "SimConnect/Data/TrafficInfo.h"
+#include "SimConnect/Data/TrafficStaticInfo.h"
+#include "SimConnect/Traffic.h"
+#include "SimConnect/Utils/Wire.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <numbers>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using smc::TrafficPosition;
+
+constexpr double ORIGIN_LAT = 40.6399;
+constexpr double ORIGIN_LON = -73.7787;
+
+// Packets of WireSize bytes, one every STRIDE bytes to keep them DWORD aligned
+constexpr std::size_t STRIDE = (smc::wire::WireSize<TrafficPosition>() + 7) / 8 * 8;
+
+struct Aircraft {
+   DWORD           id_{};
+   bool            helicopter_{};
+   TrafficPosition position_{};
+};
+
+class World {
+public:
+   explicit World(std::size_t size) {
+      for (std::size_t i = 0; i < size; ++i) {
+         aircraft_.emplace_back(Spawn());
+      }
+      user_           = Spawn().position_;
+      user_.altitude_ = 3000.;
+   }
+
+   // Moves the aircraft by one second, churn of them being replaced
+   void
+   Step(std::size_t churn) {
+      for (std::size_t i = 0; i < churn; ++i) {
+         aircraft_[rng_() % aircraft_.size()] = Spawn();
+      }
+
+      for (auto& aircraft : aircraft_) {
+         auto& position = aircraft.position_;
+         if (position.sim_on_ground_) {
+            continue;
+         }
+
+         position.lat_ += position.world_lat_velocity_ / FEET_PER_DEGREE;
+         position.lon_ += position.world_lon_velocity_
+                          / (FEET_PER_DEGREE * std::cos(position.lat_ * std::numbers::pi / 180.));
+         position.altitude_ += position.world_vertical_velocity_;
+      }
+   }
+
+   // By-type sample, as received
+   void
+   Encode(std::vector<std::byte>& packets) const {
+      packets.resize(aircraft_.size() * STRIDE);
+
+      for (std::size_t i = 0; i < aircraft_.size(); ++i) {
+         auto* it = packets.data() + i * STRIDE;
+
+         std::apply(
+           [&](auto const&... member) {
+              (
+                [&]<class M>(M const& member) {
+                   using WIRE =
+                     typename smc::wire::WireType<std::tuple_element_t<2, M>::VALUE_S>::type;
+
+                   auto const value =
+                     static_cast<WIRE>(aircraft_[i].position_.*std::get<0>(member));
+                   std::memcpy(it, &value, sizeof(value));
+                   it += sizeof(value);
+                }(member),
+                ...
+              );
+           },
+           TrafficPosition::MEMBERS
+         );
+      }
+   }
+
+   std::vector<Aircraft> const&
+   GetAircraft() const {
+      return aircraft_;
+   }
+
+   TrafficPosition const&
+   User() const {
+      return user_;
+   }
+
+private:
+   static constexpr double FEET_PER_DEGREE = 364'000.;
+
+   Aircraft
+   Spawn() {
+      std::uniform_real_distribution<double> unit{0., 1.};
+
+      Aircraft aircraft{.id_ = next_id_++, .helicopter_ = unit(rng_) < .05};
+      auto&    position = aircraft.position_;
+
+      // 10% parked, the others within 2 degrees, up to FL350
+      position.sim_on_ground_ = unit(rng_) < .1;
+      position.lat_           = ORIGIN_LAT + (unit(rng_) - .5) * 4.;
+      position.lon_           = ORIGIN_LON + (unit(rng_) - .5) * 4.;
+      position.altitude_      = position.sim_on_ground_ ? 13. : 500. + unit(rng_) * 34500.;
+
+      if (!position.sim_on_ground_) {
+         position.true_heading_    = unit(rng_) * 2. * std::numbers::pi;
+         position.ground_velocity_ = 100. + unit(rng_) * 350.;
+
+         auto const speed                  = position.ground_velocity_ * 1.68781;  // feet/second
+         position.world_lat_velocity_      = speed * std::cos(position.true_heading_);
+         position.world_lon_velocity_      = speed * std::sin(position.true_heading_);
+         position.world_vertical_velocity_ = (unit(rng_) - .5) * 40.;
+         position.vspeed_                  = position.world_vertical_velocity_;
+      }
+
+      return aircraft;
+   }
+
+   std::mt19937          rng_{42};
+   DWORD                 next_id_{1};
+   std::vector<Aircraft> aircraft_{};
+   TrafficPosition       user_{};
+};
+
+smc::TrafficStaticInfo
+StaticInfo(DWORD id) {
+   return {
+     .atc_type_  = "TT:ATCCOM.AC_MODEL_A320.0.text",
+     .atc_model_ = "TT:ATCCOM.AC_MODEL_A320.0.text",
+     .atc_id_    = "N" + std::to_string(id),
+     .category_  = "Airplane",
+   };
+}
+
+struct Counts {
+   std::size_t added_{};
+   std::size_t moved_{};
+   std::size_t removed_{};
+};
+
+// Tick times in us
+bench::Samples
+Run(std::size_t size, std::size_t ticks, Counts& counts) {
+   World                  world{size};
+   smc::TrafficTable      table{};
+   std::vector<std::byte> packets{};
+   std::vector<DWORD>     missing{};
+   bench::Samples         times{};
+   auto const             churn = size / 100;
+
+   for (std::size_t tick = 0; tick <= ticks; ++tick) {
+      if (tick) {
+         world.Step(churn);
+      }
+      world.Encode(packets);
+
+      auto const& aircraft = world.GetAircraft();
+      auto const  start    = bench::Clock::now();
+
+      // Static info requested on the previous tick
+      for (auto const id : missing) {
+         table.SetStaticInfo(id, StaticInfo(id));
+      }
+
+      table.Begin();
+      for (std::size_t i = 0; i < aircraft.size(); ++i) {
+         table.Set(
+           aircraft[i].id_,
+           smc::wire::Read<TrafficPosition>(
+             *reinterpret_cast<DWORD const*>(packets.data() + i * STRIDE)
+           ),
+           aircraft[i].helicopter_
+         );
+      }
+      table.Advise(world.User());
+      auto const diff = table.End();
+      missing         = table.TakeMissingStaticInfo();
+
+      auto const time = bench::Micros(bench::Clock::now() - start);
+      CHECK(table.Size() == size);
+
+      if (!tick) {
+         // Every aircraft is new
+         CHECK(diff.added_.size() == size);
+         continue;
+      }
+
+      times.Add(time);
+      counts.added_   += diff.added_.size();
+      counts.moved_   += diff.moved_.size();
+      counts.removed_ += diff.removed_.size();
+
+      CHECK(diff.removed_.size() == diff.added_.size());
+      CHECK(diff.removed_.size() <= churn);
+      CHECK(missing.size() == diff.added_.size());
+   }
+
+   return times;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+   std::vector<std::size_t> sizes{};
+   std::size_t              ticks = 120;
+   double                   rate  = 1.;
+
+   for (int i = 1; i < argc; ++i) {
+      std::string_view const arg{argv[i]};
+      if ((arg == "--ticks") && (i + 1 < argc)) {
+         ticks = static_cast<std::size_t>(std::atof(argv[++i]));
+      } else if ((arg == "--rate") && (i + 1 < argc)) {
+         rate = std::atof(argv[++i]);
+      } else {
+         sizes.emplace_back(static_cast<std::size_t>(std::atof(argv[i])));
+      }
+   }
+
+   if (sizes.empty()) {
+      sizes = {1000, 2000, 5000};
+   }
+
+   for (auto const size : sizes) {
+      Counts counts{};
+      auto   times = Run(size, ticks, counts);
+
+      times.Report(std::to_string(size) + " aircraft tick", "us");
+
+      auto const per_tick = [&](std::size_t count) {
+         return static_cast<double>(count) / static_cast<double>(ticks);
+      };
+      std::cout << "  diff per tick : " << per_tick(counts.added_) << " added, "
+                << per_tick(counts.moved_) << " moved, " << per_tick(counts.removed_)
+                << " removed, max rate (p99) " << 1e6 / times.Percentile(99.) << "Hz"
+                << std::endl;
+
+      // The sampling period is the budget of a tick
+      CHECK(times.Percentile(99.) < 1e6 / rate);
+   }
+
+   return EXIT_SUCCESS;
+}
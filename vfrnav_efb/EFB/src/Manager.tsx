@@ -301,8 +301,12 @@ export class Manager {
             }
 
             this.socket.onopen = () => {
+               // Sim seat to serve, the default one when unset
+               const tenant = this.GetSettings().tenant;
+
                this.socket?.send(JSON.stringify({
-                  __HELLO_WORLD__: "EFB"
+                  __HELLO_WORLD__: "EFB",
+                  tenant: tenant === "" ? undefined : tenant
                }));
             };
          } catch (e) {
@@ -468,7 +472,13 @@ export class Manager {
    }
 
    onSharedSettings(message: SharedSettings) {
+      const tenant = this.GetSettings().tenant;
       SetStoredData("settings", JSON.stringify(message));
+
+      if (message.tenant !== tenant) {
+         // The seat is picked on HelloWorld, reconnect to switch to the new one
+         this.connectToServer();
+      }
    }
 
    onExportNav(message: ExportNav) {
@@ -24,6 +24,13 @@ export class Manager {
    private serverMessageHandler: ((_id: number, _message: MessageType) => void) | undefined = undefined
    private defaultFuelPreset: { name: string, date: number } | undefined = undefined
 
+   // Session resumption, the server replays the messages missed while disconnected
+   private resumeToken: string | undefined = undefined
+   private lastSeq = 0
+
+   // Sim seat to watch (?tenant=<name>), the default one when unset
+   private readonly tenant = new URLSearchParams(window.location.search).get('tenant') ?? undefined
+
 
    constructor() {
       this.connectToServer();
@@ -108,9 +115,19 @@ export class Manager {
       this.socket.onmessage = (event) => {
          const data = (JSON.parse(event.data) as {
             id: number,
-            content: MessageType
+            content: MessageType,
+            seq?: number
          });
 
+         if (data.seq !== undefined) {
+            if (data.seq <= this.lastSeq) {
+               // Already received before the reconnection
+               return;
+            }
+
+            this.lastSeq = data.seq;
+         }
+
          if (isMessage("__HELLO_WORLD__", data.content)) {
             console.assert(data.id === 1)
          } else if (isMessage("__SET_ID__", data.content)) {
@@ -118,6 +135,10 @@ export class Manager {
             console.assert(data.id === 1);
 
             this.id = data.content.__SET_ID__;
+            this.resumeToken = data.content.resume;
+            if (!data.content.resumed) {
+               this.lastSeq = 0;
+            }
 
             this.serverMessageHandler = (id: number, message: MessageType) => {
                this.socket?.send(JSON.stringify({
@@ -155,7 +176,10 @@ export class Manager {
 
       this.socket.onopen = () => {
          this.socket?.send(JSON.stringify({
-            __HELLO_WORLD__: "Web"
+            __HELLO_WORLD__: "Web",
+            resume: this.resumeToken,
+            lastSeq: this.resumeToken ? this.lastSeq : undefined,
+            tenant: this.tenant
          }));
       };
    }
@@ -43,6 +43,7 @@ export type GlobalSettings = Settings & SharedSettings & {
   setSIAAZBAAddr: (_addr: string) => void,
   setSIAAZBADateAddr: (_addr: string) => void,
   setSIAAuth: (_token: string) => void,
+  setTenant: (_tenant: string) => void,
   setAdjustHeading: (_enable: boolean) => void,
   setAdjustTime: (_enable: boolean) => void,
 
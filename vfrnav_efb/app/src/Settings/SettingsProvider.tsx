@@ -83,6 +83,7 @@ const SettingsContextProvider = ({ children, setPopup, emptyPopup, setPage }: Pr
   const setDefaultSpeed = useCallback((value: number) => setSharedSettings(settings => ({ ...settings, defaultSpeed: value })), []);
   const setAdjustHeading = useCallback((value: boolean) => setSharedSettings(settings => ({ ...settings, adjustHeading: value })), []);
   const setAdjustTime = useCallback((value: boolean) => setSharedSettings(settings => ({ ...settings, adjustTime: value })), []);
+  const setTenant = useCallback((value: string) => setSharedSettings(settings => ({ ...settings, tenant: value })), []);
   const setSIAAuth = useCallback((value: string) => setSharedSettings(settings => ({ ...settings, SIAAuth: value })), []);
   const setSIAAddr = useCallback((value: string) => setSharedSettings(settings => ({ ...settings, SIAAddr: value })), []);
   const setSIAAZBAAddr = useCallback((value: string) => setSharedSettings(settings => ({ ...settings, SIAAZBAAddr: value })), []);
@@ -180,6 +181,7 @@ const SettingsContextProvider = ({ children, setPopup, emptyPopup, setPage }: Pr
     setDefaultSpeed: setDefaultSpeed,
     setAdjustHeading: setAdjustHeading,
     setAdjustTime: setAdjustTime,
+    setTenant: setTenant,
     setSIAAuth: setSIAAuth,
     setSIAAddr: setSIAAddr,
     setSIAAZBAAddr: setSIAAZBAAddr,
@@ -220,7 +222,7 @@ const SettingsContextProvider = ({ children, setPopup, emptyPopup, setPage }: Pr
     openaipmapsSettings, openflightmapsBaseSettings, planeSetting,
     getSIAAZBA, getSIAPDF, setPage,
     setAZBAActiveHighColor, setAZBAActiveLowColor, setAZBAInactiveHighColor, setAZBAInactiveLowColor, setAZBARange,
-    setAdjustHeading, setAdjustTime, setMarkerSize, setPopup, setSIAAZBAAddr, setSIAAZBADateAddr, setSIAAddr, setSIAAuth, setDefaultSpeed,
+    setAdjustHeading, setAdjustTime, setMarkerSize, setPopup, setSIAAZBAAddr, setSIAAZBADateAddr, setSIAAddr, setSIAAuth, setDefaultSpeed, setTenant,
     setTextBorderColor, setTextBorderSize, setTextColor, setTextMaxSize, setTextMinSize,
     globalSettings,
     sharedSettings
@@ -395,6 +395,16 @@ export const SettingsPage = () => {
                      onChange={setBorderScaleCallback}>
                      Adjust the Border size of the EFB.
                   </SliderItem>
+                  <InputItem category="Server" name="Sim seat" inputMode="text"
+                     validate={value => Promise.resolve(/^[\w-]*$/g.test(value))}
+                     placeholder='Default seat'
+                     value={settings.tenant} defaultValue={SharedSettingsRecord.defaultValues.tenant}
+                     onChange={settings.setTenant}>
+                     Name of the sim seat served by this EFB when several sims share the same server. Leave empty for the default seat.
+                     <ErrorMessage type='Error'>
+                        Only letters, digits, dashes and underscores are allowed !
+                     </ErrorMessage>
+                  </InputItem>
                </Group>
             }
             <Group name="Map">
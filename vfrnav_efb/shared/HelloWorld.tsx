@@ -16,12 +16,21 @@
 import { GenRecord } from './Types';
 
 export type HelloWorld = {
-   __HELLO_WORLD__: "EFB" | "Web" | "Server",
+   __HELLO_WORLD__: "EFB" | "Web" | "Server" | "Relay",
+
+   resume?: string,
+   lastSeq?: number,
+
+   tenant?: string
 };
 
 export const HelloWorldRecord = GenRecord<HelloWorld>({
    __HELLO_WORLD__: "EFB",
-}, {})
+}, {
+   resume: { optional: true, record: 'string' },
+   lastSeq: { optional: true, record: 'number' },
+   tenant: { optional: true, record: 'string' }
+})
 
 export type ByeBye = {
    __BYE_BYE__: true,
@@ -32,9 +41,15 @@ export const ByeByeRecord = GenRecord<ByeBye>({
 }, {})
 
 export type SetId = {
-   "__SET_ID__": number
+   "__SET_ID__": number,
+
+   resume?: string,
+   resumed?: boolean
 }
 
 export const SetIdRecord = GenRecord<SetId>({
    "__SET_ID__": 2
-}, {});
\ No newline at end of file
+}, {
+   resume: { optional: true, record: 'string' },
+   resumed: { optional: true, record: 'boolean' }
+});
\ No newline at end of file
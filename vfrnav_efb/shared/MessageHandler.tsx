@@ -26,6 +26,8 @@ import { DefaultFuelPresetRecord, DeleteFuelPresetRecord, FuelPresetsRecord, Fue
 import { DefaultDeviationPresetRecord, DeleteDeviationPresetRecord, DeviationPresetsRecord, GetDeviationCurveRecord, GetDeviationPresetsRecord, SetDeviationCurveRecord } from './Deviation';
 import { DateResponseRecord, GetDateRecord } from './Date';
 import { ATCIDResponseRecord, GetATCIdRecord } from './ATCId';
+import { GetTerrainProfileRecord, TerrainProfileRecord } from './TerrainProfile';
+import { GetTrafficRecord, TrafficRecord } from './Traffic';
 
 export type GetSettings = { __GET_SETTINGS__: true };
 export type GetRecords = { __GET_RECORDS__: true };
@@ -79,6 +81,8 @@ const Messages = {
    "__GET_RECORDS__": GetRecordsRecord,
    "__GET_SERVER_STATE__": GetServerStateRecord,
    "__GET_SETTINGS__": GetSettingsRecord,
+   "__GET_TERRAIN_PROFILE__": GetTerrainProfileRecord,
+   "__GET_TRAFFIC__": GetTrafficRecord,
    "__HELLO_WORLD__": HelloWorldRecord,
    "__ICAOS__": IcaosRecord,
    "__IMPORT_NAV__": ImportNavRecord,
@@ -97,6 +101,8 @@ const Messages = {
    "__SET_ID__": SetIdRecord,
    "__SET_PANEL_SIZE__": SetPanelSizeRecord,
    "__SETTINGS__": SharedSettingsRecord,
+   "__TERRAIN_PROFILE__": TerrainProfileRecord,
+   "__TRAFFIC__": TrafficRecord,
 };
 export type MessageType = {
    [Id in keyof typeof Messages]: typeof Messages[Id]["defaultValues"]
@@ -41,6 +41,7 @@ export type SharedSettings = {
   __SETTINGS__: true
 
   defaultSpeed: number,
+  tenant: string,
   SIAAuth: string,
   SIAAddr: string,
   SIAAZBAAddr: string,
@@ -137,6 +138,7 @@ export const SharedSettingsRecord = GenRecord<SharedSettings>({
   __SETTINGS__: true,
 
   defaultSpeed: 95,
+  tenant: "",
   SIAAuth: __SIA_AUTH__,
   SIAAddr: __SIA_ADDR__,
   SIAAZBAAddr: __SIA_AZBA_ADDR__,
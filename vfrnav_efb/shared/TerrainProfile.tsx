@@ -0,0 +1,69 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+import { GenRecord } from './Types';
+
+export type GetTerrainProfile = {
+  __GET_TERRAIN_PROFILE__: true,
+
+  // Echoed by the TerrainProfile messages
+  id: number,
+  // Route, in map coordinates like NavData coords
+  coords: number[][],
+  // Between two samples, nautical miles
+  spacing: number
+};
+
+export const GetTerrainProfileRecord = GenRecord<GetTerrainProfile>({
+  __GET_TERRAIN_PROFILE__: true,
+
+  id: 0,
+  coords: [],
+  spacing: 0.5
+}, {
+  coords: { array: true, record: { array: true, record: 'number' } }
+});
+
+// Samples [offset, offset + elevations.length) of a profile, sent as they are resolved (in any
+// order). The last message of a profile has done set.
+export type TerrainProfile = {
+  __TERRAIN_PROFILE__: true,
+
+  id: number,
+  // Samples of the whole profile
+  count: number,
+  offset: number,
+  distances: number[], // From the first coord, nautical miles
+  elevations: number[], // Feet
+  done: boolean,
+  // The samples couldn't be resolved, elevations is empty
+  error?: string
+};
+
+export const TerrainProfileRecord = GenRecord<TerrainProfile>({
+  __TERRAIN_PROFILE__: true,
+
+  id: 0,
+  count: 0,
+  offset: 0,
+  distances: [],
+  elevations: [],
+  done: false
+}, {
+  distances: { array: true, record: 'number' },
+  elevations: { array: true, record: 'number' },
+  error: { optional: true, record: 'string' }
+});
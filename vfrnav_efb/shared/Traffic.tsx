@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: (GNU General Public License v3.0 only)
+ * Copyright © 2024 Alexandre GARCIN
+ *
+ * This program is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program. If
+ * not, see <https://www.gnu.org/licenses/>.
+ */
+
+import { GenRecord } from './Types';
+
+// 0 none, 1 proximate, 2 traffic advisory, 3 resolution advisory
+export type TrafficAlert = 0 | 1 | 2 | 3;
+
+export type TrafficAircraft = {
+  id: number,
+  lat: number,
+  lon: number,
+  altitude: number, // feet
+  heading: number, // true, degrees
+  groundVelocity: number, // knots
+  verticalSpeed: number, // feet/minute
+  onGround: boolean,
+  helicopter: boolean,
+  alert: TrafficAlert,
+  atcId?: string,
+  atcType?: string,
+  atcModel?: string,
+}
+
+export const TrafficAircraftRecord = GenRecord<TrafficAircraft>({
+  id: -1,
+  lat: -1,
+  lon: -1,
+  altitude: -1,
+  heading: -1,
+  groundVelocity: -1,
+  verticalSpeed: -1,
+  onGround: false,
+  helicopter: false,
+  alert: 0
+}, {
+  atcId: { optional: true, record: 'string' },
+  atcType: { optional: true, record: 'string' },
+  atcModel: { optional: true, record: 'string' }
+});
+
+// Changes since the last Traffic message, the first one lists every aircraft as added
+export type Traffic = {
+  __TRAFFIC__: true,
+
+  added: TrafficAircraft[],
+  moved: TrafficAircraft[],
+  removed: number[]
+};
+
+export const TrafficRecord = GenRecord<Traffic>({
+  __TRAFFIC__: true,
+
+  added: [],
+  moved: [],
+  removed: []
+}, {
+  added: { array: true, record: TrafficAircraftRecord },
+  moved: { array: true, record: TrafficAircraftRecord },
+  removed: { array: true, record: 'number' }
+});
+
+export type GetTraffic = {
+  __GET_TRAFFIC__: true,
+
+  subscribe: boolean
+};
+
+export const GetTrafficRecord = GenRecord<GetTraffic>({
+  __GET_TRAFFIC__: true,
+
+  subscribe: true
+}, {});